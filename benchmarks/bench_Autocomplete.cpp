@@ -0,0 +1,152 @@
+// benchmarks/bench_Autocomplete.cpp
+// Search box completion: AutocompleteIndex over the folded titles, artists
+// and albums of a library
+// - build:   bulk build() of every entry (what a big import does)
+// - add:     same entries with one add() each (small imports, edits)
+// - remove:  remove() of a tenth of the entries
+// - memory:  index bytes per 100k entries, nodes per entry
+// - complete: us per keystroke for typed prefixes, against the full
+//             search() the box used to run on every keystroke
+//
+// Usage: bench_Autocomplete [songs]   (default 1000000)
+// Library sizes 10k, 100k and 1M (up to songs). Best of 5 runs.
+
+#include "../include/MusicLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char *WORDS[] = {
+    "love",  "night",  "river", "dream", "summer", "fire",  "rain",
+    "heart", "city",   "light", "ocean", "blue",   "gold",  "road",
+    "Hà",    "Nội",    "Sài",   "Gòn",   "mưa",    "người", "tình",
+    "yêu",   "phố",    "biển",  "xuân",  "đêm",    "nhớ",   "em",
+};
+
+// ~12 songs per album, ~5 per artist
+static std::vector<Song> makeSongs(size_t count) {
+  std::mt19937 rng(4);
+  auto word = [&] { return std::string(WORDS[rng() % std::size(WORDS)]); };
+  std::vector<Song> songs;
+  songs.reserve(count);
+  std::string artist, album;
+  for (size_t i = 0; i < count; i++) {
+    if (i % 5 == 0) {
+      artist = word() + " " + word() + " " + std::to_string(i / 5);
+    }
+    if (i % 12 == 0) {
+      album = word() + " " + word() + " " + std::to_string(i / 12);
+    }
+    Song song;
+    song.title = word() + " " + word() + " " + word() + " " +
+                 std::to_string(rng() % 1000);
+    song.artist = artist;
+    song.album = album;
+    song.filePath = "/music/" + std::to_string(i) + ".mp3";
+    songs.push_back(std::move(song));
+  }
+  return songs;
+}
+
+// Best of 5 [ms], prepare() untimed before each run
+static double bestMs(const std::function<void()> &run,
+                     const std::function<void()> &prepare = [] {}) {
+  double best = 1e300;
+  for (int round = 0; round < 5; round++) {
+    prepare();
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+static void run(size_t count) {
+  MusicLibrary library;
+  library.addSongs(makeSongs(count));
+  const SongColumns &columns = library.getColumns();
+
+  // As the library fills it: one item per title, one per name weighted
+  // by its songs
+  std::vector<AutocompleteIndex::Item> items;
+  std::vector<uint32_t> artistSongs(library.getArtists().size());
+  std::vector<uint32_t> albumSongs(library.getAlbums().size());
+  for (size_t row = 0; row < columns.size(); row++) {
+    items.push_back({columns.titleSearchKeys[row], "", 0, 1});
+    artistSongs[columns.artistIds[row]]++;
+    albumSongs[columns.albumIds[row]]++;
+  }
+  for (uint32_t id = 0; id < artistSongs.size(); id++) {
+    items.push_back(
+        {library.getArtistKeys(id).searchKey, "", 1, artistSongs[id]});
+  }
+  for (uint32_t id = 0; id < albumSongs.size(); id++) {
+    items.push_back(
+        {library.getAlbumKeys(id).searchKey, "", 2, albumSongs[id]});
+  }
+
+  AutocompleteIndex index;
+  double build = bestMs([&] { index.build(items); });
+  AutocompleteIndex added;
+  double add = bestMs(
+      [&] {
+        for (const AutocompleteIndex::Item &item : items) {
+          added.add(item.key, item.text, item.tag, item.weight);
+        }
+      },
+      [&] { added.clear(); });
+  AutocompleteIndex removed;
+  double remove = bestMs(
+      [&] {
+        for (size_t i = 0; i < items.size() / 10; i++) {
+          removed.remove(items[i].key, items[i].tag, items[i].weight);
+        }
+      },
+      [&] { removed = index; });
+  double perEntry = double(index.getMemoryUsage()) / index.size();
+
+  std::cout << std::setw(9) << count << std::setw(10) << index.size()
+            << std::setw(10) << build << std::setw(10) << add << std::setw(10)
+            << remove << std::setw(9) << perEntry * 100000 / (1 << 20)
+            << std::setw(8) << double(index.getNodeCount()) / index.size()
+            << std::endl;
+
+  std::cout << "           typed  us/complete  ms/search" << std::endl;
+  for (const char *typed : {"l", "lo", "love n", "ha noi", "người tình",
+                            "river gold 12"}) {
+    std::string prefix = makeSearchKey(typed);
+    size_t found = 0;
+    double complete = bestMs([&] {
+      for (int i = 0; i < 1000; i++) {
+        found += index.complete(prefix).size();
+      }
+    });
+    double search =
+        bestMs([&] { found += library.search(typed).songs.size(); });
+    std::cout << std::setw(16) << typed << std::setw(13) << complete
+              << std::setw(11) << search << std::endl;
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t maxSongs = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  std::cout << std::fixed << std::setprecision(3);
+  for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)}) {
+    if (count > maxSongs) {
+      continue;
+    }
+    std::cout << "    songs   entries  build ms    add ms remove ms"
+              << "  MB/100k  nodes/e" << std::endl;
+    run(count);
+    std::cout << std::endl;
+  }
+  return 0;
+}
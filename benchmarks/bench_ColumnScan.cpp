@@ -0,0 +1,187 @@
+// benchmarks/bench_ColumnScan.cpp
+// Full-library scans over three layouts:
+// - Song[]:     std::vector<Song>, the layout the library used to keep
+// - rows:       MusicLibrary::getAllSongs(), 64-byte StoredSong records
+// - columns:    MusicLibrary::getColumns(), one array per field
+//
+// Usage: bench_ColumnScan [songs]   (default 1000000)
+// Scans: album match (enqueue album), artist-or-album match (smart
+// playlist), title substring (search), path prefix (folder removed).
+// Best of 5 runs, ns per song.
+
+#include "../include/MusicLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::vector<Song> makeSongs(size_t count) {
+  std::vector<Song> songs;
+  songs.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    Song song;
+    song.title = "Song Title Number " + std::to_string(i);
+    song.artist = "Synthetic Artist Name " + std::to_string(i / 60);
+    song.album = "Synthetic Album Title Vol. " + std::to_string(i / 12);
+    song.duration = 180 + i % 120;
+    song.filePath = "/music/" + std::to_string(i / 1000) + "/" +
+                    std::to_string(i) + ".mp3";
+    songs.push_back(std::move(song));
+  }
+  return songs;
+}
+
+// Best of 5 [ns per song]; the match count keeps the scan from being
+// optimized out and checks the layouts agree
+static double nsPerSong(size_t count, size_t &matches,
+                        const std::function<size_t()> &scan) {
+  double best = 1e300;
+  for (int run = 0; run < 5; run++) {
+    auto start = std::chrono::steady_clock::now();
+    matches = scan();
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count() / count);
+  }
+  return best;
+}
+
+static void report(const char *name, size_t count,
+                   const std::function<size_t()> &legacy,
+                   const std::function<size_t()> &rows,
+                   const std::function<size_t()> &columns) {
+  size_t m1, m2, m3;
+  double a = nsPerSong(count, m1, legacy);
+  double b = nsPerSong(count, m2, rows);
+  double c = nsPerSong(count, m3, columns);
+  std::cout << std::left << std::setw(18) << name << std::right
+            << std::setw(9) << a << std::setw(9) << b << std::setw(10) << c
+            << std::setw(9) << a / c << "x";
+  if (m1 != m2 || m2 != m3) {
+    std::cout << "  (mismatch: " << m1 << " " << m2 << " " << m3 << ")";
+  }
+  std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  std::vector<Song> legacy = makeSongs(count);
+  MusicLibrary library;
+  library.addSongs(makeSongs(count));
+  const SongStore &rows = library.getAllSongs();
+  const SongColumns &columns = library.getColumns();
+
+  const std::string album = legacy[count / 2].album;
+  const std::string artist = legacy[count / 3].artist;
+  const uint32_t albumId = library.getAlbums().find(album);
+  const uint32_t artistId = library.getArtists().find(artist);
+  const std::string query = "99";
+  const std::string prefix = "/music/" + std::to_string(count / 2000) + "/";
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "songs: " << count << "  [ns/song]" << std::endl;
+  std::cout << "scan                Song[]     rows   columns  speedup"
+            << std::endl;
+
+  report(
+      "album match", count,
+      [&] {
+        size_t n = 0;
+        for (const Song &song : legacy) {
+          n += song.album == album;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (const StoredSong &song : rows) {
+          n += song.albumId == albumId;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (uint32_t id : columns.albumIds) {
+          n += id == albumId;
+        }
+        return n;
+      });
+
+  report(
+      "artist or album", count,
+      [&] {
+        size_t n = 0;
+        for (const Song &song : legacy) {
+          n += song.artist == artist || song.album == album;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (const StoredSong &song : rows) {
+          n += song.artistId == artistId || song.albumId == albumId;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (size_t row = 0; row < columns.size(); row++) {
+          n += columns.artistIds[row] == artistId ||
+               columns.albumIds[row] == albumId;
+        }
+        return n;
+      });
+
+  report(
+      "title substring", count,
+      [&] {
+        size_t n = 0;
+        for (const Song &song : legacy) {
+          n += song.title.find(query) != std::string::npos;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (const StoredSong &song : rows) {
+          n += song.title.find(query) != std::string_view::npos;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (std::string_view title : columns.titles) {
+          n += title.find(query) != std::string_view::npos;
+        }
+        return n;
+      });
+
+  report(
+      "path prefix", count,
+      [&] {
+        size_t n = 0;
+        for (const Song &song : legacy) {
+          n += song.filePath.compare(0, prefix.size(), prefix) == 0;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (const StoredSong &song : rows) {
+          n += song.filePath.compare(0, prefix.size(), prefix) == 0;
+        }
+        return n;
+      },
+      [&] {
+        size_t n = 0;
+        for (std::string_view path : columns.filePaths) {
+          n += path.compare(0, prefix.size(), prefix) == 0;
+        }
+        return n;
+      });
+  return 0;
+}
@@ -0,0 +1,89 @@
+// benchmarks/bench_FuzzySearch.cpp
+// Typo-tolerant search: MusicLibrary::fuzzySearch() latency (top 20) for
+// misspelled queries of different lengths, against a 16.7 ms frame
+//
+// Usage: bench_FuzzySearch [songs]   (default 1000000)
+// Library sizes 10k, 100k and 1M (up to songs) of word-built titles and
+// Vietnamese-style names. Best of 5 runs per query.
+
+#include "../include/MusicLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char *WORDS[] = {
+    "love",  "night",  "river", "dream", "summer", "fire",  "rain",
+    "heart", "city",   "light", "ocean", "blue",   "gold",  "road",
+    "Hà",    "Nội",    "Sài",   "Gòn",   "mưa",    "người", "tình",
+    "yêu",   "phố",    "biển",  "xuân",  "đêm",    "nhớ",   "em",
+};
+static const char *NAMES[] = {
+    "Sơn Tùng",       "Mỹ Tâm",      "Hồ Ngọc Hà",  "Đen Vâu",
+    "Trịnh Công Sơn", "Hà Anh Tuấn", "Bích Phương",
+    "Noo Phước Thịnh", "Vũ Cát Tường", "Tùng Dương",
+};
+
+// ~12 songs per album, ~5 per artist; artists are a name plus a number
+static std::vector<Song> makeSongs(size_t count) {
+  std::mt19937 rng(9);
+  auto word = [&] { return std::string(WORDS[rng() % std::size(WORDS)]); };
+  std::vector<Song> songs;
+  songs.reserve(count);
+  std::string artist, album;
+  for (size_t i = 0; i < count; i++) {
+    if (i % 5 == 0) {
+      artist = std::string(NAMES[rng() % std::size(NAMES)]) + " " +
+               std::to_string(i / 5);
+    }
+    if (i % 12 == 0) {
+      album = word() + " " + word() + " " + std::to_string(i / 12);
+    }
+    Song song;
+    song.title = word() + " " + word() + " " + word();
+    song.artist = artist;
+    song.album = album;
+    song.filePath = "/music/" + std::to_string(i) + ".mp3";
+    songs.push_back(std::move(song));
+  }
+  return songs;
+}
+
+static void run(size_t count) {
+  MusicLibrary library;
+  library.addSongs(makeSongs(count));
+
+  for (const char *query :
+       {"rian", "son tugn", "trinh cong sn", "ho ngoc ha nho em"}) {
+    std::vector<FuzzyHit> hits;
+    double best = 1e300;
+    for (int round = 0; round < 5; round++) {
+      auto start = std::chrono::steady_clock::now();
+      hits = library.fuzzySearch(query, 20);
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    std::cout << std::setw(9) << count << std::setw(20) << query
+              << std::setw(7) << hits.size() << std::setw(10) << best
+              << std::setw(10) << (best < 1000.0 / 60 ? "yes" : "no")
+              << std::endl;
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t maxSongs = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "    songs               query   hits        ms  in frame"
+            << std::endl;
+  for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)}) {
+    if (count <= maxSongs) {
+      run(count);
+    }
+  }
+  return 0;
+}
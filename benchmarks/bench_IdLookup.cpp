@@ -0,0 +1,111 @@
+// benchmarks/bench_IdLookup.cpp
+// Random song lookups by ID:
+// - map:    std::unordered_map<int, SongHandle>, the index the library
+//           used to keep, then resolve()
+// - array:  MusicLibrary::findSongByID(), IDs index a dense array
+//
+// Usage: bench_IdLookup [songs]   (default 1000000)
+// Library sizes 10k, 100k and 1M (up to songs), 1M random IDs each with
+// 1% removed songs mixed in. Best of 5 runs, ns per lookup.
+
+#include "../include/MusicLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static constexpr size_t LOOKUPS = 1000000;
+
+static std::vector<Song> makeSongs(size_t count) {
+  std::vector<Song> songs;
+  songs.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    Song song;
+    song.title = "Song " + std::to_string(i);
+    song.artist = "Artist " + std::to_string(i / 5);
+    song.album = "Album " + std::to_string(i / 12);
+    song.duration = 180 + i % 120;
+    song.filePath = "/music/" + std::to_string(i) + ".mp3";
+    songs.push_back(std::move(song));
+  }
+  return songs;
+}
+
+// Best of 5 [ns per lookup]; the found count keeps the lookups from being
+// optimized out and checks both indexes agree
+static double nsPerLookup(size_t &found,
+                          const std::function<size_t()> &lookups) {
+  double best = 1e300;
+  for (int run = 0; run < 5; run++) {
+    auto start = std::chrono::steady_clock::now();
+    found = lookups();
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count() / LOOKUPS);
+  }
+  return best;
+}
+
+static void run(size_t count) {
+  MusicLibrary library;
+  library.addSongs(makeSongs(count));
+  for (size_t id = 0; id < count; id += 100) {
+    library.removeSong(static_cast<int>(id));
+  }
+
+  std::unordered_map<int, SongHandle> byID;
+  byID.reserve(library.getSize());
+  for (const StoredSong &song : library) {
+    byID[song.id] = library.findHandleByID(song.id);
+  }
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> pick(0, static_cast<int>(count) - 1);
+  std::vector<int> ids(LOOKUPS);
+  for (int &id : ids) {
+    id = pick(rng);
+  }
+
+  size_t mapFound, arrayFound;
+  double map = nsPerLookup(mapFound, [&] {
+    size_t n = 0;
+    for (int id : ids) {
+      auto it = byID.find(id);
+      n += it != byID.end() && library.resolve(it->second) != nullptr;
+    }
+    return n;
+  });
+  double array = nsPerLookup(arrayFound, [&] {
+    size_t n = 0;
+    for (int id : ids) {
+      n += library.findSongByID(id) != nullptr;
+    }
+    return n;
+  });
+
+  std::cout << std::setw(9) << count << std::setw(9) << map << std::setw(9)
+            << array << std::setw(9) << map / array << "x";
+  if (mapFound != arrayFound) {
+    std::cout << "  (mismatch: " << mapFound << " " << arrayFound << ")";
+  }
+  std::cout << std::endl;
+}
+
+int main(int argc, char **argv) {
+  size_t maxSongs = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "lookups: " << LOOKUPS << "  [ns/lookup]" << std::endl;
+  std::cout << "    songs      map    array  speedup" << std::endl;
+  for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)}) {
+    if (count <= maxSongs) {
+      run(count);
+    }
+  }
+  return 0;
+}
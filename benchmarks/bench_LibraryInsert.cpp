@@ -0,0 +1,88 @@
+// benchmarks/bench_LibraryInsert.cpp
+// Per-song cost of MusicLibrary inserts: addSong() vs addSongs()
+//
+// Usage: bench_LibraryInsert [max songs]   (default 1000000)
+// Library sizes 10k, 100k and 1M (up to max songs):
+// - addSong:       one copy + four map updates per song
+// - addSongs(256): import-sized batches, indexes merged per batch
+// - addSongs(all): one batch, indexes built in one parallel pass
+
+#include "../include/MusicLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Songs shaped like a real library: ~12 songs per album, ~5 per artist
+static std::vector<Song> makeSongs(size_t count) {
+  std::vector<Song> songs;
+  songs.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    Song song;
+    song.title = "Song " + std::to_string(i);
+    song.artist = "Artist " + std::to_string(i / 5);
+    song.album = "Album " + std::to_string(i / 12);
+    song.duration = 180 + i % 120;
+    song.filePath = "/music/" + song.artist + "/" + song.album + "/" +
+                    song.title + ".mp3";
+    songs.push_back(std::move(song));
+  }
+  return songs;
+}
+
+// Time one way of filling a library [ns per song]
+static double nsPerSong(size_t count,
+                        const std::function<void(MusicLibrary &,
+                                                 std::vector<Song> &)> &fill) {
+  std::vector<Song> songs = makeSongs(count);
+  MusicLibrary library;
+  auto start = std::chrono::steady_clock::now();
+  fill(library, songs);
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  if (library.getSize() != count) {
+    std::cerr << "Error: library holds " << library.getSize() << " songs"
+              << std::endl;
+  }
+  return elapsed.count() / count;
+}
+
+int main(int argc, char **argv) {
+  size_t maxSongs = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "songs      addSong   addSongs(256)  addSongs(all)  [ns/song]"
+            << std::endl;
+  for (size_t count : {10000, 100000, 1000000}) {
+    if (count > maxSongs) {
+      break;
+    }
+    double single = nsPerSong(count, [](MusicLibrary &lib,
+                                        std::vector<Song> &songs) {
+      for (const Song &song : songs) {
+        lib.addSong(song);
+      }
+    });
+    double batched = nsPerSong(count, [](MusicLibrary &lib,
+                                         std::vector<Song> &songs) {
+      for (size_t i = 0; i < songs.size(); i += 256) {
+        size_t end = std::min(songs.size(), i + 256);
+        std::vector<Song> batch(std::make_move_iterator(songs.begin() + i),
+                                std::make_move_iterator(songs.begin() + end));
+        lib.addSongs(std::move(batch));
+      }
+    });
+    double bulk = nsPerSong(count, [](MusicLibrary &lib,
+                                      std::vector<Song> &songs) {
+      lib.addSongs(std::move(songs));
+    });
+    std::cout << std::setw(8) << count << std::setw(11) << single
+              << std::setw(16) << batched << std::setw(15) << bulk
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,141 @@
+// benchmarks/bench_Search.cpp
+// Substring search over title, artist and album:
+// - scan:   every song and name compared with the query, the way the
+//           search tab used to (containsString over the text)
+// - index:  MusicLibrary::search(), trigram candidates verified on the
+//           search keys
+//
+// Usage: bench_Search [songs]   (default 1000000)
+// Library sizes 10k, 100k and 1M (up to songs) of word-built titles and
+// names. Best of 5 runs per query, ms per query.
+
+#include "../include/MusicLibrary.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char *WORDS[] = {
+    "love",  "night", "river",   "dream",  "summer", "fire",   "rain",
+    "heart", "city",  "light",   "ocean",  "blue",   "gold",   "road",
+    "star",  "moon",  "winter",  "dance",  "home",   "wild",   "storm",
+    "silver", "shadow", "garden", "echo",  "paper",  "glass",  "stone",
+    "Hà",    "Nội",   "Sài",     "Gòn",    "mưa",    "người",  "tình",
+    "yêu",   "phố",   "biển",    "xuân",   "đêm",    "nhớ",    "em",
+};
+
+// Titles of 2-3 words plus a number, ~12 songs per album, ~5 per artist
+static std::vector<Song> makeSongs(size_t count) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<size_t> word(0, std::size(WORDS) - 1);
+  auto phrase = [&](int words) {
+    std::string text = WORDS[word(rng)];
+    for (int i = 1; i < words; i++) {
+      text += ' ';
+      text += WORDS[word(rng)];
+    }
+    return text;
+  };
+  std::vector<Song> songs;
+  songs.reserve(count);
+  std::string artist, album;
+  for (size_t i = 0; i < count; i++) {
+    if (i % 5 == 0) {
+      artist = phrase(2) + " " + std::to_string(i / 5);
+    }
+    if (i % 12 == 0) {
+      album = phrase(2) + " " + std::to_string(i / 12);
+    }
+    Song song;
+    song.title = phrase(2 + i % 2) + " " + std::to_string(i);
+    song.artist = artist;
+    song.album = album;
+    song.filePath = "/music/" + std::to_string(i) + ".mp3";
+    songs.push_back(std::move(song));
+  }
+  return songs;
+}
+
+// The old search tab: case-insensitive std::search per field
+static bool containsString(std::string_view haystack, std::string_view needle) {
+  auto it = std::search(haystack.begin(), haystack.end(), needle.begin(),
+                        needle.end(), [](char ch1, char ch2) {
+                          return std::toupper(ch1) == std::toupper(ch2);
+                        });
+  return it != haystack.end();
+}
+
+static size_t scan(const MusicLibrary &library, const std::string &query) {
+  std::vector<bool> artistHit(library.getArtists().size());
+  for (size_t id = 0; id < artistHit.size(); id++) {
+    artistHit[id] = containsString(library.getArtists().get(id), query);
+  }
+  std::vector<bool> albumHit(library.getAlbums().size());
+  for (size_t id = 0; id < albumHit.size(); id++) {
+    albumHit[id] = containsString(library.getAlbums().get(id), query);
+  }
+  const SongColumns &columns = library.getColumns();
+  size_t hits = 0;
+  for (size_t row = 0; row < columns.size(); row++) {
+    hits += artistHit[columns.artistIds[row]] ||
+            albumHit[columns.albumIds[row]] ||
+            containsString(columns.titles[row], query);
+  }
+  return hits;
+}
+
+// Best of 5 [ms per query]
+static double msPerQuery(size_t &hits, const std::function<size_t()> &query) {
+  double best = 1e300;
+  for (int run = 0; run < 5; run++) {
+    auto start = std::chrono::steady_clock::now();
+    hits = query();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+static void run(size_t count) {
+  MusicLibrary library;
+  library.addSongs(makeSongs(count));
+  library.search("warm up"); // lists sorted on first touch
+
+  // Selective to broad; ASCII queries so both find the same songs
+  for (const char *query : {"12345", "storm 4", "shadow", "love", "ri"}) {
+    size_t scanHits, indexHits;
+    double scanMs =
+        msPerQuery(scanHits, [&] { return scan(library, query); });
+    double indexMs = msPerQuery(indexHits, [&] {
+      return library.search(query).songs.size();
+    });
+    std::cout << std::setw(9) << count << std::setw(10) << query
+              << std::setw(9) << indexHits << std::setw(10) << scanMs
+              << std::setw(10) << indexMs << std::setw(9)
+              << scanMs / indexMs << "x";
+    if (scanHits != indexHits) {
+      std::cout << "  (mismatch: " << scanHits << " " << indexHits << ")";
+    }
+    std::cout << std::endl;
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t maxSongs = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "    songs     query     hits   scan ms  index ms  speedup"
+            << std::endl;
+  for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)}) {
+    if (count <= maxSongs) {
+      run(count);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,117 @@
+// benchmarks/bench_StringPool.cpp
+// Memory saved by interning artist and album names
+//
+// Usage: bench_StringPool [songs]   (default 1000000)
+// A synthetic library (~12 songs per album, ~5 albums per artist):
+// - per-song strings: what every Song used to carry for artist + album
+// - interned:         two uint32_t IDs per song + one pooled copy per name
+// - library:          heap of the whole MusicLibrary after addSongs()
+// Heap is counted through a replaced global operator new.
+
+#include "../include/MusicLibrary.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// --- Heap accounting: every block carries its size in a 16-byte prefix ---
+static std::atomic<size_t> liveBytes{0}; // addSongs() indexes on threads
+
+void *operator new(size_t size) {
+  void *block = std::malloc(size + 16);
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *static_cast<size_t *>(block) = size;
+  liveBytes += size;
+  return static_cast<char *>(block) + 16;
+}
+
+void operator delete(void *ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  void *block = static_cast<char *>(ptr) - 16;
+  liveBytes -= *static_cast<size_t *>(block);
+  std::free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+
+// Names longer than the small-string buffer, like most real ones
+static std::string artistName(size_t song) {
+  return "Synthetic Artist Name " + std::to_string(song / 60);
+}
+
+static std::string albumName(size_t song) {
+  return "Synthetic Album Title Vol. " + std::to_string(song / 12);
+}
+
+static double toMB(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  std::cout << std::fixed << std::setprecision(1);
+
+  // Before: two std::string per song
+  size_t start = liveBytes;
+  std::vector<std::string> perSong;
+  perSong.reserve(2 * count);
+  for (size_t i = 0; i < count; i++) {
+    perSong.push_back(artistName(i));
+    perSong.push_back(albumName(i));
+  }
+  size_t stringBytes = liveBytes - start;
+  perSong.clear();
+  perSong.shrink_to_fit();
+
+  // After: two IDs per song, each distinct name stored once
+  start = liveBytes;
+  StringPool artists;
+  StringPool albums;
+  std::vector<uint32_t> ids;
+  ids.reserve(2 * count);
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; i++) {
+    ids.push_back(artists.intern(artistName(i)));
+    ids.push_back(albums.intern(albumName(i)));
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - t0;
+  size_t internedBytes = liveBytes - start;
+
+  std::cout << "songs:            " << count << " (" << artists.size()
+            << " artists, " << albums.size() << " albums)" << std::endl;
+  std::cout << "per-song strings: " << toMB(stringBytes) << " MB" << std::endl;
+  std::cout << "interned:         " << toMB(internedBytes) << " MB  ("
+            << toMB(artists.getTextBytes() + albums.getTextBytes())
+            << " MB text)" << std::endl;
+  std::cout << "saved:            " << toMB(stringBytes - internedBytes)
+            << " MB" << std::endl;
+  std::cout << "intern:           " << elapsed.count() / (2 * count)
+            << " ns/name (includes building the name)" << std::endl;
+
+  // Whole library, for scale
+  start = liveBytes;
+  std::vector<Song> songs;
+  songs.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    Song song;
+    song.title = "Song " + std::to_string(i);
+    song.artist = artistName(i);
+    song.album = albumName(i);
+    song.filePath = "/music/" + std::to_string(i) + ".mp3";
+    songs.push_back(std::move(song));
+  }
+  MusicLibrary library;
+  library.addSongs(std::move(songs));
+  songs.shrink_to_fit(); // only the library is left
+  std::cout << "library heap:     " << toMB(liveBytes - start)
+            << " MB (" << (liveBytes - start) / count << " B/song)"
+            << std::endl;
+  return 0;
+}
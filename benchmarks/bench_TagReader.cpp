@@ -0,0 +1,200 @@
+// benchmarks/bench_TagReader.cpp
+// FastTagReader vs TagLib on the same files
+//
+// Usage: bench_TagReader [file count | music folder]
+// - file count: synthetic corpus written to the temp folder (default 500)
+// - music folder: every .mp3 / .wav below it, results are also compared
+// Both paths run three rounds over a warm cache, the best round is kept.
+
+#include "../include/DirectoryWalker.h"
+#include "../include/FastTagReader.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <taglib/fileref.h>
+#include <taglib/tag.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// --- Synthetic corpus ---
+
+static std::string be32(uint32_t v) {
+  return {char(v >> 24), char(v >> 16), char(v >> 8), char(v)};
+}
+
+static std::string le32(uint32_t v) {
+  return {char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+}
+
+static std::string syncsafe(uint32_t v) {
+  return {char(v >> 21 & 0x7F), char(v >> 14 & 0x7F), char(v >> 7 & 0x7F),
+          char(v & 0x7F)};
+}
+
+static std::string textFrame(const std::string &id, const std::string &text) {
+  return id + be32(text.size() + 1) + std::string(3, '\0') + text;
+}
+
+// ID3v2.3 tag with text frames and a 64 KB cover, Xing frame, ~4 MB audio
+static std::string syntheticMp3(size_t i) {
+  const size_t frameSize = 417; // MPEG-1 Layer III, 128 kbit/s, 44100 Hz
+  const size_t frames = 10000;
+  std::string header("\xFF\xFB\x90\x00", 4);
+
+  std::string cover = std::string(1, '\0') + "image/jpeg" + '\0' + '\3' +
+                      '\0' + std::string(64 * 1024, '\x55');
+  std::string frames23 =
+      textFrame("TIT2", "Title " + std::to_string(i)) +
+      textFrame("TPE1", "Artist " + std::to_string(i % 50)) +
+      textFrame("TALB", "Album " + std::to_string(i % 200)) + "APIC" +
+      be32(cover.size()) + std::string(2, '\0') + cover;
+  std::string tagBody = frames23 + std::string(1024, '\0');
+  std::string out = std::string("ID3\3\0\0", 6) + syncsafe(tagBody.size()) +
+                    tagBody;
+
+  std::string xing = header + std::string(32, '\0') + "Xing" + be32(0x1) +
+                     be32(frames);
+  out += xing + std::string(frameSize - xing.size(), '\0');
+  std::string frame = header + std::string(frameSize - 4, '\x11');
+  for (size_t f = 0; f < frames; f++) {
+    out += frame;
+  }
+  return out;
+}
+
+// 16-bit stereo PCM with a LIST/INFO chunk after ~4 MB of data
+static std::string syntheticWav(size_t i) {
+  std::string fmt = std::string("\1\0\2\0", 4) + le32(44100) +
+                    le32(44100 * 4) + std::string("\4\0\x10\0", 4);
+  std::string title = "Wave " + std::to_string(i);
+  title.resize(title.size() + 2 - title.size() % 2, '\0');
+  std::string info = "INFO" + std::string("INAM") + le32(title.size()) + title;
+  std::string data(1000 * 1024 * 4, '\0');
+  std::string body = "WAVE" + std::string("fmt ") + le32(fmt.size()) + fmt +
+                     "data" + le32(data.size()) + data + "LIST" +
+                     le32(info.size()) + info;
+  return "RIFF" + le32(body.size()) + body;
+}
+
+static std::vector<std::string> writeCorpus(const fs::path &dir,
+                                            size_t count) {
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  std::vector<std::string> files;
+  for (size_t i = 0; i < count; i++) {
+    bool wav = i % 10 == 9; // mostly MP3, like a typical library
+    fs::path path =
+        dir / ("song_" + std::to_string(i) + (wav ? ".wav" : ".mp3"));
+    std::ofstream(path, std::ios::binary)
+        << (wav ? syntheticWav(i) : syntheticMp3(i));
+    files.push_back(path.string());
+  }
+  return files;
+}
+
+// --- Readers ---
+
+static bool readTagLib(const std::string &filePath, Song &song) {
+  TagLib::FileRef f(fs::u8path(filePath).wstring().c_str());
+  if (f.isNull() || !f.tag()) {
+    return false;
+  }
+  song.title = f.tag()->title().to8Bit(true);
+  song.artist = f.tag()->artist().to8Bit(true);
+  song.album = f.tag()->album().to8Bit(true);
+  if (f.audioProperties()) {
+    song.duration = f.audioProperties()->lengthInSeconds();
+  }
+  return true;
+}
+
+// Best of three rounds [ms], songs and results of the last round
+static double timeReader(const std::vector<std::string> &files,
+                         const std::function<bool(const std::string &,
+                                                  Song &)> &reader,
+                         std::vector<Song> &songs, std::vector<char> &parsed) {
+  double best = 0;
+  for (int round = 0; round < 3; round++) {
+    songs.assign(files.size(), Song());
+    parsed.assign(files.size(), 0);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < files.size(); i++) {
+      parsed[i] = reader(files[i], songs[i]);
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (round == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> files;
+  fs::path corpus;
+  std::string arg = argc > 1 ? argv[1] : "500";
+  if (!arg.empty() && fs::is_directory(fs::u8path(arg))) {
+    DirectoryWalker walker;
+    std::mutex mtx;
+    walker.walk(arg, [&](fs::path &&file) {
+      std::lock_guard<std::mutex> lock(mtx);
+      files.push_back(file.u8string());
+      return true;
+    });
+  } else {
+    corpus = fs::temp_directory_path() / "bench_tag_reader";
+    std::cout << "Writing synthetic corpus to " << corpus.string() << "..."
+              << std::endl;
+    files = writeCorpus(corpus, std::stoul(arg));
+  }
+  if (files.empty()) {
+    std::cerr << "Error: No audio files found" << std::endl;
+    return 1;
+  }
+
+  std::vector<Song> fast;
+  std::vector<Song> full;
+  std::vector<char> fastOk;
+  std::vector<char> fullOk;
+  double fastMs = timeReader(files, FastTagReader::read, fast, fastOk);
+  double fullMs = timeReader(files, readTagLib, full, fullOk);
+
+  // Files parsed by both paths with different results
+  size_t fastParsed = 0;
+  size_t fullParsed = 0;
+  size_t mismatches = 0;
+  for (size_t i = 0; i < files.size(); i++) {
+    fastParsed += fastOk[i];
+    fullParsed += fullOk[i];
+    if (fastOk[i] && fullOk[i] &&
+        (fast[i].title != full[i].title || fast[i].artist != full[i].artist ||
+         fast[i].album != full[i].album ||
+         fast[i].duration != full[i].duration)) {
+      mismatches++;
+    }
+  }
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "Files         " << files.size() << std::endl;
+  std::cout << "FastTagReader " << fastMs << " ms (" << fastParsed
+            << " parsed, " << files.size() * 1000.0 / fastMs << " files/s)"
+            << std::endl;
+  std::cout << "TagLib        " << fullMs << " ms (" << fullParsed
+            << " parsed, " << files.size() * 1000.0 / fullMs << " files/s)"
+            << std::endl;
+  std::cout << "Speedup       " << fullMs / fastMs << "x" << std::endl;
+  std::cout << "Mismatches    " << mismatches << std::endl;
+
+  if (!corpus.empty()) {
+    fs::remove_all(corpus);
+  }
+  return 0;
+}
@@ -0,0 +1,134 @@
+// benchmarks/bench_TextSearch.cpp
+// Case-insensitive substring test, per haystack:
+// - toupper:  std::search with a toupper lambda on the raw text (the old
+//             containsString)
+// - find:     std::string_view::find on the folded text
+// - scalar / sse2 / avx2: findText() kernels on the folded text
+//
+// Usage: bench_TextSearch [titles]   (default 1000000)
+// Two corpora: song titles (~20 bytes each) and 4 KB text blocks. Best of
+// 5 runs, ns per haystack.
+
+#include "../include/TextKey.h"
+#include "../include/TextSearch.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char *WORDS[] = {
+    "Love",  "Night", "River",  "Dream", "Summer", "Fire",   "Rain",
+    "Heart", "City",  "Light",  "Ocean", "Blue",   "Gold",   "Road",
+    "Star",  "Moon",  "Winter", "Dance", "Home",   "Wild",   "Storm",
+    "Hà",    "Nội",   "Sài",    "Gòn",   "Mưa",    "Người",  "Tình",
+};
+
+struct Corpus {
+  std::vector<std::string> raw;
+  std::vector<std::string> folded; // makeSearchKey() of raw
+};
+
+// Phrases of `words` random words
+static Corpus makeCorpus(size_t count, size_t words) {
+  std::mt19937 rng(11);
+  Corpus corpus;
+  corpus.raw.reserve(count);
+  corpus.folded.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    std::string text = WORDS[rng() % std::size(WORDS)];
+    for (size_t w = 1; w < words; w++) {
+      text += ' ';
+      text += WORDS[rng() % std::size(WORDS)];
+    }
+    corpus.folded.push_back(makeSearchKey(text));
+    corpus.raw.push_back(std::move(text));
+  }
+  return corpus;
+}
+
+static bool containsString(std::string_view haystack, std::string_view needle) {
+  auto it = std::search(haystack.begin(), haystack.end(), needle.begin(),
+                        needle.end(), [](char ch1, char ch2) {
+                          return std::toupper(ch1) == std::toupper(ch2);
+                        });
+  return it != haystack.end();
+}
+
+// Best of 5 [ns per haystack]
+static double nsPerText(size_t texts, size_t &hits,
+                        const std::function<size_t()> &scan) {
+  double best = 1e300;
+  for (int run = 0; run < 5; run++) {
+    auto start = std::chrono::steady_clock::now();
+    hits = scan();
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count() / texts);
+  }
+  return best;
+}
+
+static void run(const char *name, const Corpus &corpus) {
+  std::cout << name << " (" << corpus.raw.size() << " texts)" << std::endl;
+  std::cout << "      needle     hits  toupper     find   scalar     sse2"
+            << "     avx2" << std::endl;
+  for (const char *query : {"o", "ri", "moon", "storm ci", "heart of gold",
+                            "nội"}) {
+    std::string needle = makeSearchKey(query);
+    size_t hits = 0, check = 0;
+    std::cout << std::setw(12) << query;
+    double old = nsPerText(corpus.raw.size(), check, [&] {
+      size_t found = 0;
+      for (const std::string &text : corpus.raw) {
+        found += containsString(text, query);
+      }
+      return found;
+    });
+    double find = nsPerText(corpus.folded.size(), hits, [&] {
+      size_t found = 0;
+      for (const std::string &text : corpus.folded) {
+        found += text.find(needle) != std::string::npos;
+      }
+      return found;
+    });
+    std::cout << std::setw(9) << hits << std::setw(9) << old << std::setw(9)
+              << find;
+    for (SimdLevel level :
+         {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+      size_t kernelHits = 0;
+      double ns = nsPerText(corpus.folded.size(), kernelHits, [&] {
+        size_t found = 0;
+        for (const std::string &text : corpus.folded) {
+          found += findText(text, needle, level) != std::string::npos;
+        }
+        return found;
+      });
+      std::cout << std::setw(9) << ns;
+      if (kernelHits != hits) {
+        std::cout << " (mismatch)";
+      }
+    }
+    std::cout << std::endl;
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t titles = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "Best kernel on this CPU: "
+            << (detectSimdLevel() == SimdLevel::AVX2   ? "avx2"
+                : detectSimdLevel() == SimdLevel::SSE2 ? "sse2"
+                                                       : "scalar")
+            << std::endl
+            << std::endl;
+  run("Titles", makeCorpus(titles, 3));
+  std::cout << std::endl;
+  run("4 KB blocks", makeCorpus(std::max<size_t>(1, titles / 200), 700));
+  return 0;
+}
@@ -0,0 +1,224 @@
+// AutocompleteIndex.h
+// Compressed radix trie over folded keys (titles, artists, albums...). Each
+// node keeps its subtree's best entries by weight, so completing a prefix
+// walks only the prefix and returns a ready list
+
+#ifndef AUTOCOMPLETE_INDEX_H
+#define AUTOCOMPLETE_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class AutocompleteIndex {
+public:
+  // Entries kept per node: the most a completion can return
+  static constexpr size_t TOP_COUNT = 8;
+
+  // One completion, views valid until the index changes
+  struct Suggestion {
+    std::string_view key;  // folded key
+    std::string_view text; // display text given with the entry
+    uint32_t weight;
+    uint8_t tag;
+  };
+
+  // Input of build()
+  struct Item {
+    std::string_view key;
+    std::string_view text; // must outlive the entry
+    uint8_t tag;
+    uint32_t weight;
+  };
+
+private:
+  static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+  // A (key, tag) pair: same key with another tag is another entry
+  struct Entry {
+    std::string_view text;
+    uint32_t keyOffset = 0; // into chars
+    uint32_t keyLength = 0;
+    uint32_t weight = 0; // 0: free, listed in freeEntries
+    uint32_t node = NONE; // node the key ends at
+    uint32_t next = NONE; // next entry ending at the same node
+    uint8_t tag = 0;
+  };
+
+  // Edge label is chars[labelOffset, +labelLength), children are a list in
+  // first byte order. Node 0 is the root (empty label)
+  struct Node {
+    uint32_t labelOffset = 0;
+    uint32_t labelLength = 0;
+    uint32_t firstChild = NONE;
+    uint32_t nextSibling = NONE;
+    uint32_t entries = NONE; // entries whose key ends here
+    uint32_t topCount = 0;
+    std::array<uint32_t, TOP_COUNT> top; // best entries below, best first
+  };
+
+  std::string chars; // every key added, removed ones stay until rebuilt
+  std::vector<Entry> entries;
+  std::vector<Node> nodes;
+  std::vector<uint32_t> freeEntries;
+  std::vector<uint32_t> freeNodes;
+  size_t entryCount = 0; // live entries
+  size_t liveChars = 0;  // key bytes of live entries
+
+  /**===================================================
+   *
+   * Description: Check if one entry ranks before another: weight, then
+   * key, then tag
+   *
+   * @param {uint32_t} a - entry
+   * @param {uint32_t} b - entry
+   * @returns {bool} true if a comes first
+   */
+  bool ranksBefore(uint32_t a, uint32_t b) const;
+  /**===================================================
+   *
+   * Description: Refill a node's top list from its own entries and its
+   * children's lists
+   *
+   * @param {uint32_t} node - node to refill
+   * @returns {none}
+   */
+  void refillTop(uint32_t node);
+  /**===================================================
+   *
+   * Description: Move an entry whose weight grew up a node's top list
+   *
+   * @param {uint32_t} node - node on the entry's path
+   * @param {uint32_t} entry - entry
+   * @returns {none}
+   */
+  void raiseInTop(uint32_t node, uint32_t entry);
+  /**===================================================
+   *
+   * Description: Walk a key from the root, keeping the nodes passed
+   *
+   * @param {std::string_view} key - folded key
+   * @param {std::vector<uint32_t>&} path - receives root ... last node
+   * @returns {bool} true if the key ends exactly at the last node
+   */
+  bool walk(std::string_view key, std::vector<uint32_t> &path) const;
+  /**===================================================
+   *
+   * Description: Create the nodes a new entry's key needs, splitting an
+   * edge where the key leaves it
+   *
+   * @param {uint32_t} entry - entry, its key already in chars
+   * @param {std::vector<uint32_t>&} path - receives root ... its node
+   * @returns {uint32_t} node the key ends at
+   */
+  uint32_t insertPath(uint32_t entry, std::vector<uint32_t> &path);
+  /**===================================================
+   *
+   * Description: Build the subtree of a key-sorted entry run, children
+   * first so top lists can be merged upwards
+   *
+   * @param {const std::vector<uint32_t>&} sorted - entries by key
+   * @param {size_t} first - run start
+   * @param {size_t} last - run end
+   * @param {size_t} depth - key bytes above the node
+   * @param {uint32_t} node - node for the run, label already set
+   * @returns {none}
+   */
+  void buildNode(const std::vector<uint32_t> &sorted, size_t first,
+                 size_t last, size_t depth, uint32_t node);
+  /**===================================================
+   *
+   * Description: Find the child whose label starts with a byte
+   *
+   * @param {uint32_t} node - parent
+   * @param {char} byte - first label byte
+   * @returns {uint32_t} child, NONE if none
+   */
+  uint32_t findChild(uint32_t node, char byte) const;
+  /**===================================================
+   *
+   * Description: Get an empty node, reusing a freed one first
+   *
+   * @param {none}
+   * @returns {uint32_t} node
+   */
+  uint32_t newNode();
+  std::string_view keyOf(uint32_t entry) const {
+    return std::string_view(chars).substr(entries[entry].keyOffset,
+                                          entries[entry].keyLength);
+  }
+
+public:
+  AutocompleteIndex();
+
+  /**===================================================
+   *
+   * Description: Replace the contents with a batch at once (sort, then
+   * one pass) - much faster than add() per item
+   * - Items with the same key and tag are one entry, weights summed,
+   *   the first item's text kept
+   * - Empty keys and zero weights are skipped
+   *
+   * @param {std::vector<Item>} items - entries to index
+   * @returns {none}
+   */
+  void build(std::vector<Item> items);
+  /**===================================================
+   *
+   * Description: Add weight to an entry, creating it if new
+   *
+   * @param {std::string_view} key - folded key (empty: ignored)
+   * @param {std::string_view} text - display text if new, must outlive it
+   * @param {uint8_t} tag - caller's kind of entry
+   * @param {uint32_t} weight - weight to add
+   * @returns {none}
+   */
+  void add(std::string_view key, std::string_view text, uint8_t tag,
+           uint32_t weight = 1);
+  /**===================================================
+   *
+   * Description: Take weight from an entry, dropping it at 0
+   * - Rebuilt once removed key bytes outnumber live ones
+   *
+   * @param {std::string_view} key - key it was added with
+   * @param {uint8_t} tag - tag it was added with
+   * @param {uint32_t} weight - weight to take
+   * @returns {bool} true if found - false if not
+   */
+  bool remove(std::string_view key, uint8_t tag, uint32_t weight = 1);
+  /**===================================================
+   *
+   * Description: Get the best entries starting with a prefix
+   * - Walks the prefix only: O(prefix length), not O(entries)
+   *
+   * @param {std::string_view} prefix - folded prefix (empty: best overall)
+   * @param {size_t} limit - at most this many (capped at TOP_COUNT)
+   * @returns {std::vector<Suggestion>} best first
+   */
+  std::vector<Suggestion> complete(std::string_view prefix,
+                                   size_t limit = TOP_COUNT) const;
+  /**===================================================
+   *
+   * Description: Drop every entry and free the memory
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+  /**===================================================
+   *
+   * Description: Get the bytes held by the index (capacity, not size)
+   *
+   * @param {none}
+   * @returns {size_t} bytes
+   */
+  size_t getMemoryUsage() const;
+
+  size_t size() const { return entryCount; }
+  size_t getNodeCount() const { return nodes.size() - freeNodes.size(); }
+};
+
+#endif
@@ -0,0 +1,85 @@
+// BoundedQueue.h
+// Fixed-capacity blocking queue used to connect import pipeline stages
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+template <typename T> class BoundedQueue {
+private:
+  std::deque<T> items;
+  size_t capacity;
+  bool closed = false;
+  std::mutex mtx;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+
+public:
+  /**===================================================
+   *
+   * Description: Construct queue holding at most `capacity` items
+   *
+   * @param {size_t} capacity - maximum number of queued items (min 1)
+   * @returns {none}
+   */
+  explicit BoundedQueue(size_t capacity) : capacity(capacity ? capacity : 1) {}
+  /**===================================================
+   *
+   * Description: Push an item, blocking while the queue is full
+   *
+   * @param {T&&} item - item to move into the queue
+   * @returns {bool} true if pushed - false if the queue was closed
+   */
+  bool push(T &&item) {
+    std::unique_lock<std::mutex> lock(mtx);
+    notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+    if (closed) {
+      return false;
+    }
+    items.push_back(std::move(item));
+    lock.unlock();
+    notEmpty.notify_one();
+    return true;
+  }
+  /**===================================================
+   *
+   * Description: Pop an item, blocking while the queue is empty
+   *
+   * @param {none}
+   * @returns {std::optional<T>} popped item - std::nullopt if closed and
+   * drained
+   */
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+    if (items.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> out(std::move(items.front()));
+    items.pop_front();
+    lock.unlock();
+    notFull.notify_one();
+    return out;
+  }
+  /**===================================================
+   *
+   * Description: Close the queue - producers fail, consumers drain the rest
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      closed = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+  }
+};
+
+#endif
@@ -0,0 +1,44 @@
+// Checksum.h
+// CRC-32 (IEEE 802.3) used to detect corrupted on-disk data
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace detail {
+constexpr std::array<uint32_t, 256> makeCrc32Table() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; k++) {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    table[i] = c;
+  }
+  return table;
+}
+inline constexpr std::array<uint32_t, 256> crc32Table = makeCrc32Table();
+} // namespace detail
+
+/**===================================================
+ *
+ * Description: Compute CRC-32 of a byte range
+ *
+ * @param {const void*} data - bytes to hash
+ * @param {size_t} size - number of bytes
+ * @param {uint32_t} crc - previous result when hashing in pieces
+ * @returns {uint32_t} checksum
+ */
+inline uint32_t crc32(const void *data, size_t size, uint32_t crc = 0) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc = detail::crc32Table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+#endif
@@ -0,0 +1,70 @@
+// DirectoryWalker.h
+// Parallel recursive folder traversal with work stealing
+
+#ifndef DIRECTORY_WALKER_H
+#define DIRECTORY_WALKER_H
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+// What a folder walk visits
+struct WalkOptions {
+  std::vector<std::string> extensions{".mp3", ".wav"}; // any case matches
+  int maxDepth = 32;           // folder levels below root (0 = root only)
+  bool followSymlinks = false; // linked folders, loops are skipped
+  size_t threadCount = 0;      // 0 = two per core (walks wait on I/O)
+
+  /**===================================================
+   *
+   * Description: Check if a file has one of the accepted extensions
+   *
+   * @param {const std::filesystem::path&} file - file path
+   * @returns {bool} true if accepted
+   */
+  bool matches(const std::filesystem::path &file) const;
+};
+
+class DirectoryWalker {
+public:
+  // Receives one accepted file - called concurrently from walker threads,
+  // return false to stop the walk
+  using FileSink = std::function<bool(std::filesystem::path &&)>;
+
+private:
+  WalkOptions options;
+
+public:
+  /**===================================================
+   *
+   * Description: Construct walker
+   *
+   * @param {WalkOptions} options - filter, depth, symlinks, threads
+   * @returns {none}
+   */
+  explicit DirectoryWalker(WalkOptions options = {});
+  /**===================================================
+   *
+   * Description: Get the number of walker threads
+   *
+   * @param {none}
+   * @returns {size_t} threads used by walk()
+   */
+  size_t getThreadCount() const;
+  /**===================================================
+   *
+   * Description: Visit every accepted file below a folder
+   * - Each thread owns a deque of folders: it works LIFO on its own and
+   *   steals FIFO (the biggest subtrees) from others when idle
+   * - Followed links are checked against every folder already visited
+   *
+   * @param {const std::string&} root - folder to walk
+   * @param {FileSink} sink - receives accepted files (must be thread-safe)
+   * @returns {size_t} number of files passed to sink
+   * @note unreadable folders are skipped silently
+   */
+  size_t walk(const std::string &root, const FileSink &sink) const;
+};
+
+#endif
@@ -0,0 +1,34 @@
+// FastTagReader.h
+// Minimal tag + duration reader for the formats the library imports
+
+#ifndef FAST_TAG_READER_H
+#define FAST_TAG_READER_H
+
+#include "Song.h"
+#include <cstddef>
+#include <string>
+
+class FastTagReader {
+public:
+  // Bytes read in one go from the start of a file (tags usually fit)
+  static constexpr size_t HEAD_SIZE = 16 * 1024;
+  // Bytes scanned for the first MPEG frame after the ID3v2 tag
+  static constexpr size_t SYNC_WINDOW = 8 * 1024;
+
+  /**===================================================
+   *
+   * Description: Read title, artist, album and duration of a file
+   * - MP3: ID3v2.2-2.4 (ID3v1 for missing fields), duration from the
+   *   Xing/Info (+ LAME gapless), VBRI header or the CBR bitrate
+   * - WAV: fmt/data chunks, LIST/INFO and id3 chunks
+   * - Only headers are read: the first HEAD_SIZE bytes, the last 128
+   *   bytes and single frames / chunks found through them
+   *
+   * @param {const std::string&} filePath - UTF-8 file path
+   * @param {Song&} song - receives non-empty fields and duration
+   * @returns {bool} true if parsed - false means use a full tag library
+   */
+  static bool read(const std::string &filePath, Song &song);
+};
+
+#endif
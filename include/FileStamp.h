@@ -0,0 +1,30 @@
+// FileStamp.h
+// Size + modification time identifying one version of a file on disk
+
+#ifndef FILE_STAMP_H
+#define FILE_STAMP_H
+
+#include <cstdint>
+#include <string>
+
+struct FileStamp {
+  uint64_t size = 0;
+  int64_t mtime = 0; // [nanosecond] since epoch
+
+  bool operator==(const FileStamp &other) const {
+    return size == other.size && mtime == other.mtime;
+  }
+  bool operator!=(const FileStamp &other) const { return !(*this == other); }
+};
+
+/**===================================================
+ *
+ * Description: Read size and mtime of a file with a single stat call
+ *
+ * @param {const std::string&} path - UTF-8 file path
+ * @param {FileStamp&} out - receives size and mtime
+ * @returns {bool} true if the file exists
+ */
+bool statFile(const std::string &path, FileStamp &out);
+
+#endif
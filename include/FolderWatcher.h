@@ -0,0 +1,206 @@
+// FolderWatcher.h
+// Live watching of loaded folders (Linux inotify, no-op elsewhere)
+
+#ifndef FOLDER_WATCHER_H
+#define FOLDER_WATCHER_H
+
+#include "DirectoryWalker.h"
+#include "ImportPipeline.h"
+#include "Song.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// One batch of file changes below a library root
+struct FolderChanges {
+  std::string root;                     // folder as it was loaded
+  std::vector<Song> upserts;            // created or modified, tags read
+  std::vector<std::string> removed;     // deleted or moved away files
+  std::vector<std::string> removedDirs; // deleted or moved away folders
+  bool overflow = false; // events were lost - root needs a full rescan
+};
+
+class FolderWatcher {
+private:
+  struct Watch {
+    std::string dir;
+    size_t root; // index into roots
+    int depth;   // folder levels below root
+  };
+  struct Root {
+    std::string path;
+    WalkOptions options;
+  };
+  struct Pending {
+    std::unordered_set<std::string> files;
+    std::unordered_set<std::string> dirs;
+    bool overflow = false;
+  };
+  using Clock = std::chrono::steady_clock;
+
+  ImportPipeline::MetadataReader reader;
+  std::chrono::milliseconds debounce;
+
+  // --- Shared with the caller (guarded by mtx) ---
+  std::mutex mtx;
+  std::vector<Root> addRequests;
+  std::vector<std::string> removeRequests;
+  bool clearRequested = false;
+  std::deque<FolderChanges> ready;
+
+  // --- Owned by the watcher thread ---
+  int inotifyFd = -1;
+  int wakeFd = -1; // eventfd - wakes the thread for requests / stop
+  std::unordered_map<int, Watch> watches; // inotify wd -> directory
+  std::vector<Root> roots;
+  std::vector<Pending> pending; // parallel to roots
+  bool hasPending = false;
+  Clock::time_point firstEvent;
+  Clock::time_point lastEvent;
+
+  std::atomic<size_t> watchCount{0};
+  std::atomic<bool> stopping{false};
+  std::thread worker;
+
+  /**===================================================
+   *
+   * Description: Create inotify/eventfd and start the thread (once)
+   *
+   * @param {none}
+   * @returns {bool} true if running
+   */
+  bool ensureStarted();
+  /**===================================================
+   *
+   * Description: Thread body - sleeps in poll() until an event, a request
+   * or the debounce deadline
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void run();
+  /**===================================================
+   *
+   * Description: Apply queued addFolder() / removeFolder() / clear() calls
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void handleRequests();
+  /**===================================================
+   *
+   * Description: Drain the inotify descriptor into the pending sets
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void readEvents();
+  /**===================================================
+   *
+   * Description: Watch a directory and all folders below it, down to the
+   * root's depth limit (links are never followed)
+   *
+   * @param {const std::string&} dir - directory to watch
+   * @param {size_t} root - index into roots
+   * @param {int} depth - folder levels of dir below root
+   * @param {bool} markFiles - also report the audio files found
+   * @returns {none}
+   */
+  void watchTree(const std::string &dir, size_t root, int depth,
+                 bool markFiles);
+  /**===================================================
+   *
+   * Description: Drop watches of a directory and all folders below it
+   *
+   * @param {const std::string&} dir - directory that went away
+   * @returns {none}
+   */
+  void unwatchTree(const std::string &dir);
+  /**===================================================
+   *
+   * Description: Turn pending paths into FolderChanges (stat + read tags)
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void flush();
+
+public:
+  /**===================================================
+   *
+   * Description: Construct watcher (thread starts with the first folder)
+   *
+   * @param {MetadataReader} reader - tag reader for changed files
+   * @param {milliseconds} debounce - quiet time before a batch is built
+   * @returns {none}
+   */
+  explicit FolderWatcher(
+      ImportPipeline::MetadataReader reader,
+      std::chrono::milliseconds debounce = std::chrono::milliseconds(500));
+  /**===================================================
+   *
+   * Description: Destruct watcher - stop and join the thread
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  ~FolderWatcher();
+  /**===================================================
+   *
+   * Description: Check if live watching works on this platform
+   *
+   * @param {none}
+   * @returns {bool} true on Linux
+   */
+  static bool isSupported();
+  /**===================================================
+   *
+   * Description: Start watching a folder tree (set up asynchronously)
+   *
+   * @param {const std::string&} root - folder as it was loaded
+   * @param {const WalkOptions&} options - extensions and depth to watch
+   * @returns {bool} false if watching is not supported
+   */
+  bool addFolder(const std::string &root, const WalkOptions &options = {});
+  /**===================================================
+   *
+   * Description: Stop watching one folder tree, drop its undelivered
+   * changes (others keep theirs)
+   *
+   * @param {const std::string&} root - folder as passed to addFolder()
+   * @returns {none}
+   */
+  void removeFolder(const std::string &root);
+  /**===================================================
+   *
+   * Description: Stop watching every folder, drop undelivered changes
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+  /**===================================================
+   *
+   * Description: Take the next finished batch (never blocks)
+   *
+   * @param {FolderChanges&} out - receives the batch
+   * @returns {bool} true if a batch was taken
+   */
+  bool takeChanges(FolderChanges &out);
+  /**===================================================
+   *
+   * Description: Get number of watched directories
+   *
+   * @param {none}
+   * @returns {size_t} number of inotify watches
+   */
+  size_t getWatchCount() const;
+};
+
+#endif
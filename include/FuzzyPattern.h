@@ -0,0 +1,63 @@
+// FuzzyPattern.h
+// Typo-tolerant matching of a folded query against folded text: Myers'
+// bit-parallel edit distance, one 64-bit word per text byte, behind a
+// letter and letter-pair count filter
+
+#ifndef FUZZY_PATTERN_H
+#define FUZZY_PATTERN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class FuzzyPattern {
+private:
+  std::array<uint64_t, 256> peq{}; // byte -> pattern positions holding it
+  // Byte pair (low 5 bits of each) -> positions where it ends in the pattern
+  std::array<uint64_t, 1024> pairs{};
+  uint64_t highBit = 0;            // last pattern position
+  size_t length = 0;
+
+public:
+  // Longer queries are cut to one machine word of pattern
+  static constexpr size_t MAX_LENGTH = 64;
+
+  /**===================================================
+   *
+   * Description: Prepare a query (bit masks built once, reused per text)
+   *
+   * @param {std::string_view} key - folded query, see makeSearchKey()
+   * @returns {none}
+   */
+  explicit FuzzyPattern(std::string_view key);
+  /**===================================================
+   *
+   * Description: Get the fewest edits (insert, delete, replace a byte)
+   * turning the pattern into some substring of a text
+   * - 0 if the text contains the pattern
+   * - Texts missing more of the pattern's letters or letter pairs than
+   *   maxErrors edits could break are rejected before the edit count
+   * - Counted on bytes: on folded keys that is letters, except scripts
+   *   makeSearchKey() keeps as multi-byte UTF-8
+   *
+   * @param {std::string_view} text - folded text
+   * @param {size_t} maxErrors - stop counting above this
+   * @returns {size_t} edits, maxErrors + 1 if more are needed
+   */
+  size_t distance(std::string_view text, size_t maxErrors) const;
+  /**===================================================
+   *
+   * Description: Get the edits a query of this length may have: none up
+   * to 3 bytes, then one more per ~4 bytes, at most 3
+   *
+   * @param {none}
+   * @returns {size_t} allowed edits
+   */
+  size_t getMaxErrors() const;
+
+  size_t size() const { return length; }
+};
+
+#endif
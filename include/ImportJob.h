@@ -0,0 +1,267 @@
+// ImportJob.h
+// Handle to a folder import running in the background
+
+#ifndef IMPORT_JOB_H
+#define IMPORT_JOB_H
+
+#include "ImportPipeline.h"
+#include "Song.h"
+#include "TagCache.h"
+#include <atomic>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class ImportJob {
+private:
+  std::string path;
+  size_t batchSize;
+  ImportProgress progress;
+  std::atomic<size_t> songsPublished{0};
+  std::atomic<bool> finished{false};
+  std::shared_ptr<TagCache> tagCache;
+  WalkOptions walkOptions;
+  bool lazyTags = false;
+
+  // Rescan: stamps of the songs already loaded (read-only while scanning)
+  bool rescan = false;
+  std::unordered_map<std::string, FileStamp> known;
+  std::vector<std::string> removed; // set before finished, complete only
+
+  std::mutex untaggedMutex;
+  // Paths published without tags (lazy) - songs get their IDs only once
+  // the library stores them
+  std::unordered_set<std::string> untagged;
+
+  std::mutex batchMutex;
+  std::deque<std::vector<Song>> readyBatches; // guarded by batchMutex
+  std::vector<Song> filling; // owned by the indexer stage thread
+
+  std::promise<ImportStats> promise;
+  std::shared_future<ImportStats> future;
+  std::thread worker;
+
+  /**===================================================
+   *
+   * Description: Hand the batch being filled over to the UI thread
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void flush();
+
+public:
+  /**===================================================
+   *
+   * Description: Construct job (does not start scanning)
+   *
+   * @param {std::string} path - folder to import
+   * @param {size_t} batchSize - songs per published batch
+   * @returns {none}
+   */
+  ImportJob(std::string path, size_t batchSize);
+  /**===================================================
+   *
+   * Description: Destruct job - cancel and join the scan thread
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  ~ImportJob();
+  /**===================================================
+   *
+   * Description: Use a persistent tag cache (call before start)
+   * - Loaded on the scan thread, pruned and saved after a complete scan
+   *
+   * @param {std::shared_ptr<TagCache>} cache - cache of the imported root
+   * @returns {none}
+   */
+  void setTagCache(std::shared_ptr<TagCache> cache);
+  /**===================================================
+   *
+   * Description: Rescan a loaded folder instead of importing it (call
+   * before start)
+   * - Files whose stamp is unchanged are neither read nor published
+   * - Known files no longer found are reported by takeRemoved()
+   *
+   * @param {std::unordered_map<std::string, FileStamp>} files - path ->
+   * stamp of the songs loaded from the folder
+   * @returns {none}
+   */
+  void setKnownFiles(std::unordered_map<std::string, FileStamp> files);
+  /**===================================================
+   *
+   * Description: Check if the job rescans a loaded folder
+   *
+   * @param {none}
+   * @returns {bool} true if setKnownFiles() was called
+   */
+  bool isRescan() const;
+  /**===================================================
+   *
+   * Description: Set which files of the folder tree are imported
+   * - Call before start()
+   *
+   * @param {WalkOptions} options - extensions, depth, symlinks, threads
+   * @returns {none}
+   */
+  void setWalkOptions(WalkOptions options);
+  /**===================================================
+   *
+   * Description: Publish songs without reading tags (call before start)
+   * - Files only get stat'ed, cached tags are still used
+   * - Songs missing tags are reported by takeUntagged()
+   *
+   * @param {bool} lazy - true to defer tag reading
+   * @returns {none}
+   */
+  void setLazyTags(bool lazy);
+  /**===================================================
+   *
+   * Description: Check if tags are deferred
+   *
+   * @param {none}
+   * @returns {bool} true if lazy
+   */
+  bool isLazyTags() const;
+  /**===================================================
+   *
+   * Description: Get the tag cache of the imported root
+   *
+   * @param {none}
+   * @returns {std::shared_ptr<TagCache>} cache, nullptr if disabled
+   */
+  std::shared_ptr<TagCache> getTagCache() const;
+  /**===================================================
+   *
+   * Description: Start the import pipeline on a background thread
+   *
+   * @param {MetadataReader} reader - tag reader (must be thread-safe)
+   * @returns {none}
+   */
+  void start(ImportPipeline::MetadataReader reader);
+  /**===================================================
+   *
+   * Description: Get the imported folder path
+   *
+   * @param {none}
+   * @returns {const std::string&} folder path
+   */
+  const std::string &getPath() const;
+  /**===================================================
+   *
+   * Description: Get number of audio files found so far
+   *
+   * @param {none}
+   * @returns {size_t} files accepted by the walker
+   */
+  size_t getFilesFound() const;
+  /**===================================================
+   *
+   * Description: Get number of files whose tags have been read
+   *
+   * @param {none}
+   * @returns {size_t} files read by the workers
+   */
+  size_t getFilesRead() const;
+  /**===================================================
+   *
+   * Description: Get number of songs already added to the library
+   *
+   * @param {none}
+   * @returns {size_t} published songs
+   */
+  size_t getSongsPublished() const;
+  /**===================================================
+   *
+   * Description: Check if scanning ended (completed or cancelled)
+   *
+   * @param {none}
+   * @returns {bool} true if no more batches will be produced
+   */
+  bool isFinished() const;
+  /**===================================================
+   *
+   * Description: Request cancellation - unpublished songs are dropped
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void cancel();
+  /**===================================================
+   *
+   * Description: Check if cancellation was requested
+   *
+   * @param {none}
+   * @returns {bool} true if cancelled
+   */
+  bool isCancelled() const;
+  /**===================================================
+   *
+   * Description: Get completion future (ready when scanning ends)
+   *
+   * @param {none}
+   * @returns {std::shared_future<ImportStats>} per-stage statistics
+   */
+  std::shared_future<ImportStats> getFuture() const;
+  /**===================================================
+   *
+   * Description: Block until scanning ends
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void wait() const;
+  /**===================================================
+   *
+   * Description: Take the oldest ready batch (used by MusicPlayer)
+   *
+   * @param {std::vector<Song>&} out - receives the batch
+   * @returns {bool} true if a batch was taken
+   */
+  bool takeBatch(std::vector<Song> &out);
+  /**===================================================
+   *
+   * Description: Record songs added to the library (used by MusicPlayer)
+   *
+   * @param {size_t} count - number of songs published
+   * @returns {none}
+   */
+  void markPublished(size_t count);
+  /**===================================================
+   *
+   * Description: Take the paths of songs in a batch still missing tags
+   *
+   * @param {const std::vector<Song>&} batch - batch from takeBatch()
+   * @param {std::vector<std::string>&} paths - receives file paths (lazy
+   * mode only)
+   * @returns {none}
+   */
+  void takeUntagged(const std::vector<Song> &batch,
+                    std::vector<std::string> &paths);
+  /**===================================================
+   *
+   * Description: Check if every produced batch has been taken
+   *
+   * @param {none}
+   * @returns {bool} true if finished and no batch is pending
+   */
+  bool isDrained();
+  /**===================================================
+   *
+   * Description: Take the known files not found by the rescan
+   * - Call once isDrained(), empty if the rescan was cancelled
+   *
+   * @param {none}
+   * @returns {std::vector<std::string>} file paths of removed songs
+   */
+  std::vector<std::string> takeRemoved();
+};
+
+#endif
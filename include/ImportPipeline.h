@@ -0,0 +1,124 @@
+// ImportPipeline.h
+// Multi-threaded folder import: walker -> tag readers -> indexer
+
+#ifndef IMPORT_PIPELINE_H
+#define IMPORT_PIPELINE_H
+
+#include "DirectoryWalker.h"
+#include "Song.h"
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Throughput of a single pipeline stage
+struct StageStats {
+  size_t files = 0;
+  double seconds = 0.0; // [second] wall time the stage was active
+
+  double filesPerSecond() const {
+    return seconds > 0.0 ? files / seconds : 0.0;
+  }
+};
+
+// Per-stage report of one pipeline run
+struct ImportStats {
+  StageStats walker;  // directory entries accepted
+  StageStats reader;  // tags read (summed over all workers)
+  StageStats indexer; // songs committed to the sink
+  size_t workerCount = 0;
+  size_t cacheHits = 0; // tags served from TagCache (set by ImportJob)
+};
+
+// Live counters and cancel flag shared with a running pipeline
+struct ImportProgress {
+  std::atomic<size_t> filesFound{0}; // accepted by the walker so far
+  std::atomic<size_t> filesRead{0};  // tags read so far
+  std::atomic<bool> cancelled{false};
+};
+
+class ImportPipeline {
+public:
+  // Fills metadata of a song whose filePath, stamp and defaults are set
+  using MetadataReader = std::function<void(const std::string &, Song &)>;
+  // Commits a finished song (called on the thread that runs the pipeline)
+  using SongSink = std::function<void(Song &&)>;
+
+private:
+  // Feeds file paths to the tag readers - emit returns false once cancelled
+  // and may be called from several threads
+  using PathSource = std::function<void(const DirectoryWalker::FileSink &)>;
+
+  size_t workerCount;
+  size_t queueCapacity;
+  WalkOptions walkOptions;
+
+  /**===================================================
+   *
+   * Description: Run the three stages with a custom path source
+   *
+   * @param {PathSource} source - walker stage (started on its own thread)
+   * @param {MetadataReader} reader - tag reader (must be thread-safe)
+   * @param {SongSink} sink - receives every song, in completion order
+   * @param {ImportProgress*} progress - optional live counters / cancel flag
+   * @returns {ImportStats} per-stage file count and throughput
+   */
+  ImportStats runFrom(const PathSource &source, const MetadataReader &reader,
+                      const SongSink &sink, ImportProgress *progress) const;
+
+public:
+  /**===================================================
+   *
+   * Description: Construct pipeline
+   *
+   * @param {size_t} workerCount - tag reader threads (0 = one per core)
+   * @param {size_t} queueCapacity - max items buffered between two stages
+   * @param {WalkOptions} walkOptions - which files run(path) imports
+   * @returns {none}
+   */
+  explicit ImportPipeline(size_t workerCount = 0, size_t queueCapacity = 256,
+                          WalkOptions walkOptions = {});
+  /**===================================================
+   *
+   * Description: Get the number of tag reader threads
+   *
+   * @param {none}
+   * @returns {size_t} number of workers used by run()
+   */
+  size_t getWorkerCount() const;
+  /**===================================================
+   *
+   * Description: Import all matching files in a folder tree
+   * - Parallel DirectoryWalker feeds a bounded path queue
+   * - Worker pool reads tags and feeds a bounded song queue
+   * - Indexer stage runs on the calling thread and commits songs to sink
+   *
+   * @param {const std::string&} path - folder to import
+   * @param {MetadataReader} reader - tag reader (must be thread-safe)
+   * @param {SongSink} sink - receives every song, in completion order
+   * @param {ImportProgress*} progress - optional live counters / cancel flag
+   * @returns {ImportStats} per-stage file count and throughput
+   * @note after cancel, stages drain their queues without doing work
+   */
+  ImportStats run(const std::string &path, const MetadataReader &reader,
+                  const SongSink &sink,
+                  ImportProgress *progress = nullptr) const;
+  /**===================================================
+   *
+   * Description: Read tags of an explicit list of files (no directory walk)
+   * - Same reader pool and indexer stage as run(path, ...)
+   *
+   * @param {const std::vector<std::string>&} files - audio files to read
+   * @param {MetadataReader} reader - tag reader (must be thread-safe)
+   * @param {SongSink} sink - receives every song, in completion order
+   * @param {ImportProgress*} progress - optional live counters / cancel flag
+   * @returns {ImportStats} per-stage file count and throughput
+   */
+  ImportStats run(const std::vector<std::string> &files,
+                  const MetadataReader &reader, const SongSink &sink,
+                  ImportProgress *progress = nullptr) const;
+
+};
+
+#endif
@@ -4,23 +4,322 @@
 #ifndef MUSIC_LIB_H
 #define MUSIC_LIB_H
 
+#include "AutocompleteIndex.h"
+#include "FuzzyPattern.h"
 #include "Song.h"
-#include <map>
+#include "SongColumns.h"
+#include "SongHandle.h"
+#include "SongStore.h"
+#include "SortView.h"
+#include "StringPool.h"
+#include "TextArena.h"
+#include "TextKey.h"
+#include "TitleIndex.h"
+#include "TrigramIndex.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+// Songs whose title, artist or album contains a query - see search()
+struct SearchResult {
+  std::vector<SongHandle> songs; // song ID order
+  std::vector<uint32_t> artists; // artist IDs whose name matched
+  std::vector<uint32_t> albums;  // album IDs whose name matched
+};
+
+// Field a fuzzy match was found in
+enum class SearchField : uint8_t {
+  Title = 0,
+  Artist = 1,
+  Album = 2,
+};
+
+// How much a match in each field counts, see fuzzySearch()
+struct FuzzyWeights {
+  float title = 1.0f;
+  float artist = 0.8f;
+  float album = 0.6f;
+};
+
+// One ranked song of fuzzySearch()
+struct FuzzyHit {
+  SongHandle song;
+  float score = 0;   // higher first: weight x share of query matched
+  uint8_t errors = 0; // edits of the best field
+  SearchField field = SearchField::Title;
+};
+
+// One search box completion of complete(), views valid until the library
+// changes
+struct Completion {
+  std::string_view text; // title or name as stored
+  SearchField field;
+  uint32_t songs; // songs with this title / by this artist / on this album
+};
+
 class MusicLibrary {
 private:
-  std::vector<Song> songs;
-  std::unordered_map<int, const Song *> songIndexByID;
-  std::map<std::string, const Song *> songIndexByTitle;
-  std::unordered_map<std::string, std::vector<const Song *>> artistIndex;
-  std::map<std::string, std::vector<const Song *>> albumIndex;
+  // Handle slot -> song slot, generation bumped when the handle is released.
+  // A slot whose generation is used up is retired (never reused): a wrapped
+  // generation would let an old handle resolve to another song
+  struct HandleEntry {
+    uint32_t songSlot = 0;
+    uint8_t generation = 0;
+    uint32_t partition = 0;
+    uint32_t partitionPos = 0; // index into its partition's song list
+  };
+
+  SongStore songs; // blocks: stored songs never move while it grows
+  SongColumns columns; // same songs by field, for scans - kept in step
+  TextArena text;  // titles and paths, the songs and indexes hold views
+  std::vector<HandleEntry> handles;
+  std::vector<uint32_t> slotHandles; // song slot -> handle slot
+  // Released handle slots, reused first and oldest first: a slot goes
+  // round its generations only as fast as all free slots together
+  std::deque<uint32_t> freeHandles;
+  // Song ID -> handle: IDs are handed out 0, 1, 2... by this library, so
+  // the ID is the index. Removed songs leave a null handle (IDs are never
+  // reused before clear())
+  std::vector<SongHandle> songIndexByID;
+  TitleIndex songIndexByTitle; // flat, sorted, duplicate titles kept
+  std::unordered_map<std::string_view, SongHandle> songIndexByPath;
+  StringPool artists; // each distinct artist stored once, songs keep IDs
+  StringPool albums;
+  std::vector<TextKeys> artistKeys; // by artist ID, made once per name
+  std::vector<TextKeys> albumKeys;  // by album ID
+  // Trigrams of the search keys: song ID / artist ID / album ID lists
+  TrigramIndex titleTrigrams;
+  TrigramIndex artistTrigrams;
+  TrigramIndex albumTrigrams;
+  // Folded titles, artist and album names for completing the search box,
+  // tagged with their SearchField and weighted by song count
+  AutocompleteIndex completions;
+  std::unordered_map<uint32_t, std::vector<SongHandle>> artistIndex;
+  std::unordered_map<uint32_t, std::vector<SongHandle>> albumIndex;
+  // Partition ID -> its songs, unordered (swap-removed in O(1))
+  std::unordered_map<uint32_t, std::vector<SongHandle>> partitionSongs;
+  uint32_t nextPartition = DEFAULT_PARTITION + 1;
+  uint64_t version = 0; // bumped on every change, see getVersion()
+
+  // Every song in one SortKey order. Built on the first getSortView(), then
+  // kept in step: merged after addSongs(), patched on single changes
+  struct SortOrder {
+    std::vector<SongHandle> handles;
+    uint64_t version = 0; // bumped on every change
+    bool built = false;
+  };
+  mutable std::array<SortOrder, SORT_KEY_COUNT> sortOrders;
+
+  // Songs indexed at once before the indexes are built on parallel threads
+  static constexpr size_t PARALLEL_INDEX_MIN = 4096;
+
+  // Normalized (NFC) tag text of a song and its title keys - made before
+  // storing, on parallel threads for big batches
+  struct PreparedText {
+    std::string title;
+    std::string artist;
+    std::string album;
+    TextKeys titleKeys;
+  };
+
+  /**===================================================
+   *
+   * Description: Normalize the tag text of a song and build title keys
+   *
+   * @param {const Song&} song - song to prepare
+   * @returns {PreparedText} normalized text and keys
+   */
+  static PreparedText prepare(const Song &song);
+  /**===================================================
+   *
+   * Description: Intern a name, building its keys (and indexing its
+   * search key) the first time
+   *
+   * @param {StringPool&} pool - artists or albums
+   * @param {std::vector<TextKeys>&} keys - keys of that pool, by ID
+   * @param {TrigramIndex&} trigrams - trigram index of that pool
+   * @param {const std::string&} name - normalized name
+   * @returns {uint32_t} ID of the name
+   */
+  static uint32_t internName(StringPool &pool, std::vector<TextKeys> &keys,
+                             TrigramIndex &trigrams, const std::string &name);
+  /**===================================================
+   *
+   * Description: Re-index every title search key once erased keys
+   * outnumber live ones (see TrigramIndex::needsRebuild())
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void compactTitleTrigrams();
+  /**===================================================
+   *
+   * Description: Rebuild the completions from every song in one batch
+   * - Big imports and removals: cheaper than an add/remove per song
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void rebuildCompletions();
+  /**===================================================
+   *
+   * Description: Count a stored song in the completions of its title,
+   * artist and album
+   *
+   * @param {size_t} slot - song slot
+   * @returns {none}
+   */
+  void addCompletions(size_t slot);
+  /**===================================================
+   *
+   * Description: Take a stored song out of its completions (before its
+   * slot changes)
+   *
+   * @param {size_t} slot - song slot
+   * @returns {none}
+   */
+  void removeCompletions(size_t slot);
+
+  using GroupIndex = std::unordered_map<uint32_t, std::vector<SongHandle>>;
+  /**===================================================
+   *
+   * Description: Find the names (artists or albums) containing a search
+   * key that still have songs
+   *
+   * @param {const TrigramIndex&} trigrams - trigram index of the names
+   * @param {const std::vector<TextKeys>&} keys - keys of the names, by ID
+   * @param {const GroupIndex&} groups - songs of each name
+   * @param {const std::string&} key - folded query, see makeSearchKey()
+   * @param {std::vector<uint32_t>&} out - receives name IDs, in ID order
+   * @returns {none}
+   */
+  static void matchNames(const TrigramIndex &trigrams,
+                         const std::vector<TextKeys> &keys,
+                         const GroupIndex &groups, const std::string &key,
+                         std::vector<uint32_t> &out);
+  /**===================================================
+   *
+   * Description: Make a handle slot's handles stale and free it for reuse
+   * - Retired instead once its generation is used up
+   *
+   * @param {uint32_t} handleSlot - slot of a removed song
+   * @returns {none}
+   */
+  void releaseHandle(uint32_t handleSlot);
+  /**===================================================
+   *
+   * Description: Get number of songs that can still be given a handle
+   *
+   * @param {none}
+   * @returns {size_t} free slots plus slots never handed out
+   */
+  size_t getHandleRoom() const;
+  /**===================================================
+   *
+   * Description: Store a song and give it a handle (free slots first)
+   * and the next song ID
+   * - Title, title keys and path are copied into the text arena, artist
+   *   and album are interned: the stored record owns no memory of its own
+   *
+   * @param {const Song&} song - song to store
+   * @param {const PreparedText&} prepared - its text, see prepare()
+   * @param {uint32_t} partition - partition the song belongs to
+   * @returns {bool} true if a new storage block was allocated
+   */
+  bool store(const Song &song, const PreparedText &prepared,
+             uint32_t partition);
+
+  /**===================================================
+   *
+   * Description: Insert a stored song into every index
+   *
+   * @param {const StoredSong&} song - song (in library)
+   * @param {SongHandle} handle - its handle
+   * @returns {none}
+   */
+  void indexSong(const StoredSong &song, SongHandle handle);
+  /**===================================================
+   *
+   * Description: Insert the songs from a slot to the end into every index
+   * - One pass per index, titles go in sorted (hinted map inserts)
+   * - Indexes are independent: big ranges fill them on parallel threads
+   *
+   * @param {size_t} first - slot of the first song to index
+   * @returns {none}
+   */
+  void indexRange(size_t first);
+  /**===================================================
+   *
+   * Description: Remove a stored song from every index
+   *
+   * @param {const StoredSong&} song - song (in library)
+   * @param {SongHandle} handle - its handle
+   * @returns {none}
+   */
+  void unindexSong(const StoredSong &song, SongHandle handle);
+  /**===================================================
+   *
+   * Description: Compare two stored songs in one sort order
+   * - Ties are broken by title, then ID: no two songs compare equal
+   *
+   * @param {SortKey} key - sort order
+   * @param {SongHandle} a - handle of first song (valid)
+   * @param {SongHandle} b - handle of second song (valid)
+   * @returns {bool} true if a comes before b
+   */
+  bool sortsBefore(SortKey key, SongHandle a, SongHandle b) const;
+  /**===================================================
+   *
+   * Description: Sort a range of handles, split over threads when large
+   *
+   * @param {SortKey} key - sort order
+   * @param {std::vector<SongHandle>::iterator} first - begin of range
+   * @param {std::vector<SongHandle>::iterator} last - end of range
+   * @returns {none}
+   */
+  void sortHandles(SortKey key, std::vector<SongHandle>::iterator first,
+                   std::vector<SongHandle>::iterator last) const;
+  /**===================================================
+   *
+   * Description: Put a song into every built sort order (binary search)
+   *
+   * @param {SongHandle} handle - handle of the song, keys already set
+   * @returns {none}
+   */
+  void sortInsert(SongHandle handle);
+  /**===================================================
+   *
+   * Description: Take a song out of every built sort order
+   *
+   * @param {SongHandle} handle - handle of the song, keys not yet changed
+   * @returns {none}
+   */
+  void sortErase(SongHandle handle);
+  /**===================================================
+   *
+   * Description: Take many songs out of every built sort order
+   * - Each is found by binary search like sortErase(), then the runs
+   *   between them are moved down in one pass per order
+   *
+   * @param {const std::vector<SongHandle>&} gone - songs, still stored
+   * @returns {none}
+   */
+  void sortEraseAll(const std::vector<SongHandle> &gone);
 
 public:
+  // Most songs one library can hold (24-bit handle slots, fewer once
+  // slots are retired - one per 256 reuses, see HandleEntry)
+  static constexpr size_t MAX_SONGS = SongHandle::SLOT_MASK;
+  // Partition of songs added without one
+  static constexpr uint32_t DEFAULT_PARTITION = 0;
+
   /**===================================================
    *
-   * Description: Construct Class with a vector with 1000 songs reserved
+   * Description: Construct empty library (storage grows in blocks)
    *
    * @param {none}
    * @returns {none}
@@ -39,33 +338,141 @@ public:
    * Description: Get all songs from library
    *
    * @param {none}
-   * @returns {const std::vector<Song>&} reference of all the songs
+   * @returns {const SongStore&} reference of all the songs
    */
-  const std::vector<Song> &getAllSongs() const;
+  const SongStore &getAllSongs() const;
+  /**===================================================
+   *
+   * Description: Get the songs as columns (one array per field)
+   * - Row i is the song in slot i of getAllSongs(); scans that read one
+   *   or two fields should walk these instead of whole songs
+   *
+   * @param {none}
+   * @returns {const SongColumns&} columnar view of all the songs
+   */
+  const SongColumns &getColumns() const;
+  /**===================================================
+   *
+   * Description: Get the handle of the song in a storage slot
+   *
+   * @param {size_t} songSlot - slot in song storage (or column row)
+   * @returns {SongHandle} handle of the song
+   */
+  SongHandle slotHandle(size_t songSlot) const;
   /**===================================================
    *
    * Description: Add Song to Library and update map
+   * - Songs already stored keep their address
+   * - The stored song gets the next ID of this library (song.id ignored)
+   * - Title, artist and album are stored NFC normalized, see TextKey.h
    *
    * @param {const Song&} song - Song to add to library
-   * @returns {bool} true if reallocated - false if not reallocated
+   * @param {uint32_t} partition - partition of the song, see
+   * createPartition()
+   * @returns {bool} true if a new storage block was allocated
+   */
+  bool addSong(const Song &song, uint32_t partition = DEFAULT_PARTITION);
+  /**===================================================
+   *
+   * Description: Add many songs at once, moved in
+   * - Text of big batches is normalized on parallel threads
+   * - Reserves once, appends, then indexes only the new songs - see
+   *   indexRange()
+   *
+   * @param {std::vector<Song>&&} batch - songs to add (left empty)
+   * @param {uint32_t} partition - partition of the songs
+   * @returns {bool} true if a new storage block was allocated
+   */
+  bool addSongs(std::vector<Song> &&batch,
+                uint32_t partition = DEFAULT_PARTITION);
+  /**===================================================
+   *
+   * Description: Remove Song from Library and update maps in place
+   * - The last song is moved into the freed slot (its address changes,
+   *   its handle stays valid) - handles of the removed song go stale
+   *
+   * @param {int} id - ID of song to remove
+   * @returns {bool} true if removed - false if not found
+   */
+  bool removeSong(int id);
+  /**===================================================
+   *
+   * Description: Remove many songs at once
+   * - Like removeSong() per song, but each built sort order is compacted
+   *   in one pass instead of one erase per song
+   * - Only the removed songs are looked up: cost grows with ids, not with
+   *   the library (beyond moving the tail of each sort order once)
+   *
+   * @param {const std::vector<int>&} ids - IDs of songs to remove
+   * @returns {size_t} number of songs removed (unknown IDs are skipped)
+   */
+  size_t removeSongs(const std::vector<int> &ids);
+  /**===================================================
+   *
+   * Description: Start a new partition (e.g. one per loaded folder)
+   * - A partition groups songs so they can be listed and removed together
+   *   at a cost that grows with the partition, not the library
+   * - IDs are not reused before clear()
+   *
+   * @param {none}
+   * @returns {uint32_t} ID of the new, empty partition
+   */
+  uint32_t createPartition();
+  /**===================================================
+   *
+   * Description: Remove every song of a partition, see removeSongs()
+   * - Handles of its songs go stale, other songs keep theirs
+   * - Their text stays in the text arena until clear()
+   *
+   * @param {uint32_t} partition - partition to remove
+   * @returns {size_t} number of songs removed
+   */
+  size_t removePartition(uint32_t partition);
+  /**===================================================
+   *
+   * Description: Get the songs of a partition
+   *
+   * @param {uint32_t} partition - partition ID
+   * @returns {const std::vector<SongHandle>&} handles in no particular
+   * order, valid until the partition changes - empty if unknown
    */
-  bool addSong(const Song &song);
+  const std::vector<SongHandle> &getPartitionSongs(uint32_t partition) const;
+  /**===================================================
+   *
+   * Description: Get the partition a song belongs to
+   *
+   * @param {SongHandle} handle - handle of the song
+   * @returns {uint32_t} its partition - DEFAULT_PARTITION if stale
+   */
+  uint32_t getPartition(SongHandle handle) const;
+  /**===================================================
+   *
+   * Description: Replace tags, path and stamp of a song, keeping its ID
+   * and address - maps are updated only for changed keys
+   * - A changed title or path is appended to the text arena, the old text
+   *   stays there until clear()
+   *
+   * @param {int} id - ID of song to update
+   * @param {const Song&} song - new content (its ID is ignored)
+   * @returns {bool} true if updated - false if not found
+   */
+  bool updateSong(int id, const Song &song);
   /**===================================================
    *
    * Description: Return begin of Class (MusicLibrary)
    *
    * @param {none}
-   * @returns {iterator} begin of songs vector
+   * @returns {iterator} begin of song storage
    */
-  std::vector<Song>::const_iterator begin() const;
+  SongStore::const_iterator begin() const;
   /**===================================================
    *
    * Description: Return end of Class (MusicLibrary)
    *
    * @param {none}
-   * @returns {iterator} end of songs vector
+   * @returns {iterator} end of song storage
    */
-  std::vector<Song>::const_iterator end() const;
+  SongStore::const_iterator end() const;
   /**===================================================
    *
    * Description: Return size of Class (MusicLibrary)
@@ -74,6 +481,15 @@ public:
    * @returns {size_t} number of songs in library
    */
   size_t getSize() const;
+  /**===================================================
+   *
+   * Description: Get a counter bumped by every add, update, remove and
+   * clear - equal values mean the songs have not changed in between
+   *
+   * @param {none}
+   * @returns {uint64_t} library version
+   */
+  uint64_t getVersion() const;
   /**===================================================
    *
    * Description: Initialize and populate ID hashmap
@@ -106,34 +522,168 @@ public:
   // void initArtistMap();
   /**===================================================
    *
-   * Description: Find song by ID using hashmap
+   * Description: Find song by ID (direct index, no hashing)
    *
    * @param {int} id - ID for search
-   * @returns {const Song*} - Pointer to song in library
+   * @returns {const StoredSong*} - Pointer to song in library
    * @note return nullptr if not found
    */
-  const Song *findSongByID(int id) const;
+  const StoredSong *findSongByID(int id) const;
+  /**===================================================
+   *
+   * Description: Get the song a handle refers to
+   *
+   * @param {SongHandle} handle - handle from this library
+   * @returns {const StoredSong*} - Pointer to song in library
+   * @note return nullptr if the handle is null or stale (song removed,
+   * library cleared)
+   */
+  const StoredSong *resolve(SongHandle handle) const;
+  /**===================================================
+   *
+   * Description: Get the handle of a song stored in this library
+   *
+   * @param {const StoredSong*} song - pointer to song (in library)
+   * @returns {SongHandle} handle of the song
+   * @note return null handle if song is nullptr or not stored here
+   */
+  SongHandle getHandle(const StoredSong *song) const;
+  /**===================================================
+   *
+   * Description: Find handle of song by ID (direct index, no hashing)
+   *
+   * @param {int} id - ID for search
+   * @returns {SongHandle} handle of the song
+   * @note return null handle if not found
+   */
+  SongHandle findHandleByID(int id) const;
+  /**===================================================
+   *
+   * Description: Get the artist of a stored song
+   *
+   * @param {const StoredSong&} song - song (in library)
+   * @returns {const std::string&} artist name
+   */
+  const std::string &getArtist(const StoredSong &song) const;
+  /**===================================================
+   *
+   * Description: Get the album of a stored song
+   *
+   * @param {const StoredSong&} song - song (in library)
+   * @returns {const std::string&} album name
+   */
+  const std::string &getAlbum(const StoredSong &song) const;
+  /**===================================================
+   *
+   * Description: Get a stored song as a classic Song (owning strings)
+   * - Compatibility accessor for code that edits or keeps songs, e.g. tag
+   *   readers and updateSong()
+   *
+   * @param {const StoredSong&} song - song (in library)
+   * @returns {Song} copy with the same ID
+   */
+  Song copySong(const StoredSong &song) const;
+  /**===================================================
+   *
+   * Description: Get the interned artist names (ID -> name)
+   *
+   * @param {none}
+   * @returns {const StringPool&} artist pool
+   */
+  const StringPool &getArtists() const;
+  /**===================================================
+   *
+   * Description: Get the interned album names (ID -> name)
+   *
+   * @param {none}
+   * @returns {const StringPool&} album pool
+   */
+  const StringPool &getAlbums() const;
+  /**===================================================
+   *
+   * Description: Find the ID of an album by name
+   * - Name is normalized first: stored names are NFC
+   *
+   * @param {const std::string&} album - album name as typed or read
+   * @returns {uint32_t} album ID - StringPool::NONE if not found
+   */
+  uint32_t findAlbumId(const std::string &album) const;
+  /**===================================================
+   *
+   * Description: Get the sort and search keys of an artist name
+   *
+   * @param {uint32_t} artistId - ID from getArtists()
+   * @returns {const TextKeys&} keys - empty for unknown IDs
+   */
+  const TextKeys &getArtistKeys(uint32_t artistId) const;
+  /**===================================================
+   *
+   * Description: Get the sort and search keys of an album name
+   *
+   * @param {uint32_t} albumId - ID from getAlbums()
+   * @returns {const TextKeys&} keys - empty for unknown IDs
+   */
+  const TextKeys &getAlbumKeys(uint32_t albumId) const;
   /**===================================================
    *
-   * Description: Find song by Title using map
+   * Description: Get the arena holding titles and file paths
+   *
+   * @param {none}
+   * @returns {const TextArena&} text arena (for memory figures)
+   */
+  const TextArena &getTextArena() const;
+  /**===================================================
+   *
+   * Description: Get the search box completion index
+   *
+   * @param {none}
+   * @returns {const AutocompleteIndex&} completions (for memory figures)
+   */
+  const AutocompleteIndex &getCompletions() const;
+  /**===================================================
+   *
+   * Description: Find song by Title (binary search in the title index)
+   * - Exact match after NFC normalization of both sides
    *
    * @param {string} title - Title for search
-   * @returns {const Song*} - Pointer to song in library
+   * @returns {const StoredSong*} - Pointer to song in library, the first
+   * added one if several share the title
+   * @note return nullptr if not found
+   */
+  const StoredSong *findSongByTitle(const std::string &title) const;
+  /**===================================================
+   *
+   * Description: Get the title index (title sort key -> song entries)
+   * - equalRange(makeSortKey(title)) gives every song with a title
+   * - prefixRange(makePrefixKey(text)) every song whose title starts with
+   *   some text, ignoring case and tones
+   *
+   * @param {none}
+   * @returns {const TitleIndex&} reference to title index - see resolve()
+   */
+  const TitleIndex &getTitleIndex() const;
+  /**===================================================
+   *
+   * Description: Find song by file path using hashmap
+   *
+   * @param {string} filePath - path as stored in the song
+   * @returns {const StoredSong*} - Pointer to song in library
    * @note return nullptr if not found
    */
-  const Song *findSongByTitle(const std::string &title);
+  const StoredSong *findSongByPath(const std::string &filePath) const;
   /**===================================================
    *
    * Description: Find song by Artist using map
    *
    * @param {string} artist - Artist for search
-   * @returns {const vector<Song*.} - Pointer to song in library
+   * @returns {const vector<StoredSong*>} - Pointer to song in library
    * @note return nullptr if not found
    */
-  std::vector<const Song *> findSongByArtist(const std::string &title);
+  std::vector<const StoredSong *> findSongByArtist(const std::string &title);
   /**===================================================
    *
    * Description: Clear all songs from library
+   * - Every handle handed out so far goes stale, IDs start again from 0
    *
    * @param {none}
    * @returns {none}
@@ -144,29 +694,118 @@ public:
    * Description: Get the artist index map directly
    *
    * @param {none}
-   * @returns {const unordered_map<string, vector<Song*>>&} reference to artist
-   * index
+   * @returns {const unordered_map<uint32_t, vector<SongHandle>>&} reference
+   * to artist index, keyed by artist ID - see getArtists(), resolve()
    */
-  const std::unordered_map<std::string, std::vector<const Song *>> &
+  const std::unordered_map<uint32_t, std::vector<SongHandle>> &
   getArtistIndex() const;
   /**===================================================
    *
-   * Description: Find song by Album using map
+   * Description: Get the album index map directly
    *
-   * @param {string} album - album name
-   * @returns {const Song*}
-   * @note return nullptr if not found
+   * @param {none}
+   * @returns {const unordered_map<uint32_t, vector<SongHandle>>&} reference
+   * to album index, keyed by album ID - see getAlbums(), resolve()
+   */
+  const std::unordered_map<uint32_t, std::vector<SongHandle>> &
+  getAlbumIndex() const;
+  /**===================================================
+   *
+   * Description: Get IDs of all albums in the library sorted by name (A-Z,
+   * collation order of TextKey.h)
+   *
+   * @param {none}
+   * @returns {vector<uint32_t>} album IDs - see getAlbums()
+   */
+  std::vector<uint32_t> getSortedAlbums() const;
+  /**===================================================
+   *
+   * Description: Find songs whose title, artist or album contains a query,
+   * ignoring case and accents (see makeSearchKey())
+   * - Queries of 3+ bytes only verify the songs and names found in the
+   *   trigram index, shorter ones scan the search key column
+   *
+   * - Not thread-safe: lookups sort the trigram lists they touch
+   *
+   * @param {std::string_view} query - text as typed
+   * @param {const std::atomic<bool>*} cancelled - polled while scanning,
+   * nullptr if the search cannot be cancelled
+   * @returns {SearchResult} matching songs, artists and albums - empty for
+   * an empty query or once cancelled
    */
-  const std::map<std::string, std::vector<const Song *>> &getAlbumIndex() const;
+  SearchResult search(std::string_view query,
+                      const std::atomic<bool> *cancelled = nullptr) const;
+  /**===================================================
+   *
+   * Description: Narrow a search result down to a query that contains the
+   * one it was found with (e.g. one more letter typed)
+   * - Only the previous songs and names are checked, no index lookup
+   * - The library must not have changed since (see getVersion())
+   *
+   * @param {const SearchResult&} previous - result of a contained query
+   * @param {std::string_view} query - text as typed
+   * @param {const std::atomic<bool>*} cancelled - as for search()
+   * @returns {SearchResult} same as search(query) would return
+   */
+  SearchResult refine(const SearchResult &previous, std::string_view query,
+                      const std::atomic<bool> *cancelled = nullptr) const;
+  /**===================================================
+   *
+   * Description: Find the songs closest to a possibly misspelled query
+   * - Edit distance of the folded query to any part of the title, artist
+   *   and album keys (FuzzyPattern): "son tugn" finds "Sơn Tùng"
+   * - A song scores its best field: weight x (1 - edits / query length),
+   *   plus a little for fields the query covers more of
+   * - Names are matched once, not per song; only the best `limit` songs
+   *   are kept (bounded heap)
+   *
+   * @param {std::string_view} query - text as typed
+   * @param {size_t} limit - most songs returned
+   * @param {const FuzzyWeights&} weights - title/artist/album weights
+   * @param {const std::atomic<bool>*} cancelled - as for search()
+   * @returns {std::vector<FuzzyHit>} best first, ties in ID order - empty
+   * for an empty query or once cancelled
+   */
+  std::vector<FuzzyHit>
+  fuzzySearch(std::string_view query, size_t limit,
+              const FuzzyWeights &weights = FuzzyWeights(),
+              const std::atomic<bool> *cancelled = nullptr) const;
+  /**===================================================
+   *
+   * Description: Get the titles, artists and albums starting with what
+   * was typed, the ones with the most songs first
+   * - Walks the folded prefix down a trie whose nodes keep their best
+   *   entries: no scan, cheap enough for every keystroke
+   *
+   * @param {std::string_view} prefix - text as typed
+   * @param {size_t} limit - most completions (at most TOP_COUNT)
+   * @returns {std::vector<Completion>} best first - empty for an empty
+   * prefix
+   */
+  std::vector<Completion>
+  complete(std::string_view prefix,
+           size_t limit = AutocompleteIndex::TOP_COUNT) const;
 
   /**===================================================
    *
    * Description: Get all songs sorted by title (A-Z)
    *
    * @param {none}
-   * @returns {vector<const Song*>} sorted vector of song pointers
+   * @returns {vector<const StoredSong*>} sorted vector of song pointers
+   */
+  std::vector<const StoredSong *> getSortedSongs() const;
+  /**===================================================
+   *
+   * Description: Get all songs in a sort order without copying them
+   * - The order is built (parallel sort) on the first call for a key and
+   *   cached: later calls allocate nothing, cheap enough for every frame
+   * - The view follows later changes: compare getVersion() with a fresh
+   *   view to know when things derived from it are out of date
+   *
+   * @param {SortKey} key - title, artist, album or duration
+   * @returns {SortView} random-access view of every song
    */
-  std::vector<const Song *> getSortedSongs() const;
+  SortView getSortView(SortKey key) const;
 };
 
 #endif
\ No newline at end of file
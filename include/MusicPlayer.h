@@ -5,11 +5,18 @@
 #define MUSIC_PLAYER_H
 
 #include "AudioEngine.h"
+#include "FolderWatcher.h"
+#include "ImportJob.h"
 #include "MusicLibrary.h"
 #include "PlaybackHistory.h"
 #include "PlaybackQueue.h"
+#include "SearchService.h"
 #include "ShuffleManager.h"
 #include "Song.h"
+#include "TagLoader.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 class MusicPlayer {
@@ -18,11 +25,58 @@ private:
   PlaybackQueue queue;
   ShuffleManager shuffleMgr;
   PlaybackHistory stack;
-  std::unordered_set<std::string> loadedFolders; // Track loaded folders
+  // A loaded folder: the path it was loaded with, its songs' partition
+  struct LoadedFolder {
+    std::string root;
+    uint32_t partition;
+  };
+  // Track loaded folders: canonical path -> folder
+  std::unordered_map<std::string, LoadedFolder> loadedFolders;
+  std::vector<std::shared_ptr<ImportJob>> importJobs; // Running imports
+  bool isTagCacheEn = true; // Reuse tags stored in each root folder
+  bool isFolderWatchEn = true; // Pick up file changes in loaded folders
+  WalkOptions walkOptions;      // Which files of a folder tree are songs
+  bool isLazyTagsEn = false;    // List songs first, read tags afterwards
+  // Caches of lazy folders, saved once their last tag is read
+  std::vector<std::shared_ptr<TagCache>> lazyCaches;
 
   bool isShuffleEn = false;
-  const Song *current = nullptr;
+  SongHandle current; // resolved through library, null when stopped
   PlaybackQueue smartPlaylist;
+  // Searches library on its own thread: changes go through lockLibrary()
+  SearchService searchService{library};
+  // Last members: their threads read tags via this
+  TagLoader tagLoader;
+  FolderWatcher watcher;
+
+  /**===================================================
+   *
+   * Description: Apply added, changed and removed files to the library
+   * - Files are matched by path, unchanged stamps are skipped
+   * - Removed songs are dropped from playback afterwards
+   *
+   * @param {FolderChanges&} changes - batch from rescan or watcher
+   * @returns {size_t} number of songs added, updated or removed
+   */
+  size_t applyChanges(FolderChanges &changes);
+  /**===================================================
+   *
+   * Description: Drop stale handles from playback (queue, history,
+   * forward, shuffle, smart playlist) after songs were removed
+   * - Current song stops playing if it was removed
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void dropStalePlayback();
+  /**===================================================
+   *
+   * Description: Find a loaded folder by the path it was loaded with
+   *
+   * @param {const std::string&} root - path as loaded
+   * @returns {const LoadedFolder*} the folder - nullptr if not loaded
+   */
+  const LoadedFolder *findFolder(const std::string &root) const;
 
 public:
   AudioEngine engine;
@@ -45,12 +99,199 @@ public:
   ~MusicPlayer();
   /**===================================================
    *
-   * Description: Load songs into library
+   * Description: Load songs into library (blocks until done)
+   * - Tags are read in parallel by ImportPipeline, songs are committed here
    *
    * @param {const std::string} path - folder path include songs
    * @returns {none}
    */
   void loadLibrary(const std::string &path);
+  /**===================================================
+   *
+   * Description: Start loading songs into library in the background
+   * - Songs are added in batches by pollImports() on the calling thread
+   *
+   * @param {const std::string&} path - folder path include songs
+   * @param {size_t} batchSize - songs per published batch
+   * @returns {std::shared_ptr<ImportJob>} job handle (progress, cancel, future)
+   * @note return nullptr if path is invalid or already loaded
+   */
+  std::shared_ptr<ImportJob> loadLibraryAsync(const std::string &path,
+                                              size_t batchSize = 256);
+  /**===================================================
+   *
+   * Description: Publish ready import batches into library (call per frame)
+   * - Rescan batches are applied as changes, their removals once the
+   *   rescan ends
+   * - Finished jobs are removed after their last batch
+   *
+   * @param {size_t} maxSongs - soft budget, at least one batch is published
+   * @returns {size_t} number of songs added
+   */
+  size_t pollImports(size_t maxSongs = 2048);
+  /**===================================================
+   *
+   * Description: Apply tags read in the background (call per frame)
+   * - Only for folders loaded with lazy tags, songs keep ID and address
+   * - Tag caches of those folders are saved once every tag is read
+   *
+   * @param {size_t} maxSongs - max songs updated
+   * @returns {size_t} number of songs updated
+   */
+  size_t pollTags(size_t maxSongs = 2048);
+  /**===================================================
+   *
+   * Description: Read tags of songs on screen first (call per frame)
+   *
+   * @param {const std::vector<int>&} ids - song IDs of the visible rows
+   * @returns {none}
+   */
+  void requestTags(const std::vector<int> &ids);
+  /**===================================================
+   *
+   * Description: Get number of songs still waiting for their tags
+   *
+   * @param {none}
+   * @returns {size_t} songs listed with default tags
+   */
+  size_t getPendingTagCount();
+  /**===================================================
+   *
+   * Description: Enable/disable lazy tags for folders loaded from now on
+   * - Songs are listed as soon as the folder walk finds them (file name
+   *   as title), tags are read afterwards: visible rows first, then
+   *   queued songs, then the rest
+   *
+   * @param {bool} enabled - true to defer tag reading
+   * @returns {none}
+   */
+  void setLazyTagsEnabled(bool enabled);
+  /**===================================================
+   *
+   * Description: Check if lazy tags are enabled
+   *
+   * @param {none}
+   * @returns {bool} true if enabled
+   */
+  bool isLazyTagsEnabled() const;
+  /**===================================================
+   *
+   * Description: Bring a loaded folder in sync with the disk (blocks until
+   * done)
+   * - Files are matched by path, then compared by size and mtime
+   * - New files are added, changed files re-read in place (same ID),
+   *   deleted files removed - queue and history keep their songs
+   *
+   * @param {const std::string&} path - folder loaded before
+   * @returns {size_t} number of songs added, updated or removed
+   * @note return 0 if the folder is not loaded or still importing
+   */
+  size_t rescanFolder(const std::string &path);
+  /**===================================================
+   *
+   * Description: Start rescanning a loaded folder in the background
+   * - Walk, stat and tag reads run on the job's thread, only new or
+   *   changed files are read
+   * - Changes are applied by pollImports() on the calling thread
+   *
+   * @param {const std::string&} path - folder loaded before
+   * @param {size_t} batchSize - changed songs per published batch
+   * @returns {std::shared_ptr<ImportJob>} job handle (progress, cancel)
+   * @note return nullptr if the folder is not loaded or still importing
+   */
+  std::shared_ptr<ImportJob> rescanFolderAsync(const std::string &path,
+                                               size_t batchSize = 256);
+  /**===================================================
+   *
+   * Description: Start rescanning every loaded folder in the background
+   *
+   * @param {none}
+   * @returns {size_t} number of rescans started
+   */
+  size_t rescanLibrary();
+  /**===================================================
+   *
+   * Description: Remove one loaded folder and its songs, keep the others
+   * - Its import is cancelled and its watch stopped
+   * - Cost grows with the folder's songs, not the whole library
+   * - Queue, history, shuffle and smart playlist drop its songs; playback
+   *   stops if the current song was one of them
+   *
+   * @param {const std::string&} path - folder loaded before (may be gone
+   * from disk already)
+   * @returns {size_t} number of songs removed
+   * @note return 0 if the folder is not loaded
+   */
+  size_t unloadFolder(const std::string &path);
+  /**===================================================
+   *
+   * Description: Get the loaded folders
+   *
+   * @param {none}
+   * @returns {std::vector<std::string>} paths as loaded, sorted
+   */
+  std::vector<std::string> getLoadedFolders() const;
+  /**===================================================
+   *
+   * Description: Apply batches from the folder watcher (call per frame)
+   * - Tags are already read, applying costs O(batch) on this thread
+   * - Lost events (overflow) start a background rescan of the folder
+   *
+   * @param {none}
+   * @returns {size_t} number of songs added, updated or removed
+   */
+  size_t pollFolderChanges();
+  /**===================================================
+   *
+   * Description: Enable/disable live watching of folders loaded from now on
+   * - Linux only (inotify), ignored elsewhere
+   *
+   * @param {bool} enabled - true to watch new folders
+   * @returns {none}
+   */
+  void setFolderWatchEnabled(bool enabled);
+  /**===================================================
+   *
+   * Description: Set extensions, depth limit and symlink handling used by
+   * imports, rescans and watches started from now on
+   *
+   * @param {const WalkOptions&} options - folder walk options
+   * @returns {none}
+   */
+  void setWalkOptions(const WalkOptions &options);
+  /**===================================================
+   *
+   * Description: Get current folder walk options
+   *
+   * @param {none}
+   * @returns {const WalkOptions&} walk options
+   */
+  const WalkOptions &getWalkOptions() const;
+  /**===================================================
+   *
+   * Description: Get running import jobs (for progress display)
+   *
+   * @param {none}
+   * @returns {const std::vector<std::shared_ptr<ImportJob>>&} running jobs
+   */
+  const std::vector<std::shared_ptr<ImportJob>> &getImportJobs() const;
+  /**===================================================
+   *
+   * Description: Check if any import is running or still publishing
+   *
+   * @param {none}
+   * @returns {bool} true if importing
+   */
+  bool isImporting() const;
+  /**===================================================
+   *
+   * Description: Enable/disable the persistent tag cache for new imports
+   * - Cache file lives in the imported folder (TagCache::FILE_NAME)
+   *
+   * @param {bool} enabled - true to reuse cached tags of unchanged files
+   * @returns {none}
+   */
+  void setTagCacheEnabled(bool enabled);
   /**===================================================
    *
    * Description: Get library
@@ -61,9 +302,40 @@ public:
   const MusicLibrary &getLibrary() const;
   /**===================================================
    *
-   * Description: Load songs into library
+   * Description: Search title, artist and album in the background (call
+   * per frame with the search box text)
+   * - Unchanged text on an unchanged library costs nothing, repeated
+   *   queries come from a cache - see SearchService
    *
-   * @param {const std::string} path - folder path include songs
+   * @param {std::string_view} query - text as typed
+   * @returns {none}
+   */
+  void searchLibrary(std::string_view query);
+  /**===================================================
+   *
+   * Description: Get the latest published search result
+   * - Songs removed since resolve to nullptr
+   *
+   * @param {none}
+   * @returns {std::shared_ptr<const SearchSnapshot>} result - nullptr
+   * before the first search
+   */
+  std::shared_ptr<const SearchSnapshot> getSearchResults();
+  /**===================================================
+   *
+   * Description: Check if the last search is still running
+   *
+   * @param {none}
+   * @returns {bool} true if its results are not published yet
+   */
+  bool isSearching();
+  /**===================================================
+   *
+   * Description: Read tags of a file into song
+   * - Thread-safe: called concurrently by import workers
+   *
+   * @param {const std::string&} filePath - path of audio file
+   * @param {Song&} newSong - song to fill (keeps defaults if no tag)
    * @returns {none}
    */
   void loadMetadata(const std::string &filePath, Song &newSong);
@@ -80,9 +352,9 @@ public:
    * Description: Get current song
    *
    * @param {none}
-   * @returns {const Song*} Current song
+   * @returns {const StoredSong*} Current song (nullptr if none or removed)
    */
-  const Song *getCurrentSong();
+  const StoredSong *getCurrentSong();
   /**===================================================
    *
    * Description: Get upcoming queue
@@ -103,18 +375,18 @@ public:
    *
    * Description: Add song into queue
    *
-   * @param {const Song*} song - Song to be added
+   * @param {const StoredSong*} song - Song to be added
    * @returns {none}
    */
-  void addSongToQueue(const Song *song);
+  void addSongToQueue(const StoredSong *song);
     /**===================================================
    *
    * Description: Remove song from queue
    *
-   * @param {const Song*} song - Song to be removed
+   * @param {const StoredSong*} song - Song to be removed
    * @returns {none}
    */
-  void removeSongFromQueue(const Song *song);
+  void removeSongFromQueue(const StoredSong *song);
   /**===================================================
    *
    * Description: Get the number of songs in queue
@@ -135,10 +407,10 @@ public:
    *
    * Description: Choose and play a song
    *
-   * @param {const Song*} song - song to be played
+   * @param {const StoredSong*} song - song to be played
    * @returns {none}
    */
-  void chooseAndPlaySong(const Song *song);
+  void chooseAndPlaySong(const StoredSong *song);
   /**===================================================
    *
    * Description: Play next song
@@ -231,10 +503,11 @@ public:
    *
    * Description: Generate a smart playlist based on a song
    *
-   * @param {const Song*} startSong
+   * @param {const StoredSong*} startSong
    * @returns {none}
    */
-  PlaybackQueue generateSmartPlaylist(const Song *startSong, size_t maxSize);
+  PlaybackQueue generateSmartPlaylist(const StoredSong *startSong,
+                                      size_t maxSize);
   /**===================================================
    *
    * Description: Clear current queue and apply the smart playlist
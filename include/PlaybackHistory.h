@@ -6,12 +6,14 @@
 
 #include <stack>
 #include <vector>
+#include "MusicLibrary.h"
 #include "Song.h"
+#include "SongHandle.h"
 
 class PlaybackHistory {
 private:
-    std::stack<const Song*> history;
-    std::vector<const Song*> forward;
+    std::stack<SongHandle, std::vector<SongHandle>> history;
+    std::vector<SongHandle> forward;
 
 public:
     /**===================================================
@@ -35,49 +37,49 @@ public:
      * Description: Return last played song and remove 
      *
      * @param {none}
-     * @returns {const Song*} - Pointer to last played song
+     * @returns {SongHandle} - Handle of last played song (null if none)
      */
-    const Song* getPreviousSong();
+    SongHandle getPreviousSong();
     /**===================================================
      * 
      * Description: Return forward song and remove
      *
      * @param {none}
-     * @returns {const Song*} - Pointer to forward song in stack
+     * @returns {SongHandle} - Handle of forward song in stack (null if none)
      */
-    const Song* getForwardSong();
+    SongHandle getForwardSong();
     /**===================================================
      * 
      * Description: Get history list (Display purpose)
      *
      * @param {none}
-     * @returns {std::vector<const Song*} - History list
+     * @returns {std::vector<SongHandle>} - History list (most recent first)
      */
-    std::vector<const Song*> getHistoryList() const;
+    std::vector<SongHandle> getHistoryList() const;
     /**===================================================
      * 
      * Description: Get forward list
      *
      * @param {none}
-     * @returns {std::vector<const Song*} - Forward list
+     * @returns {std::vector<SongHandle>} - Forward list
      */
-    std::vector<const Song*> getForwardList() const;
+    std::vector<SongHandle> getForwardList() const;
     /**===================================================
      * 
      * Description: Add song to history stack
      *
-     * @param {Song*} song - Current song just has been played
+     * @param {SongHandle} song - Current song just has been played
      * @returns {none}
      */    
-    void addSongToHistory(const Song* song);
+    void addSongToHistory(SongHandle song);
     /**===================================================
      * 
      * Description: Add song to forward stack
      *
-     * @param {Song*} song - Current song to play but got push out by "play previous"
+     * @param {SongHandle} song - Current song to play but got push out by "play previous"
      * @returns {none}
      */
-    void addSongToForward(const Song* song);
+    void addSongToForward(SongHandle song);
     /**===================================================
      * 
      * Description: Clear history
@@ -110,6 +112,15 @@ public:
      * @returns {none}
      */
     size_t getForwardSize() const;
+    /**===================================================
+     *
+     * Description: Drop songs the library no longer holds (stale handles)
+     * - Order of history and forward is kept
+     *
+     * @param {MusicLibrary&} library - library the handles come from
+     * @returns {none}
+     */
+    void removeStale(const MusicLibrary& library);
 };
 
 #endif
\ No newline at end of file
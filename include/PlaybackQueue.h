@@ -4,13 +4,14 @@
 #ifndef PLAYBACK_QUEUE_H
 #define PLAYBACK_QUEUE_H
 
-#include <list>
+#include <deque>
 #include "Song.h"
+#include "SongHandle.h"
 #include "MusicLibrary.h"
 
 class PlaybackQueue {
 private:
-    std::list<const Song*> queue;
+    std::deque<SongHandle> queue; // 4 bytes per song, resolve via library
 public:
     /**===================================================
      * 
@@ -33,25 +34,26 @@ public:
      * Description: Get queue list
      *
      * @param {none}
-     * @returns {std::list<const Song*>} - queue list   
+     * @returns {const std::deque<SongHandle>&} - queue list (handles)
      */
-    std::list<const Song*> getQueueList() const ;
+    const std::deque<SongHandle>& getQueueList() const ;
     /**===================================================
      * 
      * Description: Add song to playback queue
      *
-     * @param {const Song*} song - pointer of song (in library) to add to queue
+     * @param {SongHandle} song - handle of song (in library) to add to queue
      * @returns {none}  
+     * @note null handle is ignored
      */
-    void addSong(const Song* song);
+    void addSong(SongHandle song);
     /**===================================================
      * 
-     * Description: Remove song (pointer) from queue using ID
+     * Description: Remove song (handle) from queue
      *
-     * @param {const Song*} targetSong - song to remove
+     * @param {SongHandle} targetSong - song to remove
      * @returns {none}  
      */
-    void removeSong(const Song* targetSong);
+    void removeSong(SongHandle targetSong);
     /**===================================================
      * 
      * Description: Clear current queue
@@ -83,10 +85,10 @@ public:
      * Description: Get the next song in queue and remove the current song
      *
      * @param {none}
-     * @returns {const Song*} - Pointer to next song in list 
-     * @note do nothing if queue empty 
+     * @returns {SongHandle} - Handle of next song in list 
+     * @note return null handle if queue empty 
      */
-    const Song* getNextSong();
+    SongHandle getNextSong();
     /**===================================================
      * 
      * Description: Add songs in an album to queue
@@ -96,6 +98,14 @@ public:
      * @returns {size_t} - number of songs (in album) added  
      */   
     size_t addAlbumToQueue(const std::string& albumName, const MusicLibrary& library);
+    /**===================================================
+     *
+     * Description: Drop songs the library no longer holds (stale handles)
+     *
+     * @param {MusicLibrary&} library - library the handles come from
+     * @returns {size_t} - number of songs dropped
+     */
+    size_t removeStale(const MusicLibrary& library);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+// SearchService.h
+// Library search on a background thread: the UI submits the query every
+// frame and renders the last published result snapshot
+
+#ifndef SEARCH_SERVICE_H
+#define SEARCH_SERVICE_H
+
+#include "MusicLibrary.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Result of one query - never changed once published
+struct SearchSnapshot {
+  std::string key;         // folded query, see makeSearchKey()
+  uint64_t libraryVersion; // library state the result was found in
+  SearchResult result;     // handles go stale if songs are removed later
+  // Closest songs by edit distance, when few contain the query
+  std::vector<FuzzyHit> fuzzy;
+};
+
+// Counters since construction (tests, diagnostics)
+struct SearchStats {
+  size_t searches = 0;    // full index searches finished
+  size_t refinements = 0; // previous results narrowed instead
+  size_t cacheHits = 0;   // answered without a task
+  size_t cancelled = 0;   // tasks dropped for a newer query
+};
+
+class SearchService {
+private:
+  struct Task {
+    std::string key;
+    uint64_t generation = 0;
+    std::chrono::steady_clock::time_point due; // debounced until then
+  };
+
+  const MusicLibrary &library;
+  std::chrono::milliseconds debounce;
+  // Held shared by the worker while searching, exclusively by the thread
+  // changing the library
+  std::shared_mutex libraryMutex;
+
+  std::mutex mtx;
+  std::condition_variable wake; // new task or stopping
+  std::condition_variable idle; // a task finished or was dropped
+  std::optional<Task> pending;  // only the newest query waits
+  bool running = false;         // worker is executing a task
+  std::atomic<bool> cancelled{false}; // running task's query is outdated
+  bool stopping = false;
+  std::thread worker;
+
+  // Owned by the submitting thread
+  std::string submittedKey;
+  uint64_t submittedVersion = 0;
+  bool submittedAny = false;
+
+  // Guarded by mtx
+  uint64_t generation = 0; // bumped per submitted query
+  std::string latestKey;   // only results for it get published
+  std::shared_ptr<const SearchSnapshot> published;
+  uint64_t publishedGeneration = 0; // never replaced by an older task
+  // Recent snapshots, most recently used first
+  std::vector<std::shared_ptr<const SearchSnapshot>> cache;
+  SearchStats stats;
+
+  /**===================================================
+   *
+   * Description: Worker loop - wait out the debounce, run the newest task
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void run();
+  /**===================================================
+   *
+   * Description: Search (or refine the published result) under the
+   * library lock
+   *
+   * @param {const Task&} task - query to run
+   * @param {std::shared_ptr<const SearchSnapshot>} previous - published
+   * snapshot when the task started
+   * @param {bool&} refined - set if previous was narrowed
+   * @returns {std::shared_ptr<SearchSnapshot>} result - nullptr if
+   * cancelled
+   */
+  std::shared_ptr<SearchSnapshot>
+  execute(const Task &task, std::shared_ptr<const SearchSnapshot> previous,
+          bool &refined);
+  /**===================================================
+   *
+   * Description: Make a snapshot the current one and cache it (mtx held)
+   *
+   * @param {std::shared_ptr<const SearchSnapshot>} snapshot - result
+   * @param {uint64_t} taskGeneration - generation of its query
+   * @returns {none}
+   */
+  void publish(std::shared_ptr<const SearchSnapshot> snapshot,
+               uint64_t taskGeneration);
+
+public:
+  // Typing pause before a query runs
+  static constexpr std::chrono::milliseconds DEFAULT_DEBOUNCE{120};
+  // Snapshots kept for repeated queries
+  static constexpr size_t CACHE_SIZE = 8;
+  // Fewer exact songs than this: also rank fuzzy matches, at most this many
+  static constexpr size_t FUZZY_LIMIT = 20;
+
+  /**===================================================
+   *
+   * Description: Construct service (thread starts on the first query)
+   *
+   * @param {const MusicLibrary&} library - library searched, changed only
+   * under lockLibrary()
+   * @param {std::chrono::milliseconds} debounce - wait before running a
+   * query, restarted by every newer one
+   * @returns {none}
+   */
+  explicit SearchService(const MusicLibrary &library,
+                         std::chrono::milliseconds debounce = DEFAULT_DEBOUNCE);
+  /**===================================================
+   *
+   * Description: Destruct service - cancel and join the worker
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  ~SearchService();
+  /**===================================================
+   *
+   * Description: Ask for the results of a query (call per frame)
+   * - Same query on an unchanged library: nothing to do
+   * - Cached query: published at once, no task
+   * - Otherwise a debounced task replaces any waiting one; a running
+   *   task for another query is cancelled
+   * - A query containing the published one only filters its result
+   * - Few exact songs: the snapshot also holds the closest fuzzy matches
+   *
+   * @param {std::string_view} query - text as typed
+   * @returns {none}
+   */
+  void submit(std::string_view query);
+  /**===================================================
+   *
+   * Description: Get the latest published result
+   * - May belong to an older query while a newer one is running
+   *
+   * @param {none}
+   * @returns {std::shared_ptr<const SearchSnapshot>} snapshot - nullptr
+   * before the first result
+   */
+  std::shared_ptr<const SearchSnapshot> getSnapshot();
+  /**===================================================
+   *
+   * Description: Check if the last submitted query is still being searched
+   *
+   * @param {none}
+   * @returns {bool} true if a task is waiting or running
+   */
+  bool isSearching();
+  /**===================================================
+   *
+   * Description: Block until the last submitted query is published
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void wait();
+  /**===================================================
+   *
+   * Description: Lock the library for a change
+   * - Waits for a running search to finish with the library
+   * - Hold the lock while adding, updating, removing or clearing songs
+   *
+   * @param {none}
+   * @returns {std::unique_lock<std::shared_mutex>} exclusive lock
+   */
+  std::unique_lock<std::shared_mutex> lockLibrary();
+  /**===================================================
+   *
+   * Description: Get counters of searches, refinements and cache hits
+   *
+   * @param {none}
+   * @returns {SearchStats} copy of the counters
+   */
+  SearchStats getStats();
+};
+
+#endif
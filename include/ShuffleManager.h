@@ -6,12 +6,14 @@
 
 #include "PlaybackQueue.h"
 #include "Song.h"
+#include "SongHandle.h"
+#include <deque>
 #include <unordered_set>
 
 class ShuffleManager {
 private:
-  std::vector<const Song *> shuffleQueue;
-  std::unordered_set<const Song *> shuffleHistory;
+  std::vector<SongHandle> shuffleQueue;
+  std::unordered_set<SongHandle> shuffleHistory;
   int index = -1;
 
 public:
@@ -44,10 +46,10 @@ public:
    *
    * Description: Copy queue into shuffleQueue and shuffle all
    *
-   * @param {std::list<const Song*>} queue - upcoming PlaybackQueue
+   * @param {const std::deque<SongHandle>&} queue - upcoming PlaybackQueue
    * @returns {none}
    */
-  void enableShuffle(std::list<const Song *> queue);
+  void enableShuffle(const std::deque<SongHandle> &queue);
   /**===================================================
    *
    * Description: Get the current song in shuffle_list
@@ -61,9 +63,9 @@ public:
    * Description: Get the next song in shuffle_list
    *
    * @param {none}
-   * @returns {const Song*} pointer to next song
+   * @returns {SongHandle} handle of next song (null if queue empty)
    */
-  const Song *getNextSong();
+  SongHandle getNextSong();
   /**===================================================
    *
    * Description: Auto loop if queue ended
@@ -76,10 +78,11 @@ public:
    *
    * Description: Add song to the end of shuffle queue
    *
-   * @param {const Song*} song - Song to be added
+   * @param {SongHandle} song - Song to be added
    * @returns {none}
+   * @note null handle is ignored
    */
-  void addSong(const Song *song);
+  void addSong(SongHandle song);
     /**===================================================
    *
    * Description: Add album to the shuffle queue
@@ -93,9 +96,9 @@ public:
    * Description: Get the shuffled queue for visual display
    *
    * @param {none}
-   * @returns {const std::vector<const Song*>&} reference to shuffle queue
+   * @returns {const std::vector<SongHandle>&} reference to shuffle queue
    */
-  const std::vector<const Song *> &getShuffleList() const;
+  const std::vector<SongHandle> &getShuffleList() const;
   /**===================================================
    *
    * Description: Get current index in shuffle queue
@@ -112,6 +115,15 @@ public:
    * @returns {none}
    */
   void clear();
+  /**===================================================
+   *
+   * Description: Drop songs the library no longer holds (stale handles)
+   * - Position in the shuffle order is kept
+   *
+   * @param {MusicLibrary&} library - library the handles come from
+   * @returns {none}
+   */
+  void removeStale(const MusicLibrary &library);
 };
 
 #endif
\ No newline at end of file
@@ -2,33 +2,28 @@
 #ifndef SONG_H
 #define SONG_H
 
-#include <atomic>
+#include "FileStamp.h"
 #include <string>
 
 struct Song {
-  int id;
+  int id = -1; // given by MusicLibrary when stored (dense, per library)
   std::string title;
   std::string artist;
   std::string album;
-  size_t duration; // [second]
+  size_t duration = 0; // [second]
   std::string filePath;
+  FileStamp stamp; // file version the tags were read from
 
   // Constructor
   Song(int id, std::string t, std::string ar, std::string al, size_t d,
        std::string p)
-      : id(getNextId()), title(t), artist(ar), album(al), duration(d),
-        filePath(p) {}
+      : id(id), title(t), artist(ar), album(al), duration(d), filePath(p) {}
 
-  // Default constructor - uses unique ID
-  Song() : id(getNextId()) {}
+  // Default constructor - no ID until added to a library
+  Song() {}
 
-  // Reset ID counter (call when unloading library)
-  static void resetIdCounter() { idCounter = 0; }
-
-private:
-  static inline std::atomic<int> idCounter{0};
-
-  static int getNextId() { return idCounter++; }
+  // Keep a known ID (rebuilding a song stored in a MusicLibrary)
+  explicit Song(int knownId) : id(knownId) {}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,87 @@
+// SongColumns.h
+// Columnar (struct-of-arrays) copy of song fields for scans: one contiguous
+// array per field, row i of every column is the song in storage slot i
+
+#ifndef SONG_COLUMNS_H
+#define SONG_COLUMNS_H
+
+#include "StoredSong.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Precomputed keys of one title (see TextKey.h), views into the library's
+// TextArena
+struct TitleKeys {
+  std::string_view sortKey;
+  std::string_view searchKey;
+};
+
+struct SongColumns {
+  std::vector<int> ids;
+  std::vector<std::string_view> titles;
+  std::vector<uint32_t> artistIds;
+  std::vector<uint32_t> albumIds;
+  std::vector<uint32_t> durations; // [second]
+  std::vector<std::string_view> filePaths;
+  std::vector<std::string_view> titleSortKeys;   // makeSortKey(title)
+  std::vector<std::string_view> titleSearchKeys; // makeSearchKey(title)
+
+  /**===================================================
+   *
+   * Description: Append a song as the last row
+   *
+   * @param {const StoredSong&} song - song (in library)
+   * @param {TitleKeys} keys - keys of its title
+   * @returns {none}
+   */
+  void push_back(const StoredSong &song, TitleKeys keys);
+  /**===================================================
+   *
+   * Description: Overwrite one row
+   *
+   * @param {size_t} row - row to overwrite
+   * @param {const StoredSong&} song - new content
+   * @param {TitleKeys} keys - keys of its title
+   * @returns {none}
+   */
+  void set(size_t row, const StoredSong &song, TitleKeys keys);
+  /**===================================================
+   *
+   * Description: Get the title keys of one row
+   *
+   * @param {size_t} row - row to read
+   * @returns {TitleKeys} keys of the row's title
+   */
+  TitleKeys getKeys(size_t row) const;
+  /**===================================================
+   *
+   * Description: Drop the last row
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void pop_back();
+  /**===================================================
+   *
+   * Description: Make room for a number of rows in every column
+   * - Grows at least 2x, so reserving per import batch stays linear
+   *
+   * @param {size_t} rows - total rows
+   * @returns {none}
+   */
+  void reserve(size_t rows);
+  /**===================================================
+   *
+   * Description: Drop every row and free the columns
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+
+  size_t size() const { return ids.size(); }
+};
+
+#endif
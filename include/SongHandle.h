@@ -0,0 +1,45 @@
+// SongHandle.h
+// 32-bit reference to a song in MusicLibrary: handle slot + generation
+
+#ifndef SONG_HANDLE_H
+#define SONG_HANDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+struct SongHandle {
+  // 24-bit slot (16.7M songs), 8-bit generation bumped on every release
+  static constexpr uint32_t SLOT_BITS = 24;
+  static constexpr uint32_t SLOT_MASK = (uint32_t(1) << SLOT_BITS) - 1;
+  static constexpr uint32_t GENERATION_MASK = 0xFF;
+  static constexpr uint32_t NONE = 0xFFFFFFFF; // never handed out
+
+  uint32_t value = NONE;
+
+  SongHandle() = default;
+  SongHandle(uint32_t slot, uint32_t generation)
+      : value((generation & GENERATION_MASK) << SLOT_BITS |
+              (slot & SLOT_MASK)) {}
+
+  uint32_t slot() const { return value & SLOT_MASK; }
+  uint32_t generation() const { return value >> SLOT_BITS; }
+  bool isNull() const { return value == NONE; }
+
+  bool operator==(const SongHandle &other) const {
+    return value == other.value;
+  }
+  bool operator!=(const SongHandle &other) const {
+    return value != other.value;
+  }
+};
+
+namespace std {
+template <> struct hash<SongHandle> {
+  size_t operator()(const SongHandle &handle) const {
+    return hash<uint32_t>()(handle.value);
+  }
+};
+} // namespace std
+
+#endif
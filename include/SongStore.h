@@ -0,0 +1,173 @@
+// SongStore.h
+// Segmented song storage: fixed-size blocks, songs never move when it grows
+
+#ifndef SONG_STORE_H
+#define SONG_STORE_H
+
+#include "StoredSong.h"
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+class SongStore {
+public:
+  // Songs per block (1024) - a block is allocated whole and never moves
+  static constexpr size_t BLOCK_SHIFT = 10;
+  static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_SHIFT;
+  static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+  // Random access over slots, walks each block contiguously
+  class const_iterator {
+  private:
+    const SongStore *store = nullptr;
+    size_t slot = 0;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = StoredSong;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const StoredSong *;
+    using reference = const StoredSong &;
+
+    const_iterator() = default;
+    const_iterator(const SongStore *store, size_t slot)
+        : store(store), slot(slot) {}
+
+    reference operator*() const { return (*store)[slot]; }
+    pointer operator->() const { return &(*store)[slot]; }
+    reference operator[](difference_type n) const {
+      return (*store)[slot + n];
+    }
+    const_iterator &operator++() {
+      slot++;
+      return *this;
+    }
+    const_iterator operator++(int) { return {store, slot++}; }
+    const_iterator &operator--() {
+      slot--;
+      return *this;
+    }
+    const_iterator operator--(int) { return {store, slot--}; }
+    const_iterator &operator+=(difference_type n) {
+      slot += n;
+      return *this;
+    }
+    const_iterator &operator-=(difference_type n) {
+      slot -= n;
+      return *this;
+    }
+    const_iterator operator+(difference_type n) const {
+      return {store, slot + n};
+    }
+    const_iterator operator-(difference_type n) const {
+      return {store, slot - n};
+    }
+    difference_type operator-(const const_iterator &other) const {
+      return static_cast<difference_type>(slot - other.slot);
+    }
+    bool operator==(const const_iterator &o) const { return slot == o.slot; }
+    bool operator!=(const const_iterator &o) const { return slot != o.slot; }
+    bool operator<(const const_iterator &o) const { return slot < o.slot; }
+    bool operator>(const const_iterator &o) const { return slot > o.slot; }
+    bool operator<=(const const_iterator &o) const { return slot <= o.slot; }
+    bool operator>=(const const_iterator &o) const { return slot >= o.slot; }
+  };
+
+private:
+  std::vector<StoredSong *> blocks; // raw storage, songs built in place
+  size_t count = 0;
+
+  /**===================================================
+   *
+   * Description: Make sure the slot after the last song has storage
+   *
+   * @param {none}
+   * @returns {bool} true if a new block was allocated
+   */
+  bool grow();
+
+public:
+  /**===================================================
+   *
+   * Description: Construct empty store (no block allocated)
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  SongStore();
+  /**===================================================
+   *
+   * Description: Destruct - destroy every song and free the blocks
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  ~SongStore();
+  SongStore(const SongStore &) = delete;
+  SongStore &operator=(const SongStore &) = delete;
+  /**===================================================
+   *
+   * Description: Append a song (copy) - stored songs keep their address
+   *
+   * @param {const StoredSong&} song - song to store
+   * @returns {bool} true if a new block was allocated
+   */
+  bool push_back(const StoredSong &song);
+  /**===================================================
+   *
+   * Description: Append a song (move) - stored songs keep their address
+   *
+   * @param {StoredSong&&} song - song to store
+   * @returns {bool} true if a new block was allocated
+   */
+  bool push_back(StoredSong &&song);
+  /**===================================================
+   *
+   * Description: Destroy the last song (its block is kept for reuse)
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void pop_back();
+  /**===================================================
+   *
+   * Description: Allocate blocks up front for a number of songs
+   *
+   * @param {size_t} songs - total songs to make room for
+   * @returns {bool} true if a new block was allocated
+   */
+  bool reserve(size_t songs);
+  /**===================================================
+   *
+   * Description: Destroy every song and free all blocks
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+  /**===================================================
+   *
+   * Description: Find the slot of a stored song from its address
+   * - One range check per block
+   *
+   * @param {const StoredSong*} song - pointer to song (in store)
+   * @returns {size_t} slot of the song - size() if not stored here
+   */
+  size_t slotOf(const StoredSong *song) const;
+
+  StoredSong &operator[](size_t slot) {
+    return blocks[slot >> BLOCK_SHIFT][slot & BLOCK_MASK];
+  }
+  const StoredSong &operator[](size_t slot) const {
+    return blocks[slot >> BLOCK_SHIFT][slot & BLOCK_MASK];
+  }
+  StoredSong &back() { return (*this)[count - 1]; }
+  const StoredSong &back() const { return (*this)[count - 1]; }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  size_t capacity() const { return blocks.size() * BLOCK_SIZE; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, count}; }
+};
+
+#endif
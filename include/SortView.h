@@ -0,0 +1,56 @@
+// SortView.h
+// Read-only, random-access view of the library in one sort order - see
+// MusicLibrary::getSortView()
+
+#ifndef SORT_VIEW_H
+#define SORT_VIEW_H
+
+#include "SongHandle.h"
+#include "StoredSong.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MusicLibrary;
+
+// Orders kept by MusicLibrary, ties broken by title and then song ID
+enum class SortKey { Title, Artist, Album, Duration };
+
+static constexpr size_t SORT_KEY_COUNT = 4;
+
+class SortView {
+private:
+  const MusicLibrary *library = nullptr;
+  const std::vector<SongHandle> *order = nullptr;
+  uint64_t version = 0;
+
+public:
+  SortView() = default;
+  SortView(const MusicLibrary &library, const std::vector<SongHandle> &order,
+           uint64_t version)
+      : library(&library), order(&order), version(version) {}
+
+  /**===================================================
+   *
+   * Description: Get the song at a sorted position
+   *
+   * @param {size_t} i - position (0 = first in order)
+   * @returns {const StoredSong*} pointer to song (in library)
+   */
+  const StoredSong *operator[](size_t i) const;
+  /**===================================================
+   *
+   * Description: Get the handle of the song at a sorted position
+   *
+   * @param {size_t} i - position (0 = first in order)
+   * @returns {SongHandle} handle of the song
+   */
+  SongHandle handle(size_t i) const { return (*order)[i]; }
+
+  size_t size() const { return order ? order->size() : 0; }
+  bool empty() const { return size() == 0; }
+  // Changes whenever the order changes: callers can cache what they derive
+  uint64_t getVersion() const { return version; }
+};
+
+#endif
@@ -0,0 +1,26 @@
+// StoredSong.h
+// Compact song record as kept by MusicLibrary (64 bytes, no allocation)
+
+#ifndef STORED_SONG_H
+#define STORED_SONG_H
+
+#include "FileStamp.h"
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+struct StoredSong {
+  int id = -1;
+  uint32_t artistId = 0xFFFFFFFF; // StringPool IDs, see MusicLibrary
+  uint32_t albumId = 0xFFFFFFFF;
+  uint32_t duration = 0; // [second]
+  // Views into the library's TextArena - NUL-terminated, data() is a C string
+  std::string_view title;
+  std::string_view filePath;
+  FileStamp stamp; // file version the tags were read from
+};
+
+static_assert(std::is_trivially_copyable<StoredSong>::value,
+              "StoredSong must stay a flat record");
+
+#endif
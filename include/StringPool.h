@@ -0,0 +1,72 @@
+// StringPool.h
+// Interned strings: each distinct text stored once, referred to by a dense ID
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class StringPool {
+private:
+  std::deque<std::string> strings; // by ID - deque: keys below never move
+  std::unordered_map<std::string_view, uint32_t> ids;
+  size_t textBytes = 0;
+
+public:
+  static constexpr uint32_t NONE = 0xFFFFFFFF; // never handed out
+
+  /**===================================================
+   *
+   * Description: Get the ID of a text, storing it on first use
+   *
+   * @param {std::string_view} text - text to intern
+   * @returns {uint32_t} ID of the text (0, 1, 2... in first-use order)
+   */
+  uint32_t intern(std::string_view text);
+  /**===================================================
+   *
+   * Description: Get the ID of a text without storing it
+   *
+   * @param {std::string_view} text - text to look up
+   * @returns {uint32_t} ID of the text - NONE if never interned
+   */
+  uint32_t find(std::string_view text) const;
+  /**===================================================
+   *
+   * Description: Get the text behind an ID
+   *
+   * @param {uint32_t} id - ID from intern()
+   * @returns {const std::string&} interned text - empty for unknown IDs
+   */
+  const std::string &get(uint32_t id) const;
+  /**===================================================
+   *
+   * Description: Get number of distinct texts
+   *
+   * @param {none}
+   * @returns {size_t} number of IDs handed out
+   */
+  size_t size() const;
+  /**===================================================
+   *
+   * Description: Get bytes of interned text (without bookkeeping)
+   *
+   * @param {none}
+   * @returns {size_t} sum of all text lengths
+   */
+  size_t getTextBytes() const;
+  /**===================================================
+   *
+   * Description: Drop every text - IDs start again from 0
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+};
+
+#endif
@@ -0,0 +1,162 @@
+// TagCache.h
+// Persistent tag cache stored in a library root folder
+
+#ifndef TAG_CACHE_H
+#define TAG_CACHE_H
+
+#include "FileStamp.h"
+#include "Song.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class TagCache {
+public:
+  static constexpr uint32_t VERSION = 1;
+  static constexpr const char *FILE_NAME = ".musicplayer.tagcache";
+
+private:
+  struct Entry {
+    FileStamp stamp;
+    size_t duration = 0;
+    std::string title;
+    std::string artist;
+    std::string album;
+    bool seen = false; // looked up or stored since load()
+  };
+
+  std::string root;
+  std::unordered_map<std::string, Entry> entries; // key: path relative to root
+  mutable std::mutex mtx;
+  bool dirty = false;
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+
+  /**===================================================
+   *
+   * Description: Build map key of a file (path relative to root)
+   *
+   * @param {const std::string&} filePath - path as found by the walker
+   * @returns {std::string} key
+   */
+  std::string keyOf(const std::string &filePath) const;
+
+public:
+  /**===================================================
+   *
+   * Description: Construct empty cache for a library root folder
+   *
+   * @param {std::string} root - library root folder
+   * @returns {none}
+   */
+  explicit TagCache(std::string root);
+  /**===================================================
+   *
+   * Description: Get path of the cache file (root/FILE_NAME)
+   *
+   * @param {none}
+   * @returns {std::string} cache file path
+   */
+  std::string getCacheFile() const;
+  /**===================================================
+   *
+   * Description: Get the library root folder of the cache
+   *
+   * @param {none}
+   * @returns {const std::string&} root as given to the constructor
+   */
+  const std::string &getRoot() const;
+  /**===================================================
+   *
+   * Description: Load cache file - entries up to the first corrupt record
+   * are kept, a wrong magic/version discards the whole file
+   *
+   * @param {none}
+   * @returns {bool} true if the file was read without error
+   */
+  bool load();
+  /**===================================================
+   *
+   * Description: Write cache file if anything changed since load()
+   * - Written to a temporary file and renamed over the old one
+   *
+   * @param {none}
+   * @returns {bool} true if the file is up to date on disk
+   */
+  bool save();
+  /**===================================================
+   *
+   * Description: Fill song tags from cache if the file is unchanged
+   * - Thread-safe
+   *
+   * @param {const std::string&} filePath - path of audio file
+   * @param {const FileStamp&} stamp - current size and mtime
+   * @param {Song&} song - receives title, artist, album, duration
+   * @returns {bool} true on hit - false if missing or stale
+   */
+  bool lookup(const std::string &filePath, const FileStamp &stamp,
+              Song &song);
+  /**===================================================
+   *
+   * Description: Insert or replace tags of a file
+   * - Thread-safe
+   *
+   * @param {const std::string&} filePath - path of audio file
+   * @param {const FileStamp&} stamp - size and mtime the tags belong to
+   * @param {const Song&} song - song with tags read from file
+   * @returns {none}
+   */
+  void store(const std::string &filePath, const FileStamp &stamp,
+             const Song &song);
+  /**===================================================
+   *
+   * Description: Fill song tags from cache, or from reader on a miss
+   * (reader results are stored) - uses song.filePath and song.stamp
+   * - Thread-safe
+   *
+   * @param {Song&} song - song with filePath and stamp set
+   * @param {function} reader - tag reader called on a miss
+   * @returns {bool} true on hit
+   */
+  bool lookupOrRead(
+      Song &song,
+      const std::function<void(const std::string &, Song &)> &reader);
+  /**===================================================
+   *
+   * Description: Remove entries not looked up or stored since load()
+   * - Only meaningful after a complete scan of the root
+   *
+   * @param {none}
+   * @returns {size_t} number of stale entries removed
+   */
+  size_t prune();
+  /**===================================================
+   *
+   * Description: Get number of cached files
+   *
+   * @param {none}
+   * @returns {size_t} number of entries
+   */
+  size_t getSize() const;
+  /**===================================================
+   *
+   * Description: Get number of successful lookups
+   *
+   * @param {none}
+   * @returns {size_t} hits
+   */
+  size_t getHits() const;
+  /**===================================================
+   *
+   * Description: Get number of failed lookups
+   *
+   * @param {none}
+   * @returns {size_t} misses
+   */
+  size_t getMisses() const;
+};
+
+#endif
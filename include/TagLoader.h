@@ -0,0 +1,167 @@
+// TagLoader.h
+// Background tag reading for songs already in the library, by priority
+
+#ifndef TAG_LOADER_H
+#define TAG_LOADER_H
+
+#include "ImportPipeline.h"
+#include "Song.h"
+#include "TagCache.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Lower value is read first
+enum class TagPriority {
+  Visible = 0,    // rows on screen (most recently shown first)
+  Queued = 1,     // songs in the play queue
+  Background = 2, // everything else, in enqueue order
+};
+
+class TagLoader {
+private:
+  struct Entry {
+    Song song; // filePath, stamp and defaults set
+    std::shared_ptr<TagCache> cache;
+    TagPriority priority = TagPriority::Background;
+    uint64_t visibleCall = 0; // last prioritize(Visible) call it was in
+  };
+  // Heap item - stale once its entry was taken or moved to another priority
+  struct Ticket {
+    TagPriority priority;
+    int64_t order; // smaller first within a priority
+    int id;
+
+    bool operator<(const Ticket &other) const {
+      if (priority != other.priority) {
+        return priority > other.priority;
+      }
+      return order > other.order;
+    }
+  };
+
+  ImportPipeline::MetadataReader reader;
+  size_t workerCount;
+
+  std::mutex mtx;
+  std::condition_variable wake;
+  std::unordered_map<int, Entry> entries; // queued, by song ID
+  std::priority_queue<Ticket> tickets;
+  std::deque<Song> results;
+  int64_t tick = 0;
+  uint64_t visibleCalls = 0;
+  uint64_t epoch = 0; // bumped by clear() - drops reads in flight
+  size_t inFlight = 0;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+
+  /**===================================================
+   *
+   * Description: Worker body - read the most urgent queued song, repeat
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void run();
+  /**===================================================
+   *
+   * Description: Start the worker threads (once, mtx held)
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void ensureStarted();
+  /**===================================================
+   *
+   * Description: Push a heap ticket for an entry at its current priority
+   *
+   * @param {int} id - song ID
+   * @param {TagPriority} priority - priority of the entry
+   * @returns {none}
+   */
+  void pushTicket(int id, TagPriority priority);
+
+public:
+  /**===================================================
+   *
+   * Description: Construct loader (threads start with the first song)
+   *
+   * @param {MetadataReader} reader - tag reader (must be thread-safe)
+   * @param {size_t} workerCount - reader threads (0 = one per core)
+   * @returns {none}
+   */
+  explicit TagLoader(ImportPipeline::MetadataReader reader,
+                     size_t workerCount = 0);
+  /**===================================================
+   *
+   * Description: Destruct loader - stop and join the workers
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  ~TagLoader();
+  /**===================================================
+   *
+   * Description: Queue a song for tag reading at background priority
+   * - Read through the cache when given, the result is stored in it
+   *
+   * @param {const Song&} song - song as published (ID, path, stamp)
+   * @param {std::shared_ptr<TagCache>} cache - optional cache of its root
+   * @returns {none}
+   */
+  void enqueue(const Song &song, std::shared_ptr<TagCache> cache = nullptr);
+  /**===================================================
+   *
+   * Description: Move queued songs ahead (IDs not queued are ignored)
+   * - Visible: call once per frame with the rows on screen, rows shown
+   *   in the latest call go first
+   * - A song never moves back to a lower priority
+   *
+   * @param {const std::vector<int>&} ids - song IDs
+   * @param {TagPriority} priority - Visible or Queued
+   * @returns {none}
+   */
+  void prioritize(const std::vector<int> &ids, TagPriority priority);
+  /**===================================================
+   *
+   * Description: Take finished songs (never blocks)
+   *
+   * @param {std::vector<Song>&} out - receives songs with tags read
+   * @param {size_t} maxSongs - max songs taken
+   * @returns {size_t} number of songs taken
+   */
+  size_t takeResults(std::vector<Song> &out, size_t maxSongs);
+  /**===================================================
+   *
+   * Description: Get number of songs not delivered yet
+   *
+   * @param {none}
+   * @returns {size_t} songs queued, being read or waiting in results
+   */
+  size_t getPendingCount();
+  /**===================================================
+   *
+   * Description: Drop queued songs and unread results of some songs
+   * (e.g. of an unloaded folder) - a read in flight still finishes
+   *
+   * @param {const std::vector<int>&} ids - song IDs
+   * @returns {size_t} number of songs dropped
+   */
+  size_t cancel(const std::vector<int> &ids);
+  /**===================================================
+   *
+   * Description: Drop queued songs, unread results and reads in flight
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+};
+
+#endif
@@ -0,0 +1,59 @@
+// TextArena.h
+// Append-only text storage: strings packed back to back in large chunks
+
+#ifndef TEXT_ARENA_H
+#define TEXT_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class TextArena {
+private:
+  std::vector<std::unique_ptr<char[]>> chunks; // never move once allocated
+  size_t used = 0;     // bytes used in the last chunk
+  size_t chunkEnd = 0; // size of the last chunk
+  size_t textBytes = 0;
+  size_t chunkBytes = 0;
+
+public:
+  // Bytes per chunk - longer texts get a chunk of their own
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+  /**===================================================
+   *
+   * Description: Copy a text into the arena
+   * - Stored NUL-terminated, so data() is also a C string
+   *
+   * @param {std::string_view} text - text to copy
+   * @returns {std::string_view} stored copy - valid until clear()
+   */
+  std::string_view append(std::string_view text);
+  /**===================================================
+   *
+   * Description: Get bytes of text stored (without the NULs)
+   *
+   * @param {none}
+   * @returns {size_t} sum of all appended lengths
+   */
+  size_t getTextBytes() const;
+  /**===================================================
+   *
+   * Description: Get bytes allocated for chunks
+   *
+   * @param {none}
+   * @returns {size_t} total chunk size
+   */
+  size_t getChunkBytes() const;
+  /**===================================================
+   *
+   * Description: Free every chunk - all views handed out go invalid
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+};
+
+#endif
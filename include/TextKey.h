@@ -0,0 +1,75 @@
+// TextKey.h
+// Unicode normalization and precomputed comparison keys for metadata text.
+// Covers Latin letters built on A-Z (Vietnamese included): other text is
+// kept as-is and sorts after Latin by code point
+
+#ifndef TEXT_KEY_H
+#define TEXT_KEY_H
+
+#include <string>
+#include <string_view>
+
+// Both keys of one text, computed once at import
+struct TextKeys {
+  std::string sortKey;   // see makeSortKey()
+  std::string searchKey; // see makeSearchKey()
+};
+
+/**===================================================
+ *
+ * Description: Normalize UTF-8 text to NFC (precomposed letters)
+ * - "e" + U+0323 + U+0302 and U+1EC7 both become U+1EC7 (ệ)
+ * - Invalid UTF-8 bytes become U+FFFD
+ *
+ * @param {std::string_view} text - UTF-8 text
+ * @returns {std::string} NFC text
+ */
+std::string normalizeText(std::string_view text);
+
+/**===================================================
+ *
+ * Description: Build a collation key: comparing two keys byte by byte
+ * (memcmp, std::string_view::compare) orders the texts alphabetically
+ * - Vietnamese letter order: a ă â b c d đ e ê ... o ô ơ ... u ư ...
+ * - Letters decide first, then tones (none, huyền, hỏi, ngã, sắc, nặng)
+ *   and other marks, then case (lower first): an < ăn < ân < bạn
+ * - Punctuation < digits < letters < other scripts
+ *
+ * @param {std::string_view} text - UTF-8 text (any normalization form)
+ * @returns {std::string} binary key, no NUL bytes
+ */
+std::string makeSortKey(std::string_view text);
+
+/**===================================================
+ *
+ * Description: Build the letters-only part of the collation key
+ * - A prefix of a text gives a prefix of its sort key's letters part, so
+ *   prefix lookups ignore case and tones ("ha n" finds "Hà Nội"); letters
+ *   such as ô and đ still differ from o and d
+ *
+ * @param {std::string_view} text - UTF-8 text (any normalization form)
+ * @returns {std::string} binary key, no NUL bytes
+ */
+std::string makePrefixKey(std::string_view text);
+
+/**===================================================
+ *
+ * Description: Build a search key: case folded, marks stripped (đ -> d)
+ * - Substring match of search keys is a case and accent insensitive match
+ *   of the texts ("ha noi" is found in "Hà Nội")
+ *
+ * @param {std::string_view} text - UTF-8 text (any normalization form)
+ * @returns {std::string} UTF-8 key (ASCII for Latin text)
+ */
+std::string makeSearchKey(std::string_view text);
+
+/**===================================================
+ *
+ * Description: Build sort and search keys of a text in one call
+ *
+ * @param {std::string_view} text - UTF-8 text (any normalization form)
+ * @returns {TextKeys} both keys
+ */
+TextKeys makeTextKeys(std::string_view text);
+
+#endif
@@ -0,0 +1,68 @@
+// TextSearch.h
+// Substring search in folded text (search keys): SSE2/AVX2 kernels picked
+// at runtime, scalar fallback elsewhere. Case and accents are folded into
+// both haystack and needle beforehand (makeSearchKey()), so matching is a
+// byte comparison
+
+#ifndef TEXT_SEARCH_H
+#define TEXT_SEARCH_H
+
+#include <cstddef>
+#include <string_view>
+
+// Kernels from slowest to fastest
+enum class SimdLevel {
+  Scalar = 0,
+  SSE2 = 1,
+  AVX2 = 2,
+};
+
+/**===================================================
+ *
+ * Description: Get the best kernel this CPU runs (detected once)
+ *
+ * @param {none}
+ * @returns {SimdLevel} AVX2, SSE2 or Scalar
+ */
+SimdLevel detectSimdLevel();
+
+/**===================================================
+ *
+ * Description: Find the first occurrence of a needle
+ * - Each block compares the needle's first and last byte at every
+ *   position at once; only positions matching both are compared in full
+ * - Valid UTF-8 needles only match at character starts: a lead byte never
+ *   equals a continuation byte
+ *
+ * @param {std::string_view} haystack - folded text
+ * @param {std::string_view} needle - folded query
+ * @param {SimdLevel} level - kernel to use, lowered to what the CPU runs
+ * @returns {size_t} byte offset - std::string_view::npos if not found, 0
+ * for an empty needle
+ */
+size_t findText(std::string_view haystack, std::string_view needle,
+                SimdLevel level);
+
+/**===================================================
+ *
+ * Description: Find the first occurrence of a needle with the best kernel
+ *
+ * @param {std::string_view} haystack - folded text
+ * @param {std::string_view} needle - folded query
+ * @returns {size_t} byte offset - std::string_view::npos if not found
+ */
+size_t findText(std::string_view haystack, std::string_view needle);
+
+/**===================================================
+ *
+ * Description: Check if folded text contains a folded query
+ *
+ * @param {std::string_view} haystack - folded text
+ * @param {std::string_view} needle - folded query
+ * @returns {bool} true if found
+ */
+inline bool containsText(std::string_view haystack, std::string_view needle) {
+  return findText(haystack, needle) != std::string_view::npos;
+}
+
+#endif
@@ -0,0 +1,115 @@
+// TitleIndex.h
+// Flat sorted index of song titles: one contiguous array of (key, ID,
+// handle) entries, looked up by binary search. Duplicate titles are kept
+// side by side, ordered by song ID
+
+#ifndef TITLE_INDEX_H
+#define TITLE_INDEX_H
+
+#include "SongHandle.h"
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+class TitleIndex {
+public:
+  struct Entry {
+    std::string_view key; // views text owned by the library
+    int id;
+    SongHandle song; // null while erased, until the next settle()
+  };
+
+  // Contiguous run of entries, valid until the index changes
+  struct Range {
+    const Entry *first = nullptr;
+    const Entry *last = nullptr;
+
+    const Entry *begin() const { return first; }
+    const Entry *end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+  };
+
+private:
+  // [0, sortedCount) sorted by (key, ID), entries appended since after it.
+  // Lookups settle first, so they are const but not thread-safe
+  mutable std::vector<Entry> entries;
+  mutable size_t sortedCount = 0;
+  mutable size_t erasedCount = 0; // null entries in the sorted part
+
+  /**===================================================
+   *
+   * Description: Sort the appended entries into the sorted part
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void mergeAppended() const;
+
+public:
+  /**===================================================
+   *
+   * Description: Add an entry (appended, sorted in on the next settle())
+   *
+   * @param {std::string_view} key - title, must outlive the entry
+   * @param {int} id - song ID, orders equal titles
+   * @param {SongHandle} song - handle of the song
+   * @returns {none}
+   */
+  void insert(std::string_view key, int id, SongHandle song);
+  /**===================================================
+   *
+   * Description: Remove an entry (nulled in place, dropped on settle())
+   *
+   * @param {std::string_view} key - title the entry was added with
+   * @param {int} id - song ID the entry was added with
+   * @returns {bool} true if removed - false if not found
+   */
+  bool erase(std::string_view key, int id);
+  /**===================================================
+   *
+   * Description: Bring the array into sorted, compact order now
+   * - Sorts appended entries and merges them in, drops removed ones
+   * - Lookups do this on demand, call it to pay the cost up front
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void settle() const;
+  /**===================================================
+   *
+   * Description: Get all entries with exactly this key
+   *
+   * @param {std::string_view} key - title to look up
+   * @returns {Range} entries in song ID order, empty if none
+   */
+  Range equalRange(std::string_view key) const;
+  /**===================================================
+   *
+   * Description: Get all entries whose key starts with a prefix
+   *
+   * @param {std::string_view} prefix - start of title (empty: all)
+   * @returns {Range} entries in key order, empty if none
+   */
+  Range prefixRange(std::string_view prefix) const;
+  /**===================================================
+   *
+   * Description: Get every entry in key order
+   *
+   * @param {none}
+   * @returns {Range} all entries
+   */
+  Range all() const;
+  /**===================================================
+   *
+   * Description: Drop every entry and free the array
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+
+  size_t size() const { return entries.size() - erasedCount; }
+};
+
+#endif
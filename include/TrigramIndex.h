@@ -0,0 +1,105 @@
+// TrigramIndex.h
+// Inverted index of 3-byte substrings: trigram -> sorted list of document
+// IDs whose key contains it. A substring query only has to verify the
+// documents found in the lists of all its trigrams
+
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class TrigramIndex {
+private:
+  // [0, sortedCount) sorted and unique, IDs appended since after it
+  struct Postings {
+    std::vector<uint32_t> docs;
+    size_t sortedCount = 0;
+  };
+
+  // Lookups sort the lists they touch, so they are const but not
+  // thread-safe
+  mutable std::unordered_map<uint32_t, Postings> lists;
+  mutable size_t entryCount = 0; // postings in all lists, stale included
+  mutable size_t staleCount = 0; // postings of erased keys, still listed
+
+  /**===================================================
+   *
+   * Description: Collect the distinct trigrams of a text
+   *
+   * @param {std::string_view} text - key or query
+   * @param {std::vector<uint32_t>&} out - receives trigrams, sorted
+   * @returns {none}
+   */
+  static void trigramsOf(std::string_view text, std::vector<uint32_t> &out);
+  /**===================================================
+   *
+   * Description: Sort the appended IDs of one list into its sorted part
+   *
+   * @param {Postings&} list - list to settle
+   * @returns {none}
+   */
+  void settle(Postings &list) const;
+
+public:
+  // Shortest query the index can answer, shorter ones need a scan
+  static constexpr size_t MIN_QUERY = 3;
+
+  /**===================================================
+   *
+   * Description: Add a document (appended to its trigrams' lists)
+   * - Adding the same ID again (e.g. changed key) is fine: lists stay
+   *   duplicate-free
+   *
+   * @param {uint32_t} doc - document ID
+   * @param {std::string_view} key - its text (search key)
+   * @returns {none}
+   */
+  void insert(uint32_t doc, std::string_view key);
+  /**===================================================
+   *
+   * Description: Forget a document's key
+   * - Its postings stay until rebuilt (see needsRebuild()): candidates()
+   *   may still return it, callers verify every candidate anyway
+   *
+   * @param {std::string_view} key - text the document was added with
+   * @returns {none}
+   */
+  void erase(std::string_view key);
+  /**===================================================
+   *
+   * Description: Check if stale postings outnumber live ones
+   *
+   * @param {none}
+   * @returns {bool} true if clear() and re-inserting would pay off
+   */
+  bool needsRebuild() const;
+  /**===================================================
+   *
+   * Description: Find the documents whose key may contain a query
+   * - Intersects the lists of the query's trigrams, shortest first
+   * - Every document containing the query is returned, plus possibly some
+   *   that only share its trigrams or were erased - verify each one
+   *
+   * @param {std::string_view} query - at least MIN_QUERY bytes
+   * @param {std::vector<uint32_t>&} out - receives document IDs, sorted
+   * @returns {none}
+   */
+  void candidates(std::string_view query, std::vector<uint32_t> &out) const;
+  /**===================================================
+   *
+   * Description: Drop every list and free the memory
+   *
+   * @param {none}
+   * @returns {none}
+   */
+  void clear();
+
+  size_t getListCount() const { return lists.size(); }
+  size_t getEntryCount() const { return entryCount; }
+};
+
+#endif
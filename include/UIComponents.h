@@ -28,13 +28,14 @@ void showToast(const std::string &message);
 
 // Helper functions
 std::string formatTime(float seconds);
-bool containsString(const std::string &haystack, const std::string &needle);
 
 // Render functions
-void RenderSongItem(const Song *song, bool showAlbum = true,
+void RenderSongItem(const StoredSong *song, bool showAlbum = true,
+                    bool inQueue = false);
+void RenderSongItem(SongHandle handle, bool showAlbum = true,
                     bool inQueue = false);
 void RenderAlbumsTab();
-void RenderSmartPlaylistButton(const Song *current);
+void RenderSmartPlaylistButton(const StoredSong *current);
 void RenderToast();
 
 // Main render function for the entire UI
@@ -0,0 +1,432 @@
+// AutocompleteIndex.cpp
+
+#include "../include/AutocompleteIndex.h"
+#include <algorithm>
+
+AutocompleteIndex::AutocompleteIndex() { nodes.emplace_back(); }
+
+bool AutocompleteIndex::ranksBefore(uint32_t a, uint32_t b) const {
+  if (entries[a].weight != entries[b].weight) {
+    return entries[a].weight > entries[b].weight;
+  }
+  int order = keyOf(a).compare(keyOf(b));
+  return order != 0 ? order < 0 : entries[a].tag < entries[b].tag;
+}
+
+uint32_t AutocompleteIndex::newNode() {
+  if (!freeNodes.empty()) {
+    uint32_t node = freeNodes.back();
+    freeNodes.pop_back();
+    nodes[node] = Node();
+    return node;
+  }
+  nodes.emplace_back();
+  return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t AutocompleteIndex::findChild(uint32_t node, char byte) const {
+  for (uint32_t child = nodes[node].firstChild; child != NONE;
+       child = nodes[child].nextSibling) {
+    if (chars[nodes[child].labelOffset] == byte) {
+      return child;
+    }
+  }
+  return NONE;
+}
+
+void AutocompleteIndex::raiseInTop(uint32_t node, uint32_t entry) {
+  Node &target = nodes[node];
+  uint32_t pos = 0;
+  while (pos < target.topCount && target.top[pos] != entry) {
+    pos++;
+  }
+  if (pos == target.topCount) {
+    if (target.topCount < TOP_COUNT) {
+      target.topCount++;
+    } else if (ranksBefore(entry, target.top[TOP_COUNT - 1])) {
+      pos = TOP_COUNT - 1; // the worst one drops out
+    } else {
+      return;
+    }
+    target.top[pos] = entry;
+  }
+  for (; pos > 0 && ranksBefore(target.top[pos], target.top[pos - 1]);
+       pos--) {
+    std::swap(target.top[pos], target.top[pos - 1]);
+  }
+}
+
+void AutocompleteIndex::refillTop(uint32_t node) {
+  nodes[node].topCount = 0;
+  for (uint32_t entry = nodes[node].entries; entry != NONE;
+       entry = entries[entry].next) {
+    raiseInTop(node, entry);
+  }
+  // A child's list is its subtree's best: nothing past it can make ours
+  for (uint32_t child = nodes[node].firstChild; child != NONE;
+       child = nodes[child].nextSibling) {
+    for (uint32_t i = 0; i < nodes[child].topCount; i++) {
+      raiseInTop(node, nodes[child].top[i]);
+    }
+  }
+}
+
+bool AutocompleteIndex::walk(std::string_view key,
+                             std::vector<uint32_t> &path) const {
+  path.assign(1, 0);
+  uint32_t node = 0;
+  size_t depth = 0;
+  while (depth < key.size()) {
+    node = findChild(node, key[depth]);
+    if (node == NONE) {
+      return false;
+    }
+    std::string_view label(chars.data() + nodes[node].labelOffset,
+                           nodes[node].labelLength);
+    if (key.substr(depth, label.size()) != label) {
+      return false;
+    }
+    depth += label.size();
+    path.push_back(node);
+  }
+  return true;
+}
+
+uint32_t AutocompleteIndex::insertPath(uint32_t entry,
+                                       std::vector<uint32_t> &path) {
+  std::string_view key = keyOf(entry);
+  path.assign(1, 0);
+  uint32_t node = 0;
+  size_t depth = 0;
+  while (depth < key.size()) {
+    // Children are kept in first byte order: find the key's or its spot
+    uint32_t previous = NONE;
+    uint32_t child = nodes[node].firstChild;
+    while (child != NONE && static_cast<uint8_t>(
+                                chars[nodes[child].labelOffset]) <
+                                static_cast<uint8_t>(key[depth])) {
+      previous = child;
+      child = nodes[child].nextSibling;
+    }
+    if (child == NONE || chars[nodes[child].labelOffset] != key[depth]) {
+      uint32_t leaf = newNode();
+      nodes[leaf].labelOffset = entries[entry].keyOffset +
+                                static_cast<uint32_t>(depth);
+      nodes[leaf].labelLength = static_cast<uint32_t>(key.size() - depth);
+      nodes[leaf].nextSibling = child;
+      (previous == NONE ? nodes[node].firstChild
+                        : nodes[previous].nextSibling) = leaf;
+      path.push_back(leaf);
+      return leaf;
+    }
+
+    std::string_view label(chars.data() + nodes[child].labelOffset,
+                           nodes[child].labelLength);
+    size_t common = 1;
+    while (common < label.size() && depth + common < key.size() &&
+           label[common] == key[depth + common]) {
+      common++;
+    }
+    if (common < label.size()) {
+      // The key leaves the edge midway: split it, the new upper part
+      // holds the same subtree and so the same top list
+      uint32_t upper = newNode();
+      Node &lower = nodes[child];
+      nodes[upper].labelOffset = lower.labelOffset;
+      nodes[upper].labelLength = static_cast<uint32_t>(common);
+      nodes[upper].firstChild = child;
+      nodes[upper].nextSibling = lower.nextSibling;
+      nodes[upper].top = lower.top;
+      nodes[upper].topCount = lower.topCount;
+      lower.labelOffset += static_cast<uint32_t>(common);
+      lower.labelLength -= static_cast<uint32_t>(common);
+      lower.nextSibling = NONE;
+      (previous == NONE ? nodes[node].firstChild
+                        : nodes[previous].nextSibling) = upper;
+      child = upper;
+    }
+    node = child;
+    depth += common;
+    path.push_back(node);
+  }
+  return node;
+}
+
+void AutocompleteIndex::buildNode(const std::vector<uint32_t> &sorted,
+                                  size_t first, size_t last, size_t depth,
+                                  uint32_t node) {
+  size_t i = first;
+  for (; i < last && entries[sorted[i]].keyLength == depth; i++) {
+    entries[sorted[i]].node = node;
+    entries[sorted[i]].next = nodes[node].entries;
+    nodes[node].entries = sorted[i];
+  }
+  uint32_t previous = NONE;
+  while (i < last) {
+    // Keys sharing the next byte form one child; sorted, so the common
+    // prefix of the run is that of its first and last key
+    std::string_view key = keyOf(sorted[i]);
+    size_t end = i + 1;
+    while (end < last && keyOf(sorted[end])[depth] == key[depth]) {
+      end++;
+    }
+    std::string_view other = keyOf(sorted[end - 1]);
+    size_t common = depth + 1;
+    while (common < key.size() && common < other.size() &&
+           key[common] == other[common]) {
+      common++;
+    }
+    uint32_t child = newNode();
+    nodes[child].labelOffset =
+        entries[sorted[i]].keyOffset + static_cast<uint32_t>(depth);
+    nodes[child].labelLength = static_cast<uint32_t>(common - depth);
+    (previous == NONE ? nodes[node].firstChild
+                      : nodes[previous].nextSibling) = child;
+    previous = child;
+    buildNode(sorted, i, end, common, child);
+    i = end;
+  }
+  refillTop(node);
+}
+
+void AutocompleteIndex::build(std::vector<Item> items) {
+  items.erase(std::remove_if(items.begin(), items.end(),
+                             [](const Item &item) {
+                               return item.key.empty() || item.weight == 0;
+                             }),
+              items.end());
+  std::stable_sort(items.begin(), items.end(),
+                   [](const Item &a, const Item &b) {
+                     int order = a.key.compare(b.key);
+                     return order != 0 ? order < 0 : a.tag < b.tag;
+                   });
+  size_t bytes = 0;
+  for (const Item &item : items) {
+    bytes += item.key.size();
+  }
+  // The items may view our own bytes (see remove()): copy them out first
+  std::string packed;
+  packed.reserve(bytes);
+  std::vector<Entry> built;
+  built.reserve(items.size());
+  for (size_t i = 0; i < items.size(); i++) {
+    const Item &item = items[i];
+    if (i > 0 && item.key == items[i - 1].key) {
+      if (item.tag == items[i - 1].tag) {
+        built.back().weight += item.weight;
+        continue;
+      }
+    } else {
+      packed.append(item.key); // same key, other tag: bytes shared
+    }
+    Entry entry;
+    entry.text = item.text;
+    entry.keyOffset = static_cast<uint32_t>(packed.size() - item.key.size());
+    entry.keyLength = static_cast<uint32_t>(item.key.size());
+    entry.weight = item.weight;
+    entry.tag = item.tag;
+    built.push_back(entry);
+  }
+
+  packed.shrink_to_fit(); // reserved for every item, merged ones included
+  built.shrink_to_fit();
+  clear();
+  chars = std::move(packed);
+  entries = std::move(built);
+  entryCount = entries.size();
+  for (const Entry &entry : entries) {
+    liveChars += entry.keyLength;
+  }
+  nodes.reserve(entries.size() * 2);
+  std::vector<uint32_t> sorted(entries.size());
+  for (size_t i = 0; i < sorted.size(); i++) {
+    sorted[i] = static_cast<uint32_t>(i);
+  }
+  buildNode(sorted, 0, sorted.size(), 0, 0);
+  nodes.shrink_to_fit();
+}
+
+void AutocompleteIndex::add(std::string_view key, std::string_view text,
+                            uint8_t tag, uint32_t weight) {
+  if (key.empty() || weight == 0) {
+    return;
+  }
+  std::vector<uint32_t> path;
+  uint32_t shared = NONE; // entry with the same key, other tag
+  if (walk(key, path)) {
+    for (uint32_t entry = nodes[path.back()].entries; entry != NONE;
+         entry = entries[entry].next) {
+      if (entries[entry].tag == tag) {
+        entries[entry].weight += weight;
+        for (uint32_t node : path) {
+          raiseInTop(node, entry);
+        }
+        return;
+      }
+      shared = entry;
+    }
+  }
+
+  uint32_t entry;
+  if (!freeEntries.empty()) {
+    entry = freeEntries.back();
+    freeEntries.pop_back();
+  } else {
+    entries.emplace_back();
+    entry = static_cast<uint32_t>(entries.size() - 1);
+  }
+  Entry &created = entries[entry];
+  created = Entry();
+  created.text = text;
+  if (shared != NONE) {
+    created.keyOffset = entries[shared].keyOffset;
+  } else {
+    created.keyOffset = static_cast<uint32_t>(chars.size());
+    chars.append(key);
+  }
+  created.keyLength = static_cast<uint32_t>(key.size());
+  created.weight = weight;
+  created.tag = tag;
+  entryCount++;
+  liveChars += key.size();
+
+  uint32_t node = insertPath(entry, path);
+  entries[entry].node = node;
+  entries[entry].next = nodes[node].entries;
+  nodes[node].entries = entry;
+  for (uint32_t passed : path) {
+    raiseInTop(passed, entry);
+  }
+}
+
+bool AutocompleteIndex::remove(std::string_view key, uint8_t tag,
+                               uint32_t weight) {
+  std::vector<uint32_t> path;
+  if (key.empty() || !walk(key, path)) {
+    return false;
+  }
+  uint32_t *link = &nodes[path.back()].entries;
+  while (*link != NONE && entries[*link].tag != tag) {
+    link = &entries[*link].next;
+  }
+  uint32_t entry = *link;
+  if (entry == NONE) {
+    return false;
+  }
+  bool dropped = weight >= entries[entry].weight;
+  if (dropped) {
+    *link = entries[entry].next;
+    entries[entry].weight = 0;
+    entries[entry].node = NONE;
+    freeEntries.push_back(entry);
+    entryCount--;
+    liveChars -= key.size();
+  } else {
+    entries[entry].weight -= weight;
+  }
+
+  std::vector<size_t> depths(path.size(), 0); // key bytes above each node
+  for (size_t j = 1; j < path.size(); j++) {
+    depths[j] = depths[j - 1] + nodes[path[j - 1]].labelLength;
+  }
+  // Bottom-up, so every child's list is final before its parent's refill
+  for (size_t j = path.size(); j-- > 0;) {
+    uint32_t node = path[j];
+    Node &current = nodes[node];
+    if (j > 0 && dropped && current.entries == NONE) {
+      uint32_t child = current.firstChild;
+      if (child == NONE) {
+        // Empty leaf: unlink it from its parent
+        uint32_t *sibling = &nodes[path[j - 1]].firstChild;
+        while (*sibling != node) {
+          sibling = &nodes[*sibling].nextSibling;
+        }
+        *sibling = current.nextSibling;
+        freeNodes.push_back(node);
+        continue;
+      }
+      if (nodes[child].nextSibling == NONE) {
+        // Only one child left: fold it into this node. The merged label
+        // is a slice of any key below, e.g. the child's best one
+        const Node &only = nodes[child];
+        current.labelOffset = entries[only.top[0]].keyOffset +
+                              static_cast<uint32_t>(depths[j]);
+        current.labelLength += only.labelLength;
+        current.firstChild = only.firstChild;
+        current.entries = only.entries;
+        current.top = only.top;
+        current.topCount = only.topCount;
+        for (uint32_t moved = current.entries; moved != NONE;
+             moved = entries[moved].next) {
+          entries[moved].node = node;
+        }
+        freeNodes.push_back(child);
+        continue;
+      }
+    }
+    auto last = current.top.begin() + current.topCount;
+    if (std::find(current.top.begin(), last, entry) != last) {
+      refillTop(node);
+    }
+  }
+
+  // Removed keys leave their bytes behind: repack once they dominate
+  if (dropped && chars.size() > 4096 && chars.size() > 2 * liveChars) {
+    std::vector<Item> items;
+    items.reserve(entryCount);
+    for (uint32_t i = 0; i < entries.size(); i++) {
+      if (entries[i].weight > 0) {
+        items.push_back({keyOf(i), entries[i].text, entries[i].tag,
+                         entries[i].weight});
+      }
+    }
+    build(std::move(items));
+  }
+  return true;
+}
+
+std::vector<AutocompleteIndex::Suggestion>
+AutocompleteIndex::complete(std::string_view prefix, size_t limit) const {
+  std::vector<Suggestion> out;
+  uint32_t node = 0;
+  size_t depth = 0;
+  while (depth < prefix.size()) {
+    node = findChild(node, prefix[depth]);
+    if (node == NONE) {
+      return out;
+    }
+    // The prefix may end inside the label: every key below still fits
+    std::string_view label(chars.data() + nodes[node].labelOffset,
+                           nodes[node].labelLength);
+    std::string_view rest = prefix.substr(depth, label.size());
+    if (label.substr(0, rest.size()) != rest) {
+      return out;
+    }
+    depth += rest.size();
+  }
+  const Node &found = nodes[node];
+  size_t count = std::min<size_t>(limit, found.topCount);
+  out.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    const Entry &entry = entries[found.top[i]];
+    out.push_back({keyOf(found.top[i]), entry.text, entry.weight, entry.tag});
+  }
+  return out;
+}
+
+void AutocompleteIndex::clear() {
+  chars = std::string();
+  entries = std::vector<Entry>();
+  nodes = std::vector<Node>(1);
+  freeEntries = std::vector<uint32_t>();
+  freeNodes = std::vector<uint32_t>();
+  entryCount = 0;
+  liveChars = 0;
+}
+
+size_t AutocompleteIndex::getMemoryUsage() const {
+  return sizeof(*this) + chars.capacity() +
+         entries.capacity() * sizeof(Entry) +
+         nodes.capacity() * sizeof(Node) +
+         (freeEntries.capacity() + freeNodes.capacity()) * sizeof(uint32_t);
+}
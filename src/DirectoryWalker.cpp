@@ -0,0 +1,178 @@
+// DirectoryWalker.cpp
+
+#include "../include/DirectoryWalker.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+bool WalkOptions::matches(const fs::path &file) const {
+  std::string ext = file.extension().string();
+  for (const std::string &accepted : extensions) {
+    if (ext.size() == accepted.size() &&
+        std::equal(ext.begin(), ext.end(), accepted.begin(),
+                   [](char a, char b) {
+                     return std::tolower(static_cast<unsigned char>(a)) ==
+                            std::tolower(static_cast<unsigned char>(b));
+                   })) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Identity of a folder, equal for every path that reaches it
+static bool folderIdentity(const fs::path &dir, std::string &out) {
+#ifdef _WIN32
+  std::error_code ec;
+  fs::path real = fs::canonical(dir, ec);
+  out = real.string();
+  return !ec;
+#else
+  struct stat st;
+  if (::stat(dir.c_str(), &st) != 0) {
+    return false;
+  }
+  out = std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino);
+  return true;
+#endif
+}
+
+DirectoryWalker::DirectoryWalker(WalkOptions options)
+    : options(std::move(options)) {
+  if (this->options.threadCount == 0) {
+    this->options.threadCount =
+        2 * std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+size_t DirectoryWalker::getThreadCount() const { return options.threadCount; }
+
+size_t DirectoryWalker::walk(const std::string &root,
+                             const FileSink &sink) const {
+  struct Task {
+    fs::path dir;
+    int depth;
+  };
+  struct WorkDeque {
+    std::mutex mtx;
+    std::deque<Task> tasks;
+  };
+
+  size_t threadCount = options.threadCount;
+  std::vector<WorkDeque> deques(threadCount);
+  std::atomic<size_t> outstanding{1}; // queued + running folders
+  std::atomic<size_t> accepted{0};
+  std::atomic<bool> stopped{false};
+
+  // Loops only exist through links, so identities are only kept then
+  std::mutex visitedMutex;
+  std::unordered_set<std::string> visited;
+  auto firstVisit = [&](const fs::path &dir) {
+    std::string id;
+    if (!folderIdentity(dir, id)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(visitedMutex);
+    return visited.insert(std::move(id)).second;
+  };
+  if (options.followSymlinks) {
+    firstVisit(fs::path(root));
+  }
+  deques[0].tasks.push_back({fs::path(root), 0});
+
+  auto takeTask = [&](size_t self) -> std::optional<Task> {
+    {
+      WorkDeque &own = deques[self];
+      std::lock_guard<std::mutex> lock(own.mtx);
+      if (!own.tasks.empty()) {
+        Task task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return task;
+      }
+    }
+    for (size_t i = 1; i < threadCount; i++) {
+      WorkDeque &victim = deques[(self + i) % threadCount];
+      std::lock_guard<std::mutex> lock(victim.mtx);
+      if (!victim.tasks.empty()) {
+        Task task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return task;
+      }
+    }
+    return std::nullopt;
+  };
+
+  auto visitFolder = [&](const Task &task, size_t self) {
+    std::error_code ec;
+    for (fs::directory_iterator
+             it(task.dir, fs::directory_options::skip_permission_denied, ec),
+         end;
+         !ec && it != end && !stopped; it.increment(ec)) {
+      const fs::directory_entry &entry = *it;
+      std::error_code typeEc;
+      if (entry.is_directory(typeEc)) {
+        if (task.depth >= options.maxDepth) {
+          continue;
+        }
+        if (!options.followSymlinks && entry.is_symlink(typeEc)) {
+          continue;
+        }
+        if (options.followSymlinks && !firstVisit(entry.path())) {
+          continue; // loop, or reached before through a link
+        }
+        outstanding++;
+        std::lock_guard<std::mutex> lock(deques[self].mtx);
+        deques[self].tasks.push_back({entry.path(), task.depth + 1});
+      } else if (options.matches(entry.path())) {
+        fs::path file = entry.path();
+        if (!sink(std::move(file))) {
+          stopped = true;
+          return;
+        }
+        accepted++;
+      }
+    }
+  };
+
+  auto worker = [&](size_t self) {
+    int idleRounds = 0;
+    while (outstanding > 0 && !stopped) {
+      std::optional<Task> task = takeTask(self);
+      if (!task) {
+        // Others are still listing folders that may yield more work
+        if (++idleRounds < 64) {
+          std::this_thread::yield();
+        } else {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        continue;
+      }
+      idleRounds = 0;
+      visitFolder(*task, self);
+      outstanding--;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (size_t i = 1; i < threadCount; i++) {
+    threads.emplace_back(worker, i);
+  }
+  worker(0); // calling thread takes part
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return accepted;
+}
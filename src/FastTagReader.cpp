@@ -0,0 +1,527 @@
+// FastTagReader.cpp
+//
+// Anything unusual (unsynchronised or compressed ID3 tags, no valid MPEG
+// frame, RF64, missing fmt/data chunks) makes read() return false so the
+// caller can fall back to TagLib. Frames are only trusted when the next
+// frame header is consistent with them.
+
+#include "../include/FastTagReader.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// --- HELPERS: byte access ---
+
+// Random access reads, the first HEAD_SIZE bytes are read once and cached
+class FileBytes {
+private:
+  std::ifstream in;
+  uint64_t fileSize = 0;
+  std::vector<uint8_t> head;
+
+public:
+  bool open(const std::string &path) {
+    in.open(fs::u8path(path), std::ios::binary | std::ios::ate);
+    if (!in) {
+      return false;
+    }
+    fileSize = static_cast<uint64_t>(in.tellg());
+    head.resize(std::min<uint64_t>(fileSize, FastTagReader::HEAD_SIZE));
+    in.seekg(0);
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char *>(head.data()), head.size()));
+  }
+
+  uint64_t size() const { return fileSize; }
+
+  // Copy len bytes at offset into out - false if past the end
+  bool readAt(uint64_t offset, size_t len, std::vector<uint8_t> &out) {
+    if (offset > fileSize || len > fileSize - offset) {
+      return false;
+    }
+    out.resize(len);
+    if (offset + len <= head.size()) {
+      std::memcpy(out.data(), head.data() + offset, len);
+      return true;
+    }
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(offset));
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char *>(out.data()), len));
+  }
+};
+
+static uint32_t be32(const uint8_t *p) {
+  return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 |
+         p[3];
+}
+
+static uint32_t be24(const uint8_t *p) {
+  return uint32_t(p[0]) << 16 | uint32_t(p[1]) << 8 | p[2];
+}
+
+static uint32_t le32(const uint8_t *p) {
+  return uint32_t(p[3]) << 24 | uint32_t(p[2]) << 16 | uint32_t(p[1]) << 8 |
+         p[0];
+}
+
+static uint32_t syncsafe32(const uint8_t *p) {
+  return uint32_t(p[0] & 0x7F) << 21 | uint32_t(p[1] & 0x7F) << 14 |
+         uint32_t(p[2] & 0x7F) << 7 | (p[3] & 0x7F);
+}
+
+// --- HELPERS: text ---
+
+static void appendUtf8(std::string &out, uint32_t cp) {
+  if (cp < 0x80) {
+    out.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | cp >> 6));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | cp >> 12));
+    out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | cp >> 18));
+    out.push_back(static_cast<char>(0x80 | (cp >> 12 & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+static std::string latin1ToUtf8(const uint8_t *p, size_t n) {
+  std::string out;
+  out.reserve(n);
+  for (size_t i = 0; i < n && p[i] != 0; i++) {
+    appendUtf8(out, p[i]);
+  }
+  return out;
+}
+
+static std::string utf16ToUtf8(const uint8_t *p, size_t n, bool bigEndian) {
+  std::string out;
+  out.reserve(n / 2);
+  auto unit = [&](size_t i) -> uint32_t {
+    return bigEndian ? (p[i] << 8 | p[i + 1]) : (p[i + 1] << 8 | p[i]);
+  };
+  for (size_t i = 0; i + 1 < n; i += 2) {
+    uint32_t cp = unit(i);
+    if (cp == 0) {
+      break;
+    }
+    if (cp >= 0xD800 && cp < 0xDC00 && i + 3 < n) { // surrogate pair
+      uint32_t low = unit(i + 2);
+      if (low >= 0xDC00 && low < 0xE000) {
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        i += 2;
+      }
+    }
+    appendUtf8(out, cp);
+  }
+  return out;
+}
+
+static bool isValidUtf8(const uint8_t *p, size_t n) {
+  for (size_t i = 0; i < n;) {
+    size_t extra = p[i] < 0x80            ? 0
+                   : (p[i] >> 5) == 0x6  ? 1
+                   : (p[i] >> 4) == 0xE  ? 2
+                   : (p[i] >> 3) == 0x1E ? 3
+                                         : 4;
+    if (extra == 4 || extra >= n - i) {
+      return false; // invalid lead byte or truncated sequence
+    }
+    for (size_t k = 1; k <= extra; k++) {
+      if ((p[i + k] & 0xC0) != 0x80) {
+        return false;
+      }
+    }
+    i += extra + 1;
+  }
+  return true;
+}
+
+// NUL-terminated UTF-8 if it is valid UTF-8, Latin-1 otherwise
+static std::string utf8OrLatin1(const uint8_t *p, size_t n) {
+  n = std::find(p, p + n, 0) - p;
+  if (isValidUtf8(p, n)) {
+    return std::string(reinterpret_cast<const char *>(p), n);
+  }
+  return latin1ToUtf8(p, n);
+}
+
+// ID3v2 text frame body: encoding byte, then text
+static std::string decodeId3Text(const uint8_t *p, size_t n) {
+  if (n == 0) {
+    return {};
+  }
+  uint8_t encoding = p[0];
+  p++;
+  n--;
+  switch (encoding) {
+  case 0:
+    return latin1ToUtf8(p, n);
+  case 1: // UTF-16 with BOM
+    if (n >= 2 && p[0] == 0xFE && p[1] == 0xFF) {
+      return utf16ToUtf8(p + 2, n - 2, true);
+    }
+    if (n >= 2 && p[0] == 0xFF && p[1] == 0xFE) {
+      return utf16ToUtf8(p + 2, n - 2, false);
+    }
+    return utf16ToUtf8(p, n, false);
+  case 2:
+    return utf16ToUtf8(p, n, true);
+  case 3:
+    return utf8OrLatin1(p, n);
+  default:
+    return {};
+  }
+}
+
+static std::string trimRight(std::string s) {
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\0')) {
+    s.pop_back();
+  }
+  return s;
+}
+
+// --- ID3 ---
+
+struct TagFields {
+  std::string title;
+  std::string artist;
+  std::string album;
+
+  // Keep what is set, take the rest from a lower-priority tag
+  void fillFrom(const TagFields &other) {
+    if (title.empty()) {
+      title = other.title;
+    }
+    if (artist.empty()) {
+      artist = other.artist;
+    }
+    if (album.empty()) {
+      album = other.album;
+    }
+  }
+};
+
+// Parse an ID3v2 tag at offset. No tag: true with tagEnd == offset.
+static bool parseId3v2(FileBytes &file, uint64_t offset, TagFields &out,
+                       uint64_t &tagEnd) {
+  tagEnd = offset;
+  std::vector<uint8_t> buf;
+  if (!file.readAt(offset, 10, buf) || std::memcmp(buf.data(), "ID3", 3)) {
+    return true;
+  }
+  uint8_t major = buf[3];
+  uint8_t flags = buf[5];
+  uint32_t size = syncsafe32(&buf[6]);
+  if (major < 2 || major > 4 || (flags & 0x80)) {
+    return false; // unknown version or unsynchronised tag
+  }
+  uint64_t end = offset + 10 + size;
+  tagEnd = end + ((major == 4 && (flags & 0x10)) ? 10 : 0);
+
+  uint64_t pos = offset + 10;
+  if (flags & 0x40) {
+    if (major == 2) {
+      return false; // v2.2 compression
+    }
+    if (!file.readAt(pos, 4, buf)) {
+      return false;
+    }
+    pos += major == 3 ? 4 + be32(buf.data()) : syncsafe32(buf.data());
+  }
+
+  size_t headerSize = major == 2 ? 6 : 10;
+  while (pos + headerSize <= end && file.readAt(pos, headerSize, buf)) {
+    if (buf[0] == 0) {
+      break; // padding
+    }
+    std::string id(reinterpret_cast<const char *>(buf.data()),
+                   major == 2 ? 3 : 4);
+    uint32_t frameSize = major == 2   ? be24(&buf[3])
+                         : major == 3 ? be32(&buf[4])
+                                      : syncsafe32(&buf[4]);
+    uint8_t frameFlags = major == 2 ? 0 : buf[9];
+    uint64_t body = pos + headerSize;
+    if (frameSize > end - body) {
+      break;
+    }
+    pos = body + frameSize;
+
+    std::string *field = nullptr;
+    if (id == "TIT2" || id == "TT2") {
+      field = &out.title;
+    } else if (id == "TPE1" || id == "TP1") {
+      field = &out.artist;
+    } else if (id == "TALB" || id == "TAL") {
+      field = &out.album;
+    }
+    if (field == nullptr || !field->empty() || frameSize > 64 * 1024) {
+      continue;
+    }
+    // Compressed / encrypted / unsynchronised frames are left to TagLib
+    bool packed = major == 3 ? (frameFlags & 0xC0) != 0
+                             : major == 4 && (frameFlags & 0x0E) != 0;
+    if (packed) {
+      return false;
+    }
+    if (!file.readAt(body, frameSize, buf)) {
+      return false;
+    }
+    size_t skip = (major == 4 && (frameFlags & 0x01)) ? 4 : 0;
+    if (skip < buf.size()) {
+      *field = decodeId3Text(buf.data() + skip, buf.size() - skip);
+    }
+  }
+  return true;
+}
+
+// Parse the 128-byte ID3v1 tag at the end of the file, if any
+static bool parseId3v1(FileBytes &file, TagFields &out) {
+  std::vector<uint8_t> buf;
+  if (file.size() < 128 || !file.readAt(file.size() - 128, 128, buf) ||
+      std::memcmp(buf.data(), "TAG", 3) != 0) {
+    return false;
+  }
+  out.title = trimRight(latin1ToUtf8(&buf[3], 30));
+  out.artist = trimRight(latin1ToUtf8(&buf[33], 30));
+  out.album = trimRight(latin1ToUtf8(&buf[63], 30));
+  return true;
+}
+
+// --- MPEG ---
+
+struct MpegHeader {
+  int version;     // 1, 2 or 25 (MPEG 2.5)
+  int layer;       // 1, 2 or 3
+  int bitrate;     // [kbit/s]
+  int sampleRate;  // [Hz]
+  bool mono;
+  int samplesPerFrame;
+  size_t frameLength; // [byte] including header
+};
+
+static bool parseMpegHeader(const uint8_t *p, MpegHeader &h) {
+  static const int BITRATES[2][3][15] = {
+      {{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+       {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+       {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320}},
+      {{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+       {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+       {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}}};
+  static const int SAMPLE_RATES[3][3] = {
+      {44100, 48000, 32000}, {22050, 24000, 16000}, {11025, 12000, 8000}};
+
+  if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) {
+    return false;
+  }
+  int versionBits = p[1] >> 3 & 3;
+  int layerBits = p[1] >> 1 & 3;
+  int bitrateIndex = p[2] >> 4;
+  int rateIndex = p[2] >> 2 & 3;
+  if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 ||
+      bitrateIndex == 15 || rateIndex == 3) {
+    return false; // reserved values, free format
+  }
+  h.version = versionBits == 3 ? 1 : versionBits == 2 ? 2 : 25;
+  h.layer = 4 - layerBits;
+  int table = h.version == 1 ? 0 : 1;
+  h.bitrate = BITRATES[table][h.layer - 1][bitrateIndex];
+  h.sampleRate = SAMPLE_RATES[h.version == 1 ? 0 : h.version == 2 ? 1 : 2]
+                             [rateIndex];
+  h.mono = (p[3] >> 6) == 3;
+  int padding = p[2] >> 1 & 1;
+  if (h.layer == 1) {
+    h.samplesPerFrame = 384;
+    h.frameLength = (12 * h.bitrate * 1000 / h.sampleRate + padding) * 4;
+  } else {
+    h.samplesPerFrame = (h.layer == 3 && h.version != 1) ? 576 : 1152;
+    h.frameLength =
+        h.samplesPerFrame / 8 * h.bitrate * 1000 / h.sampleRate + padding;
+  }
+  return true;
+}
+
+// Total samples from a Xing/Info (+ LAME) or VBRI header - 0 if none
+static uint64_t vbrSamples(const uint8_t *frame, size_t size,
+                           const MpegHeader &h) {
+  size_t sideInfo = h.version == 1 ? (h.mono ? 17 : 32) : (h.mono ? 9 : 17);
+  size_t xing = 4 + sideInfo;
+  if (xing + 8 <= size && (std::memcmp(frame + xing, "Xing", 4) == 0 ||
+                           std::memcmp(frame + xing, "Info", 4) == 0)) {
+    uint32_t flags = be32(frame + xing + 4);
+    size_t pos = xing + 8;
+    if (!(flags & 0x1) || pos + 4 > size) {
+      return 0;
+    }
+    uint64_t samples = uint64_t(be32(frame + pos)) * h.samplesPerFrame;
+    pos += 4;
+    pos += (flags & 0x2) ? 4 : 0;   // byte count
+    pos += (flags & 0x4) ? 100 : 0; // seek table
+    pos += (flags & 0x8) ? 4 : 0;   // quality
+    // LAME tag: encoder delay / padding are not part of the song
+    if (pos + 24 <= size && (std::memcmp(frame + pos, "LAME", 4) == 0 ||
+                             std::memcmp(frame + pos, "Lavc", 4) == 0 ||
+                             std::memcmp(frame + pos, "Lavf", 4) == 0)) {
+      uint32_t gap = be24(frame + pos + 21);
+      uint64_t trimmed = (gap >> 12) + (gap & 0xFFF);
+      samples = samples > trimmed ? samples - trimmed : samples;
+    }
+    return samples;
+  }
+  size_t vbri = 4 + 32;
+  if (vbri + 18 <= size && std::memcmp(frame + vbri, "VBRI", 4) == 0) {
+    return uint64_t(be32(frame + vbri + 14)) * h.samplesPerFrame;
+  }
+  return 0;
+}
+
+static bool readMpeg(FileBytes &file, TagFields &tags, size_t &duration) {
+  uint64_t audioStart;
+  if (!parseId3v2(file, 0, tags, audioStart)) {
+    return false;
+  }
+  TagFields v1;
+  bool hasV1 = parseId3v1(file, v1);
+  uint64_t audioEnd = file.size() - (hasV1 ? 128 : 0);
+  if (audioStart >= audioEnd) {
+    return false;
+  }
+
+  // First frame whose successor (if buffered) agrees with it
+  std::vector<uint8_t> window;
+  size_t windowSize = static_cast<size_t>(std::min<uint64_t>(
+      FastTagReader::SYNC_WINDOW, audioEnd - audioStart));
+  if (!file.readAt(audioStart, windowSize, window)) {
+    return false;
+  }
+  MpegHeader h{};
+  size_t first = 0;
+  bool found = false;
+  for (; first + 4 <= window.size() && !found; first++) {
+    if (!parseMpegHeader(&window[first], h)) {
+      continue;
+    }
+    size_t next = first + h.frameLength;
+    MpegHeader n{};
+    found = next + 4 > window.size() ||
+            (parseMpegHeader(&window[next], n) && n.version == h.version &&
+             n.layer == h.layer && n.sampleRate == h.sampleRate);
+  }
+  if (!found) {
+    return false;
+  }
+  first--;
+
+  uint64_t samples = vbrSamples(&window[first], window.size() - first, h);
+  if (samples > 0) {
+    duration = static_cast<size_t>(samples / h.sampleRate);
+  } else { // CBR: bytes / bitrate
+    uint64_t audioBytes = audioEnd - (audioStart + first);
+    duration = static_cast<size_t>(audioBytes * 8 / (h.bitrate * 1000));
+  }
+
+  tags.fillFrom(v1);
+  return true;
+}
+
+// --- WAV ---
+
+static bool readWave(FileBytes &file, TagFields &tags, size_t &duration) {
+  std::vector<uint8_t> buf;
+  if (!file.readAt(0, 12, buf) || std::memcmp(buf.data(), "RIFF", 4) != 0 ||
+      std::memcmp(&buf[8], "WAVE", 4) != 0) {
+    return false;
+  }
+  uint32_t byteRate = 0;
+  uint64_t dataSize = 0;
+  bool hasData = false;
+  TagFields info;
+
+  uint64_t pos = 12;
+  while (pos + 8 <= file.size() && file.readAt(pos, 8, buf)) {
+    uint32_t chunkSize = le32(&buf[4]);
+    uint64_t body = pos + 8;
+    uint64_t available = file.size() - body;
+    if (std::memcmp(buf.data(), "fmt ", 4) == 0) {
+      if (chunkSize < 16 || !file.readAt(body, 16, buf)) {
+        return false;
+      }
+      byteRate = le32(&buf[8]);
+    } else if (std::memcmp(buf.data(), "data", 4) == 0) {
+      dataSize = std::min<uint64_t>(chunkSize, available);
+      hasData = true;
+    } else if (std::memcmp(buf.data(), "LIST", 4) == 0 && chunkSize >= 4 &&
+               chunkSize <= 64 * 1024 && file.readAt(body, chunkSize, buf) &&
+               std::memcmp(buf.data(), "INFO", 4) == 0) {
+      for (size_t i = 4; i + 8 <= buf.size();) {
+        uint32_t size = le32(&buf[i + 4]);
+        if (size > buf.size() - i - 8) {
+          break;
+        }
+        std::string text = trimRight(utf8OrLatin1(&buf[i + 8], size));
+        if (std::memcmp(&buf[i], "INAM", 4) == 0) {
+          info.title = text;
+        } else if (std::memcmp(&buf[i], "IART", 4) == 0) {
+          info.artist = text;
+        } else if (std::memcmp(&buf[i], "IPRD", 4) == 0) {
+          info.album = text;
+        }
+        i += 8 + size + (size & 1);
+      }
+    } else if (std::memcmp(buf.data(), "id3 ", 4) == 0 ||
+               std::memcmp(buf.data(), "ID3 ", 4) == 0) {
+      uint64_t tagEnd;
+      parseId3v2(file, body, tags, tagEnd);
+    }
+    pos = body + chunkSize + (chunkSize & 1); // chunks are word aligned
+  }
+  if (byteRate == 0 || !hasData) {
+    return false;
+  }
+  duration = static_cast<size_t>(dataSize / byteRate);
+  tags.fillFrom(info); // same priority as TagLib's RIFF::WAV::File
+  return true;
+}
+
+bool FastTagReader::read(const std::string &filePath, Song &song) {
+  std::string ext = fs::u8path(filePath).extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  if (ext != ".mp3" && ext != ".wav") {
+    return false;
+  }
+  FileBytes file;
+  if (!file.open(filePath)) {
+    return false;
+  }
+  // Nothing is written to song unless the whole file parsed
+  TagFields tags;
+  size_t duration = 0;
+  bool ok = ext == ".mp3" ? readMpeg(file, tags, duration)
+                          : readWave(file, tags, duration);
+  if (!ok) {
+    return false;
+  }
+  if (!tags.title.empty()) {
+    song.title = std::move(tags.title);
+  }
+  if (!tags.artist.empty()) {
+    song.artist = std::move(tags.artist);
+  }
+  if (!tags.album.empty()) {
+    song.album = std::move(tags.album);
+  }
+  song.duration = duration;
+  return true;
+}
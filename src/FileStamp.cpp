@@ -0,0 +1,32 @@
+// FileStamp.cpp
+
+#include "../include/FileStamp.h"
+#include <filesystem>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+
+bool statFile(const std::string &path, FileStamp &out) {
+#ifdef _WIN32
+  struct _stat64 st;
+  if (_wstat64(fs::u8path(path).wstring().c_str(), &st) != 0) {
+    return false;
+  }
+  out.size = st.st_size;
+  out.mtime = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#else
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0) {
+    return false;
+  }
+  out.size = st.st_size;
+#ifdef __APPLE__
+  out.mtime = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 +
+              st.st_mtimespec.tv_nsec;
+#else
+  out.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+              st.st_mtim.tv_nsec;
+#endif
+#endif
+  return true;
+}
@@ -0,0 +1,374 @@
+// FolderWatcher.cpp
+//
+// Events only mark paths dirty. Once the tree has been quiet for the
+// debounce time (or events kept coming for 10x as long) every dirty path
+// is stat'ed: existing files are re-read, missing ones reported removed.
+// Bursts of create/modify/move on one file therefore cost one tag read.
+
+#include "../include/FolderWatcher.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+FolderWatcher::FolderWatcher(ImportPipeline::MetadataReader reader,
+                             std::chrono::milliseconds debounce)
+    : reader(std::move(reader)), debounce(debounce) {}
+
+bool FolderWatcher::takeChanges(FolderChanges &out) {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (ready.empty()) {
+    return false;
+  }
+  out = std::move(ready.front());
+  ready.pop_front();
+  return true;
+}
+
+size_t FolderWatcher::getWatchCount() const { return watchCount; }
+
+#ifdef __linux__
+
+static const uint32_t WATCH_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE |
+                                   IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR |
+                                   IN_DONT_FOLLOW;
+
+FolderWatcher::~FolderWatcher() {
+  if (worker.joinable()) {
+    stopping = true;
+    uint64_t one = 1;
+    (void)!write(wakeFd, &one, sizeof(one));
+    worker.join();
+  }
+  if (inotifyFd >= 0) {
+    close(inotifyFd);
+  }
+  if (wakeFd >= 0) {
+    close(wakeFd);
+  }
+}
+
+bool FolderWatcher::isSupported() { return true; }
+
+bool FolderWatcher::ensureStarted() {
+  if (worker.joinable()) {
+    return true;
+  }
+  inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (inotifyFd < 0 || wakeFd < 0) {
+    std::cerr << "Error: Cannot start folder watcher" << std::endl;
+    return false;
+  }
+  worker = std::thread([this] { run(); });
+  return true;
+}
+
+bool FolderWatcher::addFolder(const std::string &root,
+                              const WalkOptions &options) {
+  if (!ensureStarted()) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    addRequests.push_back({root, options});
+  }
+  uint64_t one = 1;
+  (void)!write(wakeFd, &one, sizeof(one));
+  return true;
+}
+
+void FolderWatcher::removeFolder(const std::string &root) {
+  if (!worker.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    // An add still queued is simply dropped
+    addRequests.erase(std::remove_if(addRequests.begin(), addRequests.end(),
+                                     [&root](const Root &request) {
+                                       return request.path == root;
+                                     }),
+                      addRequests.end());
+    removeRequests.push_back(root);
+    ready.erase(std::remove_if(ready.begin(), ready.end(),
+                               [&root](const FolderChanges &changes) {
+                                 return changes.root == root;
+                               }),
+                ready.end());
+  }
+  uint64_t one = 1;
+  (void)!write(wakeFd, &one, sizeof(one));
+}
+
+void FolderWatcher::clear() {
+  if (!worker.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    addRequests.clear();
+    removeRequests.clear();
+    clearRequested = true;
+    ready.clear();
+  }
+  uint64_t one = 1;
+  (void)!write(wakeFd, &one, sizeof(one));
+}
+
+void FolderWatcher::run() {
+  while (!stopping) {
+    // Sleep without timeout unless a batch is waiting for its deadline
+    int timeout = -1;
+    if (hasPending) {
+      Clock::time_point deadline =
+          std::min(lastEvent + debounce, firstEvent + debounce * 10);
+      auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - Clock::now());
+      timeout = static_cast<int>(std::max<int64_t>(0, wait.count()));
+    }
+
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    if (poll(fds, 2, timeout) < 0 && errno != EINTR) {
+      std::cerr << "Error: Folder watcher stopped" << std::endl;
+      return;
+    }
+    if (fds[1].revents & POLLIN) {
+      uint64_t count;
+      (void)!read(wakeFd, &count, sizeof(count));
+      if (stopping) {
+        return;
+      }
+      handleRequests();
+    }
+    if (fds[0].revents & POLLIN) {
+      readEvents();
+    }
+    if (hasPending && (Clock::now() >= lastEvent + debounce ||
+                       Clock::now() >= firstEvent + debounce * 10)) {
+      flush();
+    }
+  }
+}
+
+void FolderWatcher::handleRequests() {
+  std::vector<Root> toAdd;
+  std::vector<std::string> toRemove;
+  bool toClear;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    toAdd.swap(addRequests);
+    toRemove.swap(removeRequests);
+    toClear = clearRequested;
+    clearRequested = false;
+  }
+  if (toClear) {
+    for (const auto &[wd, watch] : watches) {
+      inotify_rm_watch(inotifyFd, wd);
+    }
+    watches.clear();
+    roots.clear();
+    pending.clear();
+    hasPending = false;
+  }
+  for (const std::string &path : toRemove) {
+    auto root = std::find_if(roots.begin(), roots.end(),
+                             [&path](const Root &r) { return r.path == path; });
+    if (root == roots.end()) {
+      continue;
+    }
+    // Drop its watches, later roots move down one index
+    size_t index = root - roots.begin();
+    for (auto it = watches.begin(); it != watches.end();) {
+      if (it->second.root == index) {
+        inotify_rm_watch(inotifyFd, it->first);
+        it = watches.erase(it);
+        continue;
+      }
+      if (it->second.root > index) {
+        it->second.root--;
+      }
+      ++it;
+    }
+    roots.erase(root);
+    pending.erase(pending.begin() + index);
+  }
+  for (Root &root : toAdd) {
+    roots.push_back(std::move(root));
+    pending.emplace_back();
+    // The import reads what is there already
+    watchTree(roots.back().path, roots.size() - 1, 0, false);
+  }
+  watchCount = watches.size();
+}
+
+void FolderWatcher::readEvents() {
+  alignas(inotify_event) char buffer[64 * 1024];
+  ssize_t length;
+  while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+    for (char *p = buffer; p < buffer + length;) {
+      const inotify_event &event = *reinterpret_cast<inotify_event *>(p);
+      p += sizeof(inotify_event) + event.len;
+
+      if (event.mask & IN_Q_OVERFLOW) {
+        for (Pending &root : pending) {
+          root.overflow = true;
+        }
+      } else {
+        auto watch = watches.find(event.wd);
+        if (watch == watches.end()) {
+          continue;
+        }
+        if (event.mask & IN_IGNORED) { // directory is gone
+          watches.erase(watch);
+          continue;
+        }
+        if (event.len == 0) {
+          continue;
+        }
+        size_t root = watch->second.root;
+        int depth = watch->second.depth + 1;
+        std::string path =
+            (fs::path(watch->second.dir) / event.name).string();
+        if (event.mask & IN_ISDIR) {
+          if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+            if (depth <= roots[root].options.maxDepth) {
+              watchTree(path, root, depth, true);
+            }
+          } else if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+            unwatchTree(path);
+            pending[root].dirs.insert(path);
+          }
+        } else if (roots[root].options.matches(event.name)) {
+          pending[root].files.insert(path);
+        } else {
+          continue; // e.g. the tag cache being saved
+        }
+      }
+
+      Clock::time_point now = Clock::now();
+      if (!hasPending) {
+        firstEvent = now;
+        hasPending = true;
+      }
+      lastEvent = now;
+    }
+  }
+  watchCount = watches.size();
+}
+
+void FolderWatcher::watchTree(const std::string &dir, size_t root, int depth,
+                              bool markFiles) {
+  const WalkOptions &options = roots[root].options;
+  auto addWatch = [&](const std::string &path, int level) {
+    int wd = inotify_add_watch(inotifyFd, path.c_str(), WATCH_MASK);
+    if (wd >= 0) {
+      watches[wd] = {path, root, level};
+    } else if (errno == ENOSPC) {
+      std::cerr << "Error: inotify watch limit reached -> " << path
+                << std::endl;
+    }
+  };
+
+  addWatch(dir, depth);
+  std::error_code ec;
+  for (fs::recursive_directory_iterator
+           it(dir, fs::directory_options::skip_permission_denied, ec),
+       end;
+       !ec && it != end; it.increment(ec)) {
+    int level = depth + it.depth() + 1;
+    if (it->is_symlink(ec)) {
+      continue; // never followed, so no loops
+    }
+    if (it->is_directory(ec)) {
+      if (level > options.maxDepth) {
+        it.disable_recursion_pending();
+        continue;
+      }
+      addWatch(it->path().string(), level);
+    } else if (markFiles && options.matches(it->path())) {
+      pending[root].files.insert(it->path().string()); // moved-in tree
+    }
+  }
+}
+
+void FolderWatcher::unwatchTree(const std::string &dir) {
+  std::string prefix = (fs::path(dir) / "").string();
+  for (auto it = watches.begin(); it != watches.end();) {
+    const std::string &path = it->second.dir;
+    if (path == dir || path.compare(0, prefix.size(), prefix) == 0) {
+      inotify_rm_watch(inotifyFd, it->first);
+      it = watches.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void FolderWatcher::flush() {
+  for (size_t i = 0; i < roots.size(); i++) {
+    Pending &dirty = pending[i];
+    if (dirty.files.empty() && dirty.dirs.empty() && !dirty.overflow) {
+      continue;
+    }
+    FolderChanges changes;
+    changes.root = roots[i].path;
+    changes.overflow = dirty.overflow;
+
+    // Final state on disk decides, whatever the event order was
+    std::vector<std::string> existing;
+    for (const std::string &file : dirty.files) {
+      FileStamp stamp;
+      if (statFile(file, stamp)) {
+        existing.push_back(file);
+      } else {
+        changes.removed.push_back(file);
+      }
+    }
+    for (const std::string &dir : dirty.dirs) {
+      std::error_code ec;
+      if (!fs::is_directory(dir, ec)) {
+        changes.removedDirs.push_back(dir);
+      }
+    }
+    ImportPipeline pipeline;
+    pipeline.run(existing, reader, [&changes](Song &&song) {
+      changes.upserts.push_back(std::move(song));
+    });
+
+    dirty = Pending();
+    std::lock_guard<std::mutex> lock(mtx);
+    // Read before clear() / removeFolder() - no longer wanted
+    bool removed = std::find(removeRequests.begin(), removeRequests.end(),
+                             changes.root) != removeRequests.end();
+    if (!clearRequested && !removed) {
+      ready.push_back(std::move(changes));
+    }
+  }
+  hasPending = false;
+}
+
+#else
+
+FolderWatcher::~FolderWatcher() {}
+
+bool FolderWatcher::isSupported() { return false; }
+
+bool FolderWatcher::addFolder(const std::string &, const WalkOptions &) {
+  return false;
+}
+
+void FolderWatcher::removeFolder(const std::string &) {}
+
+void FolderWatcher::clear() {}
+
+#endif
@@ -0,0 +1,82 @@
+// FuzzyPattern.cpp
+
+#include "../include/FuzzyPattern.h"
+#include <algorithm>
+
+static size_t countBits(uint64_t bits) {
+  size_t count = 0;
+  for (; bits != 0; bits &= bits - 1) {
+    count++;
+  }
+  return count;
+}
+
+FuzzyPattern::FuzzyPattern(std::string_view key) {
+  length = std::min(key.size(), MAX_LENGTH);
+  for (size_t i = 0; i < length; i++) {
+    peq[static_cast<uint8_t>(key[i])] |= uint64_t(1) << i;
+  }
+  for (size_t i = 1; i < length; i++) {
+    size_t pair = (key[i - 1] & 31) << 5 | (key[i] & 31);
+    pairs[pair] |= uint64_t(1) << i;
+  }
+  highBit = length > 0 ? uint64_t(1) << (length - 1) : 0;
+}
+
+size_t FuzzyPattern::distance(std::string_view text, size_t maxErrors) const {
+  if (length == 0) {
+    return 0;
+  }
+  uint64_t mask = length == MAX_LENGTH ? ~uint64_t(0)
+                                       : (uint64_t(1) << length) - 1;
+  // Cheap filter first: a pattern byte the text never holds costs an edit,
+  // and one edit breaks at most two byte pairs (q-gram lemma). Pairs are
+  // told apart by 5 bits per byte: a collision only lets a text through
+  uint64_t letters = 0;
+  uint64_t letterPairs = 0;
+  size_t pair = 0;
+  for (char ch : text) {
+    letters |= peq[static_cast<uint8_t>(ch)];
+    pair = (pair << 5 | (ch & 31)) & 1023;
+    letterPairs |= pairs[pair];
+  }
+  if (countBits(mask & ~letters) > maxErrors ||
+      countBits((mask - 1) & ~letterPairs) > 2 * maxErrors) {
+    return maxErrors + 1;
+  }
+
+  // Column of the DP table as vertical +1/-1 deltas (Pv/Mv); the pattern
+  // may start anywhere in the text, so row 0 stays 0
+  uint64_t pv = mask;
+  uint64_t mv = 0;
+  size_t score = length;
+  size_t best = length;
+  for (char ch : text) {
+    uint64_t eq = peq[static_cast<uint8_t>(ch)];
+    uint64_t xv = eq | mv;
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    if (ph & highBit) {
+      score++;
+    } else if (mh & highBit) {
+      score--;
+    }
+    ph <<= 1;
+    mh <<= 1;
+    pv = (mh | ~(xv | ph)) & mask;
+    mv = ph & xv;
+    best = std::min(best, score);
+    if (best == 0) {
+      break;
+    }
+  }
+  return std::min(best, maxErrors + 1);
+}
+
+size_t FuzzyPattern::getMaxErrors() const {
+  if (length < 4) {
+    return 0;
+  }
+  return std::min<size_t>(3, (length - 4) / 4 + 1);
+}
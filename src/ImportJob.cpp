@@ -0,0 +1,180 @@
+// ImportJob.cpp
+
+#include "../include/ImportJob.h"
+#include <string_view>
+
+ImportJob::ImportJob(std::string path, size_t batchSize)
+    : path(std::move(path)), batchSize(batchSize ? batchSize : 1),
+      future(promise.get_future().share()) {}
+
+ImportJob::~ImportJob() {
+  cancel();
+  if (worker.joinable()) {
+    worker.join();
+  }
+}
+
+void ImportJob::setTagCache(std::shared_ptr<TagCache> cache) {
+  tagCache = std::move(cache);
+}
+
+void ImportJob::setKnownFiles(
+    std::unordered_map<std::string, FileStamp> files) {
+  known = std::move(files);
+  rescan = true;
+}
+
+bool ImportJob::isRescan() const { return rescan; }
+
+void ImportJob::setWalkOptions(WalkOptions options) {
+  walkOptions = std::move(options);
+}
+
+void ImportJob::setLazyTags(bool lazy) { lazyTags = lazy; }
+
+bool ImportJob::isLazyTags() const { return lazyTags; }
+
+std::shared_ptr<TagCache> ImportJob::getTagCache() const { return tagCache; }
+
+void ImportJob::start(ImportPipeline::MetadataReader reader) {
+  worker = std::thread([this, reader = std::move(reader)] {
+    ImportPipeline::MetadataReader read = reader;
+    if (tagCache) {
+      tagCache->load();
+    }
+    if (lazyTags) {
+      // Only cached tags now, the rest is read once the song is listed
+      read = [this, cache = tagCache.get()](const std::string &filePath,
+                                            Song &song) {
+        if (cache == nullptr || !cache->lookup(filePath, song.stamp, song)) {
+          std::lock_guard<std::mutex> lock(untaggedMutex);
+          untagged.insert(filePath);
+        }
+      };
+    } else if (tagCache) {
+      // Unchanged files cost no tag read, everything else goes to reader
+      read = [cache = tagCache.get(), &reader](const std::string &,
+                                               Song &song) {
+        cache->lookupOrRead(song, reader);
+      };
+    }
+    if (rescan) {
+      // Files loaded with the same stamp cost no tag read
+      read = [this, scan = std::move(read)](const std::string &filePath,
+                                            Song &song) {
+        auto file = known.find(filePath);
+        if (file == known.end() || file->second != song.stamp) {
+          scan(filePath, song);
+        }
+      };
+    }
+
+    std::unordered_set<std::string_view> seen; // known files found again
+    ImportPipeline pipeline(0, 256, walkOptions);
+    ImportStats stats = pipeline.run(
+        path, read,
+        [this, &seen](Song &&song) {
+          if (rescan) {
+            auto file = known.find(song.filePath);
+            if (file != known.end()) {
+              seen.insert(file->first);
+              if (file->second == song.stamp) {
+                return; // unchanged, nothing to publish
+              }
+            }
+          }
+          filling.push_back(std::move(song));
+          if (filling.size() >= batchSize) {
+            flush();
+          }
+        },
+        &progress);
+    if (!progress.cancelled) {
+      flush();
+    }
+    if (rescan && !progress.cancelled) {
+      for (const auto &[file, stamp] : known) {
+        if (seen.count(file) == 0) {
+          removed.push_back(file);
+        }
+      }
+    }
+    if (tagCache) {
+      stats.cacheHits = tagCache->getHits();
+      // Only a complete import knows what was deleted - a rescan never
+      // looks up unchanged files
+      if (!progress.cancelled && !rescan) {
+        tagCache->prune();
+      }
+      tagCache->save();
+    }
+    finished = true;
+    promise.set_value(stats);
+  });
+}
+
+void ImportJob::flush() {
+  if (filling.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(batchMutex);
+  readyBatches.push_back(std::move(filling));
+  filling.clear();
+  filling.reserve(batchSize);
+}
+
+const std::string &ImportJob::getPath() const { return path; }
+
+size_t ImportJob::getFilesFound() const { return progress.filesFound; }
+
+size_t ImportJob::getFilesRead() const { return progress.filesRead; }
+
+size_t ImportJob::getSongsPublished() const { return songsPublished; }
+
+bool ImportJob::isFinished() const { return finished; }
+
+void ImportJob::cancel() { progress.cancelled = true; }
+
+bool ImportJob::isCancelled() const { return progress.cancelled; }
+
+std::shared_future<ImportStats> ImportJob::getFuture() const {
+  return future;
+}
+
+void ImportJob::wait() const { future.wait(); }
+
+bool ImportJob::takeBatch(std::vector<Song> &out) {
+  std::lock_guard<std::mutex> lock(batchMutex);
+  if (readyBatches.empty() || progress.cancelled) {
+    return false;
+  }
+  out = std::move(readyBatches.front());
+  readyBatches.pop_front();
+  return true;
+}
+
+void ImportJob::markPublished(size_t count) { songsPublished += count; }
+
+void ImportJob::takeUntagged(const std::vector<Song> &batch,
+                             std::vector<std::string> &paths) {
+  if (!lazyTags) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(untaggedMutex);
+  for (const Song &song : batch) {
+    if (untagged.erase(song.filePath) > 0) {
+      paths.push_back(song.filePath);
+    }
+  }
+}
+
+bool ImportJob::isDrained() {
+  std::lock_guard<std::mutex> lock(batchMutex);
+  return finished && (readyBatches.empty() || progress.cancelled);
+}
+
+std::vector<std::string> ImportJob::takeRemoved() {
+  std::vector<std::string> paths;
+  paths.swap(removed);
+  return paths;
+}
@@ -0,0 +1,134 @@
+// ImportPipeline.cpp
+
+#include "../include/ImportPipeline.h"
+#include "../include/BoundedQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+ImportPipeline::ImportPipeline(size_t workerCount, size_t queueCapacity,
+                               WalkOptions walkOptions)
+    : workerCount(workerCount), queueCapacity(queueCapacity),
+      walkOptions(std::move(walkOptions)) {
+  if (this->workerCount == 0) {
+    this->workerCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+size_t ImportPipeline::getWorkerCount() const { return workerCount; }
+
+ImportStats ImportPipeline::run(const std::string &path,
+                                const MetadataReader &reader,
+                                const SongSink &sink,
+                                ImportProgress *progress) const {
+  DirectoryWalker walker(walkOptions);
+  return runFrom(
+      [&](const DirectoryWalker::FileSink &emit) { walker.walk(path, emit); },
+      reader, sink, progress);
+}
+
+ImportStats ImportPipeline::run(const std::vector<std::string> &files,
+                                const MetadataReader &reader,
+                                const SongSink &sink,
+                                ImportProgress *progress) const {
+  return runFrom(
+      [&files](const DirectoryWalker::FileSink &emit) {
+        for (const std::string &file : files) {
+          if (!emit(fs::path(file))) {
+            return;
+          }
+        }
+      },
+      reader, sink, progress);
+}
+
+ImportStats ImportPipeline::runFrom(const PathSource &source,
+                                    const MetadataReader &reader,
+                                    const SongSink &sink,
+                                    ImportProgress *progress) const {
+  ImportStats stats;
+  stats.workerCount = workerCount;
+
+  ImportProgress localProgress;
+  ImportProgress &live = progress ? *progress : localProgress;
+
+  BoundedQueue<fs::path> pathQueue(queueCapacity);
+  BoundedQueue<Song> songQueue(queueCapacity);
+  std::atomic<size_t> filesWalked{0};
+  std::atomic<size_t> tagsRead{0};
+  std::atomic<size_t> activeWorkers{workerCount};
+  Clock::time_point start = Clock::now();
+
+  // --- Stage 1: directory walker ---
+  std::thread walker([&] {
+    source([&](fs::path &&file) {
+      if (live.cancelled) {
+        return false;
+      }
+      pathQueue.push(std::move(file));
+      filesWalked++;
+      live.filesFound++;
+      return true;
+    });
+    stats.walker.seconds = secondsSince(start);
+    pathQueue.close(); // workers drain what is left, then stop
+  });
+
+  // --- Stage 2: tag reader pool ---
+  std::vector<std::thread> workers;
+  workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; i++) {
+    workers.emplace_back([&] {
+      while (std::optional<fs::path> file = pathQueue.pop()) {
+        if (live.cancelled) {
+          continue; // keep draining so the walker never blocks
+        }
+        Song newSong;
+        newSong.filePath = file->string();
+        statFile(newSong.filePath, newSong.stamp);
+
+        // Default metadata
+        newSong.title = file->stem().string();
+        newSong.artist = "Unknown Artist";
+        newSong.album = "Unknown Album";
+
+        reader(newSong.filePath, newSong);
+        tagsRead++;
+        live.filesRead++;
+        songQueue.push(std::move(newSong));
+      }
+      if (--activeWorkers == 0) {
+        stats.reader.seconds = secondsSince(start);
+        songQueue.close(); // last worker out lets the indexer finish
+      }
+    });
+  }
+
+  // --- Stage 3: indexer (calling thread owns the library) ---
+  while (std::optional<Song> song = songQueue.pop()) {
+    if (live.cancelled) {
+      continue;
+    }
+    sink(std::move(*song));
+    stats.indexer.files++;
+  }
+  stats.indexer.seconds = secondsSince(start);
+
+  walker.join();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  stats.walker.files = filesWalked;
+  stats.reader.files = tagsRead;
+  return stats;
+}
@@ -1,44 +1,628 @@
 // MusicLibrary.cpp
 
 #include "../include/MusicLibrary.h"
+#include "../include/TextSearch.h"
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <thread>
 
-MusicLibrary::MusicLibrary() { songs.reserve(1000); }
+MusicLibrary::MusicLibrary() {}
 
 MusicLibrary::~MusicLibrary() {}
 
-const std::vector<Song> &MusicLibrary::getAllSongs() const { return songs; }
+const SongStore &MusicLibrary::getAllSongs() const { return songs; }
 
-bool MusicLibrary::addSong(const Song &song) {
-  bool reallocated = false;
-  if (songs.size() >= songs.capacity()) {
-    reallocated = true;
-    std::cout << "Vector Reallocation" << std::endl;
+const SongColumns &MusicLibrary::getColumns() const { return columns; }
+
+MusicLibrary::PreparedText MusicLibrary::prepare(const Song &song) {
+  PreparedText prepared;
+  prepared.title = normalizeText(song.title);
+  prepared.artist = normalizeText(song.artist);
+  prepared.album = normalizeText(song.album);
+  prepared.titleKeys = makeTextKeys(prepared.title);
+  return prepared;
+}
+
+uint32_t MusicLibrary::internName(StringPool &pool, std::vector<TextKeys> &keys,
+                                  TrigramIndex &trigrams,
+                                  const std::string &name) {
+  uint32_t id = pool.intern(name);
+  if (id == keys.size()) {
+    keys.push_back(makeTextKeys(name)); // first song with this name
+    trigrams.insert(id, keys.back().searchKey);
+  }
+  return id;
+}
+
+bool MusicLibrary::store(const Song &song, const PreparedText &prepared,
+                         uint32_t partition) {
+  uint32_t handleSlot;
+  if (!freeHandles.empty()) {
+    handleSlot = freeHandles.front();
+    freeHandles.pop_front();
+  } else {
+    handleSlot = static_cast<uint32_t>(handles.size());
+    handles.emplace_back();
+  }
+  HandleEntry &entry = handles[handleSlot];
+  version++;
+  entry.songSlot = static_cast<uint32_t>(songs.size());
+  slotHandles.push_back(handleSlot);
+  std::vector<SongHandle> &members = partitionSongs[partition];
+  entry.partition = partition;
+  entry.partitionPos = static_cast<uint32_t>(members.size());
+  members.emplace_back(handleSlot, entry.generation);
+
+  StoredSong record;
+  record.id = static_cast<int>(songIndexByID.size());
+  songIndexByID.emplace_back(handleSlot, entry.generation);
+  record.artistId =
+      internName(artists, artistKeys, artistTrigrams, prepared.artist);
+  record.albumId = internName(albums, albumKeys, albumTrigrams, prepared.album);
+  record.duration = static_cast<uint32_t>(song.duration);
+  record.title = text.append(prepared.title);
+  record.filePath = text.append(song.filePath);
+  record.stamp = song.stamp;
+  columns.push_back(record, {text.append(prepared.titleKeys.sortKey),
+                             text.append(prepared.titleKeys.searchKey)});
+  return songs.push_back(record);
+}
+
+void MusicLibrary::releaseHandle(uint32_t handleSlot) {
+  HandleEntry &entry = handles[handleSlot];
+  if (entry.generation == SongHandle::GENERATION_MASK) {
+    entry.songSlot = SongHandle::NONE; // retired: resolves to nothing
+    return;
+  }
+  entry.generation++;
+  freeHandles.push_back(handleSlot);
+}
+
+size_t MusicLibrary::getHandleRoom() const {
+  return freeHandles.size() + MAX_SONGS - handles.size();
+}
+
+SongHandle MusicLibrary::slotHandle(size_t songSlot) const {
+  uint32_t handleSlot = slotHandles[songSlot];
+  return SongHandle(handleSlot, handles[handleSlot].generation);
+}
+
+bool MusicLibrary::addSong(const Song &song, uint32_t partition) {
+  if (getHandleRoom() == 0) {
+    std::cerr << "Error: Library full (" << MAX_SONGS << " songs)"
+              << std::endl;
+    return false;
+  }
+  bool allocated = store(song, prepare(song), partition);
+  indexSong(songs.back(), slotHandle(songs.size() - 1));
+  return allocated;
+}
+
+bool MusicLibrary::addSongs(std::vector<Song> &&batch, uint32_t partition) {
+  if (batch.size() > getHandleRoom()) {
+    std::cerr << "Error: Library full (" << MAX_SONGS << " songs)"
+              << std::endl;
+    batch.resize(getHandleRoom());
+  }
+  if (batch.empty()) {
+    return false;
+  }
+  // Normalizing is the costly part of storing: split it over threads
+  std::vector<PreparedText> prepared(batch.size());
+  size_t parts = std::max(1u, std::thread::hardware_concurrency());
+  if (batch.size() < PARALLEL_INDEX_MIN) {
+    parts = 1;
+  }
+  std::vector<std::thread> threads;
+  for (size_t part = 1; part < parts; part++) {
+    threads.emplace_back([&, part] {
+      size_t end = batch.size() * (part + 1) / parts;
+      for (size_t i = batch.size() * part / parts; i < end; i++) {
+        prepared[i] = prepare(batch[i]);
+      }
+    });
+  }
+  for (size_t i = 0; i < batch.size() / parts; i++) {
+    prepared[i] = prepare(batch[i]);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  size_t first = songs.size();
+  bool allocated = songs.reserve(first + batch.size());
+  columns.reserve(first + batch.size());
+  if (first + batch.size() > slotHandles.capacity()) {
+    slotHandles.reserve(
+        std::max(first + batch.size(), slotHandles.capacity() * 2));
+  }
+  for (size_t i = 0; i < batch.size(); i++) {
+    store(batch[i], prepared[i], partition);
+  }
+  batch.clear();
+  indexRange(first);
+  return allocated;
+}
+
+// Remove one handle from a group index, dropping the group once empty
+template <typename GroupMap>
+static void eraseFromGroup(GroupMap &index, uint32_t key, SongHandle handle) {
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return;
+  }
+  std::vector<SongHandle> &group = it->second;
+  group.erase(std::remove(group.begin(), group.end(), handle), group.end());
+  if (group.empty()) {
+    index.erase(it);
+  }
+}
+
+void MusicLibrary::indexSong(const StoredSong &song, SongHandle handle) {
+  uint32_t slot = handles[handle.slot()].songSlot;
+  songIndexByTitle.insert(columns.titleSortKeys[slot], song.id, handle);
+  titleTrigrams.insert(song.id, columns.titleSearchKeys[slot]);
+  songIndexByPath[song.filePath] = handle;
+  artistIndex[song.artistId].push_back(handle);
+  albumIndex[song.albumId].push_back(handle);
+  addCompletions(slot);
+  sortInsert(handle);
+}
+
+void MusicLibrary::addCompletions(size_t slot) {
+  const StoredSong &song = songs[slot];
+  completions.add(columns.titleSearchKeys[slot], song.title,
+                  static_cast<uint8_t>(SearchField::Title));
+  completions.add(artistKeys[song.artistId].searchKey,
+                  artists.get(song.artistId),
+                  static_cast<uint8_t>(SearchField::Artist));
+  completions.add(albumKeys[song.albumId].searchKey, albums.get(song.albumId),
+                  static_cast<uint8_t>(SearchField::Album));
+}
+
+void MusicLibrary::removeCompletions(size_t slot) {
+  const StoredSong &song = songs[slot];
+  completions.remove(columns.titleSearchKeys[slot],
+                     static_cast<uint8_t>(SearchField::Title));
+  completions.remove(artistKeys[song.artistId].searchKey,
+                     static_cast<uint8_t>(SearchField::Artist));
+  completions.remove(albumKeys[song.albumId].searchKey,
+                     static_cast<uint8_t>(SearchField::Album));
+}
+
+void MusicLibrary::rebuildCompletions() {
+  std::vector<AutocompleteIndex::Item> items;
+  items.reserve(songs.size() + artistKeys.size() + albumKeys.size());
+  // A name is one item weighted by its songs, not one item per song
+  std::vector<uint32_t> artistSongs(artistKeys.size());
+  std::vector<uint32_t> albumSongs(albumKeys.size());
+  for (size_t row = 0; row < columns.size(); row++) {
+    items.push_back({columns.titleSearchKeys[row], songs[row].title,
+                     static_cast<uint8_t>(SearchField::Title), 1});
+    artistSongs[columns.artistIds[row]]++;
+    albumSongs[columns.albumIds[row]]++;
+  }
+  for (uint32_t id = 0; id < artistSongs.size(); id++) {
+    items.push_back({artistKeys[id].searchKey, artists.get(id),
+                     static_cast<uint8_t>(SearchField::Artist),
+                     artistSongs[id]});
+  }
+  for (uint32_t id = 0; id < albumSongs.size(); id++) {
+    items.push_back({albumKeys[id].searchKey, albums.get(id),
+                     static_cast<uint8_t>(SearchField::Album), albumSongs[id]});
+  }
+  completions.build(std::move(items)); // names without songs: weight 0
+}
+
+void MusicLibrary::indexRange(size_t first) {
+  size_t last = songs.size();
+  size_t count = last - first;
+
+  // Each task owns one index, so they can run side by side
+  std::vector<std::function<void()>> tasks{
+      [&] {
+        songIndexByPath.reserve(songIndexByPath.size() + count);
+        for (size_t slot = first; slot < last; slot++) {
+          songIndexByPath[songs[slot].filePath] = slotHandle(slot);
+        }
+      },
+      [&] {
+        // Append, then one sort + merge instead of an insert per song.
+        // Small import batches are merged by the next lookup instead, so
+        // a 1M song import does not merge the whole array per batch
+        for (size_t slot = first; slot < last; slot++) {
+          songIndexByTitle.insert(columns.titleSortKeys[slot],
+                                  songs[slot].id, slotHandle(slot));
+        }
+        if (count * 2 >= last) {
+          songIndexByTitle.settle();
+        }
+      },
+      [&] {
+        for (size_t slot = first; slot < last; slot++) {
+          titleTrigrams.insert(songs[slot].id, columns.titleSearchKeys[slot]);
+        }
+      },
+      [&] {
+        for (size_t slot = first; slot < last; slot++) {
+          artistIndex[songs[slot].artistId].push_back(slotHandle(slot));
+        }
+      },
+      [&] {
+        for (size_t slot = first; slot < last; slot++) {
+          albumIndex[songs[slot].albumId].push_back(slotHandle(slot));
+        }
+      },
+      [&] {
+        if (count * 2 >= last) {
+          rebuildCompletions(); // bulk build: one sort, one pass
+          return;
+        }
+        for (size_t slot = first; slot < last; slot++) {
+          addCompletions(slot);
+        }
+      },
+  };
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    if (!sortOrders[k].built) {
+      continue;
+    }
+    // Sort only the new songs, then merge them into the kept order
+    tasks.push_back([this, k, first, last] {
+      SortKey key = static_cast<SortKey>(k);
+      std::vector<SongHandle> &order = sortOrders[k].handles;
+      size_t kept = order.size();
+      for (size_t slot = first; slot < last; slot++) {
+        order.push_back(slotHandle(slot));
+      }
+      sortHandles(key, order.begin() + kept, order.end());
+      std::inplace_merge(order.begin(), order.begin() + kept, order.end(),
+                         [this, key](SongHandle a, SongHandle b) {
+                           return sortsBefore(key, a, b);
+                         });
+      sortOrders[k].version++;
+    });
+  }
+
+  if (count < PARALLEL_INDEX_MIN) {
+    for (const auto &task : tasks) {
+      task();
+    }
+    return;
+  }
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < tasks.size(); i++) {
+    threads.emplace_back(tasks[i]);
+  }
+  tasks[0]();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+void MusicLibrary::unindexSong(const StoredSong &song, SongHandle handle) {
+  uint32_t slot = handles[handle.slot()].songSlot;
+  songIndexByTitle.erase(columns.titleSortKeys[slot], song.id);
+  titleTrigrams.erase(columns.titleSearchKeys[slot]);
+  auto byPath = songIndexByPath.find(song.filePath);
+  if (byPath != songIndexByPath.end() && byPath->second == handle) {
+    songIndexByPath.erase(byPath);
+  }
+  eraseFromGroup(artistIndex, song.artistId, handle);
+  eraseFromGroup(albumIndex, song.albumId, handle);
+  removeCompletions(slot);
+  sortErase(handle);
+}
+
+bool MusicLibrary::sortsBefore(SortKey key, SongHandle a, SongHandle b) const {
+  uint32_t slotA = handles[a.slot()].songSlot;
+  uint32_t slotB = handles[b.slot()].songSlot;
+  const StoredSong &x = songs[slotA];
+  const StoredSong &y = songs[slotB];
+  int order;
+  switch (key) {
+  case SortKey::Artist:
+    order = getArtistKeys(x.artistId).sortKey.compare(
+        getArtistKeys(y.artistId).sortKey);
+    if (order != 0) {
+      return order < 0;
+    }
+    [[fallthrough]]; // then by album within an artist
+  case SortKey::Album:
+    order = getAlbumKeys(x.albumId).sortKey.compare(
+        getAlbumKeys(y.albumId).sortKey);
+    if (order != 0) {
+      return order < 0;
+    }
+    break;
+  case SortKey::Duration:
+    if (x.duration != y.duration) {
+      return x.duration < y.duration;
+    }
+    break;
+  case SortKey::Title:
+    break;
+  }
+  order = columns.titleSortKeys[slotA].compare(columns.titleSortKeys[slotB]);
+  return order != 0 ? order < 0 : x.id < y.id;
+}
+
+void MusicLibrary::sortHandles(SortKey key,
+                               std::vector<SongHandle>::iterator first,
+                               std::vector<SongHandle>::iterator last) const {
+  auto less = [this, key](SongHandle a, SongHandle b) {
+    return sortsBefore(key, a, b);
+  };
+  size_t count = last - first;
+  size_t parts = std::max(1u, std::thread::hardware_concurrency());
+  if (count < PARALLEL_INDEX_MIN || parts == 1) {
+    std::sort(first, last, less);
+    return;
+  }
+
+  // Sort equal parts side by side, then merge neighbours pairwise
+  parts = std::min<size_t>(parts, 8);
+  std::vector<size_t> bounds;
+  for (size_t i = 0; i <= parts; i++) {
+    bounds.push_back(count * i / parts);
+  }
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < parts; i++) {
+    threads.emplace_back([&, i] {
+      std::sort(first + bounds[i], first + bounds[i + 1], less);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t width = 1; width < parts; width *= 2) {
+    for (size_t i = 0; i + width < parts; i += 2 * width) {
+      size_t end = std::min(i + 2 * width, parts);
+      std::inplace_merge(first + bounds[i], first + bounds[i + width],
+                         first + bounds[end], less);
+    }
+  }
+}
+
+void MusicLibrary::sortInsert(SongHandle handle) {
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    SortOrder &order = sortOrders[k];
+    if (!order.built) {
+      continue;
+    }
+    SortKey key = static_cast<SortKey>(k);
+    auto at = std::upper_bound(order.handles.begin(), order.handles.end(),
+                               handle, [this, key](SongHandle a, SongHandle b) {
+                                 return sortsBefore(key, a, b);
+                               });
+    order.handles.insert(at, handle);
+    order.version++;
+  }
+}
+
+void MusicLibrary::sortErase(SongHandle handle) {
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    SortOrder &order = sortOrders[k];
+    if (!order.built) {
+      continue;
+    }
+    SortKey key = static_cast<SortKey>(k);
+    // Total order: the lower bound is the song itself
+    auto at = std::lower_bound(order.handles.begin(), order.handles.end(),
+                               handle, [this, key](SongHandle a, SongHandle b) {
+                                 return sortsBefore(key, a, b);
+                               });
+    if (at != order.handles.end() && *at == handle) {
+      order.handles.erase(at);
+      order.version++;
+    }
+  }
+}
+
+void MusicLibrary::sortEraseAll(const std::vector<SongHandle> &gone) {
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    SortOrder &order = sortOrders[k];
+    if (!order.built || gone.empty()) {
+      continue;
+    }
+    SortKey key = static_cast<SortKey>(k);
+    std::vector<size_t> positions;
+    positions.reserve(gone.size());
+    for (SongHandle handle : gone) {
+      auto at = std::lower_bound(
+          order.handles.begin(), order.handles.end(), handle,
+          [this, key](SongHandle a, SongHandle b) {
+            return sortsBefore(key, a, b);
+          });
+      if (at != order.handles.end() && *at == handle) {
+        positions.push_back(at - order.handles.begin());
+      }
+    }
+    if (positions.empty()) {
+      continue;
+    }
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()),
+                    positions.end());
+    // Keep the runs between removed positions, from the first one on
+    auto first = order.handles.begin();
+    auto out = first + positions[0];
+    for (size_t i = 0; i < positions.size(); i++) {
+      size_t next =
+          i + 1 < positions.size() ? positions[i + 1] : order.handles.size();
+      out = std::move(first + positions[i] + 1, first + next, out);
+    }
+    order.handles.erase(out, order.handles.end());
+    order.version++;
+  }
+}
+
+bool MusicLibrary::removeSong(int id) {
+  SongHandle handle = findHandleByID(id);
+  const StoredSong *target = resolve(handle);
+  if (target == nullptr) {
+    return false;
+  }
+  uint32_t slot = handles[handle.slot()].songSlot;
+  version++;
+  unindexSong(*target, handle);
+  songIndexByID[id] = SongHandle(); // the ID is not handed out again
+
+  // Swap with the last song - only its handle entry has to follow it
+  size_t last = songs.size() - 1;
+  if (slot != last) {
+    songs[slot] = songs.back();
+    columns.set(slot, songs[slot], columns.getKeys(last));
+    uint32_t moved = slotHandles[last];
+    handles[moved].songSlot = slot;
+    slotHandles[slot] = moved;
+  }
+  songs.pop_back();
+  columns.pop_back();
+  slotHandles.pop_back();
+
+  // Swap out of its partition's list the same way
+  HandleEntry &entry = handles[handle.slot()];
+  std::vector<SongHandle> &members = partitionSongs[entry.partition];
+  members[entry.partitionPos] = members.back();
+  handles[members.back().slot()].partitionPos = entry.partitionPos;
+  members.pop_back();
+
+  // Outstanding handles of the removed song go stale
+  releaseHandle(handle.slot());
+  if (titleTrigrams.needsRebuild()) {
+    compactTitleTrigrams();
+  }
+  return true;
+}
+
+size_t MusicLibrary::removeSongs(const std::vector<int> &ids) {
+  // Out of the sort orders first, while every key can still be compared
+  std::vector<SongHandle> gone;
+  gone.reserve(ids.size());
+  for (int id : ids) {
+    SongHandle handle = findHandleByID(id);
+    if (resolve(handle) != nullptr) {
+      gone.push_back(handle);
+    }
+  }
+  sortEraseAll(gone);
+
+  // Unbuilt orders are skipped by sortErase(): nothing left to erase
+  std::array<bool, SORT_KEY_COUNT> built;
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    built[k] = sortOrders[k].built;
+    sortOrders[k].built = false;
+  }
+  size_t removed = 0;
+  for (int id : ids) {
+    removed += removeSong(id);
+  }
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    sortOrders[k].built = built[k];
+  }
+  return removed;
+}
+
+uint32_t MusicLibrary::createPartition() {
+  uint32_t partition = nextPartition++;
+  partitionSongs[partition]; // known, even while empty
+  return partition;
+}
+
+size_t MusicLibrary::removePartition(uint32_t partition) {
+  auto it = partitionSongs.find(partition);
+  if (it == partitionSongs.end()) {
+    return 0;
   }
+  std::vector<int> ids;
+  ids.reserve(it->second.size());
+  for (SongHandle handle : it->second) {
+    ids.push_back(resolve(handle)->id);
+  }
+  size_t removed = removeSongs(ids);
+  if (partition != DEFAULT_PARTITION) {
+    partitionSongs.erase(partition);
+  }
+  return removed;
+}
 
-  songs.push_back(song);
+const std::vector<SongHandle> &
+MusicLibrary::getPartitionSongs(uint32_t partition) const {
+  static const std::vector<SongHandle> none;
+  auto it = partitionSongs.find(partition);
+  return it != partitionSongs.end() ? it->second : none;
+}
 
-  const Song *songPtr = &songs.back();
+uint32_t MusicLibrary::getPartition(SongHandle handle) const {
+  return resolve(handle) != nullptr ? handles[handle.slot()].partition
+                                    : DEFAULT_PARTITION;
+}
 
-  // Update maps
+bool MusicLibrary::updateSong(int id, const Song &song) {
+  SongHandle handle = findHandleByID(id);
+  if (resolve(handle) == nullptr) {
+    return false;
+  }
+  uint32_t slot = handles[handle.slot()].songSlot;
+  StoredSong &stored = songs[slot];
+  version++;
+  PreparedText prepared = prepare(song);
+  uint32_t artistId =
+      internName(artists, artistKeys, artistTrigrams, prepared.artist);
+  uint32_t albumId =
+      internName(albums, albumKeys, albumTrigrams, prepared.album);
+  bool rekey = stored.title != prepared.title ||
+               stored.artistId != artistId || stored.albumId != albumId ||
+               stored.filePath != song.filePath ||
+               stored.duration != song.duration; // duration: sort order
+  if (rekey) {
+    unindexSong(stored, handle);
+  }
+  TitleKeys keys = columns.getKeys(slot);
+  if (stored.title != prepared.title) {
+    stored.title = text.append(prepared.title);
+    keys = {text.append(prepared.titleKeys.sortKey),
+            text.append(prepared.titleKeys.searchKey)};
+  }
+  stored.artistId = artistId;
+  stored.albumId = albumId;
+  stored.duration = static_cast<uint32_t>(song.duration);
+  if (stored.filePath != song.filePath) {
+    stored.filePath = text.append(song.filePath);
+  }
+  stored.stamp = song.stamp;
+  columns.set(slot, stored, keys);
+  if (rekey) {
+    indexSong(stored, handle);
+  }
+  if (titleTrigrams.needsRebuild()) {
+    compactTitleTrigrams();
+  }
+  return true;
+}
 
-  songIndexByID[song.id] = songPtr;
-  songIndexByTitle[song.title] = songPtr;
-  artistIndex[song.artist].push_back(songPtr);
-  albumIndex[song.album].push_back(songPtr);
-  return reallocated; //
+void MusicLibrary::compactTitleTrigrams() {
+  titleTrigrams.clear();
+  for (size_t row = 0; row < columns.size(); row++) {
+    titleTrigrams.insert(columns.ids[row], columns.titleSearchKeys[row]);
+  }
 }
 
-std::vector<Song>::const_iterator MusicLibrary::begin() const {
+SongStore::const_iterator MusicLibrary::begin() const {
   return songs.begin();
 }
 
-std::vector<Song>::const_iterator MusicLibrary::end() const {
+SongStore::const_iterator MusicLibrary::end() const {
   return songs.end();
 }
 
 size_t MusicLibrary::getSize() const { return songs.size(); }
 
+uint64_t MusicLibrary::getVersion() const { return version; }
+
 // void MusicLibrary::initIDMap() {
 //   for (int i = 0; i < songs.size(); ++i) {
 //     const Song *ptr = &songs[i];
@@ -60,58 +644,450 @@ size_t MusicLibrary::getSize() const { return songs.size(); }
 //   }
 // }
 
-const Song *MusicLibrary::findSongByID(int id) const {
-  auto it = songIndexByID.find(id);
+const StoredSong *MusicLibrary::resolve(SongHandle handle) const {
+  if (handle.isNull() || handle.slot() >= handles.size()) {
+    return nullptr;
+  }
+  const HandleEntry &entry = handles[handle.slot()];
+  if (entry.generation != handle.generation() ||
+      entry.songSlot >= songs.size()) {
+    return nullptr;
+  }
+  return &songs[entry.songSlot];
+}
 
-  if (it != songIndexByID.end()) {
-    return it->second; // Accessing 'value' using ->second
+SongHandle MusicLibrary::getHandle(const StoredSong *song) const {
+  if (song == nullptr) {
+    return {};
   }
-  return nullptr;
+  SongHandle handle = findHandleByID(song->id);
+  return resolve(handle) == song ? handle : SongHandle();
+}
+
+SongHandle MusicLibrary::findHandleByID(int id) const {
+  // Negative IDs wrap to huge values and fail the bound check too
+  if (static_cast<size_t>(id) >= songIndexByID.size()) {
+    return SongHandle();
+  }
+  return songIndexByID[id];
 }
 
-const Song *MusicLibrary::findSongByTitle(const std::string &title) {
-  auto it = songIndexByTitle.find(title);
+const StoredSong *MusicLibrary::findSongByID(int id) const {
+  return resolve(findHandleByID(id));
+}
 
-  if (it != songIndexByTitle.end()) {
-    return it->second; // Accessing 'value' using ->second
+const StoredSong *
+MusicLibrary::findSongByTitle(const std::string &title) const {
+  std::string normalized = normalizeText(title);
+  // Equal keys are almost always equal titles - check to be exact
+  for (const TitleIndex::Entry &entry :
+       songIndexByTitle.equalRange(makeSortKey(normalized))) {
+    const StoredSong *song = resolve(entry.song);
+    if (song != nullptr && song->title == normalized) {
+      return song;
+    }
   }
   return nullptr;
 }
 
-std::vector<const Song *>
+const TitleIndex &MusicLibrary::getTitleIndex() const {
+  return songIndexByTitle;
+}
+
+const StoredSong *
+MusicLibrary::findSongByPath(const std::string &filePath) const {
+  auto it = songIndexByPath.find(filePath);
+  return it != songIndexByPath.end() ? resolve(it->second) : nullptr;
+}
+
+const std::string &MusicLibrary::getArtist(const StoredSong &song) const {
+  return artists.get(song.artistId);
+}
+
+const std::string &MusicLibrary::getAlbum(const StoredSong &song) const {
+  return albums.get(song.albumId);
+}
+
+Song MusicLibrary::copySong(const StoredSong &song) const {
+  Song copy(song.id);
+  copy.title = std::string(song.title);
+  copy.artist = getArtist(song);
+  copy.album = getAlbum(song);
+  copy.duration = song.duration;
+  copy.filePath = std::string(song.filePath);
+  copy.stamp = song.stamp;
+  return copy;
+}
+
+const StringPool &MusicLibrary::getArtists() const { return artists; }
+
+const StringPool &MusicLibrary::getAlbums() const { return albums; }
+
+uint32_t MusicLibrary::findAlbumId(const std::string &album) const {
+  return albums.find(normalizeText(album));
+}
+
+const TextKeys &MusicLibrary::getArtistKeys(uint32_t artistId) const {
+  static const TextKeys none;
+  return artistId < artistKeys.size() ? artistKeys[artistId] : none;
+}
+
+const TextKeys &MusicLibrary::getAlbumKeys(uint32_t albumId) const {
+  static const TextKeys none;
+  return albumId < albumKeys.size() ? albumKeys[albumId] : none;
+}
+
+const TextArena &MusicLibrary::getTextArena() const { return text; }
+
+const AutocompleteIndex &MusicLibrary::getCompletions() const {
+  return completions;
+}
+
+std::vector<const StoredSong *>
 MusicLibrary::findSongByArtist(const std::string &artist) {
-  auto it = artistIndex.find(artist);
+  auto it = artistIndex.find(artists.find(normalizeText(artist)));
 
+  std::vector<const StoredSong *> found;
   if (it != artistIndex.end()) {
-    return it->second; // Accessing 'value' using ->second
+    found.reserve(it->second.size());
+    for (SongHandle handle : it->second) {
+      found.push_back(resolve(handle));
+    }
   }
-  return {};
+  return found;
 }
 
 void MusicLibrary::clear() {
+  version++; // not reset: versions from before stay different
   songs.clear();
+  columns.clear();
+  slotHandles.clear();
+  // Keep the handle table: bumped generations make old handles stale
+  freeHandles.clear();
+  for (size_t i = 0; i < handles.size(); i++) {
+    if (handles[i].songSlot != SongHandle::NONE) { // retired ones stay so
+      releaseHandle(static_cast<uint32_t>(i));
+    }
+  }
   songIndexByID.clear();
   songIndexByTitle.clear();
+  titleTrigrams.clear();
+  artistTrigrams.clear();
+  albumTrigrams.clear();
+  completions.clear();
+  songIndexByPath.clear();
   artistIndex.clear();
   albumIndex.clear();
-  Song::resetIdCounter(); // Reset ID counter for next library load
+  partitionSongs.clear();
+  nextPartition = DEFAULT_PARTITION + 1;
+  for (SortOrder &order : sortOrders) {
+    order.handles.clear();
+    order.built = false; // rebuilt on the next getSortView()
+    order.version++;
+  }
+  artists.clear();
+  albums.clear();
+  artistKeys.clear();
+  albumKeys.clear();
+  text.clear(); // after the indexes, their keys view it
 }
 
-const std::unordered_map<std::string, std::vector<const Song *>> &
+const std::unordered_map<uint32_t, std::vector<SongHandle>> &
 MusicLibrary::getArtistIndex() const {
   return artistIndex;
 }
 
-const std::map<std::string, std::vector<const Song *>> &
+const std::unordered_map<uint32_t, std::vector<SongHandle>> &
 MusicLibrary::getAlbumIndex() const {
   return albumIndex;
 }
 
-std::vector<const Song *> MusicLibrary::getSortedSongs() const {
-  std::vector<const Song *> sorted;
-  // songIndexByTitle is a std::map (ordered by key)
-  for (const auto &pair : songIndexByTitle) {
-    sorted.push_back(pair.second);
+std::vector<uint32_t> MusicLibrary::getSortedAlbums() const {
+  std::vector<uint32_t> sorted;
+  sorted.reserve(albumIndex.size());
+  for (const auto &pair : albumIndex) {
+    sorted.push_back(pair.first);
   }
+  std::sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b) {
+    return albumKeys[a].sortKey < albumKeys[b].sortKey;
+  });
   return sorted;
-}
\ No newline at end of file
+}
+
+void MusicLibrary::matchNames(const TrigramIndex &trigrams,
+                              const std::vector<TextKeys> &keys,
+                              const GroupIndex &groups, const std::string &key,
+                              std::vector<uint32_t> &out) {
+  out.clear();
+  if (key.size() < TrigramIndex::MIN_QUERY) {
+    for (uint32_t id = 0; id < keys.size(); id++) {
+      out.push_back(id);
+    }
+  } else {
+    trigrams.candidates(key, out);
+  }
+  // Verify, and skip names whose songs are all gone
+  out.erase(std::remove_if(out.begin(), out.end(),
+                           [&](uint32_t id) {
+                             return !containsText(keys[id].searchKey, key) ||
+                                    groups.count(id) == 0;
+                           }),
+            out.end());
+}
+
+// True every few thousand rows once the caller asked to stop
+static bool stopRequested(const std::atomic<bool> *cancelled, size_t row) {
+  return cancelled != nullptr && row % 4096 == 0 &&
+         cancelled->load(std::memory_order_relaxed);
+}
+
+SearchResult MusicLibrary::search(std::string_view query,
+                                  const std::atomic<bool> *cancelled) const {
+  SearchResult result;
+  std::string key = makeSearchKey(query);
+  if (key.empty()) {
+    return result;
+  }
+  matchNames(artistTrigrams, artistKeys, artistIndex, key, result.artists);
+  matchNames(albumTrigrams, albumKeys, albumIndex, key, result.albums);
+
+  // (song ID, handle) of every hit, sorted and deduplicated at the end
+  std::vector<std::pair<int, SongHandle>> hits;
+  for (uint32_t artistId : result.artists) {
+    for (SongHandle handle : artistIndex.at(artistId)) {
+      hits.emplace_back(resolve(handle)->id, handle);
+    }
+  }
+  for (uint32_t albumId : result.albums) {
+    for (SongHandle handle : albumIndex.at(albumId)) {
+      hits.emplace_back(resolve(handle)->id, handle);
+    }
+  }
+  if (key.size() < TrigramIndex::MIN_QUERY) {
+    for (size_t row = 0; row < columns.size(); row++) {
+      if (stopRequested(cancelled, row)) {
+        return SearchResult();
+      }
+      if (containsText(columns.titleSearchKeys[row], key)) {
+        hits.emplace_back(columns.ids[row], slotHandle(row));
+      }
+    }
+  } else {
+    std::vector<uint32_t> candidates;
+    titleTrigrams.candidates(key, candidates);
+    for (size_t i = 0; i < candidates.size(); i++) {
+      if (stopRequested(cancelled, i)) {
+        return SearchResult();
+      }
+      uint32_t id = candidates[i];
+      SongHandle handle = findHandleByID(static_cast<int>(id));
+      if (resolve(handle) == nullptr) {
+        continue; // removed since it was indexed
+      }
+      uint32_t slot = handles[handle.slot()].songSlot;
+      if (containsText(columns.titleSearchKeys[slot], key)) {
+        hits.emplace_back(static_cast<int>(id), handle);
+      }
+    }
+  }
+
+  std::sort(hits.begin(), hits.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+  result.songs.reserve(hits.size());
+  for (const auto &hit : hits) {
+    result.songs.push_back(hit.second);
+  }
+  return result;
+}
+
+SearchResult MusicLibrary::refine(const SearchResult &previous,
+                                  std::string_view query,
+                                  const std::atomic<bool> *cancelled) const {
+  SearchResult result;
+  std::string key = makeSearchKey(query);
+  if (key.empty()) {
+    return result;
+  }
+  auto contains = [&key](const std::vector<TextKeys> &keys, uint32_t id) {
+    return containsText(keys[id].searchKey, key);
+  };
+  for (uint32_t artistId : previous.artists) {
+    if (contains(artistKeys, artistId) && artistIndex.count(artistId) > 0) {
+      result.artists.push_back(artistId);
+    }
+  }
+  for (uint32_t albumId : previous.albums) {
+    if (contains(albumKeys, albumId) && albumIndex.count(albumId) > 0) {
+      result.albums.push_back(albumId);
+    }
+  }
+
+  // Songs keep their ID order: only the ones still matching are copied
+  for (size_t i = 0; i < previous.songs.size(); i++) {
+    if (stopRequested(cancelled, i)) {
+      return SearchResult();
+    }
+    SongHandle handle = previous.songs[i];
+    if (resolve(handle) == nullptr) {
+      continue;
+    }
+    uint32_t slot = handles[handle.slot()].songSlot;
+    if (containsText(columns.titleSearchKeys[slot], key) ||
+        contains(artistKeys, columns.artistIds[slot]) ||
+        contains(albumKeys, columns.albumIds[slot])) {
+      result.songs.push_back(handle);
+    }
+  }
+  return result;
+}
+
+// Weighted share of the query a field matched, coverage breaks near-ties:
+// "love" in "Love" beats "love" in "Love Me Tender"
+static float fuzzyScore(float weight, size_t errors, size_t queryLength,
+                        size_t textLength) {
+  float matched = 1.0f - static_cast<float>(errors) / queryLength;
+  float coverage = static_cast<float>(queryLength) /
+                   std::max(queryLength, textLength);
+  return weight * (0.95f * matched + 0.05f * coverage);
+}
+
+std::vector<FuzzyHit>
+MusicLibrary::fuzzySearch(std::string_view query, size_t limit,
+                          const FuzzyWeights &weights,
+                          const std::atomic<bool> *cancelled) const {
+  std::vector<FuzzyHit> hits;
+  std::string key = makeSearchKey(query);
+  if (key.empty() || limit == 0) {
+    return hits;
+  }
+  FuzzyPattern pattern(key);
+  size_t maxErrors = pattern.getMaxErrors();
+
+  // Artists and albums are shared by many songs: match each name once
+  struct NameMatch {
+    float score = -1; // below 0: too many edits
+    uint8_t errors = 0;
+  };
+  auto matchAll = [&](const std::vector<TextKeys> &keys, float weight) {
+    std::vector<NameMatch> matches(keys.size());
+    for (size_t id = 0; id < keys.size(); id++) {
+      const std::string &name = keys[id].searchKey;
+      size_t errors = pattern.distance(name, maxErrors);
+      if (errors <= maxErrors) {
+        matches[id].score =
+            fuzzyScore(weight, errors, pattern.size(), name.size());
+        matches[id].errors = static_cast<uint8_t>(errors);
+      }
+    }
+    return matches;
+  };
+  std::vector<NameMatch> artistMatches = matchAll(artistKeys, weights.artist);
+  std::vector<NameMatch> albumMatches = matchAll(albumKeys, weights.album);
+
+  // Min-heap of the best `limit` songs: the worst kept one on top
+  struct Ranked {
+    FuzzyHit hit;
+    int id;
+  };
+  auto better = [](const Ranked &a, const Ranked &b) {
+    return a.hit.score != b.hit.score ? a.hit.score > b.hit.score
+                                      : a.id < b.id;
+  };
+  std::vector<Ranked> heap;
+  heap.reserve(limit + 1);
+  for (size_t row = 0; row < columns.size(); row++) {
+    if (stopRequested(cancelled, row)) {
+      return hits;
+    }
+    Ranked candidate{FuzzyHit(), columns.ids[row]};
+    FuzzyHit &hit = candidate.hit;
+    hit.score = -1;
+    const NameMatch &artist = artistMatches[columns.artistIds[row]];
+    if (artist.score > hit.score) {
+      hit.score = artist.score;
+      hit.errors = artist.errors;
+      hit.field = SearchField::Artist;
+    }
+    const NameMatch &album = albumMatches[columns.albumIds[row]];
+    if (album.score > hit.score) {
+      hit.score = album.score;
+      hit.errors = album.errors;
+      hit.field = SearchField::Album;
+    }
+    // The title is matched per song: skip it when it cannot win
+    float floor = heap.size() == limit ? heap.front().hit.score : -1;
+    if (weights.title > std::max(hit.score, floor)) {
+      std::string_view title = columns.titleSearchKeys[row];
+      size_t errors = pattern.distance(title, maxErrors);
+      float score = errors <= maxErrors
+                        ? fuzzyScore(weights.title, errors, pattern.size(),
+                                     title.size())
+                        : -1;
+      if (score > hit.score) {
+        hit.score = score;
+        hit.errors = static_cast<uint8_t>(errors);
+        hit.field = SearchField::Title;
+      }
+    }
+    if (hit.score < 0) {
+      continue;
+    }
+    if (heap.size() == limit) {
+      if (!better(candidate, heap.front())) {
+        continue;
+      }
+      std::pop_heap(heap.begin(), heap.end(), better);
+      heap.pop_back();
+    }
+    hit.song = slotHandle(row);
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end(), better);
+  }
+
+  std::sort(heap.begin(), heap.end(), better);
+  hits.reserve(heap.size());
+  for (const Ranked &ranked : heap) {
+    hits.push_back(ranked.hit);
+  }
+  return hits;
+}
+
+std::vector<Completion> MusicLibrary::complete(std::string_view prefix,
+                                               size_t limit) const {
+  std::vector<Completion> out;
+  std::string key = makeSearchKey(prefix);
+  if (key.empty()) {
+    return out;
+  }
+  for (const AutocompleteIndex::Suggestion &suggestion :
+       completions.complete(key, limit)) {
+    out.push_back({suggestion.text, static_cast<SearchField>(suggestion.tag),
+                   suggestion.weight});
+  }
+  return out;
+}
+
+std::vector<const StoredSong *> MusicLibrary::getSortedSongs() const {
+  std::vector<const StoredSong *> sorted;
+  sorted.reserve(songIndexByTitle.size());
+  for (const TitleIndex::Entry &entry : songIndexByTitle.all()) {
+    sorted.push_back(resolve(entry.song));
+  }
+  return sorted;
+}
+
+SortView MusicLibrary::getSortView(SortKey key) const {
+  SortOrder &order = sortOrders[static_cast<size_t>(key)];
+  if (!order.built) {
+    order.handles.clear();
+    order.handles.reserve(songs.size());
+    for (size_t slot = 0; slot < songs.size(); slot++) {
+      order.handles.push_back(slotHandle(slot));
+    }
+    sortHandles(key, order.handles.begin(), order.handles.end());
+    order.built = true;
+    order.version++;
+  }
+  return SortView(*this, order.handles, order.version);
+}
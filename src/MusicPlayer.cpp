@@ -1,6 +1,9 @@
 // MusicPlayer.cpp
 
 #include "../include/MusicPlayer.h"
+#include "../include/FastTagReader.h"
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <queue>
@@ -9,105 +12,508 @@
 
 namespace fs = std::filesystem;
 
-MusicPlayer::MusicPlayer() { engine.init(); }
+MusicPlayer::MusicPlayer()
+    : tagLoader([this](const std::string &filePath, Song &newSong) {
+        loadMetadata(filePath, newSong);
+      }),
+      watcher([this](const std::string &filePath, Song &newSong) {
+        loadMetadata(filePath, newSong);
+      }) {
+  engine.init();
+}
 
-MusicPlayer::~MusicPlayer() {}
+MusicPlayer::~MusicPlayer() {
+  // Jobs call back into loadMetadata - stop them before members go away
+  for (auto &job : importJobs) {
+    job->cancel();
+    job->wait();
+  }
+}
 
 void MusicPlayer::loadLibrary(const std::string &path) {
+  std::shared_ptr<ImportJob> job = loadLibraryAsync(path);
+  if (job == nullptr) {
+    return;
+  }
+  job->wait();
+  pollImports(SIZE_MAX);
+}
+
+std::shared_ptr<ImportJob>
+MusicPlayer::loadLibraryAsync(const std::string &path, size_t batchSize) {
   if (!fs::exists(path)) {
     std::cerr << "Error: Path does not exist -> " << path << std::endl;
-    return;
+    return nullptr;
   }
 
   // Check if folder already loaded
   std::string normalizedPath = fs::canonical(path).string();
   if (loadedFolders.count(normalizedPath) > 0) {
     std::cout << "Folder already loaded: " << path << std::endl;
-    return;
+    return nullptr;
+  }
+  loadedFolders.emplace(normalizedPath,
+                        LoadedFolder{path, library.createPartition()});
+
+  auto job = std::make_shared<ImportJob>(path, batchSize);
+  job->setWalkOptions(walkOptions);
+  job->setLazyTags(isLazyTagsEn);
+  if (isTagCacheEn) {
+    job->setTagCache(std::make_shared<TagCache>(path));
   }
-  loadedFolders.insert(normalizedPath);
+  job->start([this](const std::string &filePath, Song &newSong) {
+    loadMetadata(filePath, newSong);
+  });
+  importJobs.push_back(job);
+  if (isFolderWatchEn) {
+    watcher.addFolder(path, walkOptions);
+  }
+  return job;
+}
 
-  int count = 0;
+size_t MusicPlayer::pollImports(size_t maxSongs) {
+  size_t published = 0;
+  std::vector<Song> batch;
+  for (auto it = importJobs.begin(); it != importJobs.end();) {
+    ImportJob &job = **it;
+    const LoadedFolder *folder = findFolder(job.getPath());
+    uint32_t partition =
+        folder ? folder->partition : MusicLibrary::DEFAULT_PARTITION;
+    while (published < maxSongs && job.takeBatch(batch)) {
+      size_t batchSize = batch.size();
+      if (job.isRescan()) {
+        // New and changed files, matched by path like the watcher's
+        FolderChanges changes;
+        changes.root = job.getPath();
+        changes.upserts = std::move(batch);
+        job.markPublished(applyChanges(changes));
+        published += batchSize;
+        continue;
+      }
 
-  for (const auto &entry : fs::directory_iterator(path)) {
-    if (entry.path().extension() == ".mp3" ||
-        entry.path().extension() == ".wav") {
-      Song newSong;
-      newSong.filePath = entry.path().string();
+      // The watcher may have added some files already
+      batch.erase(std::remove_if(batch.begin(), batch.end(),
+                                 [this](const Song &song) {
+                                   return library.findSongByPath(
+                                              song.filePath) != nullptr;
+                                 }),
+                  batch.end());
+      std::vector<std::string> untagged; // lazy tags: read once listed
+      job.takeUntagged(batch, untagged);
+      {
+        auto lock = searchService.lockLibrary();
+        library.addSongs(std::move(batch), partition);
+      }
+      job.markPublished(batchSize);
+      published += batchSize;
 
-      // Default metadata
-      newSong.title = entry.path().stem().string();
-      newSong.artist = "Unknown Artist";
-      newSong.album = "Unknown Album";
+      for (const std::string &filePath : untagged) {
+        if (const StoredSong *song = library.findSongByPath(filePath)) {
+          tagLoader.enqueue(library.copySong(*song), job.getTagCache());
+        }
+      }
+    }
+    if (!job.isDrained()) {
+      ++it;
+      continue;
+    }
 
-      loadMetadata(newSong.filePath, newSong);
+    // Last batch is in: report and forget the job
+    ImportStats stats = job.getFuture().get();
+    if (job.isRescan()) {
+      FolderChanges changes;
+      changes.root = job.getPath();
+      changes.removed = job.takeRemoved(); // files no longer on disk
+      job.markPublished(applyChanges(changes));
+      std::cout << "Rescanned: " << job.getSongsPublished()
+                << " songs changed in " << job.getPath()
+                << (job.isCancelled() ? " (cancelled)" : "") << std::endl;
+    } else {
+      std::cout << "Loaded: " << job.getSongsPublished() << " songs from "
+                << job.getPath() << (job.isCancelled() ? " (cancelled)" : "")
+                << std::endl;
+    }
+    std::cout << "  walker:  " << stats.walker.filesPerSecond() << " files/s"
+              << std::endl;
+    std::cout << "  readers: " << stats.reader.filesPerSecond()
+              << " files/s (" << stats.workerCount << " threads)"
+              << std::endl;
+    std::cout << "  indexer: " << stats.indexer.filesPerSecond() << " files/s"
+              << std::endl;
+    std::cout << "  cache:   " << stats.cacheHits << " hits" << std::endl;
+    if (job.isLazyTags() && job.getTagCache() != nullptr) {
+      lazyCaches.push_back(job.getTagCache()); // gets the tags read later
+    }
+    it = importJobs.erase(it);
+  }
+  return published;
+}
 
-      library.addSong(newSong);
-      count++;
+size_t MusicPlayer::pollTags(size_t maxSongs) {
+  std::vector<Song> read;
+  tagLoader.takeResults(read, maxSongs);
+  size_t updated = 0;
+  if (!read.empty()) {
+    auto lock = searchService.lockLibrary();
+    for (const Song &song : read) {
+      const StoredSong *stored = library.findSongByID(song.id);
+      if (stored == nullptr || stored->stamp != song.stamp) {
+        continue; // removed, or re-read by a rescan / the watcher meanwhile
+      }
+      updated += library.updateSong(song.id, song); // same ID and address
+    }
+  }
+
+  if (!lazyCaches.empty() && !isImporting() &&
+      tagLoader.getPendingCount() == 0) {
+    for (const auto &cache : lazyCaches) {
+      cache->save();
+    }
+    lazyCaches.clear();
+  }
+  return updated;
+}
+
+void MusicPlayer::requestTags(const std::vector<int> &ids) {
+  tagLoader.prioritize(ids, TagPriority::Visible);
+}
+
+size_t MusicPlayer::getPendingTagCount() {
+  return tagLoader.getPendingCount();
+}
+
+void MusicPlayer::setLazyTagsEnabled(bool enabled) { isLazyTagsEn = enabled; }
+
+bool MusicPlayer::isLazyTagsEnabled() const { return isLazyTagsEn; }
+
+size_t MusicPlayer::rescanFolder(const std::string &path) {
+  std::shared_ptr<ImportJob> job = rescanFolderAsync(path);
+  if (job == nullptr) {
+    return 0;
+  }
+  job->wait();
+  pollImports(SIZE_MAX);
+  return job->getSongsPublished();
+}
+
+std::shared_ptr<ImportJob>
+MusicPlayer::rescanFolderAsync(const std::string &path, size_t batchSize) {
+  if (!fs::exists(path)) {
+    std::cerr << "Error: Path does not exist -> " << path << std::endl;
+    return nullptr;
+  }
+  std::string normalizedPath = fs::canonical(path).string();
+  auto folder = loadedFolders.find(normalizedPath);
+  if (folder == loadedFolders.end()) {
+    std::cout << "Folder not loaded: " << path << std::endl;
+    return nullptr;
+  }
+  for (const auto &job : importJobs) {
+    std::error_code ec;
+    if (fs::equivalent(job->getPath(), path, ec)) {
+      std::cout << "Folder still importing: " << path << std::endl;
+      return nullptr;
+    }
+  }
+  // Song paths were built from the path the folder was loaded with
+  const std::string &root = folder->second.root;
+
+  // Only this folder's partition is compared, not the whole library
+  std::unordered_map<std::string, FileStamp> known;
+  for (SongHandle handle :
+       library.getPartitionSongs(folder->second.partition)) {
+    const StoredSong *song = library.resolve(handle);
+    known.emplace(song->filePath, song->stamp);
+  }
+
+  // Walk, stat and read new or changed files on the job's thread
+  auto job = std::make_shared<ImportJob>(root, batchSize);
+  job->setWalkOptions(walkOptions);
+  job->setKnownFiles(std::move(known));
+  if (isTagCacheEn) {
+    job->setTagCache(std::make_shared<TagCache>(root));
+  }
+  job->start([this](const std::string &filePath, Song &newSong) {
+    loadMetadata(filePath, newSong);
+  });
+  importJobs.push_back(job);
+  return job;
+}
+
+size_t MusicPlayer::rescanLibrary() {
+  std::vector<std::string> roots;
+  for (const auto &[canonical, folder] : loadedFolders) {
+    roots.push_back(folder.root);
+  }
+  size_t started = 0;
+  for (const std::string &root : roots) {
+    if (rescanFolderAsync(root) != nullptr) {
+      started++;
+    }
+  }
+  return started;
+}
+
+size_t MusicPlayer::pollFolderChanges() {
+  size_t changed = 0;
+  FolderChanges changes;
+  while (watcher.takeChanges(changes)) {
+    if (findFolder(changes.root) == nullptr) {
+      continue; // unloaded since the batch was made
+    }
+    if (changes.overflow) {
+      // Events were lost: the rescan finds every change, this batch too
+      rescanFolderAsync(changes.root);
+      continue;
+    }
+    changed += applyChanges(changes);
+  }
+  return changed;
+}
+
+void MusicPlayer::setFolderWatchEnabled(bool enabled) {
+  isFolderWatchEn = enabled;
+}
+
+void MusicPlayer::setWalkOptions(const WalkOptions &options) {
+  walkOptions = options;
+}
+
+const WalkOptions &MusicPlayer::getWalkOptions() const { return walkOptions; }
+
+size_t MusicPlayer::applyChanges(FolderChanges &changes) {
+  const LoadedFolder *folder = findFolder(changes.root);
+  if (folder == nullptr) {
+    return 0; // folder unloaded meanwhile
+  }
+  auto lock = searchService.lockLibrary();
+  std::vector<int> removedIDs;
+  for (const std::string &file : changes.removed) {
+    if (const StoredSong *song = library.findSongByPath(file)) {
+      removedIDs.push_back(song->id);
     }
   }
-  std::cout << "Loaded: " << count << " songs from " << path << std::endl;
+  for (const std::string &dir : changes.removedDirs) {
+    std::string prefix = (fs::path(dir) / "").string();
+    for (SongHandle handle : library.getPartitionSongs(folder->partition)) {
+      const StoredSong *song = library.resolve(handle);
+      if (song->filePath.compare(0, prefix.size(), prefix) == 0) {
+        removedIDs.push_back(song->id);
+      }
+    }
+  }
+
+  std::vector<Song> fresh;
+  size_t updated = 0;
+  for (Song &song : changes.upserts) {
+    const StoredSong *stored = library.findSongByPath(song.filePath);
+    if (stored == nullptr) {
+      fresh.push_back(std::move(song));
+    } else if (stored->stamp != song.stamp) {
+      updated += library.updateSong(stored->id, song);
+    }
+  }
+  size_t added = fresh.size();
+  library.addSongs(std::move(fresh), folder->partition);
+  size_t removed = library.removeSongs(removedIDs);
+  if (removed > 0) {
+    dropStalePlayback();
+  }
+
+  size_t total = added + updated + removed;
+  if (total > 0) {
+    std::cout << "Updated: " << changes.root << " (+" << added << " ~"
+              << updated << " -" << removed << ")" << std::endl;
+  }
+  return total;
+}
+
+void MusicPlayer::dropStalePlayback() {
+  queue.removeStale(library);
+  stack.removeStale(library);
+  shuffleMgr.removeStale(library);
+  smartPlaylist.removeStale(library);
+  if (!current.isNull() && library.resolve(current) == nullptr) {
+    current = {};
+    engine.stop(); // its file is gone
+  }
+}
+
+const MusicPlayer::LoadedFolder *
+MusicPlayer::findFolder(const std::string &root) const {
+  for (const auto &[canonical, folder] : loadedFolders) {
+    if (folder.root == root) {
+      return &folder;
+    }
+  }
+  return nullptr;
 }
 
+size_t MusicPlayer::unloadFolder(const std::string &path) {
+  // Match by canonical path, or as loaded if it is gone from disk
+  std::error_code ec;
+  std::string normalizedPath = fs::canonical(path, ec).string();
+  auto folder = ec ? loadedFolders.end() : loadedFolders.find(normalizedPath);
+  if (folder == loadedFolders.end()) {
+    folder = std::find_if(loadedFolders.begin(), loadedFolders.end(),
+                          [&path](const auto &entry) {
+                            return entry.second.root == path;
+                          });
+  }
+  if (folder == loadedFolders.end()) {
+    std::cout << "Folder not loaded: " << path << std::endl;
+    return 0;
+  }
+  std::string root = folder->second.root;
+
+  // Stop its import, unpublished songs are dropped
+  for (auto it = importJobs.begin(); it != importJobs.end();) {
+    if ((*it)->getPath() == root) {
+      (*it)->cancel();
+      (*it)->wait();
+      it = importJobs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  watcher.removeFolder(root);
+
+  // Its lazy tags are not read, nor its cache saved for them
+  std::vector<int> ids;
+  for (SongHandle handle :
+       library.getPartitionSongs(folder->second.partition)) {
+    ids.push_back(library.resolve(handle)->id);
+  }
+  tagLoader.cancel(ids);
+  lazyCaches.erase(std::remove_if(lazyCaches.begin(), lazyCaches.end(),
+                                  [&root](const auto &cache) {
+                                    return cache->getRoot() == root;
+                                  }),
+                   lazyCaches.end());
+
+  size_t removed;
+  {
+    auto lock = searchService.lockLibrary();
+    removed = library.removePartition(folder->second.partition);
+  }
+  loadedFolders.erase(folder);
+  if (removed > 0) {
+    dropStalePlayback();
+  }
+  std::cout << "Folder unloaded: " << root << " (" << removed << " songs)"
+            << std::endl;
+  return removed;
+}
+
+std::vector<std::string> MusicPlayer::getLoadedFolders() const {
+  std::vector<std::string> roots;
+  for (const auto &[canonical, folder] : loadedFolders) {
+    roots.push_back(folder.root);
+  }
+  std::sort(roots.begin(), roots.end());
+  return roots;
+}
+
+const std::vector<std::shared_ptr<ImportJob>> &
+MusicPlayer::getImportJobs() const {
+  return importJobs;
+}
+
+bool MusicPlayer::isImporting() const { return !importJobs.empty(); }
+
+void MusicPlayer::setTagCacheEnabled(bool enabled) { isTagCacheEn = enabled; }
+
 const MusicLibrary &MusicPlayer::getLibrary() const { return library; }
 
+void MusicPlayer::searchLibrary(std::string_view query) {
+  searchService.submit(query);
+}
+
+std::shared_ptr<const SearchSnapshot> MusicPlayer::getSearchResults() {
+  return searchService.getSnapshot();
+}
+
+bool MusicPlayer::isSearching() { return searchService.isSearching(); }
+
 void MusicPlayer::loadMetadata(const std::string &filePath, Song &newSong) {
+  // Headers only - TagLib is kept for files the fast reader cannot parse
+  if (FastTagReader::read(filePath, newSong)) {
+    return;
+  }
+
   // Use fs::u8path for proper UTF-8 to wchar_t conversion on Windows
   fs::path fsPath = fs::u8path(filePath);
   TagLib::FileRef f(fsPath.wstring().c_str());
 
   if (!f.isNull() && f.tag()) {
     TagLib::Tag *tag = f.tag();
-    newSong.title = tag->title().to8Bit(true); // Convert String to std::string
-    newSong.artist = tag->artist().to8Bit(true);
-    newSong.album = tag->album().to8Bit(true);
-    newSong.duration = f.audioProperties()->lengthInSeconds();
+    // Empty fields keep the defaults, like the fast reader
+    if (!tag->title().isEmpty()) {
+      newSong.title = tag->title().to8Bit(true); // Convert to std::string
+    }
+    if (!tag->artist().isEmpty()) {
+      newSong.artist = tag->artist().to8Bit(true);
+    }
+    if (!tag->album().isEmpty()) {
+      newSong.album = tag->album().to8Bit(true);
+    }
+    if (f.audioProperties()) {
+      newSong.duration = f.audioProperties()->lengthInSeconds();
+    }
   }
 }
 
 size_t MusicPlayer::getLibrarySize() { return library.getSize(); }
 
-const Song *MusicPlayer::getCurrentSong() { return current; }
+const StoredSong *MusicPlayer::getCurrentSong() {
+  return library.resolve(current);
+}
 
 const PlaybackQueue &MusicPlayer::getQueueManager() const { return queue; }
 
 const PlaybackHistory &MusicPlayer::getHistoryManager() const { return stack; }
 
-void MusicPlayer::addSongToQueue(const Song *song) {
-  queue.addSong(song);
+void MusicPlayer::addSongToQueue(const StoredSong *song) {
+  SongHandle handle = library.getHandle(song);
+  if (handle.isNull()) {
+    return; // not a song of this library
+  }
+  tagLoader.prioritize({song->id}, TagPriority::Queued);
+  queue.addSong(handle);
   if (isShuffleEn == true) {
-    shuffleMgr.addSong(song);
+    shuffleMgr.addSong(handle);
   }
 }
 
-void MusicPlayer::removeSongFromQueue(const Song *song) {
-  queue.removeSong(song);
+void MusicPlayer::removeSongFromQueue(const StoredSong *song) {
+  queue.removeSong(library.getHandle(song));
 }
 
 size_t MusicPlayer::getQueueSize() { return queue.getQueueSize(); }
 
 void MusicPlayer::playSong() {
-  if (current == nullptr) {
+  const StoredSong *song = library.resolve(current);
+  if (song == nullptr) {
     std::cout << "No song to play" << std::endl;
     return;
   }
-  engine.playFile(current->filePath); // play the song
+  engine.playFile(std::string(song->filePath)); // play the song
 }
 
-void MusicPlayer::chooseAndPlaySong(const Song *song) {
-  if (current != nullptr) {
+void MusicPlayer::chooseAndPlaySong(const StoredSong *song) {
+  if (!current.isNull()) {
     stack.addSongToHistory(current); // push current song into history
   }
-  current = song; // play the newly chosen song
+  current = library.getHandle(song); // play the newly chosen song
   playSong();
 }
 
 void MusicPlayer::playNext() {
-  if (current != nullptr) {
+  if (!current.isNull()) {
     stack.addSongToHistory(current); // add current song to history
   }
 
-  const Song *next = nullptr;
+  SongHandle next;
 
   if (stack.getForwardSize() != 0) {
     next = stack.getForwardSong();
@@ -116,29 +522,29 @@ void MusicPlayer::playNext() {
   } else {
     next = queue.getNextSong();
   }
-  if (next != nullptr) {
+  if (!next.isNull()) {
     current = next;
     playSong();
   } else {
     std::cout << "No Songs in Queue" << std::endl;
-    if (current != nullptr) {
+    if (!current.isNull()) {
       ma_sound_stop(&engine.sound);
       ma_sound_uninit(&engine.sound);
       engine.isSoundLoaded = false;
       engine.songFinished = true;
     }
-    current = nullptr;
+    current = {};
   }
 }
 
 void MusicPlayer::playPrevious() {
-  const Song *prev = stack.getPreviousSong();
-  if (prev == nullptr) {
+  SongHandle prev = stack.getPreviousSong();
+  if (prev.isNull()) {
     std::cout << "No previous songs" << std::endl;
     return; // Do nothing
   }
   // Only add current to forward if it's not null
-  if (current != nullptr) {
+  if (!current.isNull()) {
     stack.addSongToForward(current);
   }
   current = prev;
@@ -163,10 +569,10 @@ void MusicPlayer::disableShuffle() {
 }
 
 void MusicPlayer::selectAndPlaySong(int songID) {
-  if (current != nullptr) {
+  if (!current.isNull()) {
     stack.addSongToHistory(current);
   }
-  current = library.findSongByID(songID);
+  current = library.findHandleByID(songID);
   playSong();
 }
 
@@ -175,10 +581,10 @@ void MusicPlayer::selectAndAddSong(int songID) {
 }
 
 void MusicPlayer::selectAndPlaySong(const std::string &title) {
-  if (current != nullptr) {
+  if (!current.isNull()) {
     stack.addSongToHistory(current);
   }
-  current = library.findSongByTitle(title);
+  current = library.getHandle(library.findSongByTitle(title));
   playSong();
 }
 
@@ -188,13 +594,12 @@ void MusicPlayer::selectAndAddSong(const std::string &title) {
 
 size_t MusicPlayer::addAlbumToQueue(const std::string &albumName) {
   int count = 0;
-  for (const auto &song : library) {
-    if (song.album == albumName) {
-      const Song *songPtr = library.findSongByID(song.id);
-      if (songPtr) {
-        this->addSongToQueue(songPtr);
-        count++;
-      }
+  uint32_t albumId = library.findAlbumId(albumName);
+  const std::vector<uint32_t> &albumIds = library.getColumns().albumIds;
+  for (size_t row = 0; row < albumIds.size(); row++) {
+    if (albumIds[row] == albumId) {
+      this->addSongToQueue(&library.getAllSongs()[row]);
+      count++;
     }
   }
   return count;
@@ -208,31 +613,44 @@ void MusicPlayer::clearQueue() {
   std::cout << "Queue cleared" << std::endl;
 }
 
-PlaybackQueue MusicPlayer::generateSmartPlaylist(const Song *startSong,
+PlaybackQueue MusicPlayer::generateSmartPlaylist(const StoredSong *startSong,
                                                  size_t maxSize) {
 
   if (startSong == nullptr) {
     return {};
   }
   smartPlaylist.clearQueue();          // Clear smart playlist
-  std::queue<std::string> searchQueue; // Search queue (by artist and album)
-  std::unordered_set<const Song *> visited; // Contain pointers to song
+  // Search queue (by artist and album) - a criteria is a text, matched
+  // through its interned artist and album IDs
+  std::queue<std::pair<uint32_t, uint32_t>> searchQueue;
+  // Scan the ID columns only, "visited" by row
+  const SongColumns &columns = library.getColumns();
+  std::vector<bool> visited(columns.size());
+  size_t startRow = library.getAllSongs().slotOf(startSong);
+  if (startRow == visited.size()) {
+    return {}; // not a song of this library
+  }
 
-  searchQueue.push(startSong->artist); // Criteria 1
-  searchQueue.push(startSong->album);  // Criteria 2
-  visited.insert(startSong);           // Mark current song as visited
+  const StringPool &artists = library.getArtists();
+  const StringPool &albums = library.getAlbums();
+  const std::string &artist = library.getArtist(*startSong);
+  const std::string &album = library.getAlbum(*startSong);
+  searchQueue.push({artists.find(artist), albums.find(artist)}); // Criteria 1
+  searchQueue.push({artists.find(album), albums.find(album)});   // Criteria 2
+  visited[startRow] = true; // Mark current song as visited
 
   while (!searchQueue.empty() && (smartPlaylist.getQueueSize() < maxSize)) {
-    std::string currentCriteria =
+    auto [artistId, albumId] =
         searchQueue.front(); // Take a criteria into consideration
     searchQueue.pop();       // Release that criteria from queue
 
-    for (const auto &song : library) {
-      if (visited.find(&song) ==
-          visited.end()) { // If song not already in "visited"
-        if (song.artist == currentCriteria || song.album == currentCriteria) {
-          smartPlaylist.addSong(&song); // Add that song to smart playlist
-          visited.insert(&song);        // Mark as visited
+    for (size_t row = 0; row < visited.size(); row++) {
+      if (!visited[row]) { // If song not already in "visited"
+        if (columns.artistIds[row] == artistId ||
+            columns.albumIds[row] == albumId) {
+          // Add that song to smart playlist
+          smartPlaylist.addSong(library.slotHandle(row));
+          visited[row] = true; // Mark as visited
         }
       }
     }
@@ -267,9 +685,16 @@ void MusicPlayer::clearHistory() {
 }
 
 void MusicPlayer::clearLibrary() {
+  // Stop running imports, their unpublished songs are dropped
+  for (auto &job : importJobs) {
+    job->cancel();
+    job->wait();
+  }
+  importJobs.clear();
+
   // Stop current playback
   engine.stop();
-  current = nullptr;
+  current = {};
 
   // Clear all queues
   queue.clearQueue();
@@ -279,7 +704,13 @@ void MusicPlayer::clearLibrary() {
   smartPlaylist.clearQueue();
 
   // Clear library and loaded folders
-  library.clear();
+  watcher.clear();
+  tagLoader.clear();
+  lazyCaches.clear();
+  {
+    auto lock = searchService.lockLibrary();
+    library.clear();
+  }
   loadedFolders.clear();
   isShuffleEn = false;
 
@@ -287,8 +718,9 @@ void MusicPlayer::clearLibrary() {
 }
 
 size_t MusicPlayer::addArtistToQueue(const std::string &artistName) {
-  std::vector<const Song *> artistSongs = library.findSongByArtist(artistName);
-  for (const Song *song : artistSongs) {
+  std::vector<const StoredSong *> artistSongs =
+      library.findSongByArtist(artistName);
+  for (const StoredSong *song : artistSongs) {
     addSongToQueue(song);
   }
   std::cout << "Added " << artistSongs.size()
@@ -1,5 +1,6 @@
 // PlaybackHistory.cpp
 #include "../include/PlaybackHistory.h"
+#include <algorithm>
 
 PlaybackHistory::PlaybackHistory(){
     forward.reserve(36);
@@ -7,28 +8,29 @@ PlaybackHistory::PlaybackHistory(){
 
 PlaybackHistory::~PlaybackHistory(){}
 
-const Song* PlaybackHistory::getPreviousSong(){
+SongHandle PlaybackHistory::getPreviousSong(){
     if (history.empty()){
-        return nullptr;
+        return {};
     }
-    const Song* prev = history.top();
+    SongHandle prev = history.top();
     history.pop();
     return prev;
 }
 
-const Song* PlaybackHistory::getForwardSong(){
+SongHandle PlaybackHistory::getForwardSong(){
     if (forward.empty()){
-        return nullptr;
+        return {};
     }
-    const Song* next = forward.back();
+    SongHandle next = forward.back();
     forward.pop_back();
     return next;
 }
 
-std::vector<const Song*> PlaybackHistory::getHistoryList() const {
-    std::vector<const Song*> list;
+std::vector<SongHandle> PlaybackHistory::getHistoryList() const {
+    std::vector<SongHandle> list;
+    list.reserve(history.size());
     // Copy stack to a vector (Standard stack hack: copy it, then pop all)
-    std::stack<const Song*> temp = history; 
+    std::stack<SongHandle, std::vector<SongHandle>> temp = history; 
     while(!temp.empty()){
         list.push_back(temp.top());
         temp.pop();
@@ -36,15 +38,15 @@ std::vector<const Song*> PlaybackHistory::getHistoryList() const {
     return list;
 }
 
-std::vector<const Song*> PlaybackHistory::getForwardList() const {
+std::vector<SongHandle> PlaybackHistory::getForwardList() const {
     return forward;
 }
 
-void PlaybackHistory::addSongToHistory(const Song* song){
+void PlaybackHistory::addSongToHistory(SongHandle song){
     history.push(song);
 }
 
-void PlaybackHistory::addSongToForward(const Song* song){
+void PlaybackHistory::addSongToForward(SongHandle song){
     forward.push_back(song);
 }
 
@@ -67,3 +69,20 @@ size_t PlaybackHistory::getHistorySize() const {
 size_t PlaybackHistory::getForwardSize() const {
     return forward.size();
 }
+
+void PlaybackHistory::removeStale(const MusicLibrary& library){
+    // Unwind the stack (top first), then push back oldest first
+    std::vector<SongHandle> list = getHistoryList();
+    clearHistory();
+    for (auto it = list.rbegin(); it != list.rend(); ++it){
+        if (library.resolve(*it) != nullptr){
+            history.push(*it);
+        }
+    }
+
+    forward.erase(std::remove_if(forward.begin(), forward.end(),
+                                 [&library](SongHandle song){
+                                     return library.resolve(song) == nullptr;
+                                 }),
+                  forward.end());
+}
@@ -1,19 +1,26 @@
 // PlaybackQueue
 
 #include "../include/PlaybackQueue.h"
+#include <algorithm>
 #include <iostream>
 
 PlaybackQueue::PlaybackQueue() {}
 
 PlaybackQueue::~PlaybackQueue() {}
 
-std::list<const Song *> PlaybackQueue::getQueueList() const { return queue; }
+const std::deque<SongHandle> &PlaybackQueue::getQueueList() const {
+  return queue;
+}
 
-void PlaybackQueue::addSong(const Song *song) { queue.push_back(song); }
+void PlaybackQueue::addSong(SongHandle song) {
+  if (!song.isNull()) {
+    queue.push_back(song);
+  }
+}
 
-void PlaybackQueue::removeSong(const Song *targetSong) {
-  queue.remove_if(
-      [targetSong](const Song *ptrSong) { return ptrSong == targetSong; });
+void PlaybackQueue::removeSong(SongHandle targetSong) {
+  queue.erase(std::remove(queue.begin(), queue.end(), targetSong),
+              queue.end());
 }
 
 void PlaybackQueue::clearQueue() {
@@ -33,26 +40,34 @@ size_t PlaybackQueue::getQueueSize() const { return queue.size(); }
 //   return queue.front();
 // }
 
-const Song *PlaybackQueue::getNextSong() {
+SongHandle PlaybackQueue::getNextSong() {
   if (queue.empty()) {
-    return nullptr;
+    return {};
   }
-  const Song *next = queue.front();
+  SongHandle next = queue.front();
   queue.pop_front();
   return next;
 }
 
 size_t PlaybackQueue::addAlbumToQueue(const std::string &albumName, const MusicLibrary &library) {
   int count = 0;
-  for (const auto &song : library) {
-    if (song.album == albumName) {
-
-      const Song *songPtr = library.findSongByID(song.id);
-      if (songPtr) {
-        this->addSong(songPtr);
-        count++;
-      }
+  uint32_t albumId = library.findAlbumId(albumName);
+  const std::vector<uint32_t> &albumIds = library.getColumns().albumIds;
+  for (size_t row = 0; row < albumIds.size(); row++) {
+    if (albumIds[row] == albumId) {
+      this->addSong(library.slotHandle(row));
+      count++;
     }
   }
   return count;
 }
+
+size_t PlaybackQueue::removeStale(const MusicLibrary &library) {
+  size_t before = queue.size();
+  queue.erase(std::remove_if(queue.begin(), queue.end(),
+                             [&library](SongHandle song) {
+                               return library.resolve(song) == nullptr;
+                             }),
+              queue.end());
+  return before - queue.size();
+}
@@ -0,0 +1,176 @@
+// SearchService.cpp
+
+#include "../include/SearchService.h"
+#include <algorithm>
+
+SearchService::SearchService(const MusicLibrary &library,
+                             std::chrono::milliseconds debounce)
+    : library(library), debounce(debounce) {}
+
+SearchService::~SearchService() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+    cancelled = true;
+  }
+  wake.notify_all();
+  if (worker.joinable()) {
+    worker.join();
+  }
+}
+
+void SearchService::submit(std::string_view query) {
+  std::string key = makeSearchKey(query);
+  uint64_t version = library.getVersion();
+  if (submittedAny && key == submittedKey && version == submittedVersion) {
+    return; // same frame again: the result is published or on its way
+  }
+  bool keyChanged = !submittedAny || key != submittedKey;
+  submittedAny = true;
+  submittedKey = key;
+  submittedVersion = version;
+
+  std::lock_guard<std::mutex> lock(mtx);
+  generation++;
+  latestKey = key;
+  if (keyChanged) {
+    cancelled = true; // a running task is for an outdated query
+  }
+
+  if (key.empty()) {
+    pending.reset();
+    published = std::make_shared<SearchSnapshot>(
+        SearchSnapshot{key, version, SearchResult(), {}});
+    publishedGeneration = generation;
+    idle.notify_all();
+    return;
+  }
+  for (auto it = cache.begin(); it != cache.end(); ++it) {
+    if ((*it)->key == key && (*it)->libraryVersion == version) {
+      std::rotate(cache.begin(), it, it + 1); // most recently used first
+      published = cache.front();
+      publishedGeneration = generation;
+      stats.cacheHits++;
+      pending.reset();
+      idle.notify_all();
+      return;
+    }
+  }
+
+  // Typing restarts the wait, a changed library only reruns the query
+  auto due = std::chrono::steady_clock::now() + debounce;
+  if (!keyChanged && pending) {
+    due = pending->due;
+  }
+  pending = Task{key, generation, due};
+  if (!worker.joinable()) {
+    worker = std::thread(&SearchService::run, this);
+  }
+  wake.notify_all();
+}
+
+std::shared_ptr<const SearchSnapshot> SearchService::getSnapshot() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return published;
+}
+
+bool SearchService::isSearching() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return pending.has_value() || running;
+}
+
+void SearchService::wait() {
+  std::unique_lock<std::mutex> lock(mtx);
+  idle.wait(lock, [this] { return !pending && !running; });
+}
+
+std::unique_lock<std::shared_mutex> SearchService::lockLibrary() {
+  return std::unique_lock<std::shared_mutex>(libraryMutex);
+}
+
+SearchStats SearchService::getStats() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return stats;
+}
+
+void SearchService::run() {
+  std::unique_lock<std::mutex> lock(mtx);
+  while (true) {
+    wake.wait(lock, [this] { return stopping || pending; });
+    if (stopping) {
+      return;
+    }
+    if (std::chrono::steady_clock::now() < pending->due) {
+      // Woken early by a newer query or stop: look again
+      wake.wait_until(lock, pending->due);
+      continue;
+    }
+    Task task = std::move(*pending);
+    pending.reset();
+    running = true;
+    cancelled = false;
+    std::shared_ptr<const SearchSnapshot> previous = published;
+    lock.unlock();
+
+    bool refined = false;
+    std::shared_ptr<SearchSnapshot> snapshot =
+        execute(task, std::move(previous), refined);
+
+    lock.lock();
+    running = false;
+    if (snapshot == nullptr) {
+      stats.cancelled++;
+    } else {
+      (refined ? stats.refinements : stats.searches)++;
+      if (task.key == latestKey && task.generation > publishedGeneration) {
+        publish(std::move(snapshot), task.generation);
+      }
+    }
+    idle.notify_all();
+  }
+}
+
+std::shared_ptr<SearchSnapshot>
+SearchService::execute(const Task &task,
+                       std::shared_ptr<const SearchSnapshot> previous,
+                       bool &refined) {
+  std::shared_lock<std::shared_mutex> lock(libraryMutex);
+  auto snapshot = std::make_shared<SearchSnapshot>();
+  snapshot->key = task.key;
+  snapshot->libraryVersion = library.getVersion();
+  // Every song containing the longer query is in the shorter one's result
+  refined = previous != nullptr && !previous->key.empty() &&
+            previous->libraryVersion == snapshot->libraryVersion &&
+            task.key.find(previous->key) != std::string::npos;
+  if (refined) {
+    snapshot->result = library.refine(previous->result, task.key, &cancelled);
+  } else {
+    snapshot->result = library.search(task.key, &cancelled);
+  }
+  if (snapshot->result.songs.size() < FUZZY_LIMIT) {
+    snapshot->fuzzy = library.fuzzySearch(task.key, FUZZY_LIMIT,
+                                          FuzzyWeights(), &cancelled);
+  }
+  if (cancelled) {
+    return nullptr;
+  }
+  return snapshot;
+}
+
+void SearchService::publish(std::shared_ptr<const SearchSnapshot> snapshot,
+                            uint64_t taskGeneration) {
+  // Older library versions never match a query again
+  cache.erase(std::remove_if(cache.begin(), cache.end(),
+                             [&snapshot](const auto &entry) {
+                               return entry->key == snapshot->key ||
+                                      entry->libraryVersion <
+                                          snapshot->libraryVersion;
+                             }),
+              cache.end());
+  cache.insert(cache.begin(), snapshot);
+  if (cache.size() > CACHE_SIZE) {
+    cache.pop_back();
+  }
+  published = std::move(snapshot);
+  publishedGeneration = taskGeneration;
+}
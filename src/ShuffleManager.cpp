@@ -16,7 +16,7 @@ void ShuffleManager::shuffleAll() {
   shuffleHistory.clear();
 }
 
-void ShuffleManager::enableShuffle(std::list<const Song *> queue) {
+void ShuffleManager::enableShuffle(const std::deque<SongHandle> &queue) {
   // Clear previous shuffle session
   shuffleQueue.clear();
   shuffleHistory.clear();
@@ -24,9 +24,7 @@ void ShuffleManager::enableShuffle(std::list<const Song *> queue) {
 
   // Copy all upcoming queue songs (current song is managed separately by
   // MusicPlayer)
-  for (const Song *song : queue) {
-    shuffleQueue.push_back(song);
-  }
+  shuffleQueue.assign(queue.begin(), queue.end());
 
   // Shuffle all songs
   shuffleAll();
@@ -34,10 +32,10 @@ void ShuffleManager::enableShuffle(std::list<const Song *> queue) {
 
 //const Song *ShuffleManager::getCurrentSong() { return shuffleQueue[index]; }
 
-const Song *ShuffleManager::getNextSong() {
+SongHandle ShuffleManager::getNextSong() {
   if (shuffleQueue.empty()) {
     std::cout << "No songs in queue" << std::endl;
-    return nullptr;
+    return {};
   }
   do {
     index++;
@@ -50,22 +48,24 @@ const Song *ShuffleManager::getNextSong() {
   return shuffleQueue[index];
 }
 
-void ShuffleManager::addSong(const Song *song) { shuffleQueue.push_back(song); }
+void ShuffleManager::addSong(SongHandle song) {
+  if (!song.isNull()) {
+    shuffleQueue.push_back(song);
+  }
+}
 
-const std::vector<const Song *> &ShuffleManager::getShuffleList() const {
+const std::vector<SongHandle> &ShuffleManager::getShuffleList() const {
   return shuffleQueue;
 }
 
 size_t ShuffleManager::addAlbumToQueue(const std::string &albumName, const MusicLibrary &library) {
   int count = 0;
-  for (const auto &song : library) {
-    if (song.album == albumName) {
-
-      const Song *songPtr = library.findSongByID(song.id);
-      if (songPtr) {
-        this->addSong(songPtr);
-        count++;
-      }
+  uint32_t albumId = library.findAlbumId(albumName);
+  const std::vector<uint32_t> &albumIds = library.getColumns().albumIds;
+  for (size_t row = 0; row < albumIds.size(); row++) {
+    if (albumIds[row] == albumId) {
+      this->addSong(library.slotHandle(row));
+      count++;
     }
   }
   return count;
@@ -78,3 +78,27 @@ void ShuffleManager::clear() {
   shuffleHistory.clear();
   index = -1;
 }
+
+void ShuffleManager::removeStale(const MusicLibrary &library) {
+  std::vector<SongHandle> kept;
+  kept.reserve(shuffleQueue.size());
+  int keptIndex = -1;
+  for (int i = 0; i < static_cast<int>(shuffleQueue.size()); i++) {
+    if (library.resolve(shuffleQueue[i]) != nullptr) {
+      kept.push_back(shuffleQueue[i]);
+      if (i <= index) {
+        keptIndex++; // dropped songs before the cursor shift it left
+      }
+    }
+  }
+  shuffleQueue.swap(kept);
+  index = keptIndex;
+
+  for (auto it = shuffleHistory.begin(); it != shuffleHistory.end();) {
+    if (library.resolve(*it) == nullptr) {
+      it = shuffleHistory.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
@@ -0,0 +1,61 @@
+// SongColumns.cpp
+
+#include "../include/SongColumns.h"
+#include <algorithm>
+
+void SongColumns::push_back(const StoredSong &song, TitleKeys keys) {
+  ids.push_back(song.id);
+  titles.push_back(song.title);
+  artistIds.push_back(song.artistId);
+  albumIds.push_back(song.albumId);
+  durations.push_back(song.duration);
+  filePaths.push_back(song.filePath);
+  titleSortKeys.push_back(keys.sortKey);
+  titleSearchKeys.push_back(keys.searchKey);
+}
+
+void SongColumns::set(size_t row, const StoredSong &song, TitleKeys keys) {
+  ids[row] = song.id;
+  titles[row] = song.title;
+  artistIds[row] = song.artistId;
+  albumIds[row] = song.albumId;
+  durations[row] = song.duration;
+  filePaths[row] = song.filePath;
+  titleSortKeys[row] = keys.sortKey;
+  titleSearchKeys[row] = keys.searchKey;
+}
+
+TitleKeys SongColumns::getKeys(size_t row) const {
+  return {titleSortKeys[row], titleSearchKeys[row]};
+}
+
+void SongColumns::pop_back() {
+  ids.pop_back();
+  titles.pop_back();
+  artistIds.pop_back();
+  albumIds.pop_back();
+  durations.pop_back();
+  filePaths.pop_back();
+  titleSortKeys.pop_back();
+  titleSearchKeys.pop_back();
+}
+
+void SongColumns::reserve(size_t rows) {
+  if (rows <= ids.capacity()) {
+    return;
+  }
+  rows = std::max(rows, ids.capacity() * 2);
+  ids.reserve(rows);
+  titles.reserve(rows);
+  artistIds.reserve(rows);
+  albumIds.reserve(rows);
+  durations.reserve(rows);
+  filePaths.reserve(rows);
+  titleSortKeys.reserve(rows);
+  titleSearchKeys.reserve(rows);
+}
+
+void SongColumns::clear() {
+  // Fresh vectors - clear() alone would keep the capacity
+  *this = SongColumns();
+}
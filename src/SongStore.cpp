@@ -0,0 +1,71 @@
+// SongStore.cpp
+
+#include "../include/SongStore.h"
+#include <functional>
+#include <memory>
+#include <new>
+
+static std::allocator<StoredSong> blockAllocator;
+
+SongStore::SongStore() {}
+
+SongStore::~SongStore() { clear(); }
+
+bool SongStore::grow() {
+  if (count < capacity()) {
+    return false;
+  }
+  blocks.push_back(blockAllocator.allocate(BLOCK_SIZE));
+  return true;
+}
+
+bool SongStore::push_back(const StoredSong &song) {
+  bool allocated = grow();
+  new (&(*this)[count]) StoredSong(song);
+  count++;
+  return allocated;
+}
+
+bool SongStore::push_back(StoredSong &&song) {
+  bool allocated = grow();
+  new (&(*this)[count]) StoredSong(std::move(song));
+  count++;
+  return allocated;
+}
+
+void SongStore::pop_back() {
+  count--;
+  (*this)[count].~StoredSong();
+}
+
+bool SongStore::reserve(size_t songs) {
+  bool allocated = false;
+  while (capacity() < songs) {
+    blocks.push_back(blockAllocator.allocate(BLOCK_SIZE));
+    allocated = true;
+  }
+  return allocated;
+}
+
+void SongStore::clear() {
+  while (count > 0) {
+    pop_back();
+  }
+  for (StoredSong *block : blocks) {
+    blockAllocator.deallocate(block, BLOCK_SIZE);
+  }
+  blocks.clear();
+}
+
+size_t SongStore::slotOf(const StoredSong *song) const {
+  // std::less: pointers into different blocks compare safely
+  std::less<const StoredSong *> less;
+  for (size_t b = 0; b < blocks.size(); b++) {
+    const StoredSong *first = blocks[b];
+    if (!less(song, first) && less(song, first + BLOCK_SIZE)) {
+      size_t slot = (b << BLOCK_SHIFT) + (song - first);
+      return slot < count ? slot : count;
+    }
+  }
+  return count;
+}
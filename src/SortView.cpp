@@ -0,0 +1,8 @@
+// SortView.cpp
+
+#include "../include/SortView.h"
+#include "../include/MusicLibrary.h"
+
+const StoredSong *SortView::operator[](size_t i) const {
+  return library->resolve((*order)[i]);
+}
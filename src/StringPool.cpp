@@ -0,0 +1,35 @@
+// StringPool.cpp
+
+#include "../include/StringPool.h"
+
+uint32_t StringPool::intern(std::string_view text) {
+  auto it = ids.find(text);
+  if (it != ids.end()) {
+    return it->second;
+  }
+  uint32_t id = static_cast<uint32_t>(strings.size());
+  strings.emplace_back(text);
+  ids.emplace(strings.back(), id); // key views the stored copy
+  textBytes += text.size();
+  return id;
+}
+
+uint32_t StringPool::find(std::string_view text) const {
+  auto it = ids.find(text);
+  return it != ids.end() ? it->second : NONE;
+}
+
+const std::string &StringPool::get(uint32_t id) const {
+  static const std::string empty;
+  return id < strings.size() ? strings[id] : empty;
+}
+
+size_t StringPool::size() const { return strings.size(); }
+
+size_t StringPool::getTextBytes() const { return textBytes; }
+
+void StringPool::clear() {
+  ids.clear();
+  strings.clear();
+  textBytes = 0;
+}
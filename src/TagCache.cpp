@@ -0,0 +1,262 @@
+// TagCache.cpp
+//
+// File layout (native byte order):
+//   header : "MPTC" | u32 version | u64 entry count
+//   record : u32 payload size | payload | u32 crc32(payload)
+//   payload: u64 size | i64 mtime | u64 duration | path | title | artist |
+//            album   (strings are u32 length + UTF-8 bytes)
+
+#include "../include/TagCache.h"
+#include "../include/Checksum.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+static const char MAGIC[4] = {'M', 'P', 'T', 'C'};
+// Smallest record: size, payload with empty strings, crc
+static const size_t MIN_RECORD = 4 + 3 * 8 + 4 * 4 + 4;
+
+// --- HELPERS: binary encoding ---
+template <typename T> static void put(std::string &buf, T value) {
+  buf.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static void putString(std::string &buf, const std::string &s) {
+  put<uint32_t>(buf, static_cast<uint32_t>(s.size()));
+  buf.append(s);
+}
+
+// Bounds-checked reader over a byte range
+struct Reader {
+  const char *pos;
+  const char *end;
+
+  template <typename T> bool get(T &value) {
+    if (end - pos < (ptrdiff_t)sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  bool getString(std::string &s) {
+    uint32_t len = 0;
+    if (!get(len) || end - pos < (ptrdiff_t)len) {
+      return false;
+    }
+    s.assign(pos, len);
+    pos += len;
+    return true;
+  }
+};
+
+TagCache::TagCache(std::string root) : root(std::move(root)) {}
+
+const std::string &TagCache::getRoot() const { return root; }
+
+std::string TagCache::getCacheFile() const {
+  return (fs::u8path(root) / FILE_NAME).u8string();
+}
+
+std::string TagCache::keyOf(const std::string &filePath) const {
+  fs::path rel = fs::u8path(filePath).lexically_relative(fs::u8path(root));
+  if (rel.empty()) {
+    return filePath;
+  }
+  return rel.generic_u8string();
+}
+
+bool TagCache::load() {
+  std::lock_guard<std::mutex> lock(mtx);
+  entries.clear();
+  dirty = false;
+
+  std::ifstream in(fs::u8path(getCacheFile()), std::ios::binary);
+  if (!in) {
+    return false; // no cache yet
+  }
+  std::string data((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  Reader file{data.data(), data.data() + data.size()};
+
+  char magic[4];
+  uint32_t version = 0;
+  uint64_t count = 0;
+  if (!file.get(magic) || std::memcmp(magic, MAGIC, 4) != 0 ||
+      !file.get(version) || version != VERSION || !file.get(count)) {
+    std::cout << "Tag cache ignored (unknown format): " << getCacheFile()
+              << std::endl;
+    dirty = true; // rewrite in current format
+    return false;
+  }
+
+  // A count the file cannot hold is a corrupt header: reserving it would
+  // throw (bad_alloc) on the import thread
+  if (count > static_cast<uint64_t>(file.end - file.pos) / MIN_RECORD) {
+    std::cout << "Tag cache corrupted (" << count << " entries in "
+              << data.size() << " bytes): " << getCacheFile() << std::endl;
+    dirty = true;
+    return false;
+  }
+  entries.reserve(count);
+  for (uint64_t i = 0; i < count; i++) {
+    uint32_t payloadSize = 0;
+    uint32_t storedCrc = 0;
+    if (!file.get(payloadSize) ||
+        file.end - file.pos < (ptrdiff_t)payloadSize + 4) {
+      break;
+    }
+    Reader payload{file.pos, file.pos + payloadSize};
+    file.pos += payloadSize;
+    file.get(storedCrc);
+    if (crc32(payload.pos, payloadSize) != storedCrc) {
+      break;
+    }
+
+    std::string key;
+    Entry entry;
+    uint64_t duration = 0;
+    if (!payload.get(entry.stamp.size) || !payload.get(entry.stamp.mtime) ||
+        !payload.get(duration) || !payload.getString(key) ||
+        !payload.getString(entry.title) || !payload.getString(entry.artist) ||
+        !payload.getString(entry.album)) {
+      break;
+    }
+    entry.duration = duration;
+    entries[std::move(key)] = std::move(entry);
+  }
+
+  if (entries.size() != count) {
+    std::cout << "Tag cache corrupted, kept " << entries.size() << " of "
+              << count << " entries: " << getCacheFile() << std::endl;
+    dirty = true;
+    return false;
+  }
+  return true;
+}
+
+bool TagCache::save() {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (!dirty) {
+    return true;
+  }
+
+  std::string data;
+  data.append(MAGIC, 4);
+  put<uint32_t>(data, VERSION);
+  put<uint64_t>(data, entries.size());
+
+  std::string payload;
+  for (const auto &[key, entry] : entries) {
+    payload.clear();
+    put<uint64_t>(payload, entry.stamp.size);
+    put<int64_t>(payload, entry.stamp.mtime);
+    put<uint64_t>(payload, entry.duration);
+    putString(payload, key);
+    putString(payload, entry.title);
+    putString(payload, entry.artist);
+    putString(payload, entry.album);
+
+    put<uint32_t>(data, static_cast<uint32_t>(payload.size()));
+    data.append(payload);
+    put<uint32_t>(data, crc32(payload.data(), payload.size()));
+  }
+
+  // Write aside, then swap in - a crash never leaves a half-written cache
+  fs::path target = fs::u8path(getCacheFile());
+  fs::path temp = target;
+  temp += ".tmp";
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out.write(data.data(), data.size())) {
+      std::cerr << "Error: Cannot write tag cache -> " << temp.u8string()
+                << std::endl;
+      return false;
+    }
+  }
+  std::error_code ec;
+  fs::rename(temp, target, ec);
+  if (ec) {
+    std::cerr << "Error: Cannot replace tag cache -> " << target.u8string()
+              << std::endl;
+    fs::remove(temp, ec);
+    return false;
+  }
+  dirty = false;
+  return true;
+}
+
+bool TagCache::lookup(const std::string &filePath, const FileStamp &stamp,
+                      Song &song) {
+  std::string key = keyOf(filePath);
+  std::lock_guard<std::mutex> lock(mtx);
+  auto it = entries.find(key);
+  if (it == entries.end() || it->second.stamp.size != stamp.size ||
+      it->second.stamp.mtime != stamp.mtime) {
+    misses++;
+    return false;
+  }
+  Entry &entry = it->second;
+  entry.seen = true;
+  song.title = entry.title;
+  song.artist = entry.artist;
+  song.album = entry.album;
+  song.duration = entry.duration;
+  hits++;
+  return true;
+}
+
+void TagCache::store(const std::string &filePath, const FileStamp &stamp,
+                     const Song &song) {
+  std::string key = keyOf(filePath);
+  std::lock_guard<std::mutex> lock(mtx);
+  Entry &entry = entries[std::move(key)];
+  entry.stamp = stamp;
+  entry.duration = song.duration;
+  entry.title = song.title;
+  entry.artist = song.artist;
+  entry.album = song.album;
+  entry.seen = true;
+  dirty = true;
+}
+
+bool TagCache::lookupOrRead(
+    Song &song,
+    const std::function<void(const std::string &, Song &)> &reader) {
+  if (lookup(song.filePath, song.stamp, song)) {
+    return true;
+  }
+  reader(song.filePath, song);
+  store(song.filePath, song.stamp, song);
+  return false;
+}
+
+size_t TagCache::prune() {
+  std::lock_guard<std::mutex> lock(mtx);
+  size_t removed = 0;
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (!it->second.seen) {
+      it = entries.erase(it);
+      removed++;
+    } else {
+      ++it;
+    }
+  }
+  if (removed > 0) {
+    dirty = true;
+  }
+  return removed;
+}
+
+size_t TagCache::getSize() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return entries.size();
+}
+
+size_t TagCache::getHits() const { return hits; }
+
+size_t TagCache::getMisses() const { return misses; }
@@ -0,0 +1,146 @@
+// TagLoader.cpp
+
+#include "../include/TagLoader.h"
+#include <algorithm>
+#include <unordered_set>
+
+TagLoader::TagLoader(ImportPipeline::MetadataReader reader, size_t workerCount)
+    : reader(std::move(reader)),
+      workerCount(workerCount
+                      ? workerCount
+                      : std::max(1u, std::thread::hardware_concurrency())) {}
+
+TagLoader::~TagLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void TagLoader::ensureStarted() {
+  if (!workers.empty()) {
+    return;
+  }
+  workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; i++) {
+    workers.emplace_back(&TagLoader::run, this);
+  }
+}
+
+void TagLoader::pushTicket(int id, TagPriority priority) {
+  // Screen rows: newest first - queue and background: oldest first
+  tick++;
+  tickets.push({priority, priority == TagPriority::Visible ? -tick : tick, id});
+}
+
+void TagLoader::enqueue(const Song &song, std::shared_ptr<TagCache> cache) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    ensureStarted();
+    Entry &entry = entries[song.id];
+    entry.song = song;
+    entry.cache = std::move(cache);
+    pushTicket(song.id, entry.priority);
+  }
+  wake.notify_one();
+}
+
+void TagLoader::prioritize(const std::vector<int> &ids, TagPriority priority) {
+  std::lock_guard<std::mutex> lock(mtx);
+  uint64_t call = priority == TagPriority::Visible ? ++visibleCalls : 0;
+  for (int id : ids) {
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+      continue;
+    }
+    Entry &entry = it->second;
+    // Rows staying on screen keep their ticket, rows coming back get a
+    // newer one
+    bool reshown = call > 0 && entry.visibleCall + 1 != call;
+    if (call > 0) {
+      entry.visibleCall = call;
+    }
+    if (priority < entry.priority ||
+        (priority == entry.priority && reshown)) {
+      entry.priority = priority;
+      pushTicket(id, priority);
+    }
+  }
+}
+
+size_t TagLoader::takeResults(std::vector<Song> &out, size_t maxSongs) {
+  std::lock_guard<std::mutex> lock(mtx);
+  size_t taken = 0;
+  while (taken < maxSongs && !results.empty()) {
+    out.push_back(std::move(results.front()));
+    results.pop_front();
+    taken++;
+  }
+  return taken;
+}
+
+size_t TagLoader::getPendingCount() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return entries.size() + inFlight + results.size();
+}
+
+size_t TagLoader::cancel(const std::vector<int> &ids) {
+  std::lock_guard<std::mutex> lock(mtx);
+  size_t dropped = 0;
+  for (int id : ids) {
+    dropped += entries.erase(id); // its tickets go stale
+  }
+  std::unordered_set<int> gone(ids.begin(), ids.end());
+  size_t unread = results.size();
+  results.erase(std::remove_if(results.begin(), results.end(),
+                               [&gone](const Song &song) {
+                                 return gone.count(song.id) > 0;
+                               }),
+                results.end());
+  return dropped + unread - results.size();
+}
+
+void TagLoader::clear() {
+  std::lock_guard<std::mutex> lock(mtx);
+  entries.clear();
+  tickets = {};
+  results.clear();
+  epoch++;
+}
+
+void TagLoader::run() {
+  std::unique_lock<std::mutex> lock(mtx);
+  while (true) {
+    wake.wait(lock, [this] { return stopping || !tickets.empty(); });
+    if (stopping) {
+      return;
+    }
+    Ticket ticket = tickets.top();
+    tickets.pop();
+    auto it = entries.find(ticket.id);
+    if (it == entries.end() || it->second.priority != ticket.priority) {
+      continue; // taken already, or re-queued at another priority
+    }
+    Entry entry = std::move(it->second);
+    entries.erase(it);
+    uint64_t startEpoch = epoch;
+    inFlight++;
+
+    lock.unlock();
+    if (entry.cache) {
+      entry.cache->lookupOrRead(entry.song, reader);
+    } else {
+      reader(entry.song.filePath, entry.song);
+    }
+    lock.lock();
+
+    inFlight--;
+    if (epoch == startEpoch) {
+      results.push_back(std::move(entry.song));
+    }
+  }
+}
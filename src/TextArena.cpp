@@ -0,0 +1,42 @@
+// TextArena.cpp
+
+#include "../include/TextArena.h"
+#include <cstring>
+
+std::string_view TextArena::append(std::string_view text) {
+  size_t need = text.size() + 1;
+  char *dest;
+  if (need > CHUNK_SIZE) {
+    // Own chunk, slipped in before the last one so that one keeps filling
+    auto big = std::make_unique<char[]>(need);
+    dest = big.get();
+    chunks.insert(chunks.empty() ? chunks.end() : chunks.end() - 1,
+                  std::move(big));
+    chunkBytes += need;
+  } else {
+    if (chunkEnd - used < need) {
+      chunks.push_back(std::make_unique<char[]>(CHUNK_SIZE));
+      used = 0;
+      chunkEnd = CHUNK_SIZE;
+      chunkBytes += CHUNK_SIZE;
+    }
+    dest = chunks.back().get() + used;
+    used += need;
+  }
+  std::memcpy(dest, text.data(), text.size());
+  dest[text.size()] = '\0';
+  textBytes += text.size();
+  return {dest, text.size()};
+}
+
+size_t TextArena::getTextBytes() const { return textBytes; }
+
+size_t TextArena::getChunkBytes() const { return chunkBytes; }
+
+void TextArena::clear() {
+  chunks.clear();
+  used = 0;
+  chunkEnd = 0;
+  textBytes = 0;
+  chunkBytes = 0;
+}
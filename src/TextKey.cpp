@@ -0,0 +1,606 @@
+// TextKey.cpp
+
+#include "../include/TextKey.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+struct Decomposition {
+  uint16_t codePoint;
+  char base;
+  uint16_t mark1;
+  uint16_t mark2; // 0 = none
+};
+
+struct Composition {
+  char32_t first;
+  char32_t mark;
+  char32_t composite;
+};
+
+// Precomposed Latin letters (Latin-1, Extended-A/B, Extended Additional):
+// canonical decomposition into an ASCII letter and up to two marks in
+// canonical order. Generated from the Unicode database
+const Decomposition DECOMPOSITIONS[] = {
+    {0xC0, 'A', 0x300, 0}, {0xC1, 'A', 0x301, 0}, {0xC2, 'A', 0x302, 0},
+    {0xC3, 'A', 0x303, 0}, {0xC4, 'A', 0x308, 0}, {0xC5, 'A', 0x30A, 0},
+    {0xC7, 'C', 0x327, 0}, {0xC8, 'E', 0x300, 0}, {0xC9, 'E', 0x301, 0},
+    {0xCA, 'E', 0x302, 0}, {0xCB, 'E', 0x308, 0}, {0xCC, 'I', 0x300, 0},
+    {0xCD, 'I', 0x301, 0}, {0xCE, 'I', 0x302, 0}, {0xCF, 'I', 0x308, 0},
+    {0xD1, 'N', 0x303, 0}, {0xD2, 'O', 0x300, 0}, {0xD3, 'O', 0x301, 0},
+    {0xD4, 'O', 0x302, 0}, {0xD5, 'O', 0x303, 0}, {0xD6, 'O', 0x308, 0},
+    {0xD9, 'U', 0x300, 0}, {0xDA, 'U', 0x301, 0}, {0xDB, 'U', 0x302, 0},
+    {0xDC, 'U', 0x308, 0}, {0xDD, 'Y', 0x301, 0}, {0xE0, 'a', 0x300, 0},
+    {0xE1, 'a', 0x301, 0}, {0xE2, 'a', 0x302, 0}, {0xE3, 'a', 0x303, 0},
+    {0xE4, 'a', 0x308, 0}, {0xE5, 'a', 0x30A, 0}, {0xE7, 'c', 0x327, 0},
+    {0xE8, 'e', 0x300, 0}, {0xE9, 'e', 0x301, 0}, {0xEA, 'e', 0x302, 0},
+    {0xEB, 'e', 0x308, 0}, {0xEC, 'i', 0x300, 0}, {0xED, 'i', 0x301, 0},
+    {0xEE, 'i', 0x302, 0}, {0xEF, 'i', 0x308, 0}, {0xF1, 'n', 0x303, 0},
+    {0xF2, 'o', 0x300, 0}, {0xF3, 'o', 0x301, 0}, {0xF4, 'o', 0x302, 0},
+    {0xF5, 'o', 0x303, 0}, {0xF6, 'o', 0x308, 0}, {0xF9, 'u', 0x300, 0},
+    {0xFA, 'u', 0x301, 0}, {0xFB, 'u', 0x302, 0}, {0xFC, 'u', 0x308, 0},
+    {0xFD, 'y', 0x301, 0}, {0xFF, 'y', 0x308, 0}, {0x100, 'A', 0x304, 0},
+    {0x101, 'a', 0x304, 0}, {0x102, 'A', 0x306, 0}, {0x103, 'a', 0x306, 0},
+    {0x104, 'A', 0x328, 0}, {0x105, 'a', 0x328, 0}, {0x106, 'C', 0x301, 0},
+    {0x107, 'c', 0x301, 0}, {0x108, 'C', 0x302, 0}, {0x109, 'c', 0x302, 0},
+    {0x10A, 'C', 0x307, 0}, {0x10B, 'c', 0x307, 0}, {0x10C, 'C', 0x30C, 0},
+    {0x10D, 'c', 0x30C, 0}, {0x10E, 'D', 0x30C, 0}, {0x10F, 'd', 0x30C, 0},
+    {0x112, 'E', 0x304, 0}, {0x113, 'e', 0x304, 0}, {0x114, 'E', 0x306, 0},
+    {0x115, 'e', 0x306, 0}, {0x116, 'E', 0x307, 0}, {0x117, 'e', 0x307, 0},
+    {0x118, 'E', 0x328, 0}, {0x119, 'e', 0x328, 0}, {0x11A, 'E', 0x30C, 0},
+    {0x11B, 'e', 0x30C, 0}, {0x11C, 'G', 0x302, 0}, {0x11D, 'g', 0x302, 0},
+    {0x11E, 'G', 0x306, 0}, {0x11F, 'g', 0x306, 0}, {0x120, 'G', 0x307, 0},
+    {0x121, 'g', 0x307, 0}, {0x122, 'G', 0x327, 0}, {0x123, 'g', 0x327, 0},
+    {0x124, 'H', 0x302, 0}, {0x125, 'h', 0x302, 0}, {0x128, 'I', 0x303, 0},
+    {0x129, 'i', 0x303, 0}, {0x12A, 'I', 0x304, 0}, {0x12B, 'i', 0x304, 0},
+    {0x12C, 'I', 0x306, 0}, {0x12D, 'i', 0x306, 0}, {0x12E, 'I', 0x328, 0},
+    {0x12F, 'i', 0x328, 0}, {0x130, 'I', 0x307, 0}, {0x134, 'J', 0x302, 0},
+    {0x135, 'j', 0x302, 0}, {0x136, 'K', 0x327, 0}, {0x137, 'k', 0x327, 0},
+    {0x139, 'L', 0x301, 0}, {0x13A, 'l', 0x301, 0}, {0x13B, 'L', 0x327, 0},
+    {0x13C, 'l', 0x327, 0}, {0x13D, 'L', 0x30C, 0}, {0x13E, 'l', 0x30C, 0},
+    {0x143, 'N', 0x301, 0}, {0x144, 'n', 0x301, 0}, {0x145, 'N', 0x327, 0},
+    {0x146, 'n', 0x327, 0}, {0x147, 'N', 0x30C, 0}, {0x148, 'n', 0x30C, 0},
+    {0x14C, 'O', 0x304, 0}, {0x14D, 'o', 0x304, 0}, {0x14E, 'O', 0x306, 0},
+    {0x14F, 'o', 0x306, 0}, {0x150, 'O', 0x30B, 0}, {0x151, 'o', 0x30B, 0},
+    {0x154, 'R', 0x301, 0}, {0x155, 'r', 0x301, 0}, {0x156, 'R', 0x327, 0},
+    {0x157, 'r', 0x327, 0}, {0x158, 'R', 0x30C, 0}, {0x159, 'r', 0x30C, 0},
+    {0x15A, 'S', 0x301, 0}, {0x15B, 's', 0x301, 0}, {0x15C, 'S', 0x302, 0},
+    {0x15D, 's', 0x302, 0}, {0x15E, 'S', 0x327, 0}, {0x15F, 's', 0x327, 0},
+    {0x160, 'S', 0x30C, 0}, {0x161, 's', 0x30C, 0}, {0x162, 'T', 0x327, 0},
+    {0x163, 't', 0x327, 0}, {0x164, 'T', 0x30C, 0}, {0x165, 't', 0x30C, 0},
+    {0x168, 'U', 0x303, 0}, {0x169, 'u', 0x303, 0}, {0x16A, 'U', 0x304, 0},
+    {0x16B, 'u', 0x304, 0}, {0x16C, 'U', 0x306, 0}, {0x16D, 'u', 0x306, 0},
+    {0x16E, 'U', 0x30A, 0}, {0x16F, 'u', 0x30A, 0}, {0x170, 'U', 0x30B, 0},
+    {0x171, 'u', 0x30B, 0}, {0x172, 'U', 0x328, 0}, {0x173, 'u', 0x328, 0},
+    {0x174, 'W', 0x302, 0}, {0x175, 'w', 0x302, 0}, {0x176, 'Y', 0x302, 0},
+    {0x177, 'y', 0x302, 0}, {0x178, 'Y', 0x308, 0}, {0x179, 'Z', 0x301, 0},
+    {0x17A, 'z', 0x301, 0}, {0x17B, 'Z', 0x307, 0}, {0x17C, 'z', 0x307, 0},
+    {0x17D, 'Z', 0x30C, 0}, {0x17E, 'z', 0x30C, 0}, {0x1A0, 'O', 0x31B, 0},
+    {0x1A1, 'o', 0x31B, 0}, {0x1AF, 'U', 0x31B, 0}, {0x1B0, 'u', 0x31B, 0},
+    {0x1CD, 'A', 0x30C, 0}, {0x1CE, 'a', 0x30C, 0}, {0x1CF, 'I', 0x30C, 0},
+    {0x1D0, 'i', 0x30C, 0}, {0x1D1, 'O', 0x30C, 0}, {0x1D2, 'o', 0x30C, 0},
+    {0x1D3, 'U', 0x30C, 0}, {0x1D4, 'u', 0x30C, 0}, {0x1D5, 'U', 0x308, 0x304},
+    {0x1D6, 'u', 0x308, 0x304}, {0x1D7, 'U', 0x308, 0x301},
+    {0x1D8, 'u', 0x308, 0x301}, {0x1D9, 'U', 0x308, 0x30C},
+    {0x1DA, 'u', 0x308, 0x30C}, {0x1DB, 'U', 0x308, 0x300},
+    {0x1DC, 'u', 0x308, 0x300}, {0x1DE, 'A', 0x308, 0x304},
+    {0x1DF, 'a', 0x308, 0x304}, {0x1E0, 'A', 0x307, 0x304},
+    {0x1E1, 'a', 0x307, 0x304}, {0x1E6, 'G', 0x30C, 0}, {0x1E7, 'g', 0x30C, 0},
+    {0x1E8, 'K', 0x30C, 0}, {0x1E9, 'k', 0x30C, 0}, {0x1EA, 'O', 0x328, 0},
+    {0x1EB, 'o', 0x328, 0}, {0x1EC, 'O', 0x328, 0x304},
+    {0x1ED, 'o', 0x328, 0x304}, {0x1F0, 'j', 0x30C, 0}, {0x1F4, 'G', 0x301, 0},
+    {0x1F5, 'g', 0x301, 0}, {0x1F8, 'N', 0x300, 0}, {0x1F9, 'n', 0x300, 0},
+    {0x1FA, 'A', 0x30A, 0x301}, {0x1FB, 'a', 0x30A, 0x301},
+    {0x200, 'A', 0x30F, 0}, {0x201, 'a', 0x30F, 0}, {0x202, 'A', 0x311, 0},
+    {0x203, 'a', 0x311, 0}, {0x204, 'E', 0x30F, 0}, {0x205, 'e', 0x30F, 0},
+    {0x206, 'E', 0x311, 0}, {0x207, 'e', 0x311, 0}, {0x208, 'I', 0x30F, 0},
+    {0x209, 'i', 0x30F, 0}, {0x20A, 'I', 0x311, 0}, {0x20B, 'i', 0x311, 0},
+    {0x20C, 'O', 0x30F, 0}, {0x20D, 'o', 0x30F, 0}, {0x20E, 'O', 0x311, 0},
+    {0x20F, 'o', 0x311, 0}, {0x210, 'R', 0x30F, 0}, {0x211, 'r', 0x30F, 0},
+    {0x212, 'R', 0x311, 0}, {0x213, 'r', 0x311, 0}, {0x214, 'U', 0x30F, 0},
+    {0x215, 'u', 0x30F, 0}, {0x216, 'U', 0x311, 0}, {0x217, 'u', 0x311, 0},
+    {0x218, 'S', 0x326, 0}, {0x219, 's', 0x326, 0}, {0x21A, 'T', 0x326, 0},
+    {0x21B, 't', 0x326, 0}, {0x21E, 'H', 0x30C, 0}, {0x21F, 'h', 0x30C, 0},
+    {0x226, 'A', 0x307, 0}, {0x227, 'a', 0x307, 0}, {0x228, 'E', 0x327, 0},
+    {0x229, 'e', 0x327, 0}, {0x22A, 'O', 0x308, 0x304},
+    {0x22B, 'o', 0x308, 0x304}, {0x22C, 'O', 0x303, 0x304},
+    {0x22D, 'o', 0x303, 0x304}, {0x22E, 'O', 0x307, 0}, {0x22F, 'o', 0x307, 0},
+    {0x230, 'O', 0x307, 0x304}, {0x231, 'o', 0x307, 0x304},
+    {0x232, 'Y', 0x304, 0}, {0x233, 'y', 0x304, 0}, {0x1E00, 'A', 0x325, 0},
+    {0x1E01, 'a', 0x325, 0}, {0x1E02, 'B', 0x307, 0}, {0x1E03, 'b', 0x307, 0},
+    {0x1E04, 'B', 0x323, 0}, {0x1E05, 'b', 0x323, 0}, {0x1E06, 'B', 0x331, 0},
+    {0x1E07, 'b', 0x331, 0}, {0x1E08, 'C', 0x327, 0x301},
+    {0x1E09, 'c', 0x327, 0x301}, {0x1E0A, 'D', 0x307, 0},
+    {0x1E0B, 'd', 0x307, 0}, {0x1E0C, 'D', 0x323, 0}, {0x1E0D, 'd', 0x323, 0},
+    {0x1E0E, 'D', 0x331, 0}, {0x1E0F, 'd', 0x331, 0}, {0x1E10, 'D', 0x327, 0},
+    {0x1E11, 'd', 0x327, 0}, {0x1E12, 'D', 0x32D, 0}, {0x1E13, 'd', 0x32D, 0},
+    {0x1E14, 'E', 0x304, 0x300}, {0x1E15, 'e', 0x304, 0x300},
+    {0x1E16, 'E', 0x304, 0x301}, {0x1E17, 'e', 0x304, 0x301},
+    {0x1E18, 'E', 0x32D, 0}, {0x1E19, 'e', 0x32D, 0}, {0x1E1A, 'E', 0x330, 0},
+    {0x1E1B, 'e', 0x330, 0}, {0x1E1C, 'E', 0x327, 0x306},
+    {0x1E1D, 'e', 0x327, 0x306}, {0x1E1E, 'F', 0x307, 0},
+    {0x1E1F, 'f', 0x307, 0}, {0x1E20, 'G', 0x304, 0}, {0x1E21, 'g', 0x304, 0},
+    {0x1E22, 'H', 0x307, 0}, {0x1E23, 'h', 0x307, 0}, {0x1E24, 'H', 0x323, 0},
+    {0x1E25, 'h', 0x323, 0}, {0x1E26, 'H', 0x308, 0}, {0x1E27, 'h', 0x308, 0},
+    {0x1E28, 'H', 0x327, 0}, {0x1E29, 'h', 0x327, 0}, {0x1E2A, 'H', 0x32E, 0},
+    {0x1E2B, 'h', 0x32E, 0}, {0x1E2C, 'I', 0x330, 0}, {0x1E2D, 'i', 0x330, 0},
+    {0x1E2E, 'I', 0x308, 0x301}, {0x1E2F, 'i', 0x308, 0x301},
+    {0x1E30, 'K', 0x301, 0}, {0x1E31, 'k', 0x301, 0}, {0x1E32, 'K', 0x323, 0},
+    {0x1E33, 'k', 0x323, 0}, {0x1E34, 'K', 0x331, 0}, {0x1E35, 'k', 0x331, 0},
+    {0x1E36, 'L', 0x323, 0}, {0x1E37, 'l', 0x323, 0},
+    {0x1E38, 'L', 0x323, 0x304}, {0x1E39, 'l', 0x323, 0x304},
+    {0x1E3A, 'L', 0x331, 0}, {0x1E3B, 'l', 0x331, 0}, {0x1E3C, 'L', 0x32D, 0},
+    {0x1E3D, 'l', 0x32D, 0}, {0x1E3E, 'M', 0x301, 0}, {0x1E3F, 'm', 0x301, 0},
+    {0x1E40, 'M', 0x307, 0}, {0x1E41, 'm', 0x307, 0}, {0x1E42, 'M', 0x323, 0},
+    {0x1E43, 'm', 0x323, 0}, {0x1E44, 'N', 0x307, 0}, {0x1E45, 'n', 0x307, 0},
+    {0x1E46, 'N', 0x323, 0}, {0x1E47, 'n', 0x323, 0}, {0x1E48, 'N', 0x331, 0},
+    {0x1E49, 'n', 0x331, 0}, {0x1E4A, 'N', 0x32D, 0}, {0x1E4B, 'n', 0x32D, 0},
+    {0x1E4C, 'O', 0x303, 0x301}, {0x1E4D, 'o', 0x303, 0x301},
+    {0x1E4E, 'O', 0x303, 0x308}, {0x1E4F, 'o', 0x303, 0x308},
+    {0x1E50, 'O', 0x304, 0x300}, {0x1E51, 'o', 0x304, 0x300},
+    {0x1E52, 'O', 0x304, 0x301}, {0x1E53, 'o', 0x304, 0x301},
+    {0x1E54, 'P', 0x301, 0}, {0x1E55, 'p', 0x301, 0}, {0x1E56, 'P', 0x307, 0},
+    {0x1E57, 'p', 0x307, 0}, {0x1E58, 'R', 0x307, 0}, {0x1E59, 'r', 0x307, 0},
+    {0x1E5A, 'R', 0x323, 0}, {0x1E5B, 'r', 0x323, 0},
+    {0x1E5C, 'R', 0x323, 0x304}, {0x1E5D, 'r', 0x323, 0x304},
+    {0x1E5E, 'R', 0x331, 0}, {0x1E5F, 'r', 0x331, 0}, {0x1E60, 'S', 0x307, 0},
+    {0x1E61, 's', 0x307, 0}, {0x1E62, 'S', 0x323, 0}, {0x1E63, 's', 0x323, 0},
+    {0x1E64, 'S', 0x301, 0x307}, {0x1E65, 's', 0x301, 0x307},
+    {0x1E66, 'S', 0x30C, 0x307}, {0x1E67, 's', 0x30C, 0x307},
+    {0x1E68, 'S', 0x323, 0x307}, {0x1E69, 's', 0x323, 0x307},
+    {0x1E6A, 'T', 0x307, 0}, {0x1E6B, 't', 0x307, 0}, {0x1E6C, 'T', 0x323, 0},
+    {0x1E6D, 't', 0x323, 0}, {0x1E6E, 'T', 0x331, 0}, {0x1E6F, 't', 0x331, 0},
+    {0x1E70, 'T', 0x32D, 0}, {0x1E71, 't', 0x32D, 0}, {0x1E72, 'U', 0x324, 0},
+    {0x1E73, 'u', 0x324, 0}, {0x1E74, 'U', 0x330, 0}, {0x1E75, 'u', 0x330, 0},
+    {0x1E76, 'U', 0x32D, 0}, {0x1E77, 'u', 0x32D, 0},
+    {0x1E78, 'U', 0x303, 0x301}, {0x1E79, 'u', 0x303, 0x301},
+    {0x1E7A, 'U', 0x304, 0x308}, {0x1E7B, 'u', 0x304, 0x308},
+    {0x1E7C, 'V', 0x303, 0}, {0x1E7D, 'v', 0x303, 0}, {0x1E7E, 'V', 0x323, 0},
+    {0x1E7F, 'v', 0x323, 0}, {0x1E80, 'W', 0x300, 0}, {0x1E81, 'w', 0x300, 0},
+    {0x1E82, 'W', 0x301, 0}, {0x1E83, 'w', 0x301, 0}, {0x1E84, 'W', 0x308, 0},
+    {0x1E85, 'w', 0x308, 0}, {0x1E86, 'W', 0x307, 0}, {0x1E87, 'w', 0x307, 0},
+    {0x1E88, 'W', 0x323, 0}, {0x1E89, 'w', 0x323, 0}, {0x1E8A, 'X', 0x307, 0},
+    {0x1E8B, 'x', 0x307, 0}, {0x1E8C, 'X', 0x308, 0}, {0x1E8D, 'x', 0x308, 0},
+    {0x1E8E, 'Y', 0x307, 0}, {0x1E8F, 'y', 0x307, 0}, {0x1E90, 'Z', 0x302, 0},
+    {0x1E91, 'z', 0x302, 0}, {0x1E92, 'Z', 0x323, 0}, {0x1E93, 'z', 0x323, 0},
+    {0x1E94, 'Z', 0x331, 0}, {0x1E95, 'z', 0x331, 0}, {0x1E96, 'h', 0x331, 0},
+    {0x1E97, 't', 0x308, 0}, {0x1E98, 'w', 0x30A, 0}, {0x1E99, 'y', 0x30A, 0},
+    {0x1EA0, 'A', 0x323, 0}, {0x1EA1, 'a', 0x323, 0}, {0x1EA2, 'A', 0x309, 0},
+    {0x1EA3, 'a', 0x309, 0}, {0x1EA4, 'A', 0x302, 0x301},
+    {0x1EA5, 'a', 0x302, 0x301}, {0x1EA6, 'A', 0x302, 0x300},
+    {0x1EA7, 'a', 0x302, 0x300}, {0x1EA8, 'A', 0x302, 0x309},
+    {0x1EA9, 'a', 0x302, 0x309}, {0x1EAA, 'A', 0x302, 0x303},
+    {0x1EAB, 'a', 0x302, 0x303}, {0x1EAC, 'A', 0x323, 0x302},
+    {0x1EAD, 'a', 0x323, 0x302}, {0x1EAE, 'A', 0x306, 0x301},
+    {0x1EAF, 'a', 0x306, 0x301}, {0x1EB0, 'A', 0x306, 0x300},
+    {0x1EB1, 'a', 0x306, 0x300}, {0x1EB2, 'A', 0x306, 0x309},
+    {0x1EB3, 'a', 0x306, 0x309}, {0x1EB4, 'A', 0x306, 0x303},
+    {0x1EB5, 'a', 0x306, 0x303}, {0x1EB6, 'A', 0x323, 0x306},
+    {0x1EB7, 'a', 0x323, 0x306}, {0x1EB8, 'E', 0x323, 0},
+    {0x1EB9, 'e', 0x323, 0}, {0x1EBA, 'E', 0x309, 0}, {0x1EBB, 'e', 0x309, 0},
+    {0x1EBC, 'E', 0x303, 0}, {0x1EBD, 'e', 0x303, 0},
+    {0x1EBE, 'E', 0x302, 0x301}, {0x1EBF, 'e', 0x302, 0x301},
+    {0x1EC0, 'E', 0x302, 0x300}, {0x1EC1, 'e', 0x302, 0x300},
+    {0x1EC2, 'E', 0x302, 0x309}, {0x1EC3, 'e', 0x302, 0x309},
+    {0x1EC4, 'E', 0x302, 0x303}, {0x1EC5, 'e', 0x302, 0x303},
+    {0x1EC6, 'E', 0x323, 0x302}, {0x1EC7, 'e', 0x323, 0x302},
+    {0x1EC8, 'I', 0x309, 0}, {0x1EC9, 'i', 0x309, 0}, {0x1ECA, 'I', 0x323, 0},
+    {0x1ECB, 'i', 0x323, 0}, {0x1ECC, 'O', 0x323, 0}, {0x1ECD, 'o', 0x323, 0},
+    {0x1ECE, 'O', 0x309, 0}, {0x1ECF, 'o', 0x309, 0},
+    {0x1ED0, 'O', 0x302, 0x301}, {0x1ED1, 'o', 0x302, 0x301},
+    {0x1ED2, 'O', 0x302, 0x300}, {0x1ED3, 'o', 0x302, 0x300},
+    {0x1ED4, 'O', 0x302, 0x309}, {0x1ED5, 'o', 0x302, 0x309},
+    {0x1ED6, 'O', 0x302, 0x303}, {0x1ED7, 'o', 0x302, 0x303},
+    {0x1ED8, 'O', 0x323, 0x302}, {0x1ED9, 'o', 0x323, 0x302},
+    {0x1EDA, 'O', 0x31B, 0x301}, {0x1EDB, 'o', 0x31B, 0x301},
+    {0x1EDC, 'O', 0x31B, 0x300}, {0x1EDD, 'o', 0x31B, 0x300},
+    {0x1EDE, 'O', 0x31B, 0x309}, {0x1EDF, 'o', 0x31B, 0x309},
+    {0x1EE0, 'O', 0x31B, 0x303}, {0x1EE1, 'o', 0x31B, 0x303},
+    {0x1EE2, 'O', 0x31B, 0x323}, {0x1EE3, 'o', 0x31B, 0x323},
+    {0x1EE4, 'U', 0x323, 0}, {0x1EE5, 'u', 0x323, 0}, {0x1EE6, 'U', 0x309, 0},
+    {0x1EE7, 'u', 0x309, 0}, {0x1EE8, 'U', 0x31B, 0x301},
+    {0x1EE9, 'u', 0x31B, 0x301}, {0x1EEA, 'U', 0x31B, 0x300},
+    {0x1EEB, 'u', 0x31B, 0x300}, {0x1EEC, 'U', 0x31B, 0x309},
+    {0x1EED, 'u', 0x31B, 0x309}, {0x1EEE, 'U', 0x31B, 0x303},
+    {0x1EEF, 'u', 0x31B, 0x303}, {0x1EF0, 'U', 0x31B, 0x323},
+    {0x1EF1, 'u', 0x31B, 0x323}, {0x1EF2, 'Y', 0x300, 0},
+    {0x1EF3, 'y', 0x300, 0}, {0x1EF4, 'Y', 0x323, 0}, {0x1EF5, 'y', 0x323, 0},
+    {0x1EF6, 'Y', 0x309, 0}, {0x1EF7, 'y', 0x309, 0}, {0x1EF8, 'Y', 0x303, 0},
+    {0x1EF9, 'y', 0x303, 0},
+};
+
+// Canonical combining class of U+0300..U+036F (other code points: 0)
+const uint8_t COMBINING_CLASS[0x70] = {
+    230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+    230, 230, 230, 230, 230, 230, 230, 230, 230, 232, 220, 220,
+    220, 220, 232, 216, 220, 220, 220, 220, 220, 202, 202, 220,
+    220, 220, 220, 202, 202, 220, 220, 220, 220, 220, 220, 220,
+    220, 220, 220, 220, 1,   1,   1,   1,   1,   220, 220, 220,
+    220, 230, 230, 230, 230, 230, 230, 230, 230, 240, 230, 220,
+    220, 220, 230, 230, 230, 220, 220, 0,   230, 230, 230, 220,
+    220, 220, 220, 230, 232, 220, 220, 230, 233, 234, 234, 233,
+    234, 234, 233, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+    230, 230, 230, 230,
+};
+
+constexpr char32_t REPLACEMENT = 0xFFFD;
+constexpr char32_t GRAVE = 0x300, ACUTE = 0x301, CIRCUMFLEX = 0x302;
+constexpr char32_t TILDE = 0x303, BREVE = 0x306, HOOK = 0x309;
+constexpr char32_t HORN = 0x31B, DOT_BELOW = 0x323;
+constexpr char32_t D_STROKE = 0x111, D_STROKE_UPPER = 0x110;
+constexpr char32_t STROKE = 1; // pseudo mark: đ does not decompose
+
+// Vietnamese alphabet (plus f j w z): letter + mark that makes it a letter
+struct AlphabetLetter {
+  char base;
+  char32_t mark;
+};
+const AlphabetLetter ALPHABET[] = {
+    {'a', 0},     {'a', BREVE}, {'a', CIRCUMFLEX}, {'b', 0},
+    {'c', 0},     {'d', 0},     {'d', STROKE},     {'e', 0},
+    {'e', CIRCUMFLEX}, {'f', 0}, {'g', 0},         {'h', 0},
+    {'i', 0},     {'j', 0},     {'k', 0},          {'l', 0},
+    {'m', 0},     {'n', 0},     {'o', 0},          {'o', CIRCUMFLEX},
+    {'o', HORN},  {'p', 0},     {'q', 0},          {'r', 0},
+    {'s', 0},     {'t', 0},     {'u', 0},          {'u', HORN},
+    {'v', 0},     {'w', 0},     {'x', 0},          {'y', 0},
+    {'z', 0},
+};
+
+// Alphabet position of a base letter plus its letter-making mark (or 0)
+int alphabetIndex(char base, char32_t mark) {
+  static const std::array<int, 26> plain = [] {
+    std::array<int, 26> index{};
+    for (size_t k = 0; k < std::size(ALPHABET); k++) {
+      if (ALPHABET[k].mark == 0) {
+        index[ALPHABET[k].base - 'a'] = int(k);
+      }
+    }
+    return index;
+  }();
+  if (mark == 0) {
+    return plain[base - 'a'];
+  }
+  for (size_t k = 0; k < std::size(ALPHABET); k++) {
+    if (ALPHABET[k].base == base && ALPHABET[k].mark == mark) {
+      return int(k);
+    }
+  }
+  return -1;
+}
+
+// Tones in dictionary order: none, huyền, hỏi, ngã, sắc, nặng
+const char32_t TONES[] = {GRAVE, HOOK, TILDE, ACUTE, DOT_BELOW};
+
+// Key bytes: LEVEL_SEPARATOR < every weight, so shorter texts sort first
+constexpr char LEVEL_SEPARATOR = 0x01;
+constexpr unsigned char WEIGHT_MIN = 0x02;      // also "no mark", lower case
+constexpr unsigned char DIGIT_WEIGHT = 0x61;    // after ASCII punctuation
+constexpr unsigned char LETTER_WEIGHT = 0x6B;   // after digits
+constexpr unsigned char OTHER_WEIGHT = 0xF0;    // + 3 bytes of code point
+constexpr unsigned char OTHER_MARK_WEIGHT = 0x08; // after the tones
+
+uint8_t combiningClass(char32_t cp) {
+  return cp >= 0x300 && cp < 0x370 ? COMBINING_CLASS[cp - 0x300] : 0;
+}
+
+const Decomposition *findDecomposition(char32_t cp) {
+  if (cp < DECOMPOSITIONS[0].codePoint) {
+    return nullptr; // ASCII and other unaccented text
+  }
+  auto it = std::lower_bound(
+      std::begin(DECOMPOSITIONS), std::end(DECOMPOSITIONS), cp,
+      [](const Decomposition &d, char32_t key) { return d.codePoint < key; });
+  return it != std::end(DECOMPOSITIONS) && it->codePoint == cp ? &*it
+                                                               : nullptr;
+}
+
+bool findComposition(const std::vector<Composition> &table, char32_t first,
+                     char32_t mark, char32_t &composite) {
+  auto it = std::lower_bound(table.begin(), table.end(),
+                             Composition{first, mark, 0},
+                             [](const Composition &a, const Composition &b) {
+                               return a.first != b.first ? a.first < b.first
+                                                         : a.mark < b.mark;
+                             });
+  if (it == table.end() || it->first != first || it->mark != mark) {
+    return false;
+  }
+  composite = it->composite;
+  return true;
+}
+
+// (first, mark) -> composite pairs, derived once from DECOMPOSITIONS:
+// a two-mark letter composes from its one-mark letter plus the last mark
+const std::vector<Composition> &compositions() {
+  static const std::vector<Composition> table = [] {
+    auto byPair = [](const Composition &a, const Composition &b) {
+      return a.first != b.first ? a.first < b.first : a.mark < b.mark;
+    };
+    std::vector<Composition> pairs;
+    for (const Decomposition &d : DECOMPOSITIONS) {
+      if (d.mark2 == 0) {
+        pairs.push_back({char32_t(d.base), d.mark1, d.codePoint});
+      }
+    }
+    std::sort(pairs.begin(), pairs.end(), byPair);
+    std::vector<Composition> twoMarks;
+    for (const Decomposition &d : DECOMPOSITIONS) {
+      char32_t first;
+      if (d.mark2 != 0 &&
+          findComposition(pairs, char32_t(d.base), d.mark1, first)) {
+        twoMarks.push_back({first, d.mark2, d.codePoint});
+      }
+    }
+    pairs.insert(pairs.end(), twoMarks.begin(), twoMarks.end());
+    std::sort(pairs.begin(), pairs.end(), byPair);
+    return pairs;
+  }();
+  return table;
+}
+
+char32_t decodeUtf8(std::string_view text, size_t &pos) {
+  static const char32_t MIN_VALUE[] = {0, 0, 0x80, 0x800, 0x10000};
+  unsigned char lead = text[pos];
+  size_t length;
+  char32_t cp;
+  if (lead < 0x80) {
+    pos++;
+    return lead;
+  } else if ((lead & 0xE0) == 0xC0) {
+    length = 2;
+    cp = lead & 0x1F;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 3;
+    cp = lead & 0x0F;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 4;
+    cp = lead & 0x07;
+  } else {
+    pos++;
+    return REPLACEMENT;
+  }
+  if (pos + length > text.size()) {
+    pos++;
+    return REPLACEMENT;
+  }
+  for (size_t k = 1; k < length; k++) {
+    unsigned char next = text[pos + k];
+    if ((next & 0xC0) != 0x80) {
+      pos++;
+      return REPLACEMENT;
+    }
+    cp = cp << 6 | (next & 0x3F);
+  }
+  pos += length;
+  bool surrogate = cp >= 0xD800 && cp <= 0xDFFF;
+  if (cp < MIN_VALUE[length] || cp > 0x10FFFF || surrogate) {
+    return REPLACEMENT; // overlong or not a character
+  }
+  return cp;
+}
+
+void appendUtf8(std::string &out, char32_t cp) {
+  if (cp < 0x80) {
+    out += char(cp);
+  } else if (cp < 0x800) {
+    out += char(0xC0 | cp >> 6);
+    out += char(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += char(0xE0 | cp >> 12);
+    out += char(0x80 | (cp >> 6 & 0x3F));
+    out += char(0x80 | (cp & 0x3F));
+  } else {
+    out += char(0xF0 | cp >> 18);
+    out += char(0x80 | (cp >> 12 & 0x3F));
+    out += char(0x80 | (cp >> 6 & 0x3F));
+    out += char(0x80 | (cp & 0x3F));
+  }
+}
+
+// NFD for the letters in the table: decomposed, marks in canonical order
+std::vector<char32_t> decompose(std::string_view text) {
+  std::vector<char32_t> out;
+  out.reserve(text.size());
+  bool marks = false;
+  for (size_t pos = 0; pos < text.size();) {
+    char32_t cp = decodeUtf8(text, pos);
+    marks = marks || cp >= 0x80;
+    if (const Decomposition *d = findDecomposition(cp)) {
+      out.push_back(char32_t(d->base));
+      out.push_back(d->mark1);
+      if (d->mark2 != 0) {
+        out.push_back(d->mark2);
+      }
+    } else {
+      out.push_back(cp);
+    }
+  }
+  // Canonical order: each run of marks sorted (stable) by combining class
+  for (size_t i = 0; marks && i < out.size();) {
+    if (combiningClass(out[i]) == 0) {
+      i++;
+      continue;
+    }
+    size_t end = i;
+    while (end < out.size() && combiningClass(out[end]) != 0) {
+      end++;
+    }
+    std::stable_sort(out.begin() + i, out.begin() + end,
+                     [](char32_t a, char32_t b) {
+                       return combiningClass(a) < combiningClass(b);
+                     });
+    i = end;
+  }
+  return out;
+}
+
+// All keys of a text in one pass over its decomposed form, one unit per
+// starter (letter, digit, ...) with its marks. Null outputs are skipped
+void buildKeys(std::string_view text, std::string *primary,
+               std::string *secondary, std::string *tertiary,
+               std::string *search) {
+  std::vector<char32_t> cps = decompose(text);
+  for (std::string *out : {primary, secondary, tertiary, search}) {
+    if (out) {
+      out->reserve(out->size() + cps.size());
+    }
+  }
+  for (size_t i = 0; i < cps.size();) {
+    char32_t cp = cps[i++];
+    size_t marksBegin = i;
+    while (i < cps.size() && combiningClass(cps[i]) != 0) {
+      i++;
+    }
+    if (combiningClass(cp) != 0) {
+      continue; // marks with nothing to attach to
+    }
+
+    bool upper = (cp >= 'A' && cp <= 'Z') || cp == D_STROKE_UPPER;
+    char32_t lower = cp >= 'A' && cp <= 'Z' ? cp + ('a' - 'A') : cp;
+    char32_t letterMark = 0;
+    if (lower == D_STROKE || lower == D_STROKE_UPPER) {
+      lower = 'd';
+      letterMark = STROKE;
+    }
+
+    unsigned char weight;
+    int letter = -1;
+    if (lower >= 'a' && lower <= 'z') {
+      // A mark that makes a letter of its own (ă â ê ô ơ ư) is part of it
+      for (size_t m = marksBegin; m < i && letterMark == 0; m++) {
+        if (alphabetIndex(char(lower), cps[m]) >= 0) {
+          letterMark = cps[m];
+        }
+      }
+      letter = alphabetIndex(char(lower), letterMark);
+      weight = LETTER_WEIGHT + letter;
+    } else if (cp >= '0' && cp <= '9') {
+      weight = DIGIT_WEIGHT + (cp - '0');
+    } else if (cp >= 0x20 && cp < 0x7F) {
+      weight = WEIGHT_MIN + (cp - 0x20); // punctuation in ASCII order
+    } else if (cp < 0x80) {
+      weight = WEIGHT_MIN; // controls count as spaces
+    } else {
+      weight = OTHER_WEIGHT;
+    }
+
+    if (primary) {
+      primary->push_back(char(weight));
+      if (weight == OTHER_WEIGHT) {
+        // 7 bits per byte, high bit set: no NUL, code point order kept
+        primary->push_back(char(0x80 | cp >> 14));
+        primary->push_back(char(0x80 | (cp >> 7 & 0x7F)));
+        primary->push_back(char(0x80 | (cp & 0x7F)));
+      }
+    }
+    if (secondary) {
+      // Tone if there is one, else the first other mark
+      unsigned char markWeight = WEIGHT_MIN;
+      for (size_t m = marksBegin; m < i; m++) {
+        if (cps[m] == letterMark) {
+          continue;
+        }
+        auto tone = std::find(std::begin(TONES), std::end(TONES), cps[m]);
+        if (tone != std::end(TONES)) {
+          markWeight = WEIGHT_MIN + 1 + (tone - std::begin(TONES));
+          break;
+        }
+        if (markWeight == WEIGHT_MIN) {
+          markWeight = OTHER_MARK_WEIGHT + (cps[m] - 0x300);
+        }
+      }
+      secondary->push_back(char(markWeight));
+    }
+    if (tertiary) {
+      tertiary->push_back(char(upper ? WEIGHT_MIN + 1 : WEIGHT_MIN));
+    }
+    if (search) {
+      if (letter >= 0) {
+        search->push_back(char(lower)); // marks dropped, đ -> d
+      } else if (cp < 0x80) {
+        search->push_back(char(cp));
+      } else {
+        appendUtf8(*search, cp);
+      }
+    }
+  }
+}
+
+} // namespace
+
+std::string normalizeText(std::string_view text) {
+  if (std::all_of(text.begin(), text.end(),
+                  [](char c) { return (unsigned char)c < 0x80; })) {
+    return std::string(text); // ASCII is NFC
+  }
+  std::vector<char32_t> cps = decompose(text);
+  const std::vector<Composition> &table = compositions();
+  std::string out;
+  out.reserve(text.size());
+  std::u32string kept; // marks that did not compose with the starter
+  for (size_t i = 0; i < cps.size();) {
+    char32_t starter = cps[i++];
+    if (combiningClass(starter) != 0) {
+      appendUtf8(out, starter);
+      continue;
+    }
+    kept.clear();
+    uint8_t lastClass = 0;
+    while (i < cps.size() && combiningClass(cps[i]) != 0) {
+      char32_t mark = cps[i++];
+      uint8_t markClass = combiningClass(mark);
+      // A kept mark of the same or higher class blocks later ones
+      char32_t composite;
+      if ((kept.empty() || lastClass < markClass) &&
+          findComposition(table, starter, mark, composite)) {
+        starter = composite;
+      } else {
+        kept.push_back(mark);
+        lastClass = markClass;
+      }
+    }
+    appendUtf8(out, starter);
+    for (char32_t mark : kept) {
+      appendUtf8(out, mark);
+    }
+  }
+  return out;
+}
+
+std::string makeSortKey(std::string_view text) {
+  std::string key, secondary, tertiary;
+  buildKeys(text, &key, &secondary, &tertiary, nullptr);
+  key += LEVEL_SEPARATOR;
+  key += secondary;
+  key += LEVEL_SEPARATOR;
+  key += tertiary;
+  return key;
+}
+
+std::string makePrefixKey(std::string_view text) {
+  std::string key;
+  buildKeys(text, &key, nullptr, nullptr, nullptr);
+  return key;
+}
+
+std::string makeSearchKey(std::string_view text) {
+  std::string key;
+  buildKeys(text, nullptr, nullptr, nullptr, &key);
+  return key;
+}
+
+TextKeys makeTextKeys(std::string_view text) {
+  TextKeys keys;
+  std::string secondary, tertiary;
+  buildKeys(text, &keys.sortKey, &secondary, &tertiary, &keys.searchKey);
+  keys.sortKey += LEVEL_SEPARATOR;
+  keys.sortKey += secondary;
+  keys.sortKey += LEVEL_SEPARATOR;
+  keys.sortKey += tertiary;
+  return keys;
+}
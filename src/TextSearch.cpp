@@ -0,0 +1,174 @@
+// TextSearch.cpp
+
+#include "../include/TextSearch.h"
+#include <cstdint>
+#include <cstring>
+
+// SSE2 is part of every x86-64 CPU, AVX2 is checked at runtime
+#if defined(__x86_64__) || defined(_M_X64)
+#define TEXT_SEARCH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TEXT_SEARCH_AVX2_FN __attribute__((target("avx2")))
+#else
+#define TEXT_SEARCH_AVX2_FN // MSVC compiles AVX2 intrinsics anywhere
+#endif
+
+namespace {
+
+constexpr size_t NOT_FOUND = std::string_view::npos;
+
+// Checks start positions from..size-len: memchr jumps to each first byte
+size_t findScalar(const char *haystack, size_t size, const char *needle,
+                  size_t len, size_t from) {
+  if (size < len) {
+    return NOT_FOUND;
+  }
+  size_t lastStart = size - len;
+  for (size_t i = from; i <= lastStart; i++) {
+    const void *hit = std::memchr(haystack + i, needle[0], lastStart - i + 1);
+    if (hit == nullptr) {
+      return NOT_FOUND;
+    }
+    i = static_cast<const char *>(hit) - haystack;
+    if (haystack[i + len - 1] == needle[len - 1] &&
+        std::memcmp(haystack + i + 1, needle + 1, len - 1) == 0) {
+      return i;
+    }
+  }
+  return NOT_FOUND;
+}
+
+#ifdef TEXT_SEARCH_X86
+
+inline unsigned lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+// 16 start positions per step: bit k set if byte k matches the first
+// needle byte and byte k+len-1 the last one
+size_t findSSE2(const char *haystack, size_t size, const char *needle,
+                size_t len) {
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[len - 1]);
+  size_t i = 0;
+  for (; i + len - 1 + 16 <= size; i += 16) {
+    __m128i head =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+    __m128i tail = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(haystack + i + len - 1));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+        _mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+    while (mask != 0) {
+      size_t pos = i + lowestBit(mask);
+      if (std::memcmp(haystack + pos + 1, needle + 1, len - 1) == 0) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return findScalar(haystack, size, needle, len, i);
+}
+
+// Same as findSSE2(), 32 start positions per step
+TEXT_SEARCH_AVX2_FN size_t findAVX2(const char *haystack, size_t size,
+                                    const char *needle, size_t len) {
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[len - 1]);
+  size_t i = 0;
+  for (; i + len - 1 + 32 <= size; i += 32) {
+    __m256i head =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+    __m256i tail = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(haystack + i + len - 1));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(head, first),
+                         _mm256_cmpeq_epi8(tail, last))));
+    while (mask != 0) {
+      size_t pos = i + lowestBit(mask);
+      if (std::memcmp(haystack + pos + 1, needle + 1, len - 1) == 0) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+  // Fewer than 32 positions left: one SSE2 pass covers most of them
+  size_t rest = findSSE2(haystack + i, size - i, needle, len);
+  return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+bool cpuHasAVX2() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+  __cpuidex(info, 7, 0);
+  return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef TEXT_SEARCH_X86
+  static const SimdLevel level =
+      cpuHasAVX2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+  return level;
+#else
+  return SimdLevel::Scalar;
+#endif
+}
+
+size_t findText(std::string_view haystack, std::string_view needle,
+                SimdLevel level) {
+  if (needle.empty()) {
+    return 0;
+  }
+  if (needle.size() > haystack.size()) {
+    return NOT_FOUND;
+  }
+  if (level > detectSimdLevel()) {
+    level = detectSimdLevel();
+  }
+  // Fewer start positions than a block (most titles): set-up would cost
+  // more than it saves. One byte: memchr is vectorized already
+  size_t starts = haystack.size() - needle.size() + 1;
+  if (needle.size() == 1 || starts < 16) {
+    level = SimdLevel::Scalar;
+  } else if (starts < 32 && level == SimdLevel::AVX2) {
+    level = SimdLevel::SSE2;
+  }
+  switch (level) {
+#ifdef TEXT_SEARCH_X86
+  case SimdLevel::AVX2:
+    return findAVX2(haystack.data(), haystack.size(), needle.data(),
+                    needle.size());
+  case SimdLevel::SSE2:
+    return findSSE2(haystack.data(), haystack.size(), needle.data(),
+                    needle.size());
+#endif
+  default:
+    return findScalar(haystack.data(), haystack.size(), needle.data(),
+                      needle.size(), 0);
+  }
+}
+
+size_t findText(std::string_view haystack, std::string_view needle) {
+  return findText(haystack, needle, detectSimdLevel());
+}
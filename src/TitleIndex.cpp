@@ -0,0 +1,96 @@
+// TitleIndex.cpp
+
+#include "../include/TitleIndex.h"
+#include <algorithm>
+
+using Entry = TitleIndex::Entry;
+
+static bool entryBefore(const Entry &a, const Entry &b) {
+  int order = a.key.compare(b.key);
+  return order != 0 ? order < 0 : a.id < b.id;
+}
+
+static bool keyBefore(const Entry &entry, std::string_view key) {
+  return entry.key < key;
+}
+
+static bool keyAfter(std::string_view key, const Entry &entry) {
+  return key < entry.key;
+}
+
+void TitleIndex::insert(std::string_view key, int id, SongHandle song) {
+  entries.push_back({key, id, song});
+}
+
+bool TitleIndex::erase(std::string_view key, int id) {
+  mergeAppended();
+  Entry probe{key, id, SongHandle()};
+  auto end = entries.begin() + sortedCount;
+  auto it = std::lower_bound(entries.begin(), end, probe, entryBefore);
+  // Skip entries already erased (same song re-added before a settle)
+  while (it != end && it->id == id && it->key == key && it->song.isNull()) {
+    ++it;
+  }
+  if (it == end || it->key != key || it->id != id) {
+    return false;
+  }
+  it->song = SongHandle(); // dropped on the next settle()
+  erasedCount++;
+  return true;
+}
+
+void TitleIndex::mergeAppended() const {
+  if (sortedCount == entries.size()) {
+    return;
+  }
+  auto middle = entries.begin() + sortedCount;
+  std::sort(middle, entries.end(), entryBefore);
+  std::inplace_merge(entries.begin(), middle, entries.end(), entryBefore);
+  sortedCount = entries.size();
+}
+
+void TitleIndex::settle() const {
+  mergeAppended();
+  if (erasedCount == 0) {
+    return;
+  }
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [](const Entry &entry) {
+                                 return entry.song.isNull();
+                               }),
+                entries.end());
+  sortedCount = entries.size();
+  erasedCount = 0;
+}
+
+TitleIndex::Range TitleIndex::equalRange(std::string_view key) const {
+  settle();
+  auto first = std::lower_bound(entries.begin(), entries.end(), key,
+                                keyBefore);
+  auto last = std::upper_bound(first, entries.end(), key, keyAfter);
+  return {entries.data() + (first - entries.begin()),
+          entries.data() + (last - entries.begin())};
+}
+
+TitleIndex::Range TitleIndex::prefixRange(std::string_view prefix) const {
+  settle();
+  auto first = std::lower_bound(entries.begin(), entries.end(), prefix,
+                                keyBefore);
+  // Keys from first on are >= prefix: the ones starting with it come first
+  auto last = std::partition_point(first, entries.end(), [&](const Entry &e) {
+    return e.key.compare(0, prefix.size(), prefix) == 0;
+  });
+  return {entries.data() + (first - entries.begin()),
+          entries.data() + (last - entries.begin())};
+}
+
+TitleIndex::Range TitleIndex::all() const {
+  settle();
+  return {entries.data(), entries.data() + entries.size()};
+}
+
+void TitleIndex::clear() {
+  entries = std::vector<Entry>();
+  sortedCount = 0;
+  erasedCount = 0;
+}
@@ -0,0 +1,107 @@
+// TrigramIndex.cpp
+
+#include "../include/TrigramIndex.h"
+#include <algorithm>
+
+void TrigramIndex::trigramsOf(std::string_view text,
+                              std::vector<uint32_t> &out) {
+  out.clear();
+  for (size_t i = 0; i + MIN_QUERY <= text.size(); i++) {
+    out.push_back(uint32_t(uint8_t(text[i])) << 16 |
+                  uint32_t(uint8_t(text[i + 1])) << 8 |
+                  uint32_t(uint8_t(text[i + 2])));
+  }
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void TrigramIndex::settle(Postings &list) const {
+  if (list.sortedCount == list.docs.size()) {
+    return;
+  }
+  auto middle = list.docs.begin() + list.sortedCount;
+  std::sort(middle, list.docs.end());
+  std::inplace_merge(list.docs.begin(), middle, list.docs.end());
+  // Duplicates: IDs added again, their stale posting is live again
+  size_t before = list.docs.size();
+  list.docs.erase(std::unique(list.docs.begin(), list.docs.end()),
+                  list.docs.end());
+  size_t duplicates = before - list.docs.size();
+  entryCount -= duplicates;
+  staleCount -= std::min(staleCount, duplicates);
+  list.sortedCount = list.docs.size();
+}
+
+void TrigramIndex::insert(uint32_t doc, std::string_view key) {
+  std::vector<uint32_t> trigrams;
+  trigramsOf(key, trigrams);
+  for (uint32_t trigram : trigrams) {
+    Postings &list = lists[trigram];
+    if (list.docs.empty() || list.docs.back() < doc) {
+      // New IDs are the largest: appended in order, still sorted
+      if (list.sortedCount == list.docs.size()) {
+        list.sortedCount++;
+      }
+    } else if (list.docs.back() == doc) {
+      continue;
+    }
+    list.docs.push_back(doc);
+    entryCount++;
+  }
+}
+
+void TrigramIndex::erase(std::string_view key) {
+  std::vector<uint32_t> trigrams;
+  trigramsOf(key, trigrams);
+  staleCount += trigrams.size();
+}
+
+bool TrigramIndex::needsRebuild() const {
+  return staleCount > 1024 && staleCount * 2 > entryCount;
+}
+
+void TrigramIndex::candidates(std::string_view query,
+                              std::vector<uint32_t> &out) const {
+  out.clear();
+  std::vector<uint32_t> trigrams;
+  trigramsOf(query, trigrams);
+  std::vector<Postings *> found;
+  for (uint32_t trigram : trigrams) {
+    auto it = lists.find(trigram);
+    if (it == lists.end()) {
+      return; // no key has this trigram
+    }
+    settle(it->second);
+    found.push_back(&it->second);
+  }
+  if (found.empty()) {
+    return;
+  }
+
+  // Start from the shortest list, keep the IDs every other list has
+  std::sort(found.begin(), found.end(), [](Postings *a, Postings *b) {
+    return a->docs.size() < b->docs.size();
+  });
+  out = found[0]->docs;
+  for (size_t k = 1; k < found.size() && !out.empty(); k++) {
+    const std::vector<uint32_t> &docs = found[k]->docs;
+    auto from = docs.begin();
+    size_t kept = 0;
+    for (uint32_t doc : out) {
+      from = std::lower_bound(from, docs.end(), doc);
+      if (from == docs.end()) {
+        break;
+      }
+      if (*from == doc) {
+        out[kept++] = doc;
+      }
+    }
+    out.resize(kept);
+  }
+}
+
+void TrigramIndex::clear() {
+  lists = std::unordered_map<uint32_t, Postings>();
+  entryCount = 0;
+  staleCount = 0;
+}
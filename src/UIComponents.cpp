@@ -4,8 +4,10 @@
 #include "imgui.h"
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
+#include <list>
 #include <map>
 #include <set>
 #include <sstream>
@@ -34,36 +36,29 @@ std::string formatTime(float seconds) {
   return oss.str();
 }
 
-// --- HELPER: Case Insensitive Search ---
-bool containsString(const std::string &haystack, const std::string &needle) {
-  auto it = std::search(haystack.begin(), haystack.end(), needle.begin(),
-                        needle.end(), [](char ch1, char ch2) {
-                          return std::toupper(ch1) == std::toupper(ch2);
-                        });
-  return (it != haystack.end());
-}
-
 // --- RENDER SONG ITEM ---
-void RenderSongItem(const Song *song, bool spacious, bool inQueue) {
+void RenderSongItem(const StoredSong *song, bool spacious, bool inQueue) {
   ImGui::PushID(song);
 
+  const std::string &artist = player.getLibrary().getArtist(*song);
   if (spacious) {
     ImGui::BeginGroup();
     if (song == player.getCurrentSong()) {
       ImGui::TextColored(ImVec4(0.6f, 0.4f, 0.8f, 1), "%s",
-                         song->title.c_str());
+                         song->title.data());
     } else {
-      ImGui::TextColored(ImVec4(1, 1, 1, 1), "%s", song->title.c_str());
+      ImGui::TextColored(ImVec4(1, 1, 1, 1), "%s", song->title.data());
     }
     ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1), "%s - %s",
-                       song->artist.c_str(), song->album.c_str());
+                       artist.c_str(),
+                       player.getLibrary().getAlbum(*song).c_str());
     ImGui::EndGroup();
   } else {
     if (song == player.getCurrentSong()) {
       ImGui::TextColored(ImVec4(0.6f, 0.4f, 0.8f, 1), "%s - %s",
-                         song->title.c_str(), song->artist.c_str());
+                         song->title.data(), artist.c_str());
     } else {
-      ImGui::Text("%s - %s", song->title.c_str(), song->artist.c_str());
+      ImGui::Text("%s - %s", song->title.data(), artist.c_str());
     }
   }
   if (ImGui::IsItemHovered()) {
@@ -84,7 +79,7 @@ void RenderSongItem(const Song *song, bool spacious, bool inQueue) {
       player.addSongToQueue(song);
     }
     if (ImGui::MenuItem("Show Artist")) {
-      strcpy(searchBuf, song->artist.c_str());
+      strcpy(searchBuf, artist.c_str());
       currentTab = TAB_SEARCH;
     }
     if (inQueue) {
@@ -100,12 +95,22 @@ void RenderSongItem(const Song *song, bool spacious, bool inQueue) {
   ImGui::PopID();
 }
 
+// Handles from playback and indexes - stale ones are skipped
+void RenderSongItem(SongHandle handle, bool spacious, bool inQueue) {
+  if (const StoredSong *song = player.getLibrary().resolve(handle)) {
+    RenderSongItem(song, spacious, inQueue);
+  }
+}
+
 // --- RENDER ALBUMS TAB ---
 void RenderAlbumsTab() {
-  const auto &albums = player.getLibrary().getAlbumIndex();
+  const MusicLibrary &library = player.getLibrary();
+  const auto &albums = library.getAlbumIndex();
   ImGui::Text("Albums (%zu)", albums.size());
   ImGui::Separator();
-  for (const auto &[albumName, songs] : albums) {
+  for (uint32_t albumId : library.getSortedAlbums()) {
+    const std::string &albumName = library.getAlbums().get(albumId);
+    const std::vector<SongHandle> &songs = albums.at(albumId);
     ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.55f, 0.30f, 0.65f, 0.6f));
     bool open = ImGui::CollapsingHeader(albumName.c_str());
     ImGui::PopStyleColor();
@@ -122,7 +127,7 @@ void RenderAlbumsTab() {
       ImGui::PopID();
       ImGui::Spacing();
       ImGui::Separator();
-      for (const auto *s : songs) {
+      for (SongHandle s : songs) {
         RenderSongItem(s, false);
         ImGui::Separator();
       }
@@ -132,10 +137,12 @@ void RenderAlbumsTab() {
 }
 // --- RENDER ARTIST TAB ---
 void RenderArtistTab() {
-  const auto &artists = player.getLibrary().getArtistIndex();
+  const MusicLibrary &library = player.getLibrary();
+  const auto &artists = library.getArtistIndex();
   ImGui::Text("Artists (%zu)", artists.size());
   ImGui::Separator();
-  for (const auto &[artistName, songs] : artists) {
+  for (const auto &[artistId, songs] : artists) {
+    const std::string &artistName = library.getArtists().get(artistId);
     ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.55f, 0.30f, 0.65f, 0.6f));
     bool open = ImGui::CollapsingHeader(artistName.c_str());
     ImGui::PopStyleColor();
@@ -152,7 +159,7 @@ void RenderArtistTab() {
       ImGui::PopID();
       ImGui::Spacing();
       ImGui::Separator();
-      for (const auto *s : songs) {
+      for (SongHandle s : songs) {
         RenderSongItem(s, false);
         ImGui::Separator();
       }
@@ -164,8 +171,29 @@ void RenderArtistTab() {
 void RenderSearchTab() {
   ImGui::InputTextWithHint(
       "##SearchBox", "Search Title, Artist, Album, or ID...", searchBuf, 128);
+  // Completions of what was typed: a walk down a trie, no library scan
+  static const char *FIELD_NAMES[] = {"title", "artist", "album"};
+  std::vector<Completion> completions =
+      player.getLibrary().complete(searchBuf, 5);
+  for (size_t i = 0; i < completions.size(); i++) {
+    const Completion &completion = completions[i];
+    if (completion.text == searchBuf) {
+      continue; // already picked
+    }
+    std::string label = std::string(completion.text) + "  (" +
+                        FIELD_NAMES[static_cast<size_t>(completion.field)] +
+                        ", " + std::to_string(completion.songs) +
+                        ")##complete" + std::to_string(i);
+    if (ImGui::Selectable(label.c_str())) {
+      snprintf(searchBuf, sizeof(searchBuf), "%.*s",
+               static_cast<int>(completion.text.size()),
+               completion.text.data());
+    }
+  }
   ImGui::Separator();
   std::string query(searchBuf);
+  // Runs off this thread: only a changed query or library starts a search
+  player.searchLibrary(query);
   if (query.length() > 0) {
     bool isNumeric = true;
     for (char c : query) {
@@ -176,26 +204,35 @@ void RenderSearchTab() {
     }
     if (isNumeric) {
       int searchId = std::stoi(query);
-      const Song *found = player.getLibrary().findSongByID(searchId);
+      const StoredSong *found = player.getLibrary().findSongByID(searchId);
       if (found) {
         ImGui::TextColored(ImVec4(0.6f, 0.8f, 0.6f, 1.0f), "Found by ID:");
         RenderSongItem(found);
       }
     }
-    std::list<const Song *> matchedSongs;
+    std::list<const StoredSong *> matchedSongs;
     int matchedCount = 0;
     ;
     ImGui::TextDisabled("Songs:");
-    for (const auto &song : player.getLibrary().getAllSongs()) {
-      if (containsString(song.title, query) ||
-          containsString(song.artist, query) ||
-          containsString(song.album, query)) {
-        matchedSongs.push_back(&song);
+    const MusicLibrary &library = player.getLibrary();
+    // Search keys fold case and accents: "ha noi" finds "Hà Nội".
+    // Last published result - the previous query's while typing
+    std::shared_ptr<const SearchSnapshot> snapshot = player.getSearchResults();
+    static const SearchResult noResults;
+    const SearchResult &results = snapshot ? snapshot->result : noResults;
+    for (SongHandle song : results.songs) {
+      // Songs removed after the snapshot was taken no longer resolve
+      if (const StoredSong *stored = library.resolve(song)) {
+        matchedSongs.push_back(stored);
         matchedCount++;
       }
     }
     ImGui::SameLine();
     ImGui::Text("Found %zu related song(s)", matchedCount);
+    if (player.isSearching()) {
+      ImGui::SameLine();
+      ImGui::TextDisabled("(searching...)");
+    }
     ImGui::Separator();
     if (ImGui::SmallButton("Add All to Queue")) {
       for (auto &songs : matchedSongs) {
@@ -205,12 +242,28 @@ void RenderSearchTab() {
     for (auto &songs : matchedSongs) {
       RenderSongItem(songs);
     }
+    // Misspelled queries: closest songs, ranked (exact ones listed above)
+    static const std::vector<FuzzyHit> noFuzzy;
+    const std::vector<FuzzyHit> &fuzzy = snapshot ? snapshot->fuzzy : noFuzzy;
+    bool fuzzyHeader = false;
+    for (const FuzzyHit &hit : fuzzy) {
+      const StoredSong *stored = library.resolve(hit.song);
+      if (hit.errors == 0 || stored == nullptr) {
+        continue;
+      }
+      if (!fuzzyHeader) {
+        ImGui::Separator();
+        ImGui::TextDisabled("Did you mean:");
+        fuzzyHeader = true;
+      }
+      RenderSongItem(stored);
+    }
     ImGui::Separator();
     ImGui::TextDisabled("Albums:");
     std::set<std::string> matchedAlbums;
-    for (const auto &song : player.getLibrary().getAllSongs()) {
-      if (containsString(song.album, query)) {
-        matchedAlbums.insert(song.album);
+    for (uint32_t albumId : results.albums) {
+      if (albumId < library.getAlbums().size()) {
+        matchedAlbums.insert(library.getAlbums().get(albumId));
       }
     }
     for (const auto &albumName : matchedAlbums) {
@@ -230,7 +283,7 @@ void RenderSearchTab() {
 }
 
 // --- RENDER SMART PLAYLIST BUTTON ---
-void RenderSmartPlaylistButton(const Song *current) {
+void RenderSmartPlaylistButton(const StoredSong *current) {
   static int playlistSize = 20;
 
   if (ImGui::Button("Smart Playlist", ImVec2(110.0f, 0))) {
@@ -239,7 +292,8 @@ void RenderSmartPlaylistButton(const Song *current) {
 
   if (ImGui::BeginPopup("SmartPlaylistPopup")) {
     ImGui::Text("Generate based on album: %s and artist: %s",
-                current->album.c_str(), current->artist.c_str());
+                player.getLibrary().getAlbum(*current).c_str(),
+                player.getLibrary().getArtist(*current).c_str());
     ImGui::Separator();
     ImGui::SliderInt("Songs", &playlistSize, 5, 100);
     ImGui::Spacing();
@@ -279,6 +333,11 @@ void RenderToast() {
 
 // --- RENDER MAIN UI ---
 void RenderMainUI(char *pathBuffer) {
+  // Publish songs from background imports (bounded work per frame)
+  player.pollImports();
+  player.pollTags();
+  player.pollFolderChanges();
+
   // FULLSCREEN DOCKING
   ImGui::SetNextWindowPos(ImVec2(0, 0));
   ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
@@ -311,9 +370,52 @@ void RenderMainUI(char *pathBuffer) {
   ImGui::Dummy(ImVec2(0, 20));
   ImGui::Text("Import:");
   ImGui::InputText("##Path", pathBuffer, 256);
+  static bool lazyTags = true;
+  ImGui::Checkbox("List first, tags later", &lazyTags);
   if (ImGui::Button("Load Folder", ImVec2(-1, 0))) {
-    player.loadLibrary(pathBuffer);
-    showToast("Library loaded");
+    player.setLazyTagsEnabled(lazyTags);
+    if (player.loadLibraryAsync(pathBuffer)) {
+      showToast("Importing...");
+    } else {
+      showToast("Invalid or already loaded folder");
+    }
+  }
+  for (const auto &job : player.getImportJobs()) {
+    size_t found = job->getFilesFound();
+    size_t read = job->getFilesRead();
+    ImGui::PushID(job.get());
+    ImGui::TextDisabled("%s %zu / %zu",
+                        job->isRescan() ? "Rescanning" : "Importing", read,
+                        found);
+    ImGui::ProgressBar(found > 0 ? (float)read / found : 0.0f, ImVec2(-60, 0));
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Cancel")) {
+      job->cancel();
+      showToast(job->isRescan() ? "Rescan cancelled" : "Import cancelled");
+    }
+    ImGui::PopID();
+  }
+  if (size_t pendingTags = player.getPendingTagCount()) {
+    ImGui::TextDisabled("Reading tags: %zu left", pendingTags);
+  }
+  // Each folder rescans / unloads on its own
+  for (const std::string &folder : player.getLoadedFolders()) {
+    ImGui::PushID(folder.c_str());
+    ImGui::TextDisabled("%s", folder.c_str());
+    if (ImGui::SmallButton("Rescan")) {
+      showToast(player.rescanFolderAsync(folder) ? "Rescanning..."
+                                                 : "Folder still importing");
+    }
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Unload")) {
+      size_t removed = player.unloadFolder(folder);
+      showToast("Unloaded " + std::to_string(removed) + " songs");
+    }
+    ImGui::PopID();
+  }
+  if (ImGui::Button("Rescan Library", ImVec2(-1, 0))) {
+    size_t started = player.rescanLibrary();
+    showToast(started > 0 ? "Rescanning..." : "Nothing to rescan");
   }
   if (ImGui::Button("Unload Library", ImVec2(-1, 0))) {
     player.clearLibrary();
@@ -330,20 +432,28 @@ void RenderMainUI(char *pathBuffer) {
   ImGui::BeginChild("MainView", ImVec2(0, -140), true);
 
   if (currentTab == TAB_LIBRARY) {
-    static bool sortAZ = false;
+    // Click cycles OFF -> title -> artist -> album -> duration
+    static const char *sortLabels[] = {"SORT: OFF", "SORT: A-Z",
+                                       "SORT: ARTIST", "SORT: ALBUM",
+                                       "SORT: DURATION"};
+    static int sortMode = 0;
     ImGui::Text("All Songs (%zu)", player.getLibrary().getSize());
     ImGui::SameLine();
-    if (ImGui::SmallButton(sortAZ ? "SORT: A-Z" : "SORT: OFF")) {
-      sortAZ = !sortAZ;
+    if (ImGui::SmallButton(sortLabels[sortMode])) {
+      sortMode = (sortMode + 1) % 5;
     }
     ImGui::Separator();
     ImGuiListClipper clipper;
-    if (sortAZ) {
-      auto sorted = player.getLibrary().getSortedSongs();
+    std::vector<int> visibleIDs; // rows on screen get their tags first
+    if (sortMode > 0) {
+      // Cached order kept by the library: nothing is copied per frame
+      SortView sorted = player.getLibrary().getSortView(
+          static_cast<SortKey>(sortMode - 1));
       clipper.Begin(sorted.size());
       while (clipper.Step()) {
         ImGui::Indent(20.0f);
         for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+          visibleIDs.push_back(sorted[i]->id);
           ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1), "%zu", i + 1);
           ImGui::SameLine();
           ImGui::SetCursorPosX(55.0f);
@@ -359,6 +469,7 @@ void RenderMainUI(char *pathBuffer) {
       while (clipper.Step()) {
         ImGui::Indent(20.0f);
         for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+          visibleIDs.push_back(all[i].id);
           ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1), "%zu", i + 1);
           ImGui::SameLine();
           ImGui::SetCursorPosX(55.0f);
@@ -369,6 +480,9 @@ void RenderMainUI(char *pathBuffer) {
         ImGui::Unindent();
       }
     }
+    if (player.getPendingTagCount() > 0) {
+      player.requestTags(visibleIDs);
+    }
   } else if (currentTab == TAB_ALBUMS) {
     RenderAlbumsTab();
   } else if (currentTab == TAB_ARTISTS) {
@@ -376,10 +490,11 @@ void RenderMainUI(char *pathBuffer) {
   } else if (currentTab == TAB_SEARCH) {
     RenderSearchTab();
   } else if (currentTab == TAB_QUEUE) {
-    const Song *current = player.getCurrentSong();
+    const StoredSong *current = player.getCurrentSong();
     ImGui::Text("Upcoming Queue");
     if (current) {
-      std::string nowPlaying = current->title + " - " + current->artist;
+      std::string nowPlaying = std::string(current->title) + " - " +
+                               player.getLibrary().getArtist(*current);
       ImGui::SameLine();
       ImGui::TextColored(ImVec4(0.6f, 0.4f, 0.8f, 1), "   (Now Playing: %s)",
                          nowPlaying.c_str());
@@ -427,7 +542,7 @@ void RenderMainUI(char *pathBuffer) {
     } else {
       int idx = forwardSize;
       ImGui::Indent(20.0f);
-      for (const Song *s : player.getQueueManager().getQueueList()) {
+      for (SongHandle s : player.getQueueManager().getQueueList()) {
         ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1), "%zu", ++idx);
         ImGui::SameLine();
         ImGui::SetCursorPosX(55.0f);
@@ -449,12 +564,11 @@ void RenderMainUI(char *pathBuffer) {
       showToast("History cleared");
     }
     ImGui::Separator();
-    std::vector<const Song *> hist =
-        player.getHistoryManager().getHistoryList();
+    std::vector<SongHandle> hist = player.getHistoryManager().getHistoryList();
     if (hist.empty()) {
       ImGui::TextDisabled("No songs played yet.");
     } else {
-      for (const auto *s : hist) {
+      for (SongHandle s : hist) {
         RenderSongItem(s, false);
       }
     }
@@ -465,7 +579,7 @@ void RenderMainUI(char *pathBuffer) {
   // --- BOTTOM BAR (height 140px, no scroll) ---
   ImGui::BeginChild("BottomBar", ImVec2(0, 0), true,
                     ImGuiWindowFlags_NoScrollbar);
-  const Song *current = player.getCurrentSong();
+  const StoredSong *current = player.getCurrentSong();
   float time = player.engine.getCurrentTime();
   float duration = player.engine.getTotalDuration();
   float barWidth = ImGui::GetWindowWidth();
@@ -476,7 +590,8 @@ void RenderMainUI(char *pathBuffer) {
 
   // Use global fontLarge (defined in main.cpp, declared in UIComponents.h)
   if (current) {
-    std::string nowPlaying = current->title + " - " + current->artist;
+    std::string nowPlaying = std::string(current->title) + " - " +
+                             player.getLibrary().getArtist(*current);
     auto fontLarge = ImGui::GetIO().Fonts->Fonts.Size > 1
                          ? ImGui::GetIO().Fonts->Fonts[1]
                          : nullptr;
@@ -0,0 +1,44 @@
+// tests/TempDir.h
+// Fixture base for tests on real files: a fresh folder per test, removed
+// afterwards
+
+#ifndef TESTS_TEMP_DIR_H
+#define TESTS_TEMP_DIR_H
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+class TempDirTest : public ::testing::Test {
+private:
+  std::string prefix;
+
+protected:
+  std::filesystem::path root; // <temp>/<prefix><test name>
+
+  explicit TempDirTest(std::string prefix) : prefix(std::move(prefix)) {}
+
+  void SetUp() override {
+    root = std::filesystem::temp_directory_path() /
+           (prefix + ::testing::UnitTest::GetInstance()
+                         ->current_test_info()
+                         ->name());
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+  }
+
+  void TearDown() override {
+    if (!root.empty()) { // empty if skipped before SetUp() ran
+      std::filesystem::remove_all(root);
+    }
+  }
+
+  // Helper: create a one-byte file (and its folders) below root
+  void touch(const std::filesystem::path &relative) {
+    std::filesystem::create_directories((root / relative).parent_path());
+    std::ofstream(root / relative).put('x');
+  }
+};
+
+#endif
@@ -0,0 +1,169 @@
+// tests/test_AutocompleteIndex.cpp
+// Unit tests for AutocompleteIndex class
+
+#include "../include/AutocompleteIndex.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class AutocompleteIndexTest : public ::testing::Test {
+protected:
+  AutocompleteIndex index;
+
+  std::vector<std::string> keys(std::string_view prefix, size_t limit = 8) {
+    std::vector<std::string> out;
+    for (const auto &suggestion : index.complete(prefix, limit)) {
+      out.emplace_back(suggestion.key);
+    }
+    return out;
+  }
+};
+
+// ========================
+// Test: complete
+// ========================
+
+TEST_F(AutocompleteIndexTest, Complete_BestWeightsUnderPrefix) {
+  index.build({{"son tung", "Sơn Tùng", 1, 40},
+               {"song cho", "Sống Cho", 0, 1},
+               {"song of love", "Song of Love", 0, 1},
+               {"so far", "So Far", 2, 3},
+               {"my tam", "Mỹ Tâm", 1, 25},
+               {"son tung", "Son Tung", 1, 2}}); // same entry: weight summed
+
+  EXPECT_EQ(keys("so"), (std::vector<std::string>{"son tung", "so far",
+                                                  "song cho", "song of love"}));
+  EXPECT_EQ(keys("son"), (std::vector<std::string>{"son tung", "song cho",
+                                                   "song of love"}));
+  EXPECT_EQ(keys("song o"), (std::vector<std::string>{"song of love"}));
+  EXPECT_EQ(keys("so", 2), (std::vector<std::string>{"son tung", "so far"}));
+  EXPECT_EQ(keys(""), (std::vector<std::string>{"son tung", "my tam",
+                                                "so far", "song cho",
+                                                "song of love"}));
+  EXPECT_TRUE(keys("sx").empty());
+  EXPECT_TRUE(keys("son tungx").empty());
+
+  auto top = index.complete("son t");
+  ASSERT_EQ(top.size(), 1);
+  EXPECT_EQ(top[0].text, "Sơn Tùng"); // first item's text
+  EXPECT_EQ(top[0].weight, 42);
+  EXPECT_EQ(top[0].tag, 1);
+  EXPECT_EQ(index.size(), 5);
+}
+
+TEST_F(AutocompleteIndexTest, Complete_SameKeyOtherTag_BothListed) {
+  index.add("love", "Love", 0, 2);
+  index.add("love", "LOVE", 2, 5);
+  index.add("lovely", "Lovely", 0);
+
+  auto found = index.complete("lov");
+  ASSERT_EQ(found.size(), 3);
+  EXPECT_EQ(found[0].tag, 2);
+  EXPECT_EQ(found[1].tag, 0);
+  EXPECT_EQ(found[2].key, "lovely");
+}
+
+// ========================
+// Test: add / remove
+// ========================
+
+TEST_F(AutocompleteIndexTest, AddRemove_SameAsBruteForce) {
+  // Small alphabet: many shared prefixes, splits and merges
+  std::mt19937 rng(3);
+  auto word = [&] {
+    std::string out(1 + rng() % 6, 'a');
+    for (char &ch : out) {
+      ch = "abc "[rng() % 4];
+    }
+    return out;
+  };
+  std::vector<std::string> pool;
+  for (int i = 0; i < 200; i++) {
+    pool.push_back(word());
+  }
+  std::map<std::pair<std::string, uint8_t>, uint32_t> expected;
+  for (int step = 0; step < 4000; step++) {
+    const std::string &key = pool[rng() % pool.size()];
+    uint8_t tag = rng() % 2;
+    uint32_t weight = 1 + rng() % 3;
+    if (rng() % 3 != 0) {
+      index.add(key, key, tag, weight);
+      expected[{key, tag}] += weight;
+    } else {
+      auto it = expected.find({key, tag});
+      ASSERT_EQ(index.remove(key, tag, weight), it != expected.end());
+      if (it != expected.end()) {
+        it->second = it->second > weight ? it->second - weight : 0;
+        if (it->second == 0) {
+          expected.erase(it);
+        }
+      }
+    }
+    if (step % 100 != 99) {
+      continue;
+    }
+    ASSERT_EQ(index.size(), expected.size());
+    for (const std::string &prefix : {std::string(), word(), word()}) {
+      std::vector<std::pair<std::string, uint8_t>> ranked;
+      for (const auto &[entry, weight] : expected) {
+        if (entry.first.compare(0, prefix.size(), prefix) == 0) {
+          ranked.push_back(entry);
+        }
+      }
+      std::sort(ranked.begin(), ranked.end(), [&](auto &a, auto &b) {
+        return expected[a] != expected[b] ? expected[a] > expected[b]
+                                          : a < b;
+      });
+      ranked.resize(std::min<size_t>(ranked.size(), 8));
+      std::vector<std::pair<std::string, uint8_t>> found;
+      for (const auto &suggestion : index.complete(prefix)) {
+        found.emplace_back(suggestion.key, suggestion.tag);
+      }
+      ASSERT_EQ(found, ranked) << "step " << step << " prefix '" << prefix
+                               << "'";
+    }
+  }
+}
+
+TEST_F(AutocompleteIndexTest, Remove_AllEntries_NodesAndBytesFreed) {
+  std::vector<std::string> titles;
+  for (int i = 0; i < 2000; i++) {
+    titles.push_back("title number " + std::to_string(i));
+  }
+  std::vector<AutocompleteIndex::Item> items;
+  for (const std::string &title : titles) {
+    items.push_back({title, title, 0, 1});
+  }
+  index.build(items);
+  EXPECT_EQ(index.size(), 2000);
+  size_t built = index.getMemoryUsage();
+
+  EXPECT_FALSE(index.remove("title number", 0)); // inner node, no entry
+  EXPECT_FALSE(index.remove("title number 5", 1)); // other tag
+  for (size_t i = 0; i < titles.size(); i++) {
+    ASSERT_TRUE(index.remove(titles[i], 0));
+    if (i == 1000) {
+      EXPECT_EQ(keys("title number 1"),
+                (std::vector<std::string>{"title number 1001",
+                                          "title number 1002",
+                                          "title number 1003",
+                                          "title number 1004",
+                                          "title number 1005",
+                                          "title number 1006",
+                                          "title number 1007",
+                                          "title number 1008"}));
+    }
+  }
+  EXPECT_EQ(index.size(), 0);
+  EXPECT_EQ(index.getNodeCount(), 1); // the root
+  EXPECT_TRUE(keys("").empty());
+  EXPECT_LT(index.getMemoryUsage(), built); // repacked along the way
+
+  index.clear();
+  index.add("again", "again", 0);
+  EXPECT_EQ(keys("a"), (std::vector<std::string>{"again"}));
+}
@@ -0,0 +1,116 @@
+// tests/test_DirectoryWalker.cpp
+// Unit tests for DirectoryWalker class
+
+#include "../include/DirectoryWalker.h"
+#include "TempDir.h"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+
+namespace fs = std::filesystem;
+
+class DirectoryWalkerTest : public TempDirTest {
+protected:
+  DirectoryWalkerTest() : TempDirTest("directory_walker_") {}
+
+  // Helper: walk root, return found paths relative to root
+  std::set<std::string> walk(const WalkOptions &options) {
+    std::mutex mtx;
+    std::set<std::string> found;
+    DirectoryWalker walker(options);
+    walker.walk(root.string(), [&](fs::path &&file) {
+      std::lock_guard<std::mutex> lock(mtx);
+      found.insert(file.lexically_relative(root).generic_string());
+      return true;
+    });
+    return found;
+  }
+};
+
+// ========================
+// Test: walk
+// ========================
+
+TEST_F(DirectoryWalkerTest, Walk_FindsFilesInNestedFolders) {
+  touch("root.mp3");
+  touch("Artist/Album/01.mp3");
+  touch("Artist/Album/02.wav");
+  touch("Artist/cover.jpg");
+  touch("Other/Deep/Er/Track.mp3");
+
+  std::set<std::string> expected = {"root.mp3", "Artist/Album/01.mp3",
+                                    "Artist/Album/02.wav",
+                                    "Other/Deep/Er/Track.mp3"};
+  EXPECT_EQ(walk(WalkOptions()), expected);
+}
+
+TEST_F(DirectoryWalkerTest, Walk_ManyFolders_EveryFileOnce) {
+  for (int a = 0; a < 8; a++) {
+    for (int b = 0; b < 8; b++) {
+      touch("A" + std::to_string(a) + "/B" + std::to_string(b) + "/t.mp3");
+    }
+  }
+  WalkOptions options;
+  options.threadCount = 4;
+
+  EXPECT_EQ(walk(options).size(), 64);
+}
+
+TEST_F(DirectoryWalkerTest, Walk_ExtensionFilter_CaseInsensitive) {
+  touch("a.MP3");
+  touch("b.flac");
+  touch("c.wav");
+  WalkOptions options;
+  options.extensions = {".mp3", ".flac"};
+
+  std::set<std::string> expected = {"a.MP3", "b.flac"};
+  EXPECT_EQ(walk(options), expected);
+}
+
+TEST_F(DirectoryWalkerTest, Walk_MaxDepth_StopsDescending) {
+  touch("top.mp3");
+  touch("L1/one.mp3");
+  touch("L1/L2/two.mp3");
+  WalkOptions options;
+  options.maxDepth = 1;
+
+  std::set<std::string> expected = {"top.mp3", "L1/one.mp3"};
+  EXPECT_EQ(walk(options), expected);
+  options.maxDepth = 0;
+  EXPECT_EQ(walk(options), std::set<std::string>{"top.mp3"});
+}
+
+TEST_F(DirectoryWalkerTest, Walk_SymlinkLoop_VisitedOnce) {
+  touch("Album/song.mp3");
+  std::error_code ec;
+  fs::create_directory_symlink(root, root / "Album" / "loop", ec);
+  if (ec) {
+    GTEST_SKIP() << "Cannot create directory symlinks here";
+  }
+  WalkOptions options;
+  options.followSymlinks = true;
+
+  EXPECT_EQ(walk(options), std::set<std::string>{"Album/song.mp3"});
+  options.followSymlinks = false;
+  EXPECT_EQ(walk(options), std::set<std::string>{"Album/song.mp3"});
+}
+
+TEST_F(DirectoryWalkerTest, Walk_SinkReturnsFalse_Stops) {
+  for (int i = 0; i < 20; i++) {
+    touch("t" + std::to_string(i) + ".mp3");
+  }
+  WalkOptions options;
+  options.threadCount = 1;
+  int calls = 0;
+
+  DirectoryWalker walker(options);
+  walker.walk(root.string(), [&](fs::path &&) { return ++calls < 3; });
+
+  EXPECT_EQ(calls, 3);
+}
+
+TEST_F(DirectoryWalkerTest, Walk_MissingRoot_FindsNothing) {
+  fs::remove_all(root);
+  EXPECT_TRUE(walk(WalkOptions()).empty());
+}
@@ -0,0 +1,267 @@
+// tests/test_FastTagReader.cpp
+// Unit tests for FastTagReader on synthetic MP3 / WAV files
+
+#include "../include/FastTagReader.h"
+#include "TempDir.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class FastTagReaderTest : public TempDirTest {
+protected:
+  // MPEG-1 Layer III, 128 kbit/s, 44100 Hz, stereo: 417 byte frames
+  static constexpr size_t FRAME_SIZE = 417;
+
+  FastTagReaderTest() : TempDirTest("fast_tag_reader_") {}
+
+  // Helper: write bytes to a file below root
+  std::string writeFile(const std::string &name, const std::string &bytes) {
+    fs::path path = root / name;
+    std::ofstream(path, std::ios::binary) << bytes;
+    return path.string();
+  }
+
+  // Helper: integers in file byte orders
+  static std::string be32(uint32_t v) {
+    return {char(v >> 24), char(v >> 16), char(v >> 8), char(v)};
+  }
+  static std::string le32(uint32_t v) {
+    return {char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+  }
+  static std::string le16(uint16_t v) { return {char(v), char(v >> 8)}; }
+  static std::string syncsafe(uint32_t v) {
+    return {char(v >> 21 & 0x7F), char(v >> 14 & 0x7F), char(v >> 7 & 0x7F),
+            char(v & 0x7F)};
+  }
+
+  // Helper: ID3v2.3 text frame (encoding byte + text)
+  static std::string frame23(const std::string &id, const std::string &body) {
+    return id + be32(body.size()) + std::string(2, '\0') + body;
+  }
+  // Helper: ID3v2.4 text frame (syncsafe size)
+  static std::string frame24(const std::string &id, const std::string &body) {
+    return id + syncsafe(body.size()) + std::string(2, '\0') + body;
+  }
+  // Helper: ID3v2 tag around frames, with some padding
+  static std::string id3Tag(char major, const std::string &frames,
+                            char flags = 0) {
+    std::string body = frames + std::string(64, '\0');
+    return std::string("ID3") + major + '\0' + flags + syncsafe(body.size()) +
+           body;
+  }
+  // Helper: ID3v1 tag
+  static std::string id3v1(const std::string &title, const std::string &artist,
+                           const std::string &album) {
+    auto field = [](const std::string &s, size_t n) {
+      return s + std::string(n - s.size(), '\0');
+    };
+    return "TAG" + field(title, 30) + field(artist, 30) + field(album, 30) +
+           std::string(35, '\0');
+  }
+
+  // Helper: frame header (MPEG-1 Layer III, 128 kbit/s, 44100 Hz)
+  static std::string header() { return std::string("\xFF\xFB\x90\x00", 4); }
+  // Helper: one audio frame (silence)
+  static std::string audioFrame() {
+    return header() + std::string(FRAME_SIZE - 4, '\0');
+  }
+  // Helper: frames audio frames
+  static std::string audio(size_t frames) {
+    std::string out;
+    for (size_t i = 0; i < frames; i++) {
+      out += audioFrame();
+    }
+    return out;
+  }
+  // Helper: Xing frame with a frame count, optionally with a LAME tag
+  static std::string xingFrame(uint32_t frames, uint16_t delay = 0,
+                               uint16_t padding = 0, bool lame = false) {
+    std::string f = header() + std::string(32, '\0') + "Xing" +
+                    be32(0x1) + be32(frames);
+    if (lame) {
+      uint32_t gap = uint32_t(delay) << 12 | padding;
+      f += "LAME3.100" + std::string(12, '\0') +
+           std::string{char(gap >> 16), char(gap >> 8), char(gap)};
+    }
+    return f + std::string(FRAME_SIZE - f.size(), '\0');
+  }
+  // Helper: VBRI frame with a frame count
+  static std::string vbriFrame(uint32_t frames) {
+    std::string f = header() + std::string(32, '\0') + "VBRI" +
+                    std::string(6, '\0') + be32(0) + be32(frames);
+    return f + std::string(FRAME_SIZE - f.size(), '\0');
+  }
+
+  // Helper: RIFF chunk, padded to an even size
+  static std::string chunk(const std::string &id, const std::string &body) {
+    return id + le32(body.size()) + body + std::string(body.size() % 2, '\0');
+  }
+  // Helper: 16-bit stereo 44100 Hz PCM wave around extra chunks
+  static std::string wave(size_t seconds, const std::string &before,
+                          const std::string &after = "") {
+    std::string fmt = le16(1) + le16(2) + le32(44100) + le32(44100 * 4) +
+                      le16(4) + le16(16);
+    std::string body = "WAVE" + chunk("fmt ", fmt) + before +
+                       chunk("data", std::string(seconds * 44100 * 4, '\0')) +
+                       after;
+    return "RIFF" + le32(body.size()) + body;
+  }
+};
+
+// ========================
+// Test: MP3
+// ========================
+
+TEST_F(FastTagReaderTest, Mp3_Id3v23AndXing_ReadsTagsAndDuration) {
+  std::string tag = id3Tag(3, frame23("TIT2", std::string("\0Title", 6)) +
+                                  frame23("TPE1", std::string("\0Artist", 7)) +
+                                  frame23("TALB", std::string("\0Album", 6)));
+  std::string path = writeFile("a.mp3", tag + xingFrame(1000) + audio(20));
+  Song song;
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "Title");
+  EXPECT_EQ(song.artist, "Artist");
+  EXPECT_EQ(song.album, "Album");
+  EXPECT_EQ(song.duration, 26); // 1000 * 1152 / 44100
+}
+
+TEST_F(FastTagReaderTest, Mp3_Utf16AndUtf8Text_ConvertedToUtf8) {
+  // "Hà" as UTF-16LE with BOM, "Nội" as UTF-8 (v2.4)
+  std::string utf16 = std::string("\x01\xFF\xFE", 3) +
+                      std::string("H\0\xE0\0", 4);
+  std::string tag = id3Tag(4, frame24("TIT2", utf16) +
+                                  frame24("TPE1", "\x03N\xE1\xBB\x99i"));
+  std::string path = writeFile("b.mp3", tag + audio(10));
+  Song song;
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "H\xC3\xA0");
+  EXPECT_EQ(song.artist, "N\xE1\xBB\x99i");
+}
+
+TEST_F(FastTagReaderTest, Mp3_LameGapless_TrimsDelayAndPadding) {
+  // 1000 frames = 1152000 samples, minus 5760 = 25.99 seconds
+  std::string path =
+      writeFile("c.mp3", xingFrame(1000, 2880, 2880, true) + audio(10));
+  Song song;
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.duration, 25);
+}
+
+TEST_F(FastTagReaderTest, Mp3_Vbri_ReadsDuration) {
+  std::string path = writeFile("d.mp3", vbriFrame(2000) + audio(10));
+  Song song;
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.duration, 52); // 2000 * 1152 / 44100
+}
+
+TEST_F(FastTagReaderTest, Mp3_CbrWithId3v1_EstimatesFromSize) {
+  std::string path =
+      writeFile("e.mp3", std::string(100, '\0') + audio(1000) +
+                             id3v1("V1 Title", "V1 Artist", "V1 Album"));
+  Song song;
+  song.title = "e";
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "V1 Title");
+  EXPECT_EQ(song.artist, "V1 Artist");
+  EXPECT_EQ(song.album, "V1 Album");
+  EXPECT_EQ(song.duration, 26); // 1000 * 417 bytes at 128 kbit/s
+}
+
+TEST_F(FastTagReaderTest, Mp3_Id3v2WinsOverId3v1) {
+  std::string tag = id3Tag(3, frame23("TIT2", std::string("\0V2", 3)));
+  std::string path = writeFile(
+      "f.mp3", tag + audio(10) + id3v1("V1", "V1 Artist", "V1 Album"));
+  Song song;
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "V2");
+  EXPECT_EQ(song.artist, "V1 Artist");
+}
+
+TEST_F(FastTagReaderTest, Mp3_NoTags_KeepsDefaults) {
+  std::string path = writeFile("g.mp3", audio(10));
+  Song song;
+  song.title = "g";
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "g");
+  EXPECT_EQ(song.artist, "");
+}
+
+// ========================
+// Test: Fallback
+// ========================
+
+TEST_F(FastTagReaderTest, Mp3_UnsynchronisedTag_ReturnsFalse) {
+  std::string tag =
+      id3Tag(3, frame23("TIT2", std::string("\0Title", 6)), '\x80');
+  std::string path = writeFile("h.mp3", tag + audio(10));
+  Song song;
+  song.title = "h";
+
+  EXPECT_FALSE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "h"); // untouched for the fallback
+}
+
+TEST_F(FastTagReaderTest, Mp3_NoAudioFrames_ReturnsFalse) {
+  std::string path = writeFile("i.mp3", std::string(4096, 'x'));
+  Song song;
+  EXPECT_FALSE(FastTagReader::read(path, song));
+}
+
+TEST_F(FastTagReaderTest, UnsupportedOrMissingFile_ReturnsFalse) {
+  std::string flac = writeFile("j.flac", "fLaC");
+  Song song;
+
+  EXPECT_FALSE(FastTagReader::read(flac, song));
+  EXPECT_FALSE(FastTagReader::read((root / "missing.mp3").string(), song));
+}
+
+// ========================
+// Test: WAV
+// ========================
+
+TEST_F(FastTagReaderTest, Wav_InfoChunk_ReadsTagsAndDuration) {
+  std::string info = "INFO" + chunk("INAM", std::string("Wave Title\0", 11)) +
+                     chunk("IART", std::string("Wave Artist\0", 12)) +
+                     chunk("IPRD", std::string("Wave Album\0", 11));
+  std::string path = writeFile("k.wav", wave(3, "", chunk("LIST", info)));
+  Song song;
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "Wave Title");
+  EXPECT_EQ(song.artist, "Wave Artist");
+  EXPECT_EQ(song.album, "Wave Album");
+  EXPECT_EQ(song.duration, 3);
+}
+
+TEST_F(FastTagReaderTest, Wav_Id3Chunk_WinsOverInfo) {
+  std::string info = "INFO" + chunk("INAM", std::string("Info Title\0", 11)) +
+                     chunk("IART", std::string("Info Artist\0", 12));
+  std::string id3 = id3Tag(3, frame23("TIT2", std::string("\0Id3 Title", 10)));
+  std::string path = writeFile(
+      "l.wav", wave(1, chunk("LIST", info), chunk("id3 ", id3)));
+  Song song;
+
+  ASSERT_TRUE(FastTagReader::read(path, song));
+  EXPECT_EQ(song.title, "Id3 Title");
+  EXPECT_EQ(song.artist, "Info Artist");
+}
+
+TEST_F(FastTagReaderTest, Wav_MissingDataChunk_ReturnsFalse) {
+  std::string fmt = le16(1) + le16(2) + le32(44100) + le32(44100 * 4) +
+                    le16(4) + le16(16);
+  std::string body = "WAVE" + chunk("fmt ", fmt);
+  std::string path = writeFile("m.wav", "RIFF" + le32(body.size()) + body);
+  Song song;
+
+  EXPECT_FALSE(FastTagReader::read(path, song));
+}
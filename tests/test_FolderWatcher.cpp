@@ -0,0 +1,180 @@
+// tests/test_FolderWatcher.cpp
+// Unit tests for FolderWatcher class
+
+#include "../include/FolderWatcher.h"
+#include "TempDir.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+class FolderWatcherTest : public TempDirTest {
+protected:
+  FolderWatcher watcher{[](const std::string &, Song &song) {
+                          song.artist = "Watched Artist";
+                        },
+                        50ms};
+
+  FolderWatcherTest() : TempDirTest("folder_watcher_") {}
+
+  void SetUp() override {
+    if (!FolderWatcher::isSupported()) {
+      GTEST_SKIP() << "Folder watching is not supported on this platform";
+    }
+    TempDirTest::SetUp();
+  }
+
+  // Helper: start watching root and wait until the watches exist
+  void watchRoot(size_t expectedWatches = 1) {
+    ASSERT_TRUE(watcher.addFolder(root.string()));
+    for (int i = 0; i < 200 && watcher.getWatchCount() < expectedWatches;
+         i++) {
+      std::this_thread::sleep_for(5ms);
+    }
+    ASSERT_GE(watcher.getWatchCount(), expectedWatches);
+  }
+
+  // Helper: wait for the next batch (false on timeout)
+  bool waitForChanges(FolderChanges &changes) {
+    for (int i = 0; i < 400; i++) {
+      if (watcher.takeChanges(changes)) {
+        return true;
+      }
+      std::this_thread::sleep_for(5ms);
+    }
+    return false;
+  }
+};
+
+// ========================
+// Test: file events
+// ========================
+
+TEST_F(FolderWatcherTest, NewFile_ReportedWithTags) {
+  watchRoot();
+
+  std::ofstream(root / "new.mp3") << "x";
+
+  FolderChanges changes;
+  ASSERT_TRUE(waitForChanges(changes));
+  EXPECT_EQ(changes.root, root.string());
+  ASSERT_EQ(changes.upserts.size(), 1);
+  EXPECT_EQ(changes.upserts[0].filePath, (root / "new.mp3").string());
+  EXPECT_EQ(changes.upserts[0].artist, "Watched Artist");
+  EXPECT_EQ(changes.upserts[0].stamp.size, 1);
+}
+
+TEST_F(FolderWatcherTest, BurstOfWrites_CoalescedIntoOneUpsert) {
+  watchRoot();
+
+  for (int i = 0; i < 20; i++) {
+    std::ofstream(root / "busy.mp3") << std::string(i + 1, 'x');
+  }
+
+  FolderChanges changes;
+  ASSERT_TRUE(waitForChanges(changes));
+  ASSERT_EQ(changes.upserts.size(), 1);
+  EXPECT_EQ(changes.upserts[0].stamp.size, 20);
+  EXPECT_FALSE(watcher.takeChanges(changes));
+}
+
+TEST_F(FolderWatcherTest, DeletedFile_ReportedRemoved) {
+  std::ofstream(root / "old.mp3") << "x";
+  watchRoot();
+
+  fs::remove(root / "old.mp3");
+
+  FolderChanges changes;
+  ASSERT_TRUE(waitForChanges(changes));
+  EXPECT_TRUE(changes.upserts.empty());
+  ASSERT_EQ(changes.removed.size(), 1);
+  EXPECT_EQ(changes.removed[0], (root / "old.mp3").string());
+}
+
+TEST_F(FolderWatcherTest, NonAudioFile_Ignored) {
+  watchRoot();
+
+  std::ofstream(root / "cover.jpg") << "x";
+  std::this_thread::sleep_for(200ms);
+
+  FolderChanges changes;
+  EXPECT_FALSE(watcher.takeChanges(changes));
+}
+
+// ========================
+// Test: folder events
+// ========================
+
+TEST_F(FolderWatcherTest, NewSubfolder_IsWatched) {
+  watchRoot();
+
+  fs::create_directories(root / "Album");
+  for (int i = 0; i < 200 && watcher.getWatchCount() < 2; i++) {
+    std::this_thread::sleep_for(5ms);
+  }
+  std::ofstream(root / "Album" / "track.mp3") << "x";
+
+  FolderChanges changes;
+  ASSERT_TRUE(waitForChanges(changes));
+  ASSERT_EQ(changes.upserts.size(), 1);
+  EXPECT_EQ(changes.upserts[0].filePath,
+            (root / "Album" / "track.mp3").string());
+}
+
+TEST_F(FolderWatcherTest, DeletedSubfolder_ReportedRemoved) {
+  fs::create_directories(root / "Album");
+  watchRoot(2);
+
+  fs::remove_all(root / "Album");
+
+  FolderChanges changes;
+  ASSERT_TRUE(waitForChanges(changes));
+  ASSERT_EQ(changes.removedDirs.size(), 1);
+  EXPECT_EQ(changes.removedDirs[0], (root / "Album").string());
+}
+
+// ========================
+// Test: removeFolder / clear
+// ========================
+
+TEST_F(FolderWatcherTest, RemoveFolder_OtherRootKeepsReporting) {
+  fs::path other = root.string() + "_other";
+  fs::remove_all(other);
+  fs::create_directories(other);
+  ASSERT_TRUE(watcher.addFolder(other.string()));
+  watchRoot(2);
+
+  watcher.removeFolder(root.string());
+  for (int i = 0; i < 200 && watcher.getWatchCount() > 1; i++) {
+    std::this_thread::sleep_for(5ms);
+  }
+  std::ofstream(root / "late.mp3") << "x";
+  std::ofstream(other / "kept.mp3") << "x";
+
+  FolderChanges changes;
+  ASSERT_TRUE(waitForChanges(changes));
+  EXPECT_EQ(watcher.getWatchCount(), 1);
+  EXPECT_EQ(changes.root, other.string());
+  ASSERT_EQ(changes.upserts.size(), 1);
+  std::this_thread::sleep_for(200ms);
+  EXPECT_FALSE(watcher.takeChanges(changes));
+  fs::remove_all(other);
+}
+
+TEST_F(FolderWatcherTest, Clear_StopsReporting) {
+  watchRoot();
+
+  watcher.clear();
+  for (int i = 0; i < 200 && watcher.getWatchCount() > 0; i++) {
+    std::this_thread::sleep_for(5ms);
+  }
+  std::ofstream(root / "late.mp3") << "x";
+  std::this_thread::sleep_for(200ms);
+
+  FolderChanges changes;
+  EXPECT_EQ(watcher.getWatchCount(), 0);
+  EXPECT_FALSE(watcher.takeChanges(changes));
+}
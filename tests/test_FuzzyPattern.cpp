@@ -0,0 +1,77 @@
+// tests/test_FuzzyPattern.cpp
+// Unit tests for FuzzyPattern class
+
+#include "../include/FuzzyPattern.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+// Reference: fewest edits from pattern to any substring of text (DP table)
+static size_t bestSubstringDistance(const std::string &pattern,
+                                    const std::string &text) {
+  std::vector<size_t> column(pattern.size() + 1);
+  for (size_t i = 0; i <= pattern.size(); i++) {
+    column[i] = i;
+  }
+  size_t best = column.back();
+  for (char ch : text) {
+    size_t diagonal = column[0]; // row 0 stays 0: start anywhere
+    for (size_t i = 1; i <= pattern.size(); i++) {
+      size_t up = column[i];
+      column[i] = std::min({column[i] + 1, column[i - 1] + 1,
+                            diagonal + (pattern[i - 1] != ch)});
+      diagonal = up;
+    }
+    best = std::min(best, column.back());
+  }
+  return best;
+}
+
+// ========================
+// Test: distance
+// ========================
+
+TEST(FuzzyPatternTest, Distance_CountsEdits) {
+  FuzzyPattern pattern("son tung");
+
+  EXPECT_EQ(pattern.distance("son tung m tp", 3), 0);
+  EXPECT_EQ(pattern.distance("ca si son tung", 3), 0);
+  EXPECT_EQ(pattern.distance("sno tung", 3), 2);  // swapped letters
+  EXPECT_EQ(pattern.distance("son tugn", 3), 1);  // "son tug" one edit away
+  EXPECT_EQ(pattern.distance("son tng", 3), 1);   // missing letter
+  EXPECT_EQ(pattern.distance("sonn tung", 3), 1); // extra letter
+  EXPECT_EQ(pattern.distance("san tung", 3), 1);  // wrong letter
+  EXPECT_EQ(pattern.distance("my tam", 2), 3);    // capped at max + 1
+  EXPECT_EQ(pattern.distance("", 9), 8);
+}
+
+TEST(FuzzyPatternTest, Distance_MatchesDynamicProgramming) {
+  std::mt19937 rng(5);
+  auto text = [&](size_t length) {
+    std::string out;
+    for (size_t i = 0; i < length; i++) {
+      out += "abcd "[rng() % 5];
+    }
+    return out;
+  };
+  for (int round = 0; round < 3000; round++) {
+    std::string pattern = text(1 + rng() % 70); // past one word: cut to 64
+    std::string haystack = text(rng() % 90);
+    std::string used = pattern.substr(0, FuzzyPattern::MAX_LENGTH);
+    size_t maxErrors = round % 2 ? 100 : rng() % 4; // small: filter runs
+    ASSERT_EQ(FuzzyPattern(pattern).distance(haystack, maxErrors),
+              std::min(bestSubstringDistance(used, haystack), maxErrors + 1))
+        << "pattern '" << pattern << "' text '" << haystack << "'";
+  }
+}
+
+TEST(FuzzyPatternTest, MaxErrors_GrowWithLength) {
+  EXPECT_EQ(FuzzyPattern("abc").getMaxErrors(), 0);
+  EXPECT_EQ(FuzzyPattern("abcd").getMaxErrors(), 1);
+  EXPECT_EQ(FuzzyPattern("abcdefg").getMaxErrors(), 1);
+  EXPECT_EQ(FuzzyPattern("abcdefgh").getMaxErrors(), 2);
+  EXPECT_EQ(FuzzyPattern(std::string(40, 'a')).getMaxErrors(), 3);
+  EXPECT_EQ(FuzzyPattern(std::string(100, 'a')).size(), 64);
+}
@@ -0,0 +1,99 @@
+// tests/test_ImportPipeline.cpp
+// Unit tests for ImportPipeline class
+
+#include "../include/ImportPipeline.h"
+#include "TempDir.h"
+#include <atomic>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <set>
+
+namespace fs = std::filesystem;
+
+class ImportPipelineTest : public TempDirTest {
+protected:
+  ImportPipelineTest() : TempDirTest("import_pipeline_") {}
+
+  // Reader that leaves the filename defaults untouched
+  static void noTags(const std::string &, Song &) {}
+};
+
+// ========================
+// Test: run
+// ========================
+
+TEST_F(ImportPipelineTest, Run_ImportsOnlyAudioFiles) {
+  touch("a.mp3");
+  touch("b.wav");
+  touch("cover.jpg");
+  touch("notes.txt");
+  std::vector<Song> songs;
+
+  ImportPipeline pipeline(2);
+  ImportStats stats = pipeline.run(root.string(), noTags,
+                                   [&](Song &&s) { songs.push_back(s); });
+
+  EXPECT_EQ(songs.size(), 2);
+  EXPECT_EQ(stats.walker.files, 2);
+  EXPECT_EQ(stats.reader.files, 2);
+  EXPECT_EQ(stats.indexer.files, 2);
+}
+
+TEST_F(ImportPipelineTest, Run_AppliesDefaultMetadata) {
+  touch("My Song.mp3");
+  std::vector<Song> songs;
+
+  ImportPipeline pipeline(1);
+  pipeline.run(root.string(), noTags, [&](Song &&s) { songs.push_back(s); });
+
+  ASSERT_EQ(songs.size(), 1);
+  EXPECT_EQ(songs[0].title, "My Song");
+  EXPECT_EQ(songs[0].artist, "Unknown Artist");
+  EXPECT_EQ(songs[0].album, "Unknown Album");
+}
+
+TEST_F(ImportPipelineTest, Run_ReaderOverridesDefaults) {
+  touch("track.mp3");
+  std::vector<Song> songs;
+
+  ImportPipeline pipeline(1);
+  pipeline.run(
+      root.string(),
+      [](const std::string &, Song &s) {
+        s.title = "Tagged";
+        s.artist = "Tag Artist";
+      },
+      [&](Song &&s) { songs.push_back(s); });
+
+  ASSERT_EQ(songs.size(), 1);
+  EXPECT_EQ(songs[0].title, "Tagged");
+  EXPECT_EQ(songs[0].artist, "Tag Artist");
+}
+
+TEST_F(ImportPipelineTest, Run_ManyFilesManyWorkers_NoLossNoDuplicate) {
+  for (int i = 0; i < 500; i++) {
+    touch("song" + std::to_string(i) + ".mp3");
+  }
+  std::atomic<int> readerCalls{0};
+  std::set<std::string> paths;
+
+  // Queue smaller than the file count forces back-pressure on every stage
+  ImportPipeline pipeline(8, 4);
+  ImportStats stats = pipeline.run(
+      root.string(), [&](const std::string &, Song &) { readerCalls++; },
+      [&](Song &&s) { paths.insert(s.filePath); });
+
+  EXPECT_EQ(paths.size(), 500);
+  EXPECT_EQ(readerCalls, 500);
+  EXPECT_EQ(stats.workerCount, 8);
+}
+
+TEST_F(ImportPipelineTest, Run_EmptyFolder_ReturnsZeroStats) {
+  ImportPipeline pipeline;
+
+  ImportStats stats =
+      pipeline.run(root.string(), noTags, [](Song &&) { FAIL(); });
+
+  EXPECT_EQ(stats.indexer.files, 0);
+  EXPECT_GE(pipeline.getWorkerCount(), 1);
+}
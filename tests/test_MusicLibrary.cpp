@@ -2,6 +2,7 @@
 // Unit tests for MusicLibrary class
 
 #include "../include/MusicLibrary.h"
+#include <algorithm>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -9,11 +10,6 @@ class MusicLibraryTest : public ::testing::Test {
 protected:
   MusicLibrary library;
 
-  void SetUp() override {
-    // Reset ID counter before each test
-    Song::resetIdCounter();
-  }
-
   void TearDown() override { library.clear(); }
 
   // Helper to create a test song
@@ -57,15 +53,104 @@ TEST_F(MusicLibraryTest, AddSong_AssignsUniqueIds) {
   EXPECT_NE(songs[0].id, songs[1].id);
 }
 
-TEST_F(MusicLibraryTest, AddSong_ReallocationCheck) {
-  for (int i = 0; i < 1000; i++) {
-    library.addSong(createTestSong("Mock Song", "Mock Artist", "Mock Album"));
+TEST_F(MusicLibraryTest, AddSong_NewBlock_SongsKeepAddress) {
+  EXPECT_TRUE(library.addSong(createTestSong("First", "Artist", "Album")));
+  const StoredSong *first = &library.getAllSongs()[0];
+  for (size_t i = 1; i < SongStore::BLOCK_SIZE; i++) {
+    EXPECT_FALSE(library.addSong(
+        createTestSong("Mock Song", "Mock Artist", "Mock Album")));
+  }
+  // Storage grows by a new block, nothing already stored moves
+  bool allocated = library.addSong(
+      createTestSong("Mock Song 1025", "Mock Artist", "Mock Album"));
+  EXPECT_TRUE(allocated);
+  EXPECT_EQ(&library.getAllSongs()[0], first);
+  EXPECT_EQ(first->title, "First");
+}
+// ========================
+// Test: addSongs
+// ========================
+
+TEST_F(MusicLibraryTest, AddSongs_IndexesEverySong) {
+  std::vector<Song> batch{createTestSong("Song 1", "Artist A", "Album 1"),
+                          createTestSong("Song 2", "Artist B", "Album 1"),
+                          createTestSong("Song 3", "Artist A", "Album 2")};
+
+  EXPECT_TRUE(library.addSongs(std::move(batch))); // first block
+
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(library.getSize(), 3);
+  EXPECT_EQ(library.findSongByID(1), &library.getAllSongs()[1]);
+  EXPECT_EQ(library.findSongByTitle("Song 3"), &library.getAllSongs()[2]);
+  EXPECT_NE(library.findSongByPath("/test/path/Song 2.mp3"), nullptr);
+  EXPECT_EQ(library.findSongByArtist("Artist A").size(), 2);
+  uint32_t album = library.getAlbums().find("Album 1");
+  EXPECT_EQ(library.getAlbumIndex().at(album).size(), 2);
+}
+
+TEST_F(MusicLibraryTest, AddSongs_AfterSingleSongs_MergesGroupsInOrder) {
+  library.addSong(createTestSong("Song 1", "Artist", "Album"));
+  std::vector<Song> batch{createTestSong("Song 2", "Artist", "Album"),
+                          createTestSong("Song 3", "Artist", "Album")};
+
+  library.addSongs(std::move(batch));
+
+  std::vector<const StoredSong *> group = library.findSongByArtist("Artist");
+  ASSERT_EQ(group.size(), 3);
+  EXPECT_EQ(group[0]->title, "Song 1");
+  EXPECT_EQ(group[2]->title, "Song 3");
+}
+
+TEST_F(MusicLibraryTest, AddSongs_NewBlocks_SongsKeepAddress) {
+  library.addSong(createTestSong("First", "Artist", "Album"));
+  const StoredSong *first = library.findSongByID(0);
+  std::vector<Song> batch;
+  for (int i = 0; i < 3000; i++) {
+    batch.push_back(
+        createTestSong("Song " + std::to_string(i), "Artist", "Album"));
+  }
+
+  EXPECT_TRUE(library.addSongs(std::move(batch)));
+
+  EXPECT_EQ(library.findSongByID(0), first);
+  EXPECT_EQ(&library.getAllSongs()[0], first);
+  EXPECT_EQ(library.findSongByTitle("First"), first);
+  EXPECT_EQ(library.findSongByArtist("Artist").size(), 3001);
+}
+
+TEST_F(MusicLibraryTest, AddSongs_LargeBatch_SameIndexesAsAddSong) {
+  // Big enough for the parallel index build, with duplicate titles
+  std::vector<Song> batch;
+  for (int i = 0; i < 10000; i++) {
+    batch.push_back(createTestSong("Song " + std::to_string(i % 3000),
+                                   "Artist " + std::to_string(i % 70),
+                                   "Album " + std::to_string(i % 300)));
+    batch.back().filePath += std::to_string(i);
+  }
+  MusicLibrary reference;
+  for (const Song &song : batch) {
+    reference.addSong(song);
+  }
+
+  library.addSongs(std::move(batch));
+
+  ASSERT_EQ(library.getSize(), reference.getSize());
+  for (int i = 0; i < 3000; i++) {
+    std::string title = "Song " + std::to_string(i);
+    EXPECT_EQ(library.findSongByTitle(title)->id,
+              reference.findSongByTitle(title)->id);
   }
-  // Check if reallocation happened
-  bool reallocation_happened = library.addSong(
-      createTestSong("Mock Song 1001", "Mock Artist", "Mock Album"));
-  EXPECT_TRUE(reallocation_happened);
+  EXPECT_EQ(library.getArtistIndex().size(), 70);
+  EXPECT_EQ(library.getAlbumIndex().size(), 300);
+  EXPECT_EQ(library.findSongByArtist("Artist 5").front()->id,
+            reference.findSongByArtist("Artist 5").front()->id);
+}
+
+TEST_F(MusicLibraryTest, AddSongs_EmptyBatch_NoChange) {
+  EXPECT_FALSE(library.addSongs({}));
+  EXPECT_EQ(library.getSize(), 0);
 }
+
 // ========================
 // Test: findSongByID
 // ========================
@@ -73,7 +158,7 @@ TEST_F(MusicLibraryTest, AddSong_ReallocationCheck) {
 TEST_F(MusicLibraryTest, FindSongByID_ExistingID_ReturnsSong) {
   library.addSong(createTestSong("Target Song", "Artist", "Album"));
 
-  const Song *found = library.findSongByID(0);
+  const StoredSong *found = library.findSongByID(0);
 
   ASSERT_NE(found, nullptr);
   EXPECT_EQ(found->title, "Target Song");
@@ -82,9 +167,37 @@ TEST_F(MusicLibraryTest, FindSongByID_ExistingID_ReturnsSong) {
 TEST_F(MusicLibraryTest, FindSongByID_NonExistingID_ReturnsNull) {
   library.addSong(createTestSong("Song", "Artist", "Album"));
 
-  const Song *found = library.findSongByID(999);
+  const StoredSong *found = library.findSongByID(999);
 
   EXPECT_EQ(found, nullptr);
+  EXPECT_EQ(library.findSongByID(-1), nullptr);
+}
+
+TEST_F(MusicLibraryTest, FindSongByID_IdsDenseInInsertOrder) {
+  Song song = createTestSong("Song", "Artist", "Album");
+  song.id = 42; // ignored: the library hands out IDs
+  library.addSong(song);
+  library.addSongs({createTestSong("A", "Artist", "Album"),
+                    createTestSong("B", "Artist", "Album")});
+
+  for (int id = 0; id < 3; id++) {
+    ASSERT_NE(library.findSongByID(id), nullptr);
+    EXPECT_EQ(library.findSongByID(id)->id, id);
+  }
+  EXPECT_EQ(library.findSongByID(1)->title, "A");
+  EXPECT_EQ(library.findSongByID(3), nullptr);
+}
+
+TEST_F(MusicLibraryTest, FindSongByID_RemovedIdNotReused) {
+  library.addSong(createTestSong("Gone", "Artist", "Album"));
+  library.addSong(createTestSong("Kept", "Artist", "Album"));
+  library.removeSong(0);
+
+  library.addSong(createTestSong("New", "Artist", "Album"));
+
+  EXPECT_EQ(library.findSongByID(0), nullptr);
+  EXPECT_EQ(library.findSongByID(1)->title, "Kept");
+  EXPECT_EQ(library.findSongByID(2)->title, "New");
 }
 
 // ========================
@@ -94,7 +207,7 @@ TEST_F(MusicLibraryTest, FindSongByID_NonExistingID_ReturnsNull) {
 TEST_F(MusicLibraryTest, FindSongByTitle_ExactMatch_ReturnsSong) {
   library.addSong(createTestSong("Unique Title", "Artist", "Album"));
 
-  const Song *found = library.findSongByTitle("Unique Title");
+  const StoredSong *found = library.findSongByTitle("Unique Title");
 
   ASSERT_NE(found, nullptr);
   EXPECT_EQ(found->title, "Unique Title");
@@ -103,7 +216,7 @@ TEST_F(MusicLibraryTest, FindSongByTitle_ExactMatch_ReturnsSong) {
 TEST_F(MusicLibraryTest, FindSongByTitle_NoMatch_ReturnsNull) {
   library.addSong(createTestSong("Some Song", "Artist", "Album"));
 
-  const Song *found = library.findSongByTitle("Nonexistent");
+  const StoredSong *found = library.findSongByTitle("Nonexistent");
 
   EXPECT_EQ(found, nullptr);
 }
@@ -142,8 +255,9 @@ TEST_F(MusicLibraryTest, GetArtistIndex_GroupsByArtist) {
   const auto &index = library.getArtistIndex();
 
   EXPECT_EQ(index.size(), 2);                // 2 artists
-  EXPECT_EQ(index.at("Artist A").size(), 2); // 2 songs
-  EXPECT_EQ(index.at("Artist B").size(), 1); // 1 song
+  const StringPool &artists = library.getArtists();
+  EXPECT_EQ(index.at(artists.find("Artist A")).size(), 2); // 2 songs
+  EXPECT_EQ(index.at(artists.find("Artist B")).size(), 1); // 1 song
 }
 
 // ========================
@@ -158,8 +272,94 @@ TEST_F(MusicLibraryTest, GetAlbumIndex_GroupsByAlbum) {
   const auto &index = library.getAlbumIndex();
 
   EXPECT_EQ(index.size(), 2); // 2 albums
-  EXPECT_EQ(index.at("Album X").size(), 2);
-  EXPECT_EQ(index.at("Album Y").size(), 1);
+  EXPECT_EQ(index.at(library.getAlbums().find("Album X")).size(), 2);
+  EXPECT_EQ(index.at(library.getAlbums().find("Album Y")).size(), 1);
+}
+
+TEST_F(MusicLibraryTest, GetSortedAlbums_SortedByName) {
+  library.addSong(createTestSong("Song 1", "Artist", "Zeta"));
+  library.addSong(createTestSong("Song 2", "Artist", "Alpha"));
+  library.addSong(createTestSong("Song 3", "Artist", "Zeta"));
+
+  std::vector<uint32_t> sorted = library.getSortedAlbums();
+
+  ASSERT_EQ(sorted.size(), 2);
+  EXPECT_EQ(library.getAlbums().get(sorted[0]), "Alpha");
+  EXPECT_EQ(library.getAlbums().get(sorted[1]), "Zeta");
+}
+
+// ========================
+// Test: artist / album interning
+// ========================
+
+TEST_F(MusicLibraryTest, AddSong_SameArtist_SharesID) {
+  library.addSong(createTestSong("Song 1", "Artist", "Album 1"));
+  library.addSong(createTestSong("Song 2", "Artist", "Album 2"));
+
+  const StoredSong *first = library.findSongByID(0);
+  const StoredSong *second = library.findSongByID(1);
+
+  EXPECT_EQ(first->artistId, second->artistId);
+  EXPECT_NE(first->albumId, second->albumId);
+  EXPECT_EQ(library.getArtists().size(), 1);
+  EXPECT_EQ(library.getAlbums().size(), 2);
+}
+
+TEST_F(MusicLibraryTest, AddSong_StoredSong_TextInPools) {
+  library.addSong(createTestSong("Song", "Artist", "Album"));
+  const StoredSong *song = library.findSongByID(0);
+
+  EXPECT_EQ(library.getArtist(*song), "Artist");
+  EXPECT_EQ(library.getAlbum(*song), "Album");
+
+  Song copy = library.copySong(*song);
+  EXPECT_EQ(copy.title, "Song");
+  EXPECT_EQ(copy.artist, "Artist");
+  EXPECT_EQ(copy.album, "Album");
+  EXPECT_EQ(copy.filePath, "/test/path/Song.mp3");
+  EXPECT_EQ(copy.id, song->id);
+}
+
+// ========================
+// Test: getColumns
+// ========================
+
+TEST_F(MusicLibraryTest, Columns_FollowAddRemoveUpdate) {
+  library.addSong(createTestSong("First", "Artist A", "Album 1"));
+  library.addSongs({createTestSong("Second", "Artist B", "Album 2"),
+                    createTestSong("Third", "Artist A", "Album 2")});
+  library.removeSong(0); // "Third" moves into slot 0
+  library.updateSong(1, createTestSong("Renamed", "Artist C", "Album 3"));
+
+  const SongColumns &columns = library.getColumns();
+  const SongStore &rows = library.getAllSongs();
+  ASSERT_EQ(columns.size(), rows.size());
+  for (size_t row = 0; row < rows.size(); row++) {
+    EXPECT_EQ(columns.ids[row], rows[row].id);
+    EXPECT_EQ(columns.titles[row], rows[row].title);
+    EXPECT_EQ(columns.artistIds[row], rows[row].artistId);
+    EXPECT_EQ(columns.albumIds[row], rows[row].albumId);
+    EXPECT_EQ(columns.filePaths[row], rows[row].filePath);
+    EXPECT_EQ(library.resolve(library.slotHandle(row)), &rows[row]);
+  }
+  EXPECT_EQ(columns.titles[0], "Third");
+  EXPECT_EQ(columns.titles[1], "Renamed");
+
+  library.clear();
+  EXPECT_EQ(library.getColumns().size(), 0);
+}
+
+TEST_F(MusicLibraryTest, AddSong_TitleAndPath_InTextArena) {
+  library.addSong(createTestSong("Song", "Artist", "Album"));
+  const StoredSong *song = library.findSongByID(0);
+
+  EXPECT_EQ(song->title, "Song");
+  EXPECT_STREQ(song->filePath.data(), "/test/path/Song.mp3"); // C string
+  TitleKeys keys = library.getColumns().getKeys(0); // title keys too
+  EXPECT_EQ(library.getTextArena().getTextBytes(),
+            song->title.size() + song->filePath.size() + keys.sortKey.size() +
+                keys.searchKey.size());
+  EXPECT_LE(sizeof(StoredSong), 64); // one cache line on 64-bit builds
 }
 
 // ========================
@@ -179,6 +379,351 @@ TEST_F(MusicLibraryTest, GetSortedSongs_ReturnsSortedByTitle) {
   EXPECT_EQ(sorted[2]->title, "Zebra");
 }
 
+TEST_F(MusicLibraryTest, GetSortedSongs_DuplicateTitlesAllListed) {
+  library.addSong(createTestSong("Intro", "Artist A", "Album A"));
+  library.addSong(createTestSong("Intro", "Artist B", "Album B"));
+  library.addSong(createTestSong("Interlude", "Artist A", "Album A"));
+
+  auto sorted = library.getSortedSongs();
+
+  ASSERT_EQ(sorted.size(), 3);
+  EXPECT_EQ(sorted[1]->id, 0);
+  EXPECT_EQ(sorted[2]->id, 1);
+  EXPECT_EQ(library.findSongByTitle("Intro")->id, 0); // first added
+  const TitleIndex &index = library.getTitleIndex();
+  EXPECT_EQ(index.equalRange(makeSortKey("Intro")).size(), 2);
+  EXPECT_EQ(index.prefixRange(makePrefixKey("Int")).size(), 3);
+
+  library.removeSong(0);
+  EXPECT_EQ(library.findSongByTitle("Intro")->id, 1);
+}
+
+// ========================
+// Test: Unicode text
+// ========================
+
+TEST_F(MusicLibraryTest, AddSong_DecomposedText_StoredComposed) {
+  // "Hà Nội" typed with combining marks (NFD), as some taggers write it
+  std::string decomposed = "Ha\xCC\x80 No\xCC\x82\xCC\xA3i";
+  library.addSong(createTestSong(decomposed, decomposed, "Album"));
+
+  const StoredSong *song = library.findSongByID(0);
+  EXPECT_EQ(song->title, "H\xC3\xA0 N\xE1\xBB\x99i");
+  EXPECT_EQ(library.findSongByTitle(decomposed), song);
+  EXPECT_EQ(library.findSongByTitle("H\xC3\xA0 N\xE1\xBB\x99i"), song);
+  EXPECT_EQ(library.findSongByTitle("Ha Noi"), nullptr); // marks matter
+  EXPECT_EQ(library.findSongByArtist("H\xC3\xA0 N\xE1\xBB\x99i").size(), 1);
+  EXPECT_EQ(library.getColumns().titleSearchKeys[0], "ha noi");
+}
+
+TEST_F(MusicLibraryTest, SortOrders_FollowVietnameseCollation) {
+  // Byte order would put "Đà Lạt" and "Ánh" after "Zen"
+  library.addSong(createTestSong("Zen", "A", "\xC3\x81nh")); // Ánh
+  library.addSong(createTestSong("\xC4\x90\xC3\xA0 L\xE1\xBA\xA1t", "A",
+                                 "anh")); // Đà Lạt
+  library.addSong(createTestSong("dao", "A", "Zen"));
+
+  SortView byTitle = library.getSortView(SortKey::Title);
+  EXPECT_EQ(byTitle[0]->id, 2); // d < đ < z
+  EXPECT_EQ(byTitle[1]->id, 1);
+  EXPECT_EQ(byTitle[2]->id, 0);
+
+  std::vector<uint32_t> albums = library.getSortedAlbums();
+  ASSERT_EQ(albums.size(), 3);
+  EXPECT_EQ(library.getAlbums().get(albums[0]), "anh"); // anh < Ánh
+  EXPECT_EQ(library.getAlbums().get(albums[1]), "\xC3\x81nh");
+  EXPECT_EQ(library.getAlbums().get(albums[2]), "Zen");
+}
+
+TEST_F(MusicLibraryTest, TitleIndex_PrefixKeyIgnoresCaseAndMarks) {
+  library.addSong(createTestSong("H\xC3\xA0 N\xE1\xBB\x99i", "A", "B"));
+  library.addSong(createTestSong("hanh", "A", "B"));
+  library.addSong(createTestSong("Hue", "A", "B"));
+
+  const TitleIndex &index = library.getTitleIndex();
+  EXPECT_EQ(index.prefixRange(makePrefixKey("HA")).size(), 2);
+  EXPECT_EQ(index.prefixRange(makePrefixKey("ha n")).size(), 1);
+  EXPECT_EQ(index.prefixRange(makePrefixKey("hu")).begin()->id, 2);
+}
+
+// ========================
+// Test: search
+// ========================
+
+TEST_F(MusicLibraryTest, Search_IgnoresCaseAndMarks_MatchesEveryField) {
+  library.addSong(createTestSong("H\xC3\xA0 N\xE1\xBB\x99i m\xC3\xB9\x61 thu",
+                                 "M\xE1\xBB\xB9 T\xC3\xA2m", "Best"));
+  library.addSong(createTestSong("Other", "Artist",
+                                 "H\xC3\xA0 N\xE1\xBB\x99i x\xC6\xB0\x61"));
+  library.addSong(createTestSong("Nothing", "Artist", "Album"));
+
+  SearchResult byTitleOrAlbum = library.search("HA NOI");
+  ASSERT_EQ(byTitleOrAlbum.songs.size(), 2);
+  EXPECT_EQ(library.resolve(byTitleOrAlbum.songs[0])->id, 0);
+  EXPECT_EQ(library.resolve(byTitleOrAlbum.songs[1])->id, 1);
+  ASSERT_EQ(byTitleOrAlbum.albums.size(), 1);
+  EXPECT_EQ(library.getAlbums().get(byTitleOrAlbum.albums[0]),
+            "H\xC3\xA0 N\xE1\xBB\x99i x\xC6\xB0\x61");
+
+  SearchResult byArtist = library.search("tam");
+  ASSERT_EQ(byArtist.songs.size(), 1);
+  EXPECT_EQ(library.resolve(byArtist.songs[0])->id, 0);
+  EXPECT_EQ(byArtist.artists.size(), 1);
+
+  EXPECT_TRUE(library.search("").songs.empty());
+  EXPECT_TRUE(library.search("no such song").songs.empty());
+}
+
+TEST_F(MusicLibraryTest, Search_ShortQuery_ScansKeys) {
+  library.addSong(createTestSong("H\xC3\xA0", "A", "B"));
+  library.addSong(createTestSong("Xa", "A", "B"));
+  library.addSong(createTestSong("Yo", "A", "B"));
+
+  EXPECT_EQ(library.search("a").songs.size(), 3); // artist "A" matches all
+  SearchResult titles = library.search("Ha");
+  ASSERT_EQ(titles.songs.size(), 1);
+  EXPECT_EQ(library.resolve(titles.songs[0])->id, 0);
+}
+
+TEST_F(MusicLibraryTest, Search_RemovedOrUpdatedSongs_NotReturned) {
+  for (int i = 0; i < 2000; i++) {
+    library.addSong(
+        createTestSong("Song " + std::to_string(i), "Artist", "Album"));
+  }
+  EXPECT_TRUE(library.updateSong(1, createTestSong("Alpha", "X", "Y")));
+  // Enough erased postings to re-index the titles
+  for (int i = 500; i < 2000; i++) {
+    library.removeSong(i);
+  }
+
+  EXPECT_EQ(library.search("song").songs.size(), 499);
+  EXPECT_TRUE(library.search("song 1999").songs.empty());
+  SearchResult updated = library.search("alpha");
+  ASSERT_EQ(updated.songs.size(), 1);
+  EXPECT_EQ(library.resolve(updated.songs[0])->id, 1);
+  for (SongHandle handle : library.search("song").songs) {
+    EXPECT_NE(library.resolve(handle)->id, 1); // no longer "Song 1"
+  }
+}
+
+TEST_F(MusicLibraryTest, Refine_SameAsSearchingAgain) {
+  library.addSong(createTestSong("Love Story", "Taylor", "Fearless"));
+  library.addSong(createTestSong("Rain", "Lovelace", "Storm"));
+  library.addSong(createTestSong("Sunny", "Ann", "Lovers"));
+  library.addSong(createTestSong("Loud", "Ann", "Noise"));
+
+  SearchResult broad = library.search("lo");
+  EXPECT_EQ(broad.songs.size(), 4);
+  SearchResult narrow = library.refine(broad, "LOVE");
+  SearchResult fresh = library.search("love");
+
+  EXPECT_EQ(narrow.songs, fresh.songs);
+  EXPECT_EQ(narrow.artists, fresh.artists);
+  EXPECT_EQ(narrow.albums, fresh.albums);
+  EXPECT_EQ(narrow.songs.size(), 3);
+}
+
+TEST_F(MusicLibraryTest, FuzzySearch_MisspelledNames_Ranked) {
+  library.addSong(createTestSong("Lac Troi", "S\xC6\xA1n T\xC3\xB9ng M-TP",
+                                 "Single")); // Sơn Tùng
+  library.addSong(createTestSong("Song Tung", "Other", "Album"));
+  library.addSong(createTestSong("Noi Nay Co Anh", "Someone", "Son Tung Hits"));
+  library.addSong(createTestSong("Unrelated", "Nobody", "Nothing"));
+
+  EXPECT_TRUE(library.search("son tugn").songs.empty());
+  std::vector<FuzzyHit> hits = library.fuzzySearch("son tugn", 10);
+
+  ASSERT_EQ(hits.size(), 3);
+  // Same edits: title > artist > album by weight
+  EXPECT_EQ(library.resolve(hits[0].song)->id, 1);
+  EXPECT_EQ(hits[0].field, SearchField::Title);
+  EXPECT_EQ(library.resolve(hits[1].song)->id, 0);
+  EXPECT_EQ(hits[1].field, SearchField::Artist);
+  EXPECT_EQ(hits[1].errors, 1);
+  EXPECT_EQ(library.resolve(hits[2].song)->id, 2);
+  EXPECT_EQ(hits[2].field, SearchField::Album);
+  EXPECT_GT(hits[0].score, hits[1].score);
+  EXPECT_GT(hits[1].score, hits[2].score);
+}
+
+TEST_F(MusicLibraryTest, FuzzySearch_KeepsOnlyBestLimit) {
+  for (int i = 0; i < 300; i++) {
+    library.addSong(createTestSong("Rain " + std::to_string(i), "A", "B"));
+  }
+  library.addSong(createTestSong("Rain", "A", "B")); // exact, shortest
+  FuzzyWeights titlesOnly;
+  titlesOnly.artist = titlesOnly.album = 0;
+
+  std::vector<FuzzyHit> hits = library.fuzzySearch("rain", 5, titlesOnly);
+
+  ASSERT_EQ(hits.size(), 5);
+  EXPECT_EQ(library.resolve(hits[0].song)->id, 300);
+  EXPECT_EQ(hits[0].errors, 0);
+  for (size_t i = 2; i < hits.size(); i++) { // equal scores: ID order
+    EXPECT_LT(library.resolve(hits[i - 1].song)->id,
+              library.resolve(hits[i].song)->id);
+  }
+  EXPECT_TRUE(library.fuzzySearch("", 5).empty());
+  EXPECT_TRUE(library.fuzzySearch("rain", 0).empty());
+}
+
+// ========================
+// Test: complete
+// ========================
+
+TEST_F(MusicLibraryTest, Complete_TitlesAndNames_MostSongsFirst) {
+  std::vector<Song> batch;
+  for (int i = 0; i < 3; i++) {
+    batch.push_back(createTestSong(
+        "Ha Noi " + std::to_string(i),
+        "H\xC3\xA0 Anh Tu\xE1\xBA\xA5n", "Solo")); // Hà Anh Tuấn
+  }
+  batch.push_back(createTestSong("Hello", "Someone",
+                                 "H\xC3\xA0 N\xE1\xBB\x99i")); // Hà Nội
+  batch.push_back(createTestSong("hello", "Someone", "Ha Noi")); // same keys
+  library.addSongs(std::move(batch));
+
+  std::vector<Completion> found = library.complete("HA");
+  ASSERT_EQ(found.size(), 5);
+  EXPECT_EQ(found[0].text, "H\xC3\xA0 Anh Tu\xE1\xBA\xA5n");
+  EXPECT_EQ(found[0].field, SearchField::Artist);
+  EXPECT_EQ(found[0].songs, 3);
+  EXPECT_EQ(found[1].text, "H\xC3\xA0 N\xE1\xBB\x99i"); // first name kept
+  EXPECT_EQ(found[1].field, SearchField::Album);
+  EXPECT_EQ(found[1].songs, 2);
+  EXPECT_EQ(found[2].text, "Ha Noi 0"); // then by key
+  EXPECT_EQ(found[2].field, SearchField::Title);
+
+  EXPECT_EQ(library.complete("hel")[0].songs, 2);
+  EXPECT_EQ(library.complete("ha", 2).size(), 2);
+  EXPECT_TRUE(library.complete("hax").empty());
+  EXPECT_TRUE(library.complete("").empty());
+  EXPECT_GT(library.getCompletions().getMemoryUsage(), 0);
+}
+
+TEST_F(MusicLibraryTest, Complete_FollowsAddRemoveUpdate) {
+  for (int i = 0; i < 10; i++) {
+    library.addSong(createTestSong("Track " + std::to_string(i), "Band",
+                                   "Album"));
+  }
+  library.addSong(createTestSong("Tango", "Tom", "Trip"));
+  EXPECT_EQ(library.complete("t").size(), 8);
+  EXPECT_EQ(library.complete("tan")[0].text, "Tango");
+
+  library.removeSong(10);
+  EXPECT_TRUE(library.complete("tan").empty());
+  EXPECT_TRUE(library.complete("tom").empty());
+
+  Song renamed = createTestSong("Tango", "Band", "Album");
+  library.updateSong(0, renamed);
+  EXPECT_EQ(library.complete("tan")[0].text, "Tango");
+  EXPECT_TRUE(library.complete("track 0").empty());
+  EXPECT_EQ(library.complete("band")[0].songs, 10);
+
+  library.removePartition(MusicLibrary::DEFAULT_PARTITION);
+  EXPECT_TRUE(library.complete("t").empty());
+  EXPECT_EQ(library.getCompletions().size(), 0);
+}
+
+TEST_F(MusicLibraryTest, Search_Cancelled_ReturnsNothing) {
+  for (int i = 0; i < 5000; i++) {
+    library.addSong(createTestSong("Song " + std::to_string(i), "A", "B"));
+  }
+  std::atomic<bool> cancelled{true};
+  uint64_t version = library.getVersion();
+
+  EXPECT_TRUE(library.search("so", &cancelled).songs.empty());
+  EXPECT_TRUE(library.search("song", &cancelled).songs.empty());
+  cancelled = false;
+  EXPECT_EQ(library.search("song", &cancelled).songs.size(), 5000);
+  EXPECT_EQ(library.getVersion(), version); // searching changes nothing
+  library.removeSong(0);
+  EXPECT_GT(library.getVersion(), version);
+}
+
+// ========================
+// Test: getSortView
+// ========================
+
+TEST_F(MusicLibraryTest, GetSortView_EachKeyOrdersAllSongs) {
+  Song slow = createTestSong("Beta", "Artist B", "Album A");
+  slow.duration = 300;
+  library.addSong(slow);
+  library.addSong(createTestSong("Alpha", "Artist B", "Album B"));
+  library.addSong(createTestSong("Beta", "Artist A", "Album C")); // same title
+
+  SortView byTitle = library.getSortView(SortKey::Title);
+  ASSERT_EQ(byTitle.size(), 3);
+  EXPECT_EQ(byTitle[0]->title, "Alpha");
+  EXPECT_EQ(byTitle[1]->id, 0); // equal titles: by ID
+  EXPECT_EQ(byTitle[2]->id, 2);
+
+  SortView byArtist = library.getSortView(SortKey::Artist);
+  EXPECT_EQ(byArtist[0]->id, 2);
+  EXPECT_EQ(byArtist[1]->id, 0); // Artist B: Album A before Album B
+  EXPECT_EQ(byArtist[2]->id, 1);
+
+  SortView byAlbum = library.getSortView(SortKey::Album);
+  EXPECT_EQ(byAlbum[0]->id, 0);
+  EXPECT_EQ(byAlbum[2]->id, 2);
+
+  SortView byDuration = library.getSortView(SortKey::Duration);
+  EXPECT_EQ(byDuration[0]->title, "Alpha"); // 180s songs by title
+  EXPECT_EQ(byDuration[2]->id, 0);
+  EXPECT_EQ(byDuration.handle(2), library.findHandleByID(0));
+}
+
+TEST_F(MusicLibraryTest, GetSortView_CachedUntilLibraryChanges) {
+  library.addSong(createTestSong("B", "Artist", "Album"));
+  SortView first = library.getSortView(SortKey::Title);
+  SortView again = library.getSortView(SortKey::Title);
+  EXPECT_EQ(again.getVersion(), first.getVersion());
+
+  library.addSong(createTestSong("A", "Artist", "Album"));
+
+  SortView changed = library.getSortView(SortKey::Title);
+  EXPECT_NE(changed.getVersion(), first.getVersion());
+  ASSERT_EQ(first.size(), 2); // old views see the patched order
+  EXPECT_EQ(first[0]->title, "A");
+}
+
+TEST_F(MusicLibraryTest, GetSortView_PatchedOnRemoveAndUpdate) {
+  for (const char *title : {"D", "B", "A", "C"}) {
+    library.addSong(createTestSong(title, "Artist", "Album"));
+  }
+  SortView view = library.getSortView(SortKey::Title);
+
+  library.removeSong(1); // "B" - "C" moves into its slot
+  Song renamed = library.copySong(*library.findSongByID(0));
+  renamed.title = "0";
+  library.updateSong(0, renamed);
+
+  ASSERT_EQ(view.size(), 3);
+  EXPECT_EQ(view[0]->title, "0");
+  EXPECT_EQ(view[1]->title, "A");
+  EXPECT_EQ(view[2]->title, "C");
+}
+
+TEST_F(MusicLibraryTest, GetSortView_LargeBatchMergedInOrder) {
+  library.addSong(createTestSong("Song 5000", "Artist", "Album"));
+  SortView view = library.getSortView(SortKey::Duration);
+
+  std::vector<Song> batch;
+  for (int i = 0; i < 10000; i++) { // parallel sort, then merged
+    batch.push_back(createTestSong("Song " + std::to_string(i), "Artist",
+                                   "Album"));
+    batch.back().duration = (i * 7919) % 600;
+  }
+  library.addSongs(std::move(batch));
+
+  ASSERT_EQ(view.size(), 10001);
+  for (size_t i = 1; i < view.size(); i++) {
+    ASSERT_LE(view[i - 1]->duration, view[i]->duration);
+  }
+  library.clear();
+  EXPECT_TRUE(library.getSortView(SortKey::Duration).empty());
+}
+
 // ========================
 // Test: clear
 // ========================
@@ -202,6 +747,19 @@ TEST_F(MusicLibraryTest, Clear_ResetsIdCounter) {
   EXPECT_EQ(songs[0].id, 0); // ID should restart from 0
 }
 
+TEST_F(MusicLibraryTest, Clear_ReloadLooksUpNewSongs) {
+  library.addSong(createTestSong("Old 0", "Artist", "Album"));
+  library.addSong(createTestSong("Old 1", "Artist", "Album"));
+  library.clear();
+
+  EXPECT_EQ(library.findSongByID(0), nullptr);
+  library.addSongs({createTestSong("New 0", "Artist", "Album")});
+
+  ASSERT_NE(library.findSongByID(0), nullptr);
+  EXPECT_EQ(library.findSongByID(0)->title, "New 0");
+  EXPECT_EQ(library.findSongByID(1), nullptr);
+}
+
 TEST_F(MusicLibraryTest, Clear_ClearsAllIndexes) {
   library.addSong(createTestSong("Song", "Artist", "Album"));
   library.clear();
@@ -209,6 +767,9 @@ TEST_F(MusicLibraryTest, Clear_ClearsAllIndexes) {
   EXPECT_TRUE(library.getArtistIndex().empty());
   EXPECT_TRUE(library.getAlbumIndex().empty());
   EXPECT_TRUE(library.getSortedSongs().empty());
+  EXPECT_EQ(library.getArtists().size(), 0);
+  EXPECT_EQ(library.getAlbums().size(), 0);
+  EXPECT_EQ(library.getTextArena().getChunkBytes(), 0);
 }
 
 // ========================
@@ -229,3 +790,271 @@ TEST_F(MusicLibraryTest, GetAllSongs_EmptyLibrary_ReturnsEmpty) {
 
   EXPECT_TRUE(songs.empty());
 }
+
+// ========================
+// Test: removeSong / updateSong
+// ========================
+
+TEST_F(MusicLibraryTest, RemoveSong_RemovesFromAllIndexes) {
+  library.addSong(createTestSong("Gone", "Solo Artist", "Solo Album"));
+  library.addSong(createTestSong("Kept", "Artist", "Album"));
+
+  EXPECT_TRUE(library.removeSong(0));
+
+  EXPECT_EQ(library.getSize(), 1);
+  EXPECT_EQ(library.findSongByID(0), nullptr);
+  EXPECT_EQ(library.findSongByTitle("Gone"), nullptr);
+  // Names stay interned, their groups are gone
+  uint32_t artist = library.getArtists().find("Solo Artist");
+  uint32_t album = library.getAlbums().find("Solo Album");
+  EXPECT_EQ(library.getArtistIndex().count(artist), 0);
+  EXPECT_EQ(library.getAlbumIndex().count(album), 0);
+}
+
+TEST_F(MusicLibraryTest, RemoveSong_MovedSongStillIndexed) {
+  library.addSong(createTestSong("First", "Artist", "Album"));
+  library.addSong(createTestSong("Middle", "Artist", "Album"));
+  library.addSong(createTestSong("Last", "Artist", "Album"));
+
+  library.removeSong(0); // "Last" moves into slot 0
+
+  const StoredSong *moved = library.findSongByID(2);
+  ASSERT_NE(moved, nullptr);
+  EXPECT_EQ(moved, &library.getAllSongs()[0]);
+  EXPECT_EQ(library.findSongByTitle("Last"), moved);
+  auto artistSongs = library.findSongByArtist("Artist");
+  EXPECT_EQ(artistSongs.size(), 2);
+  EXPECT_NE(std::find(artistSongs.begin(), artistSongs.end(), moved),
+            artistSongs.end());
+}
+
+// ========================
+// Test: partitions
+// ========================
+
+TEST_F(MusicLibraryTest, RemovePartition_RemovesOnlyItsSongs) {
+  uint32_t kept = library.createPartition();
+  uint32_t gone = library.createPartition();
+  library.addSong(createTestSong("B", "Artist", "Kept"), kept);
+  library.addSongs({createTestSong("A", "Artist", "Gone"),
+                    createTestSong("C", "Other", "Gone")},
+                   gone);
+  library.addSong(createTestSong("D", "Artist", "Kept"), kept);
+  library.getSortView(SortKey::Title); // built: compacted, not rebuilt
+  SongHandle keptSong = library.findHandleByID(3);
+  SongHandle goneSong = library.findHandleByID(1);
+  EXPECT_EQ(library.getPartition(keptSong), kept);
+  EXPECT_EQ(library.getPartitionSongs(gone).size(), 2);
+
+  EXPECT_EQ(library.removePartition(gone), 2);
+
+  EXPECT_EQ(library.getSize(), 2);
+  EXPECT_EQ(library.resolve(goneSong), nullptr);
+  EXPECT_EQ(library.resolve(keptSong)->title, "D");
+  EXPECT_EQ(library.findSongByTitle("A"), nullptr);
+  EXPECT_TRUE(library.findSongByArtist("Other").empty());
+  EXPECT_EQ(library.getAlbumIndex().count(library.getAlbums().find("Gone")),
+            0);
+  SortView byTitle = library.getSortView(SortKey::Title);
+  ASSERT_EQ(byTitle.size(), 2);
+  EXPECT_EQ(byTitle[0]->title, "B");
+  EXPECT_EQ(byTitle[1]->title, "D");
+  EXPECT_TRUE(library.getPartitionSongs(gone).empty());
+  EXPECT_EQ(library.getPartitionSongs(kept).size(), 2);
+  EXPECT_EQ(library.removePartition(gone), 0); // already gone
+}
+
+TEST_F(MusicLibraryTest, RemoveSongs_KeepsPartitionsInStep) {
+  uint32_t partition = library.createPartition();
+  for (int i = 0; i < 5; i++) {
+    library.addSong(createTestSong("Song " + std::to_string(i), "A", "B"),
+                    partition);
+  }
+  library.addSong(createTestSong("Loose", "A", "B")); // default partition
+
+  EXPECT_EQ(library.removeSongs({0, 3, 3, 99}), 2); // repeats and unknown
+
+  const std::vector<SongHandle> &songs = library.getPartitionSongs(partition);
+  std::vector<int> ids;
+  for (SongHandle handle : songs) {
+    ids.push_back(library.resolve(handle)->id);
+  }
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(ids, (std::vector<int>{1, 2, 4}));
+  EXPECT_EQ(library.getPartition(library.findHandleByID(5)),
+            MusicLibrary::DEFAULT_PARTITION);
+  EXPECT_EQ(library.removePartition(partition), 3);
+  EXPECT_EQ(library.getSize(), 1);
+}
+
+TEST_F(MusicLibraryTest, RemovePartition_SortOrdersAndCompletionsInStep) {
+  // Half the library goes: every built order is patched, not rebuilt
+  uint32_t kept = library.createPartition();
+  uint32_t gone = library.createPartition();
+  MusicLibrary expected;
+  for (int i = 0; i < 60; i++) {
+    bool keep = i % 3 != 1 && i < 50;
+    std::string name =
+        (keep ? "Kept " : "Gone ") + std::to_string(i * 7 % 60);
+    Song song = createTestSong(name, "Artist " + std::to_string(i % 4),
+                               "Album " + std::to_string(i % 5));
+    song.duration = 100 + i * 13 % 40;
+    library.addSong(song, keep ? kept : gone);
+    if (keep) {
+      expected.addSong(song);
+    }
+  }
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    library.getSortView(static_cast<SortKey>(k));
+  }
+
+  EXPECT_EQ(library.removePartition(gone), 60 - expected.getSize());
+
+  for (size_t k = 0; k < SORT_KEY_COUNT; k++) {
+    SortView view = library.getSortView(static_cast<SortKey>(k));
+    SortView want = expected.getSortView(static_cast<SortKey>(k));
+    ASSERT_EQ(view.size(), want.size());
+    for (size_t i = 0; i < view.size(); i++) {
+      ASSERT_EQ(view[i]->title, want[i]->title) << "order " << k;
+    }
+  }
+  EXPECT_TRUE(library.complete("gone").empty());
+  ASSERT_FALSE(library.complete("kept").empty());
+  EXPECT_EQ(library.complete("kept 0")[0].text, "Kept 0");
+}
+
+// ========================
+// Test: SongHandle
+// ========================
+
+TEST_F(MusicLibraryTest, Handle_ResolvesToSong) {
+  library.addSong(createTestSong("Song", "Artist", "Album"));
+  const StoredSong *song = library.findSongByID(0);
+
+  SongHandle handle = library.getHandle(song);
+
+  EXPECT_FALSE(handle.isNull());
+  EXPECT_EQ(library.resolve(handle), song);
+  EXPECT_EQ(library.findHandleByID(0), handle);
+  uint32_t artist = library.getArtists().find("Artist");
+  EXPECT_EQ(library.getArtistIndex().at(artist).front(), handle);
+}
+
+TEST_F(MusicLibraryTest, Handle_RemovedSong_GoesStale) {
+  library.addSong(createTestSong("Gone", "Artist", "Album"));
+  SongHandle gone = library.findHandleByID(0);
+  library.removeSong(0);
+
+  // Its handle slot is reused by the next song, with a new generation
+  library.addSong(createTestSong("New", "Artist", "Album"));
+
+  EXPECT_EQ(library.resolve(gone), nullptr);
+  SongHandle fresh = library.findHandleByID(1);
+  EXPECT_EQ(fresh.slot(), gone.slot());
+  EXPECT_NE(fresh, gone);
+}
+
+TEST_F(MusicLibraryTest, Handle_MovedSong_StaysValid) {
+  library.addSong(createTestSong("First", "Artist", "Album"));
+  library.addSong(createTestSong("Last", "Artist", "Album"));
+  SongHandle last = library.findHandleByID(1);
+
+  library.removeSong(0); // "Last" moves into slot 0
+
+  EXPECT_EQ(library.resolve(last), &library.getAllSongs()[0]);
+  EXPECT_EQ(library.resolve(last)->title, "Last");
+}
+
+TEST_F(MusicLibraryTest, Handle_AfterClear_GoesStale) {
+  library.addSong(createTestSong("Song", "Artist", "Album"));
+  SongHandle old = library.findHandleByID(0);
+
+  library.clear();
+  library.addSong(createTestSong("Reloaded", "Artist", "Album"));
+
+  EXPECT_EQ(library.resolve(old), nullptr);
+  EXPECT_EQ(library.resolve(SongHandle()), nullptr);
+}
+
+TEST_F(MusicLibraryTest, Handle_SlotReusedManyTimes_OldHandlesStayStale) {
+  library.addSong(createTestSong("Song", "Artist", "Album"));
+  std::vector<SongHandle> old;
+  // Past the 8-bit generation: the slot is retired, not wrapped
+  for (int cycle = 0; cycle < 600; cycle++) {
+    SongHandle handle = library.findHandleByID(cycle);
+    ASSERT_NE(library.resolve(handle), nullptr);
+    old.push_back(handle);
+    library.removeSong(cycle);
+    library.addSong(createTestSong("Song", "Artist", "Album"));
+  }
+
+  for (SongHandle handle : old) {
+    ASSERT_EQ(library.resolve(handle), nullptr);
+  }
+  EXPECT_EQ(library.resolve(library.findHandleByID(600))->id, 600);
+  EXPECT_EQ(library.getSize(), 1);
+
+  library.clear(); // retired slots stay retired
+  library.addSong(createTestSong("Again", "Artist", "Album"));
+  for (SongHandle handle : old) {
+    ASSERT_EQ(library.resolve(handle), nullptr);
+  }
+}
+
+TEST_F(MusicLibraryTest, Handle_FreedSlots_ReusedOldestFirst) {
+  for (int i = 0; i < 3; i++) {
+    library.addSong(createTestSong("Song " + std::to_string(i), "A", "B"));
+  }
+  uint32_t first = library.findHandleByID(0).slot();
+  uint32_t second = library.findHandleByID(1).slot();
+  library.removeSong(0);
+  library.removeSong(1);
+
+  library.addSong(createTestSong("Next", "A", "B"));
+  EXPECT_EQ(library.findHandleByID(3).slot(), first);
+  library.addSong(createTestSong("Then", "A", "B"));
+  EXPECT_EQ(library.findHandleByID(4).slot(), second);
+}
+
+TEST_F(MusicLibraryTest, Handle_ForeignSong_IsNull) {
+  library.addSong(createTestSong("Song", "Artist", "Album"));
+  StoredSong copy = *library.findSongByID(0); // same ID, not stored here
+
+  EXPECT_TRUE(library.getHandle(&copy).isNull());
+  EXPECT_TRUE(library.getHandle(nullptr).isNull());
+}
+
+TEST_F(MusicLibraryTest, RemoveSong_UnknownID_ReturnsFalse) {
+  library.addSong(createTestSong("Song", "Artist", "Album"));
+
+  EXPECT_FALSE(library.removeSong(999));
+  EXPECT_EQ(library.getSize(), 1);
+}
+
+TEST_F(MusicLibraryTest, UpdateSong_KeepsIDAndAddress_ReindexesArtist) {
+  library.addSong(createTestSong("Song", "Old Artist", "Album"));
+  const StoredSong *before = library.findSongByID(0);
+
+  Song fresh = createTestSong("Song", "New Artist", "Album");
+  EXPECT_TRUE(library.updateSong(0, fresh));
+
+  EXPECT_EQ(library.findSongByID(0), before);
+  EXPECT_EQ(before->id, 0);
+  EXPECT_EQ(library.getArtist(*before), "New Artist");
+  uint32_t oldArtist = library.getArtists().find("Old Artist");
+  EXPECT_EQ(library.getArtistIndex().count(oldArtist), 0);
+  EXPECT_EQ(library.findSongByArtist("New Artist").size(), 1);
+}
+
+TEST_F(MusicLibraryTest, AddSong_ManyBlocks_IndexesStayValid) {
+  library.addSong(createTestSong("Song 0", "Artist", "Album"));
+  const StoredSong *first = library.findSongByID(0);
+  for (int i = 1; i < 3000; i++) {
+    library.addSong(
+        createTestSong("Song " + std::to_string(i), "Artist", "Album"));
+  }
+
+  EXPECT_EQ(library.findSongByID(0), first);
+  EXPECT_EQ(library.findSongByTitle("Song 0"), first);
+  EXPECT_EQ(library.findSongByID(2999), &library.getAllSongs()[2999]);
+}
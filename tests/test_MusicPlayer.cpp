@@ -3,20 +3,35 @@
 
 #include "../include/MusicPlayer.h"
 #include "PlaybackQueue.h"
+#include "TempDir.h"
 #include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <thread>
 #include <utility>
 
-class MusicPlayerTest : public ::testing::Test {
+class MusicPlayerTest : public TempDirTest {
 protected:
   MusicPlayer player;
 
-  void SetUp() override { Song::resetIdCounter(); }
+  MusicPlayerTest() : TempDirTest("music_player_") {}
 
-  void TearDown() override { player.clearLibrary(); }
+  void TearDown() override {
+    player.clearLibrary(); // stops the imports reading below root
+    TempDirTest::TearDown();
+  }
+
+  // Helper: touch `count` (untagged) trackN.mp3 files into root/folder
+  std::filesystem::path makeTracks(int count,
+                                   const std::filesystem::path &folder = {}) {
+    for (int i = 0; i < count; i++) {
+      touch(folder / ("track" + std::to_string(i) + ".mp3"));
+    }
+    return folder.empty() ? root : root / folder;
+  }
 
   // Helper: Add a song to library and return pointer
-  const Song *addSongToLibrary(const std::string &title,
+  const StoredSong *addSongToLibrary(const std::string &title,
                                const std::string &artist,
                                const std::string &album) {
     Song song;
@@ -82,6 +97,336 @@ TEST_F(MusicPlayerTest, LoadLibrary_MultipleTimes_SamePath) {
   EXPECT_EQ(player.getLibrarySize(), 2);
 }
 
+// ========================
+// Test: Load Library Async
+// ========================
+
+TEST_F(MusicPlayerTest, LoadLibraryAsync_PublishesOnPoll) {
+  makeTracks(3);
+
+  auto job = player.loadLibraryAsync(root.string());
+  ASSERT_NE(job, nullptr);
+  job->wait();
+
+  EXPECT_EQ(player.getLibrarySize(), 0); // nothing until the UI thread polls
+  EXPECT_EQ(player.pollImports(), 3);
+  EXPECT_EQ(player.getLibrarySize(), 3);
+  EXPECT_EQ(job->getSongsPublished(), 3);
+  EXPECT_FALSE(player.isImporting());
+}
+
+TEST_F(MusicPlayerTest, LoadLibraryAsync_PollBudget_PublishesInBatches) {
+  makeTracks(10);
+
+  auto job = player.loadLibraryAsync(root.string(), 4);
+  job->wait();
+
+  EXPECT_EQ(player.pollImports(1), 4); // one whole batch per poll
+  EXPECT_EQ(player.getLibrarySize(), 4);
+  EXPECT_TRUE(player.isImporting());
+  player.pollImports();
+  EXPECT_EQ(player.getLibrarySize(), 10);
+  EXPECT_FALSE(player.isImporting());
+}
+
+TEST_F(MusicPlayerTest, LoadLibraryAsync_SamePathTwice_ReturnsNull) {
+  makeTracks(1);
+
+  auto first = player.loadLibraryAsync(root.string());
+  auto second = player.loadLibraryAsync(root.string());
+
+  EXPECT_NE(first, nullptr);
+  EXPECT_EQ(second, nullptr);
+  first->wait();
+}
+
+TEST_F(MusicPlayerTest, LoadLibraryAsync_InvalidPath_ReturnsNull) {
+  EXPECT_EQ(player.loadLibraryAsync("/test/invalid"), nullptr);
+  EXPECT_FALSE(player.isImporting());
+}
+
+TEST_F(MusicPlayerTest, LoadLibraryAsync_Cancel_DropsUnpublishedSongs) {
+  makeTracks(50);
+
+  auto job = player.loadLibraryAsync(root.string());
+  job->cancel();
+  ImportStats stats = job->getFuture().get();
+  player.pollImports();
+
+  EXPECT_TRUE(job->isCancelled());
+  EXPECT_LE(stats.indexer.files, 50);
+  EXPECT_EQ(player.getLibrarySize(), 0);
+  EXPECT_FALSE(player.isImporting());
+}
+
+TEST_F(MusicPlayerTest, LoadLibraryAsync_Reload_ServedFromTagCache) {
+  makeTracks(5);
+  player.loadLibraryAsync(root.string())->wait();
+  player.pollImports();
+  player.clearLibrary();
+
+  auto job = player.loadLibraryAsync(root.string());
+  ImportStats stats = job->getFuture().get();
+  player.pollImports();
+
+  EXPECT_EQ(stats.cacheHits, 5);
+  EXPECT_EQ(player.getLibrarySize(), 5);
+}
+
+TEST_F(MusicPlayerTest, ClearLibrary_CancelsRunningImport) {
+  makeTracks(20);
+  auto job = player.loadLibraryAsync(root.string());
+
+  player.clearLibrary();
+
+  EXPECT_TRUE(job->isFinished());
+  EXPECT_FALSE(player.isImporting());
+  EXPECT_EQ(player.pollImports(), 0);
+  EXPECT_EQ(player.getLibrarySize(), 0);
+}
+
+// ========================
+// Test: Rescan Folder
+// ========================
+
+TEST_F(MusicPlayerTest, RescanFolder_AddsUpdatesAndRemoves) {
+  makeTracks(3);
+  player.setTagCacheEnabled(false);
+  player.loadLibrary(root.string());
+  MusicLibrary &lib = const_cast<MusicLibrary &>(player.getLibrary());
+  const StoredSong *changed = lib.findSongByTitle("track1");
+  ASSERT_NE(changed, nullptr);
+  int changedID = changed->id;
+
+  std::filesystem::remove(root / "track0.mp3");
+  std::ofstream(root / "track1.mp3") << "longer";
+  touch("track3.mp3");
+
+  EXPECT_EQ(player.rescanFolder(root.string()), 3);
+  EXPECT_EQ(player.getLibrarySize(), 3);
+  EXPECT_EQ(lib.findSongByTitle("track0"), nullptr);
+  EXPECT_NE(lib.findSongByTitle("track3"), nullptr);
+  const StoredSong *updated = lib.findSongByID(changedID);
+  ASSERT_NE(updated, nullptr);
+  EXPECT_EQ(updated->stamp.size, 6);
+
+  EXPECT_EQ(player.rescanFolder(root.string()), 0); // nothing left to do
+}
+
+TEST_F(MusicPlayerTest, RescanFolder_QueueKeepsSongs) {
+  makeTracks(3);
+  player.loadLibrary(root.string());
+  MusicLibrary &lib = const_cast<MusicLibrary &>(player.getLibrary());
+  int keptID = lib.findSongByTitle("track2")->id;
+  player.addSongToQueue(lib.findSongByTitle("track0"));
+  player.addSongToQueue(lib.findSongByTitle("track2"));
+
+  // Removing track0 moves another song into its slot
+  std::filesystem::remove(root / "track0.mp3");
+  player.rescanFolder(root.string());
+
+  auto queueList = player.getQueueManager().getQueueList();
+  ASSERT_EQ(queueList.size(), 1);
+  const StoredSong *kept = lib.resolve(queueList.front());
+  EXPECT_EQ(kept, lib.findSongByID(keptID));
+  EXPECT_EQ(kept->title, "track2");
+}
+
+TEST_F(MusicPlayerTest, RescanFolderAsync_AppliedOnPoll) {
+  makeTracks(3);
+  player.setFolderWatchEnabled(false);
+  player.loadLibrary(root.string());
+  const MusicLibrary &lib = player.getLibrary();
+  std::filesystem::remove(root / "track0.mp3");
+  touch("track3.mp3");
+
+  auto job = player.rescanFolderAsync(root.string());
+  ASSERT_NE(job, nullptr);
+  EXPECT_TRUE(job->isRescan());
+  EXPECT_EQ(player.rescanFolderAsync(root.string()), nullptr); // running
+  job->wait();
+  EXPECT_NE(lib.findSongByTitle("track0"), nullptr); // not polled yet
+
+  player.pollImports();
+  EXPECT_FALSE(player.isImporting());
+  EXPECT_EQ(job->getSongsPublished(), 2);
+  EXPECT_EQ(player.getLibrarySize(), 3);
+  EXPECT_EQ(lib.findSongByTitle("track0"), nullptr);
+  EXPECT_NE(lib.findSongByTitle("track3"), nullptr);
+
+  // Every loaded folder, nothing left to change
+  EXPECT_EQ(player.rescanLibrary(), 1);
+  for (const auto &running : player.getImportJobs()) {
+    running->wait();
+  }
+  player.pollImports();
+  EXPECT_EQ(player.getLibrarySize(), 3);
+}
+
+TEST_F(MusicPlayerTest, FolderWatch_NewFileAppliedOnPoll) {
+  if (!FolderWatcher::isSupported()) {
+    GTEST_SKIP() << "Folder watching is not supported on this platform";
+  }
+  makeTracks(1);
+  player.loadLibrary(root.string());
+  std::this_thread::sleep_for(std::chrono::milliseconds(50)); // watch set up
+
+  touch("dropped.mp3");
+  for (int i = 0; i < 300 && player.getLibrarySize() < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    player.pollFolderChanges();
+  }
+
+  EXPECT_EQ(player.getLibrarySize(), 2);
+  std::string dropped = (root / "dropped.mp3").string();
+  EXPECT_NE(player.getLibrary().findSongByPath(dropped), nullptr);
+}
+
+TEST_F(MusicPlayerTest, LoadLibrary_NestedFolders_Imported) {
+  makeTracks(1);
+  touch("Artist/Album/deep.mp3");
+  player.setFolderWatchEnabled(false);
+
+  player.loadLibrary(root.string());
+
+  EXPECT_EQ(player.getLibrarySize(), 2);
+  std::filesystem::remove(root / "Artist" / "Album" / "deep.mp3");
+  EXPECT_EQ(player.rescanFolder(root.string()), 1);
+  EXPECT_EQ(player.getLibrarySize(), 1);
+}
+
+TEST_F(MusicPlayerTest, LazyTags_ListedFirstThenTagged) {
+  makeTracks(3);
+  // ID3v2.3 title + two MPEG frames - tags only arrive through pollTags()
+  std::string title("\0Tagged", 7);
+  std::string frame = "TIT2" + std::string(3, '\0') + char(title.size()) +
+                      std::string(2, '\0') + title;
+  std::string tag = std::string("ID3\3\0\0\0\0\0", 9) + char(frame.size()) +
+                    frame;
+  std::string audio = std::string("\xFF\xFB\x90\x00", 4) +
+                      std::string(413, '\0');
+  std::ofstream(root / "tagged.mp3", std::ios::binary) << tag << audio << audio;
+  player.setLazyTagsEnabled(true);
+  player.setFolderWatchEnabled(false);
+
+  player.loadLibrary(root.string());
+  MusicLibrary &lib = const_cast<MusicLibrary &>(player.getLibrary());
+  const StoredSong *song = lib.findSongByTitle("tagged"); // file name for now
+  ASSERT_NE(song, nullptr);
+  EXPECT_EQ(player.getLibrarySize(), 4);
+  player.addSongToQueue(song);
+  for (int i = 0; i < 300 && player.getPendingTagCount() > 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    player.pollTags();
+  }
+  player.pollTags();
+
+  EXPECT_EQ(player.getPendingTagCount(), 0);
+  EXPECT_EQ(song->title, "Tagged"); // updated in place
+  EXPECT_EQ(lib.findSongByTitle("Tagged"), song);
+  EXPECT_EQ(lib.findSongByTitle("tagged"), nullptr);
+  EXPECT_EQ(lib.resolve(player.getQueueManager().getQueueList().front()),
+            song);
+
+  // Tags read lazily went into the cache: a reload has nothing to read
+  player.clearLibrary();
+  player.loadLibrary(root.string());
+  EXPECT_NE(lib.findSongByTitle("Tagged"), nullptr);
+  EXPECT_EQ(player.getPendingTagCount(), 0);
+}
+
+TEST_F(MusicPlayerTest, RescanFolder_NotLoaded_ReturnsZero) {
+  makeTracks(2);
+
+  EXPECT_EQ(player.rescanFolder(root.string()), 0);
+  EXPECT_EQ(player.rescanFolder("/test/invalid"), 0);
+  EXPECT_EQ(player.getLibrarySize(), 0);
+}
+
+// ========================
+// Test: Unload Folder
+// ========================
+
+TEST_F(MusicPlayerTest, UnloadFolder_KeepsOtherFoldersPrunesPlayback) {
+  auto kept = makeTracks(2, "kept");
+  auto gone = makeTracks(3, "gone");
+  player.setFolderWatchEnabled(false);
+  player.loadLibrary(kept.string());
+  player.loadLibrary(gone.string());
+  MusicLibrary &lib = const_cast<MusicLibrary &>(player.getLibrary());
+  std::string keptPath = (kept / "track1.mp3").string();
+  std::string gonePath = (gone / "track1.mp3").string();
+  const StoredSong *keptSong = lib.findSongByPath(keptPath);
+  int keptID = keptSong->id;
+  player.chooseAndPlaySong(keptSong);
+  player.chooseAndPlaySong(lib.findSongByPath(gonePath)); // now playing
+  player.addSongToQueue(lib.findSongByPath((gone / "track0.mp3").string()));
+  player.addSongToQueue(keptSong);
+
+  EXPECT_EQ(player.unloadFolder(gone.string()), 3);
+
+  EXPECT_EQ(player.getLibrarySize(), 2);
+  EXPECT_EQ(lib.findSongByPath(gonePath), nullptr);
+  EXPECT_EQ(lib.findSongByPath(keptPath), lib.findSongByID(keptID));
+  EXPECT_EQ(player.getCurrentSong(), nullptr); // its file was unloaded
+  auto queueList = player.getQueueManager().getQueueList();
+  ASSERT_EQ(queueList.size(), 1);
+  EXPECT_EQ(lib.resolve(queueList.front())->id, keptID);
+  auto history = player.getHistoryManager().getHistoryList();
+  ASSERT_EQ(history.size(), 1);
+  EXPECT_EQ(lib.resolve(history.front())->id, keptID);
+  EXPECT_EQ(player.getLoadedFolders(),
+            std::vector<std::string>{kept.string()});
+
+  // Loads again independently, the other folder untouched
+  player.loadLibrary(gone.string());
+  EXPECT_EQ(player.getLibrarySize(), 5);
+  EXPECT_EQ(player.rescanFolder(kept.string()), 0);
+}
+
+TEST_F(MusicPlayerTest, UnloadFolder_CancelsImportAndDeletedFolder) {
+  makeTracks(20);
+  auto job = player.loadLibraryAsync(root.string());
+
+  EXPECT_EQ(player.unloadFolder(root.string()), 0); // nothing published yet
+  EXPECT_TRUE(job->isFinished());
+  EXPECT_FALSE(player.isImporting());
+  EXPECT_EQ(player.pollImports(), 0);
+  EXPECT_EQ(player.unloadFolder(root.string()), 0); // not loaded any more
+
+  // A folder deleted from disk is matched by the path it was loaded with
+  player.loadLibrary(root.string());
+  std::filesystem::remove_all(root);
+  EXPECT_EQ(player.unloadFolder(root.string()), 20);
+  EXPECT_EQ(player.getLibrarySize(), 0);
+  EXPECT_TRUE(player.getLoadedFolders().empty());
+}
+
+// ========================
+// Test: Search
+// ========================
+
+TEST_F(MusicPlayerTest, SearchLibrary_WhileImporting_FollowsLibrary) {
+  makeTracks(200);
+  auto job = player.loadLibraryAsync(root.string(), 16);
+  ASSERT_NE(job, nullptr);
+
+  // Frames: publish a batch, ask for the same text again
+  while (player.isImporting()) {
+    player.pollImports(16);
+    player.searchLibrary("TRACK1");
+  }
+  player.searchLibrary("TRACK1");
+  while (player.isSearching()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  std::shared_ptr<const SearchSnapshot> results = player.getSearchResults();
+  ASSERT_NE(results, nullptr);
+  EXPECT_EQ(results->result.songs.size(), 111); // 1, 10-19, 100-199
+  EXPECT_EQ(results->libraryVersion, player.getLibrary().getVersion());
+}
+
 // ========================
 // Test: Queue Management
 // ========================
@@ -92,7 +437,7 @@ TEST_F(MusicPlayerTest, GetQueueManager) {
 }
 
 TEST_F(MusicPlayerTest, AddSongToQueue_IncreasesQueueSize) {
-  const Song *song = addSongToLibrary("Test Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Test Song", "Artist", "Album");
 
   player.addSongToQueue(song);
 
@@ -100,9 +445,9 @@ TEST_F(MusicPlayerTest, AddSongToQueue_IncreasesQueueSize) {
 }
 
 TEST_F(MusicPlayerTest, AddSongToQueue_MultipleSongs) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
-  const Song *song3 = addSongToLibrary("Song 3", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song3 = addSongToLibrary("Song 3", "Artist", "Album");
 
   player.addSongToQueue(song1);
   player.addSongToQueue(song2);
@@ -112,8 +457,8 @@ TEST_F(MusicPlayerTest, AddSongToQueue_MultipleSongs) {
 }
 
 TEST_F(MusicPlayerTest, AddSongToQueue_ShuffleMode) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
 
   player.addSongToQueue(song1);
   player.enableShuffle();
@@ -124,7 +469,7 @@ TEST_F(MusicPlayerTest, AddSongToQueue_ShuffleMode) {
 }
 
 TEST_F(MusicPlayerTest, RemoveSongFromQueue_DecreasesQueueSize) {
-  const Song *song = addSongToLibrary("Test Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Test Song", "Artist", "Album");
   player.addSongToQueue(song);
 
   player.removeSongFromQueue(song);
@@ -132,9 +477,19 @@ TEST_F(MusicPlayerTest, RemoveSongFromQueue_DecreasesQueueSize) {
   EXPECT_EQ(player.getQueueSize(), 0);
 }
 
+TEST_F(MusicPlayerTest, AddSongToQueue_NotInLibrary_Ignored) {
+  StoredSong outside;
+  outside.title = "Outside";
+
+  player.addSongToQueue(&outside);
+  player.addSongToQueue(nullptr);
+
+  EXPECT_EQ(player.getQueueSize(), 0);
+}
+
 TEST_F(MusicPlayerTest, ClearQueue_EmptiesQueue) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
   player.addSongToQueue(song1);
   player.addSongToQueue(song2);
 
@@ -148,7 +503,7 @@ TEST_F(MusicPlayerTest, ClearQueue_EmptiesQueue) {
 // ========================
 
 TEST_F(MusicPlayerTest, GetShuffleManager) {
-  const Song *song = addSongToLibrary("Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Song", "Artist", "Album");
   player.addSongToQueue(song);
   player.enableShuffle();
   auto &shuffleMgr = player.getShuffleManager();
@@ -157,7 +512,7 @@ TEST_F(MusicPlayerTest, GetShuffleManager) {
 }
 
 TEST_F(MusicPlayerTest, EnableShuffle_SetsFlag) {
-  const Song *song = addSongToLibrary("Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Song", "Artist", "Album");
   player.addSongToQueue(song);
 
   player.enableShuffle();
@@ -172,7 +527,7 @@ TEST_F(MusicPlayerTest, EnableShuffle_WithEmptyQueue_DoesNotChangeState) {
 }
 
 TEST_F(MusicPlayerTest, DisableShuffle_ClearsFlag) {
-  const Song *song = addSongToLibrary("Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Song", "Artist", "Album");
   player.addSongToQueue(song);
   player.enableShuffle();
 
@@ -182,7 +537,7 @@ TEST_F(MusicPlayerTest, DisableShuffle_ClearsFlag) {
 }
 
 TEST_F(MusicPlayerTest, ClearQueue_DisablesShuffle) {
-  const Song *song = addSongToLibrary("Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Song", "Artist", "Album");
   player.addSongToQueue(song);
   player.enableShuffle();
 
@@ -196,7 +551,7 @@ TEST_F(MusicPlayerTest, ClearQueue_DisablesShuffle) {
 // ========================
 
 TEST_F(MusicPlayerTest, ChooseAndPlaySong_SetsCurrentSong) {
-  const Song *song = addSongToLibrary("Target Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Target Song", "Artist", "Album");
 
   player.chooseAndPlaySong(song);
 
@@ -213,7 +568,7 @@ TEST_F(MusicPlayerTest, ChooseAndPlaySong_NullSong_NoChange) {
 // ========================
 
 TEST_F(MusicPlayerTest, SelectAndAddSong_ByID_SetsCurrentSong) {
-  const Song *song = addSongToLibrary("Unique Title", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Unique Title", "Artist", "Album");
 
   player.selectAndAddSong(song->id);
 
@@ -225,7 +580,7 @@ TEST_F(MusicPlayerTest, SelectAndAddSong_ByID_SetsCurrentSong) {
 // ========================
 
 TEST_F(MusicPlayerTest, SelectAndAddSong_ByTitle_SetsCurrentSong) {
-  const Song *song = addSongToLibrary("Unique Title", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Unique Title", "Artist", "Album");
 
   player.selectAndAddSong(std::string("Unique Title"));
 
@@ -237,14 +592,14 @@ TEST_F(MusicPlayerTest, SelectAndAddSong_ByTitle_SetsCurrentSong) {
 // ========================
 
 TEST_F(MusicPlayerTest, SelectAndPlaySong_ByID_SetsCurrentSong) {
-  const Song *song = addSongToLibrary("Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Song", "Artist", "Album");
   player.selectAndPlaySong(song->id);
   EXPECT_EQ(player.getCurrentSong(), song);
 }
 
 TEST_F(MusicPlayerTest, SelectAndPlaySong_ByID_GoesBack) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
   player.selectAndPlaySong(song1->id);
   player.selectAndPlaySong(song2->id);
 
@@ -266,7 +621,7 @@ TEST_F(MusicPlayerTest, SelectAndPlaySong_InvalidID_NoChange) {
 // ========================
 
 TEST_F(MusicPlayerTest, SelectAndPlaySong_ByTitle_SetsCurrentSong) {
-  const Song *song = addSongToLibrary("Unique Title", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Unique Title", "Artist", "Album");
 
   player.selectAndPlaySong(std::string("Unique Title"));
 
@@ -274,8 +629,8 @@ TEST_F(MusicPlayerTest, SelectAndPlaySong_ByTitle_SetsCurrentSong) {
 }
 
 TEST_F(MusicPlayerTest, SelectAndPlaySong_ByTitle_GoesBack) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
   player.selectAndPlaySong(std::string("Song 1"));
   player.selectAndPlaySong(std::string("Song 2"));
 
@@ -307,6 +662,18 @@ TEST_F(MusicPlayerTest, AddAlbumToQueue_AddsAllSongsFromAlbum) {
   EXPECT_EQ(player.getQueueSize(), 2);
 }
 
+TEST_F(MusicPlayerTest, AddAlbumToQueue_DecomposedName_FindsNfcAlbum) {
+  addSongToLibrary("Song 1", "Artist", "Ti\xE1\xBA\xBFng Vi\xE1\xBB\x87t");
+  addSongToLibrary("Song 2", "Artist", "Other Album");
+
+  // Same name typed with combining marks (NFD): stored names are NFC
+  size_t added =
+      player.addAlbumToQueue("Tie\xCC\x82\xCC\x81ng Vie\xCC\xA3\xCC\x82t");
+
+  EXPECT_EQ(added, 1);
+  EXPECT_EQ(player.getQueueSize(), 1);
+}
+
 TEST_F(MusicPlayerTest, AddAlbumToQueue_NonexistentAlbum_ReturnsZero) {
   addSongToLibrary("Song", "Artist", "Album");
 
@@ -335,7 +702,7 @@ TEST_F(MusicPlayerTest, AddArtistToQueue_AddsAllSongsFromArtist) {
 // ========================
 
 TEST_F(MusicPlayerTest, ClearLibrary_ClearsEverything) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
   addSongToLibrary("Song 2", "Artist", "Album");
   player.addSongToQueue(song1);
   player.chooseAndPlaySong(song1);
@@ -352,8 +719,8 @@ TEST_F(MusicPlayerTest, ClearLibrary_ClearsEverything) {
 // ========================
 
 TEST_F(MusicPlayerTest, PlayNext_FromQueue_ChangesCurrentSong) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
   player.addSongToQueue(song1);
   player.addSongToQueue(song2);
   player.chooseAndPlaySong(song1);
@@ -366,9 +733,9 @@ TEST_F(MusicPlayerTest, PlayNext_FromQueue_ChangesCurrentSong) {
 }
 
 TEST_F(MusicPlayerTest, PlayNext_FromFuture_ChangesCurrentSong) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
-  const Song *song3 = addSongToLibrary("Song 3", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song3 = addSongToLibrary("Song 3", "Artist", "Album");
   player.addSongToQueue(song1);
   player.addSongToQueue(song2);
   player.addSongToQueue(song3);
@@ -381,16 +748,16 @@ TEST_F(MusicPlayerTest, PlayNext_FromFuture_ChangesCurrentSong) {
 }
 
 TEST_F(MusicPlayerTest, PlayNext_FromShuffle_ChangesCurrentSong) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
-  const Song *song3 = addSongToLibrary("Song 3", "Artist", "Album");
-  const Song *song4 = addSongToLibrary("Song 4", "Artist", "Album");
-  const Song *song5 = addSongToLibrary("Song 5", "Artist", "Album");
-  const Song *song6 = addSongToLibrary("Song 6", "Artist", "Album");
-  const Song *song7 = addSongToLibrary("Song 7", "Artist", "Album");
-  const Song *song8 = addSongToLibrary("Song 8", "Artist", "Album");
-  const Song *song9 = addSongToLibrary("Song 9", "Artist", "Album");
-  const Song *song10 = addSongToLibrary("Song 10", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song3 = addSongToLibrary("Song 3", "Artist", "Album");
+  const StoredSong *song4 = addSongToLibrary("Song 4", "Artist", "Album");
+  const StoredSong *song5 = addSongToLibrary("Song 5", "Artist", "Album");
+  const StoredSong *song6 = addSongToLibrary("Song 6", "Artist", "Album");
+  const StoredSong *song7 = addSongToLibrary("Song 7", "Artist", "Album");
+  const StoredSong *song8 = addSongToLibrary("Song 8", "Artist", "Album");
+  const StoredSong *song9 = addSongToLibrary("Song 9", "Artist", "Album");
+  const StoredSong *song10 = addSongToLibrary("Song 10", "Artist", "Album");
   player.addSongToQueue(song1);
   player.addSongToQueue(song2);
   player.addSongToQueue(song3);
@@ -413,7 +780,7 @@ TEST_F(MusicPlayerTest, PlayNext_FromShuffle_ChangesCurrentSong) {
 }
 
 TEST_F(MusicPlayerTest, PlayNext_EmptyQueue_NoChange) {
-  const Song *before = player.getCurrentSong();
+  const StoredSong *before = player.getCurrentSong();
 
   player.playNext();
 
@@ -421,7 +788,7 @@ TEST_F(MusicPlayerTest, PlayNext_EmptyQueue_NoChange) {
 }
 
 TEST_F(MusicPlayerTest, PlayNext_EmptyQueue_WithSongPlaying) {
-  const Song *song = addSongToLibrary("Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Song", "Artist", "Album");
   player.chooseAndPlaySong(song);
   player.playNext();
   EXPECT_FALSE(player.engine.isSoundLoaded);
@@ -432,7 +799,7 @@ TEST_F(MusicPlayerTest, PlayNext_EmptyQueue_WithSongPlaying) {
 // ========================
 
 TEST_F(MusicPlayerTest, PlayPrevious_NoHistory_StaysOnCurrentSong) {
-  const Song *song = addSongToLibrary("Song", "Artist", "Album");
+  const StoredSong *song = addSongToLibrary("Song", "Artist", "Album");
   player.chooseAndPlaySong(song);
 
   player.playPrevious();
@@ -441,8 +808,8 @@ TEST_F(MusicPlayerTest, PlayPrevious_NoHistory_StaysOnCurrentSong) {
 }
 
 TEST_F(MusicPlayerTest, PlayPrevious_WithHistory_GoesBack) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
   player.chooseAndPlaySong(song1);
   player.chooseAndPlaySong(song2);
 
@@ -461,8 +828,8 @@ TEST_F(MusicPlayerTest, GetHistoryManager) {
 }
 
 TEST_F(MusicPlayerTest, ClearHistory_ClearsPlaybackHistory) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
   player.chooseAndPlaySong(song1);
   player.chooseAndPlaySong(song2);
 
@@ -474,8 +841,8 @@ TEST_F(MusicPlayerTest, ClearHistory_ClearsPlaybackHistory) {
 }
 
 TEST_F(MusicPlayerTest, GetHistory_ReturnsPlaybackHistory) {
-  const Song *song1 = addSongToLibrary("Song 1", "Artist", "Album");
-  const Song *song2 = addSongToLibrary("Song 2", "Artist", "Album");
+  const StoredSong *song1 = addSongToLibrary("Song 1", "Artist", "Album");
+  const StoredSong *song2 = addSongToLibrary("Song 2", "Artist", "Album");
   player.chooseAndPlaySong(song1);
   player.chooseAndPlaySong(song2);
   player.playNext();
@@ -483,8 +850,8 @@ TEST_F(MusicPlayerTest, GetHistory_ReturnsPlaybackHistory) {
   auto history = player.getHistoryManager().getHistoryList();
 
   EXPECT_EQ(history.size(), 2);
-  EXPECT_EQ(history[0], song2);
-  EXPECT_EQ(history[1], song1);
+  EXPECT_EQ(player.getLibrary().resolve(history[0]), song2);
+  EXPECT_EQ(player.getLibrary().resolve(history[1]), song1);
 }
 
 // ========================
@@ -498,7 +865,7 @@ TEST_F(MusicPlayerTest,
 }
 
 TEST_F(MusicPlayerTest, GenerateSmartPlaylist_ReturnsSameArtistSongs) {
-  const Song *base = addSongToLibrary("Base Song", "Same Artist", "Album 1");
+  const StoredSong *base = addSongToLibrary("Base Song", "Same Artist", "Album 1");
   addSongToLibrary("Song 2", "Same Artist", "Album 2");
   addSongToLibrary("Song 3", "Different Artist", "Album 3");
 
@@ -509,7 +876,7 @@ TEST_F(MusicPlayerTest, GenerateSmartPlaylist_ReturnsSameArtistSongs) {
 }
 
 TEST_F(MusicPlayerTest, GenerateSmartPlaylist_EmptyPlaylist) {
-  const Song *base = addSongToLibrary("Base Song", "Same Artist", "Album 1");
+  const StoredSong *base = addSongToLibrary("Base Song", "Same Artist", "Album 1");
   addSongToLibrary("Song 2", "Different Artist", "Album 2");
 
   PlaybackQueue playlist = player.generateSmartPlaylist(base, 10);
@@ -525,7 +892,7 @@ TEST_F(MusicPlayerTest, ApplySmartPlaylist_NoPlaylist) {
 }
 
 TEST_F(MusicPlayerTest, ApplySmartPlaylist_AddsSongsToQueue) {
-  const Song *base = addSongToLibrary("Base Song", "Same Artist", "Album 1");
+  const StoredSong *base = addSongToLibrary("Base Song", "Same Artist", "Album 1");
   addSongToLibrary("Song 2", "Same Artist", "Album 2");
   addSongToLibrary("Song 3", "Different Artist", "Album 3");
 
@@ -0,0 +1,134 @@
+// tests/test_SearchService.cpp
+// Unit tests for SearchService class
+
+#include "../include/SearchService.h"
+#include <gtest/gtest.h>
+#include <string>
+
+class SearchServiceTest : public ::testing::Test {
+protected:
+  MusicLibrary library;
+
+  void SetUp() override {
+    for (int i = 0; i < 100; i++) {
+      Song song;
+      song.title = (i % 2 ? "Love Song " : "Rain Song ") + std::to_string(i);
+      song.artist = "Artist";
+      song.album = "Album";
+      song.filePath = "/music/" + std::to_string(i) + ".mp3";
+      library.addSong(song);
+    }
+  }
+
+  // Songs in the published snapshot
+  static size_t countOf(SearchService &search) {
+    std::shared_ptr<const SearchSnapshot> snapshot = search.getSnapshot();
+    return snapshot ? snapshot->result.songs.size() : 0;
+  }
+};
+
+// ========================
+// Test: submit
+// ========================
+
+TEST_F(SearchServiceTest, Submit_PublishesSnapshot) {
+  SearchService search(library, std::chrono::milliseconds(0));
+  EXPECT_EQ(search.getSnapshot(), nullptr);
+
+  search.submit("LOVE");
+  search.wait();
+
+  std::shared_ptr<const SearchSnapshot> snapshot = search.getSnapshot();
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->key, "love");
+  EXPECT_EQ(snapshot->libraryVersion, library.getVersion());
+  EXPECT_EQ(snapshot->result.songs.size(), 50);
+  EXPECT_FALSE(search.isSearching());
+
+  search.submit("");
+  EXPECT_EQ(countOf(search), 0); // empty query: published at once
+}
+
+TEST_F(SearchServiceTest, Submit_SameOrCachedQuery_NoNewSearch) {
+  SearchService search(library, std::chrono::milliseconds(0));
+  search.submit("love");
+  search.wait();
+  std::shared_ptr<const SearchSnapshot> first = search.getSnapshot();
+  search.submit("love"); // every frame while the text is unchanged
+  search.submit("rain");
+  search.wait();
+
+  search.submit("love");
+
+  EXPECT_EQ(search.getSnapshot(), first); // same snapshot, no task
+  SearchStats stats = search.getStats();
+  EXPECT_EQ(stats.searches, 2);
+  EXPECT_EQ(stats.cacheHits, 1);
+}
+
+TEST_F(SearchServiceTest, Submit_ExtendedQuery_RefinesPrevious) {
+  SearchService search(library, std::chrono::milliseconds(0));
+  search.submit("son");
+  search.wait();
+  EXPECT_EQ(countOf(search), 100);
+
+  search.submit("love son");
+  search.wait();
+  search.submit("love song 1");
+  search.wait();
+
+  EXPECT_EQ(countOf(search), 6); // 1, 11, 13, ..., 19
+  SearchStats stats = search.getStats();
+  EXPECT_EQ(stats.searches, 1);
+  EXPECT_EQ(stats.refinements, 2);
+}
+
+TEST_F(SearchServiceTest, Submit_Misspelled_HasFuzzyMatches) {
+  SearchService search(library, std::chrono::milliseconds(0));
+
+  search.submit("lvoe song 13");
+  search.wait();
+
+  std::shared_ptr<const SearchSnapshot> snapshot = search.getSnapshot();
+  EXPECT_TRUE(snapshot->result.songs.empty());
+  ASSERT_FALSE(snapshot->fuzzy.empty());
+  EXPECT_LE(snapshot->fuzzy.size(), SearchService::FUZZY_LIMIT);
+  EXPECT_EQ(library.resolve(snapshot->fuzzy[0].song)->title, "Love Song 13");
+
+  search.submit("song"); // plenty of exact songs: no fuzzy ranking
+  search.wait();
+  EXPECT_TRUE(search.getSnapshot()->fuzzy.empty());
+}
+
+TEST_F(SearchServiceTest, Submit_NewerQuery_ReplacesWaitingOne) {
+  SearchService search(library, std::chrono::milliseconds(50));
+
+  search.submit("l");
+  search.submit("lo"); // typed within the debounce: "l" never runs
+  search.submit("rain");
+  search.wait();
+
+  EXPECT_EQ(search.getSnapshot()->key, "rain");
+  EXPECT_EQ(countOf(search), 50);
+  EXPECT_EQ(search.getStats().searches, 1);
+}
+
+TEST_F(SearchServiceTest, Submit_LibraryChanged_SearchesAgain) {
+  SearchService search(library, std::chrono::milliseconds(0));
+  search.submit("love");
+  search.wait();
+  {
+    auto lock = search.lockLibrary();
+    Song song;
+    song.title = "Love Again";
+    song.filePath = "/music/again.mp3";
+    library.addSong(song);
+  }
+
+  search.submit("love"); // same text, newer library
+
+  search.wait();
+  EXPECT_EQ(countOf(search), 51);
+  EXPECT_EQ(search.getSnapshot()->libraryVersion, library.getVersion());
+  EXPECT_EQ(search.getStats().cacheHits, 0);
+}
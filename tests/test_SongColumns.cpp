@@ -0,0 +1,76 @@
+// tests/test_SongColumns.cpp
+// Unit tests for SongColumns struct
+
+#include "../include/SongColumns.h"
+#include <gtest/gtest.h>
+
+class SongColumnsTest : public ::testing::Test {
+protected:
+  SongColumns columns;
+
+  // Helper: record with every field derived from one number
+  StoredSong makeSong(int n) {
+    StoredSong song;
+    song.id = n;
+    song.title = titles[n % 2];
+    song.artistId = 10 + n;
+    song.albumId = 20 + n;
+    song.duration = 30 + n;
+    song.filePath = paths[n % 2];
+    return song;
+  }
+
+private:
+  const char *titles[2] = {"Even", "Odd"};
+  const char *paths[2] = {"/music/even.mp3", "/music/odd.mp3"};
+};
+
+// ========================
+// Test: push_back / set / pop_back
+// ========================
+
+TEST_F(SongColumnsTest, PushBack_FillsEveryColumn) {
+  columns.push_back(makeSong(0), {});
+  columns.push_back(makeSong(1), {"key", "odd"});
+
+  ASSERT_EQ(columns.size(), 2);
+  EXPECT_EQ(columns.ids[1], 1);
+  EXPECT_EQ(columns.titles[1], "Odd");
+  EXPECT_EQ(columns.artistIds[1], 11);
+  EXPECT_EQ(columns.albumIds[1], 21);
+  EXPECT_EQ(columns.durations[1], 31);
+  EXPECT_EQ(columns.filePaths[1], "/music/odd.mp3");
+  EXPECT_EQ(columns.titleSortKeys[1], "key");
+  EXPECT_EQ(columns.getKeys(1).searchKey, "odd");
+}
+
+TEST_F(SongColumnsTest, SetAndPopBack_KeepColumnsInStep) {
+  columns.push_back(makeSong(0), {});
+  columns.push_back(makeSong(1), {"key", "odd"});
+
+  // like a swap-remove in MusicLibrary
+  columns.set(0, makeSong(1), columns.getKeys(1));
+  columns.pop_back();
+
+  ASSERT_EQ(columns.size(), 1);
+  EXPECT_EQ(columns.titles.size(), 1);
+  EXPECT_EQ(columns.filePaths.size(), 1);
+  EXPECT_EQ(columns.ids[0], 1);
+  EXPECT_EQ(columns.albumIds[0], 21);
+  EXPECT_EQ(columns.titleSearchKeys.size(), 1);
+  EXPECT_EQ(columns.titleSearchKeys[0], "odd");
+}
+
+// ========================
+// Test: clear
+// ========================
+
+TEST_F(SongColumnsTest, Clear_FreesColumns) {
+  columns.reserve(100);
+  columns.push_back(makeSong(0), {});
+
+  columns.clear();
+
+  EXPECT_EQ(columns.size(), 0);
+  EXPECT_EQ(columns.titles.capacity(), 0);
+}
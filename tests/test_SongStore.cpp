@@ -0,0 +1,109 @@
+// tests/test_SongStore.cpp
+// Unit tests for SongStore class
+
+#include "../include/SongStore.h"
+#include "../include/TextArena.h"
+#include <gtest/gtest.h>
+
+class SongStoreTest : public ::testing::Test {
+protected:
+  SongStore store;
+  TextArena text; // keeps the titles the records view
+
+  // Helper: fill with songs titled by their slot
+  void fill(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      StoredSong song;
+      song.id = static_cast<int>(store.size());
+      song.title = text.append("Song " + std::to_string(store.size()));
+      store.push_back(song);
+    }
+  }
+};
+
+// ========================
+// Test: push_back
+// ========================
+
+TEST_F(SongStoreTest, PushBack_GrowsByBlocks_AddressesStable) {
+  fill(1);
+  const StoredSong *first = &store[0];
+  EXPECT_EQ(store.capacity(), SongStore::BLOCK_SIZE);
+
+  fill(3 * SongStore::BLOCK_SIZE);
+
+  EXPECT_EQ(&store[0], first);
+  EXPECT_EQ(first->title, "Song 0");
+  EXPECT_EQ(store.size(), 3 * SongStore::BLOCK_SIZE + 1);
+  EXPECT_EQ(store.capacity(), 4 * SongStore::BLOCK_SIZE);
+}
+
+TEST_F(SongStoreTest, PushBack_ReturnsTrueOnlyForNewBlock) {
+  StoredSong song;
+  EXPECT_TRUE(store.push_back(song));
+  fill(SongStore::BLOCK_SIZE - 1);
+  EXPECT_EQ(store.capacity(), SongStore::BLOCK_SIZE);
+  EXPECT_TRUE(store.push_back(song));
+}
+
+// ========================
+// Test: iteration
+// ========================
+
+TEST_F(SongStoreTest, Iterate_AcrossBlocks_InSlotOrder) {
+  fill(2 * SongStore::BLOCK_SIZE + 10);
+
+  size_t slot = 0;
+  for (const StoredSong &song : store) {
+    ASSERT_EQ(song.title, "Song " + std::to_string(slot));
+    slot++;
+  }
+  EXPECT_EQ(slot, store.size());
+  EXPECT_EQ(store.end() - store.begin(), store.size());
+  EXPECT_EQ(store.begin()[SongStore::BLOCK_SIZE].title,
+            "Song " + std::to_string(SongStore::BLOCK_SIZE));
+}
+
+// ========================
+// Test: pop_back / reserve / clear
+// ========================
+
+TEST_F(SongStoreTest, PopBack_KeepsBlockForReuse) {
+  fill(SongStore::BLOCK_SIZE + 1);
+  store.pop_back();
+  EXPECT_EQ(store.size(), SongStore::BLOCK_SIZE);
+  EXPECT_EQ(store.back().title,
+            "Song " + std::to_string(SongStore::BLOCK_SIZE - 1));
+
+  StoredSong song;
+  EXPECT_FALSE(store.push_back(song)); // second block still allocated
+}
+
+TEST_F(SongStoreTest, Reserve_AllocatesWholeBlocks) {
+  EXPECT_TRUE(store.reserve(SongStore::BLOCK_SIZE + 1));
+  EXPECT_EQ(store.capacity(), 2 * SongStore::BLOCK_SIZE);
+  EXPECT_FALSE(store.reserve(10));
+  EXPECT_TRUE(store.empty());
+}
+
+TEST_F(SongStoreTest, Clear_FreesEverything) {
+  fill(SongStore::BLOCK_SIZE * 2);
+  store.clear();
+  EXPECT_TRUE(store.empty());
+  EXPECT_EQ(store.capacity(), 0);
+  EXPECT_TRUE(store.begin() == store.end());
+}
+
+// ========================
+// Test: slotOf
+// ========================
+
+TEST_F(SongStoreTest, SlotOf_FindsSlotInAnyBlock) {
+  fill(3 * SongStore::BLOCK_SIZE);
+  size_t slot = 2 * SongStore::BLOCK_SIZE + 7;
+  EXPECT_EQ(store.slotOf(&store[slot]), slot);
+  EXPECT_EQ(store.slotOf(&store[0]), 0);
+
+  StoredSong outside;
+  EXPECT_EQ(store.slotOf(&outside), store.size());
+}
@@ -0,0 +1,62 @@
+// tests/test_StringPool.cpp
+// Unit tests for StringPool class
+
+#include "../include/StringPool.h"
+#include <gtest/gtest.h>
+
+class StringPoolTest : public ::testing::Test {
+protected:
+  StringPool pool;
+};
+
+// ========================
+// Test: intern / find / get
+// ========================
+
+TEST_F(StringPoolTest, Intern_SameText_SameID) {
+  uint32_t first = pool.intern("Artist");
+  uint32_t other = pool.intern("Other");
+
+  EXPECT_EQ(pool.intern("Artist"), first);
+  EXPECT_EQ(first, 0);
+  EXPECT_EQ(other, 1);
+  EXPECT_EQ(pool.size(), 2);
+}
+
+TEST_F(StringPoolTest, Get_ReturnsInternedText) {
+  uint32_t id = pool.intern("S\xC6\xA1n T\xC3\xB9ng");
+
+  EXPECT_EQ(pool.get(id), "S\xC6\xA1n T\xC3\xB9ng");
+  EXPECT_EQ(pool.get(StringPool::NONE), "");
+}
+
+TEST_F(StringPoolTest, Find_DoesNotStore) {
+  EXPECT_EQ(pool.find("Missing"), StringPool::NONE);
+  EXPECT_EQ(pool.size(), 0);
+
+  uint32_t id = pool.intern("Present");
+  EXPECT_EQ(pool.find("Present"), id);
+}
+
+TEST_F(StringPoolTest, Intern_ManyTexts_KeysStayValid) {
+  // Growing past many deque chunks must not break earlier keys
+  for (int i = 0; i < 10000; i++) {
+    pool.intern("Name " + std::to_string(i));
+  }
+
+  EXPECT_EQ(pool.find("Name 0"), 0);
+  EXPECT_EQ(pool.find("Name 9999"), 9999);
+  EXPECT_EQ(pool.get(5000), "Name 5000");
+}
+
+TEST_F(StringPoolTest, Clear_RestartsIDs) {
+  pool.intern("Old");
+  EXPECT_EQ(pool.getTextBytes(), 3);
+
+  pool.clear();
+
+  EXPECT_EQ(pool.size(), 0);
+  EXPECT_EQ(pool.getTextBytes(), 0);
+  EXPECT_EQ(pool.find("Old"), StringPool::NONE);
+  EXPECT_EQ(pool.intern("New"), 0);
+}
@@ -0,0 +1,180 @@
+// tests/test_TagCache.cpp
+// Unit tests for TagCache class
+
+#include "../include/TagCache.h"
+#include "TempDir.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class TagCacheTest : public TempDirTest {
+protected:
+  TagCacheTest() : TempDirTest("tag_cache_") {}
+
+  // Helper: a song as if its tags were read from file
+  Song taggedSong(const std::string &title) {
+    Song song;
+    song.title = title;
+    song.artist = "Cached Artist";
+    song.album = "Cached Album";
+    song.duration = 200;
+    return song;
+  }
+
+  std::string pathOf(const std::string &name) {
+    return (root / name).string();
+  }
+};
+
+// ========================
+// Test: statFile
+// ========================
+
+TEST_F(TagCacheTest, StatFile_ExistingFile_ReturnsSize) {
+  std::ofstream(root / "a.mp3") << "12345";
+  FileStamp stamp;
+
+  ASSERT_TRUE(statFile(pathOf("a.mp3"), stamp));
+  EXPECT_EQ(stamp.size, 5);
+  EXPECT_NE(stamp.mtime, 0);
+}
+
+TEST_F(TagCacheTest, StatFile_MissingFile_ReturnsFalse) {
+  FileStamp stamp;
+  EXPECT_FALSE(statFile(pathOf("missing.mp3"), stamp));
+}
+
+// ========================
+// Test: lookup / store
+// ========================
+
+TEST_F(TagCacheTest, Lookup_AfterStore_Hits) {
+  TagCache cache(root.string());
+  FileStamp stamp{100, 42};
+  cache.store(pathOf("a.mp3"), stamp, taggedSong("Cached"));
+
+  Song song;
+  ASSERT_TRUE(cache.lookup(pathOf("a.mp3"), stamp, song));
+  EXPECT_EQ(song.title, "Cached");
+  EXPECT_EQ(song.artist, "Cached Artist");
+  EXPECT_EQ(song.duration, 200);
+  EXPECT_EQ(cache.getHits(), 1);
+}
+
+TEST_F(TagCacheTest, Lookup_ChangedSizeOrMtime_Misses) {
+  TagCache cache(root.string());
+  cache.store(pathOf("a.mp3"), FileStamp{100, 42}, taggedSong("Cached"));
+
+  Song song;
+  EXPECT_FALSE(cache.lookup(pathOf("a.mp3"), FileStamp{101, 42}, song));
+  EXPECT_FALSE(cache.lookup(pathOf("a.mp3"), FileStamp{100, 43}, song));
+  EXPECT_EQ(cache.getMisses(), 2);
+}
+
+// ========================
+// Test: save / load
+// ========================
+
+TEST_F(TagCacheTest, SaveLoad_RoundTrip) {
+  {
+    TagCache cache(root.string());
+    cache.store(pathOf("a.mp3"), FileStamp{1, 2}, taggedSong("Bài hát"));
+    cache.store(pathOf("b.mp3"), FileStamp{3, 4}, taggedSong("Second"));
+    ASSERT_TRUE(cache.save());
+  }
+
+  TagCache reloaded(root.string());
+  ASSERT_TRUE(reloaded.load());
+  Song song;
+  EXPECT_EQ(reloaded.getSize(), 2);
+  ASSERT_TRUE(reloaded.lookup(pathOf("a.mp3"), FileStamp{1, 2}, song));
+  EXPECT_EQ(song.title, "Bài hát");
+}
+
+TEST_F(TagCacheTest, Load_NoFile_ReturnsFalse) {
+  TagCache cache(root.string());
+  EXPECT_FALSE(cache.load());
+  EXPECT_EQ(cache.getSize(), 0);
+}
+
+TEST_F(TagCacheTest, Load_WrongVersion_DiscardsCache) {
+  {
+    TagCache cache(root.string());
+    cache.store(pathOf("a.mp3"), FileStamp{1, 2}, taggedSong("A"));
+    cache.save();
+  }
+  // Bump the version field (bytes 4..7)
+  std::fstream file(root / TagCache::FILE_NAME,
+                    std::ios::in | std::ios::out | std::ios::binary);
+  uint32_t version = TagCache::VERSION + 1;
+  file.seekp(4);
+  file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+  file.close();
+
+  TagCache cache(root.string());
+  EXPECT_FALSE(cache.load());
+  EXPECT_EQ(cache.getSize(), 0);
+}
+
+TEST_F(TagCacheTest, Load_CorruptedRecord_DetectedByChecksum) {
+  {
+    TagCache cache(root.string());
+    cache.store(pathOf("a.mp3"), FileStamp{1, 2}, taggedSong("A"));
+    cache.save();
+  }
+  // Flip a byte of the last record's payload
+  fs::path file = root / TagCache::FILE_NAME;
+  std::fstream stream(file, std::ios::in | std::ios::out | std::ios::binary);
+  stream.seekp(fs::file_size(file) - 6);
+  stream.put('#');
+  stream.close();
+
+  TagCache cache(root.string());
+  EXPECT_FALSE(cache.load());
+  EXPECT_EQ(cache.getSize(), 0);
+}
+
+TEST_F(TagCacheTest, Load_CorruptHeaderCount_RejectedWithoutAllocating) {
+  {
+    TagCache cache(root.string());
+    cache.store(pathOf("a.mp3"), FileStamp{1, 2}, taggedSong("A"));
+    cache.save();
+  }
+  // Entry count field (bytes 8..15): far more than the file can hold
+  std::fstream file(root / TagCache::FILE_NAME,
+                    std::ios::in | std::ios::out | std::ios::binary);
+  uint64_t count = uint64_t(1) << 60;
+  file.seekp(8);
+  file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  file.close();
+
+  TagCache cache(root.string());
+  EXPECT_NO_THROW(EXPECT_FALSE(cache.load()));
+  EXPECT_EQ(cache.getSize(), 0);
+  cache.store(pathOf("a.mp3"), FileStamp{1, 2}, taggedSong("A"));
+  EXPECT_TRUE(cache.save()); // rebuilt cache loads again
+  EXPECT_TRUE(TagCache(root.string()).load());
+}
+
+// ========================
+// Test: prune
+// ========================
+
+TEST_F(TagCacheTest, Prune_RemovesEntriesNotSeenSinceLoad) {
+  {
+    TagCache cache(root.string());
+    cache.store(pathOf("kept.mp3"), FileStamp{1, 1}, taggedSong("Kept"));
+    cache.store(pathOf("gone.mp3"), FileStamp{2, 2}, taggedSong("Gone"));
+    cache.save();
+  }
+
+  TagCache cache(root.string());
+  cache.load();
+  Song song;
+  cache.lookup(pathOf("kept.mp3"), FileStamp{1, 1}, song);
+
+  EXPECT_EQ(cache.prune(), 1);
+  EXPECT_EQ(cache.getSize(), 1);
+}
@@ -0,0 +1,222 @@
+// tests/test_TagLoader.cpp
+// Unit tests for TagLoader class
+
+#include "../include/TagLoader.h"
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class TagLoaderTest : public ::testing::Test {
+protected:
+  // Reader that records the read order and holds the first read until
+  // release() - lets a test queue and reorder songs behind it
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool firstStarted = false;
+  bool released = false;
+  std::vector<std::string> order;
+
+  ImportPipeline::MetadataReader gatedReader() {
+    return [this](const std::string &filePath, Song &song) {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (!firstStarted) {
+        firstStarted = true;
+        cv.notify_all();
+        cv.wait(lock, [this] { return released; });
+      }
+      order.push_back(filePath);
+      song.title = "Read " + filePath;
+    };
+  }
+
+  void waitFirstStarted() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this] { return firstStarted; });
+  }
+
+  void release() {
+    std::lock_guard<std::mutex> lock(mtx);
+    released = true;
+    cv.notify_all();
+  }
+
+  int nextId = 0; // listed songs carry their library ID
+
+  void TearDown() override { release(); }
+
+  // Helper: song as published by a lazy import
+  Song listedSong(const std::string &name) {
+    Song song(nextId++);
+    song.title = name;
+    song.filePath = name;
+    return song;
+  }
+
+  // Helper: take results until count songs arrived (or timeout)
+  static std::vector<Song> collect(TagLoader &loader, size_t count) {
+    std::vector<Song> out;
+    for (int i = 0; i < 500 && out.size() < count; i++) {
+      if (loader.takeResults(out, SIZE_MAX) == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+    }
+    return out;
+  }
+};
+
+// ========================
+// Test: enqueue
+// ========================
+
+TEST_F(TagLoaderTest, Enqueue_ReadsEverySong) {
+  TagLoader loader(
+      [](const std::string &filePath, Song &song) {
+        song.title = "Read " + filePath;
+      },
+      4);
+  std::vector<Song> songs;
+  for (int i = 0; i < 50; i++) {
+    songs.push_back(listedSong("s" + std::to_string(i)));
+    loader.enqueue(songs.back());
+  }
+
+  std::vector<Song> read = collect(loader, 50);
+
+  ASSERT_EQ(read.size(), 50);
+  for (const Song &song : read) {
+    EXPECT_EQ(song.title, "Read " + song.filePath);
+  }
+  EXPECT_EQ(loader.getPendingCount(), 0);
+}
+
+TEST_F(TagLoaderTest, Enqueue_WithCache_StoresTags) {
+  fs::path root = fs::temp_directory_path() / "tag_loader_cache";
+  fs::create_directories(root);
+  auto cache = std::make_shared<TagCache>(root.string());
+  TagLoader loader(
+      [](const std::string &, Song &song) { song.artist = "Artist"; }, 1);
+  Song song = listedSong((root / "a.mp3").string());
+  song.stamp = {10, 20};
+
+  loader.enqueue(song, cache);
+  ASSERT_EQ(collect(loader, 1).size(), 1);
+
+  Song cached;
+  EXPECT_TRUE(cache->lookup(song.filePath, song.stamp, cached));
+  EXPECT_EQ(cached.artist, "Artist");
+  fs::remove_all(root);
+}
+
+// ========================
+// Test: prioritize
+// ========================
+
+TEST_F(TagLoaderTest, Prioritize_VisibleThenQueuedThenBackground) {
+  TagLoader loader(gatedReader(), 1);
+  std::vector<Song> songs;
+  for (int i = 0; i < 7; i++) {
+    songs.push_back(listedSong("s" + std::to_string(i)));
+  }
+  loader.enqueue(songs[0]);
+  waitFirstStarted(); // s0 holds the only worker
+  for (int i = 1; i < 7; i++) {
+    loader.enqueue(songs[i]);
+  }
+
+  loader.prioritize({songs[5].id}, TagPriority::Queued);
+  loader.prioritize({songs[3].id}, TagPriority::Visible);
+  loader.prioritize({songs[6].id}, TagPriority::Visible); // latest frame
+  release();
+  collect(loader, 7);
+
+  std::vector<std::string> expected{"s0", "s6", "s3", "s5", "s1", "s2", "s4"};
+  EXPECT_EQ(order, expected);
+}
+
+TEST_F(TagLoaderTest, Prioritize_RowShownAgain_GoesFirst) {
+  TagLoader loader(gatedReader(), 1);
+  std::vector<Song> songs;
+  for (int i = 0; i < 4; i++) {
+    songs.push_back(listedSong("s" + std::to_string(i)));
+  }
+  loader.enqueue(songs[0]);
+  waitFirstStarted();
+  for (int i = 1; i < 4; i++) {
+    loader.enqueue(songs[i]);
+  }
+
+  loader.prioritize({songs[1].id}, TagPriority::Visible);
+  loader.prioritize({songs[2].id}, TagPriority::Visible); // s1 scrolled away
+  loader.prioritize({songs[1].id}, TagPriority::Visible); // and back
+  release();
+  collect(loader, 4);
+
+  std::vector<std::string> expected{"s0", "s1", "s2", "s3"};
+  EXPECT_EQ(order, expected);
+}
+
+TEST_F(TagLoaderTest, Prioritize_NeverLowersPriority) {
+  TagLoader loader(gatedReader(), 1);
+  std::vector<Song> songs;
+  for (int i = 0; i < 3; i++) {
+    songs.push_back(listedSong("s" + std::to_string(i)));
+  }
+  loader.enqueue(songs[0]);
+  waitFirstStarted();
+  loader.enqueue(songs[1]);
+  loader.enqueue(songs[2]);
+
+  loader.prioritize({songs[2].id}, TagPriority::Visible);
+  loader.prioritize({songs[2].id}, TagPriority::Queued);
+  loader.prioritize({songs[1].id, 999}, TagPriority::Queued); // 999 unknown
+  release();
+  collect(loader, 3);
+
+  std::vector<std::string> expected{"s0", "s2", "s1"};
+  EXPECT_EQ(order, expected);
+}
+
+// ========================
+// Test: cancel / clear
+// ========================
+
+TEST_F(TagLoaderTest, Cancel_DropsOnlyGivenSongs) {
+  TagLoader loader(gatedReader(), 1);
+  loader.enqueue(listedSong("s0")); // in flight: still delivered
+  waitFirstStarted();
+  for (int i = 1; i < 6; i++) {
+    loader.enqueue(listedSong("s" + std::to_string(i)));
+  }
+
+  EXPECT_EQ(loader.cancel({1, 3, 5, 42}), 3);
+  release();
+
+  std::vector<Song> read = collect(loader, 3);
+  ASSERT_EQ(read.size(), 3);
+  EXPECT_EQ(read[0].filePath, "s0");
+  EXPECT_EQ(read[1].filePath, "s2");
+  EXPECT_EQ(read[2].filePath, "s4");
+  EXPECT_EQ(loader.getPendingCount(), 0);
+}
+
+TEST_F(TagLoaderTest, Clear_DropsQueuedAndInFlight) {
+  TagLoader loader(gatedReader(), 1);
+  loader.enqueue(listedSong("s0"));
+  waitFirstStarted();
+  loader.enqueue(listedSong("s1"));
+
+  loader.clear();
+  release();
+  for (int i = 0; i < 500 && loader.getPendingCount() > 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  std::vector<Song> out;
+  EXPECT_EQ(loader.takeResults(out, SIZE_MAX), 0);
+  EXPECT_EQ(loader.getPendingCount(), 0);
+}
@@ -0,0 +1,70 @@
+// tests/test_TextArena.cpp
+// Unit tests for TextArena class
+
+#include "../include/TextArena.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class TextArenaTest : public ::testing::Test {
+protected:
+  TextArena arena;
+};
+
+// ========================
+// Test: append
+// ========================
+
+TEST_F(TextArenaTest, Append_ReturnsNulTerminatedCopy) {
+  std::string source = "Title";
+  std::string_view stored = arena.append(source);
+  source = "Changed";
+
+  EXPECT_EQ(stored, "Title");
+  EXPECT_STREQ(stored.data(), "Title");
+  EXPECT_EQ(arena.getTextBytes(), 5);
+}
+
+TEST_F(TextArenaTest, Append_PacksIntoOneChunk) {
+  std::string_view first = arena.append("abc");
+  std::string_view second = arena.append("de");
+
+  EXPECT_EQ(second.data(), first.data() + 4); // right after the NUL
+  EXPECT_EQ(arena.getChunkBytes(), TextArena::CHUNK_SIZE);
+}
+
+TEST_F(TextArenaTest, Append_ManyChunks_ViewsStayValid) {
+  std::vector<std::string_view> views;
+  for (int i = 0; i < 20000; i++) {
+    views.push_back(arena.append("/music/file " + std::to_string(i)));
+  }
+
+  EXPECT_GT(arena.getChunkBytes(), TextArena::CHUNK_SIZE);
+  EXPECT_EQ(views[0], "/music/file 0");
+  EXPECT_EQ(views[19999], "/music/file 19999");
+}
+
+TEST_F(TextArenaTest, Append_LongText_OwnChunk_KeepsFilling) {
+  std::string_view small = arena.append("small");
+  std::string longText(TextArena::CHUNK_SIZE + 10, 'x');
+  std::string_view big = arena.append(longText);
+  std::string_view next = arena.append("next");
+
+  EXPECT_EQ(big, longText);
+  EXPECT_EQ(next.data(), small.data() + 6); // same chunk as before
+  EXPECT_EQ(arena.getChunkBytes(),
+            TextArena::CHUNK_SIZE + longText.size() + 1);
+}
+
+// ========================
+// Test: clear
+// ========================
+
+TEST_F(TextArenaTest, Clear_FreesEverything) {
+  arena.append("text");
+  arena.clear();
+
+  EXPECT_EQ(arena.getTextBytes(), 0);
+  EXPECT_EQ(arena.getChunkBytes(), 0);
+  EXPECT_STREQ(arena.append("again").data(), "again");
+}
@@ -0,0 +1,94 @@
+// tests/test_TextKey.cpp
+// Unit tests for Unicode normalization and text keys
+
+#include "../include/TextKey.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// ========================
+// Test: normalizeText
+// ========================
+
+TEST(TextKeyTest, Normalize_ComposesAndOrdersMarks) {
+  // e + dot below + circumflex, and e + circumflex + dot below: both ệ
+  EXPECT_EQ(normalizeText("e\xCC\xA3\xCC\x82"), "\xE1\xBB\x87");
+  EXPECT_EQ(normalizeText("e\xCC\x82\xCC\xA3"), "\xE1\xBB\x87");
+  EXPECT_EQ(normalizeText("\xE1\xBB\x87"), "\xE1\xBB\x87"); // already NFC
+  EXPECT_EQ(normalizeText("A\xCC\x8A"), "\xC3\x85");        // Å
+  EXPECT_EQ(normalizeText("plain ascii"), "plain ascii");
+  EXPECT_EQ(normalizeText(""), "");
+}
+
+TEST(TextKeyTest, Normalize_InvalidUtf8_Replaced) {
+  EXPECT_EQ(normalizeText("a\xFF" "b"), "a\xEF\xBF\xBD" "b");
+  EXPECT_EQ(normalizeText("\xC3"), "\xEF\xBF\xBD"); // truncated sequence
+  EXPECT_EQ(normalizeText("\xE6\x97\xA5"), "\xE6\x97\xA5"); // 日 kept
+}
+
+// ========================
+// Test: makeSortKey
+// ========================
+
+TEST(TextKeyTest, SortKey_VietnameseLetterOrder) {
+  std::vector<std::string> words = {
+      "\xC6\xB0",     // ư
+      "\xC4\x91",     // đ
+      "\xC3\xA2",     // â
+      "z",  "u", "d", "\xC4\x83", // ă
+      "a",  "\xC6\xA1", "o", "\xC3\xB4", // ơ o ô
+  };
+  std::sort(words.begin(), words.end(),
+            [](const std::string &a, const std::string &b) {
+              return makeSortKey(a) < makeSortKey(b);
+            });
+  std::vector<std::string> expected = {
+      "a", "\xC4\x83", "\xC3\xA2", "d", "\xC4\x91", "o", "\xC3\xB4",
+      "\xC6\xA1", "u", "\xC6\xB0", "z"};
+  EXPECT_EQ(words, expected);
+}
+
+TEST(TextKeyTest, SortKey_LettersThenTonesThenCase) {
+  // Tones: none < huyền < hỏi < ngã < sắc < nặng
+  EXPECT_LT(makeSortKey("ma"), makeSortKey("m\xC3\xA0"));     // mà
+  EXPECT_LT(makeSortKey("m\xC3\xA0"), makeSortKey("m\xE1\xBA\xA3")); // mả
+  EXPECT_LT(makeSortKey("m\xE1\xBA\xA3"), makeSortKey("m\xC3\xA3"));  // mã
+  EXPECT_LT(makeSortKey("m\xC3\xA3"), makeSortKey("m\xC3\xA1"));      // má
+  EXPECT_LT(makeSortKey("m\xC3\xA1"), makeSortKey("m\xE1\xBA\xA1"));  // mạ
+  // The letters decide before any mark: mạ < mb
+  EXPECT_LT(makeSortKey("m\xE1\xBA\xA1"), makeSortKey("mb"));
+  // Case last: lower first, but "Apple" < "banana"
+  EXPECT_LT(makeSortKey("apple"), makeSortKey("Apple"));
+  EXPECT_LT(makeSortKey("Apple"), makeSortKey("banana"));
+  // Forms and punctuation: NFD equals NFC, punctuation < digits < letters
+  EXPECT_EQ(makeSortKey("ma\xCC\x80"), makeSortKey("m\xC3\xA0"));
+  EXPECT_LT(makeSortKey("!"), makeSortKey("1"));
+  EXPECT_LT(makeSortKey("1"), makeSortKey("a"));
+  EXPECT_LT(makeSortKey("z"), makeSortKey("\xE6\x97\xA5")); // other scripts
+  EXPECT_EQ(makeSortKey("x\xE6\x97\xA5").find('\0'), std::string::npos);
+}
+
+// ========================
+// Test: makePrefixKey / makeSearchKey
+// ========================
+
+TEST(TextKeyTest, PrefixKey_PrefixOfSortKey) {
+  std::string key = makeSortKey("H\xC3\xA0 N\xE1\xBB\x99i"); // Hà Nội
+  EXPECT_EQ(key.compare(0, makePrefixKey("ha").size(), makePrefixKey("ha")),
+            0);
+  EXPECT_EQ(key.rfind(makePrefixKey("HA N\xC3\x94I"), 0), 0); // HA NÔI
+  EXPECT_NE(key.rfind(makePrefixKey("ha noi"), 0), 0); // ô is its own letter
+  EXPECT_NE(key.rfind(makePrefixKey("hb"), 0), 0);
+}
+
+TEST(TextKeyTest, SearchKey_FoldsCaseAndMarks) {
+  EXPECT_EQ(makeSearchKey("H\xC3\xA0 N\xE1\xBB\x99i"), "ha noi");
+  EXPECT_EQ(makeSearchKey("\xC4\x90\xC3\xA0 L\xE1\xBA\xA1t"), "da lat");
+  EXPECT_EQ(makeSearchKey("Ha\xCC\x80"), "ha"); // NFD input
+  EXPECT_EQ(makeSearchKey("Caf\xC3\xA9 \xE6\x97\xA5"), "cafe \xE6\x97\xA5");
+
+  TextKeys keys = makeTextKeys("\xC3\x89t\xC3\xA9");
+  EXPECT_EQ(keys.sortKey, makeSortKey("\xC3\x89t\xC3\xA9"));
+  EXPECT_EQ(keys.searchKey, "ete");
+}
@@ -0,0 +1,77 @@
+// tests/test_TextSearch.cpp
+// Unit tests for the substring search kernels
+
+#include "../include/TextSearch.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+static const SimdLevel LEVELS[] = {SimdLevel::Scalar, SimdLevel::SSE2,
+                                   SimdLevel::AVX2};
+
+// ========================
+// Test: findText
+// ========================
+
+TEST(TextSearchTest, FindText_EveryLevelMatchesStringFind) {
+  // Small alphabet with UTF-8 bytes: many first/last byte candidates
+  const std::string letters[] = {"a", "b", " ", "\xC3\xA0", "\xE1\xBB\x99"};
+  std::mt19937 rng(3);
+  auto text = [&](size_t pieces) {
+    std::string out;
+    for (size_t i = 0; i < pieces; i++) {
+      out += letters[rng() % std::size(letters)];
+    }
+    return out;
+  };
+  for (int round = 0; round < 2000; round++) {
+    std::string haystack = text(rng() % 90);
+    std::string needle = text(1 + rng() % 6);
+    if (round % 3 == 0 && !haystack.empty()) { // make sure some are found
+      size_t start = rng() % haystack.size();
+      needle = haystack.substr(start, 1 + rng() % 20);
+    }
+    size_t expected = std::string_view(haystack).find(needle);
+    for (SimdLevel level : LEVELS) {
+      ASSERT_EQ(findText(haystack, needle, level), expected)
+          << "level " << static_cast<int>(level) << " haystack '" << haystack
+          << "' needle '" << needle << "'";
+    }
+  }
+}
+
+TEST(TextSearchTest, FindText_BlockEdgesAndShortInput) {
+  std::string haystack(100, 'x');
+  haystack.replace(30, 4, "abcd"); // crosses the first 32-byte block
+  haystack.replace(96, 4, "wxyz"); // last bytes, scanned by the tail
+  for (SimdLevel level : LEVELS) {
+    EXPECT_EQ(findText(haystack, "abcd", level), 30);
+    EXPECT_EQ(findText(haystack, "wxyz", level), 96);
+    EXPECT_EQ(findText(haystack, "z", level), 99);
+    EXPECT_EQ(findText(haystack, "xa", level), 29);
+    EXPECT_EQ(findText(haystack, "abce", level), std::string::npos);
+    EXPECT_EQ(findText(haystack, "", level), 0);
+    EXPECT_EQ(findText("ab", "abc", level), std::string::npos);
+    EXPECT_EQ(findText("", "a", level), std::string::npos);
+  }
+}
+
+TEST(TextSearchTest, FindText_Utf8_MatchesWholeCharacters) {
+  // Needles starting with a lead byte only match at character starts
+  std::string text = "h\xC3\xA0 n\xE1\xBB\x99i \xE1\xBB\x99";
+  for (SimdLevel level : LEVELS) {
+    EXPECT_EQ(findText(text, "\xE1\xBB\x99i", level), 5);
+    EXPECT_EQ(findText(text, "\xBB\x99", level), 6); // bytes still compare
+    EXPECT_EQ(findText(text, "\xE1\xBB\x98", level), std::string::npos);
+  }
+  EXPECT_TRUE(containsText("ha noi mua thu", "noi"));
+  EXPECT_FALSE(containsText("ha noi mua thu", "hanoi"));
+}
+
+TEST(TextSearchTest, DetectSimdLevel_Stable) {
+  SimdLevel level = detectSimdLevel();
+  EXPECT_EQ(detectSimdLevel(), level);
+#if defined(__x86_64__) || defined(_M_X64)
+  EXPECT_GE(static_cast<int>(level), static_cast<int>(SimdLevel::SSE2));
+#endif
+}
@@ -0,0 +1,93 @@
+// tests/test_TitleIndex.cpp
+// Unit tests for TitleIndex class
+
+#include "../include/TitleIndex.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class TitleIndexTest : public ::testing::Test {
+protected:
+  TitleIndex index;
+
+  // Helper: IDs of a range, in range order
+  static std::vector<int> ids(TitleIndex::Range range) {
+    std::vector<int> out;
+    for (const TitleIndex::Entry &entry : range) {
+      out.push_back(entry.id);
+    }
+    return out;
+  }
+};
+
+// ========================
+// Test: insert / equalRange
+// ========================
+
+TEST_F(TitleIndexTest, EqualRange_DuplicateTitlesKeptInIdOrder) {
+  index.insert("Intro", 5, SongHandle(5, 0));
+  index.insert("Outro", 1, SongHandle(1, 0));
+  index.insert("Intro", 2, SongHandle(2, 0));
+
+  EXPECT_EQ(ids(index.equalRange("Intro")), (std::vector<int>{2, 5}));
+  EXPECT_EQ(index.equalRange("Intro").begin()->song, SongHandle(2, 0));
+  EXPECT_TRUE(index.equalRange("Missing").empty());
+  EXPECT_EQ(index.size(), 3);
+}
+
+TEST_F(TitleIndexTest, All_SortedByKeyThenId) {
+  index.insert("b", 0, SongHandle(0, 0));
+  index.insert("a", 3, SongHandle(3, 0));
+  index.settle();
+  index.insert("a", 1, SongHandle(1, 0)); // merged into the sorted part
+  index.insert("c", 2, SongHandle(2, 0));
+
+  EXPECT_EQ(ids(index.all()), (std::vector<int>{1, 3, 0, 2}));
+}
+
+// ========================
+// Test: prefixRange
+// ========================
+
+TEST_F(TitleIndexTest, PrefixRange_OnlyKeysStartingWithPrefix) {
+  index.insert("Love Song", 0, SongHandle(0, 0));
+  index.insert("Lovely", 1, SongHandle(1, 0));
+  index.insert("Lov", 2, SongHandle(2, 0));
+  index.insert("Lo", 3, SongHandle(3, 0));
+  index.insert("Lp", 4, SongHandle(4, 0));
+
+  EXPECT_EQ(ids(index.prefixRange("Lov")), (std::vector<int>{2, 0, 1}));
+  EXPECT_TRUE(index.prefixRange("Lx").empty());
+  EXPECT_EQ(index.prefixRange("").size(), 5);
+}
+
+// ========================
+// Test: erase / clear
+// ========================
+
+TEST_F(TitleIndexTest, Erase_RemovesOnlyThatSong) {
+  index.insert("Intro", 0, SongHandle(0, 0));
+  index.insert("Intro", 1, SongHandle(1, 0));
+
+  EXPECT_TRUE(index.erase("Intro", 0));
+  EXPECT_FALSE(index.erase("Intro", 0));
+  EXPECT_FALSE(index.erase("Other", 1));
+
+  EXPECT_EQ(ids(index.equalRange("Intro")), (std::vector<int>{1}));
+  EXPECT_EQ(index.size(), 1);
+}
+
+TEST_F(TitleIndexTest, Erase_ThenReAddSameSong_Found) {
+  index.insert("Intro", 0, SongHandle(0, 0));
+  index.settle();
+  index.erase("Intro", 0);
+  index.insert("Intro", 0, SongHandle(0, 1)); // e.g. tags updated
+
+  EXPECT_TRUE(index.erase("Intro", 0));
+  EXPECT_TRUE(index.equalRange("Intro").empty());
+
+  index.insert("Intro", 0, SongHandle(0, 2));
+  index.clear();
+  EXPECT_EQ(index.size(), 0);
+  EXPECT_TRUE(index.all().empty());
+}
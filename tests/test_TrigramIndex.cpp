@@ -0,0 +1,81 @@
+// tests/test_TrigramIndex.cpp
+// Unit tests for TrigramIndex class
+
+#include "../include/TrigramIndex.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class TrigramIndexTest : public ::testing::Test {
+protected:
+  TrigramIndex index;
+  std::vector<uint32_t> found;
+};
+
+// ========================
+// Test: candidates
+// ========================
+
+TEST_F(TrigramIndexTest, Candidates_IntersectsEveryTrigram) {
+  index.insert(0, "love song");
+  index.insert(1, "song of love");
+  index.insert(2, "long road");
+  index.insert(3, "lovely");
+
+  index.candidates("love", found);
+  EXPECT_EQ(found, (std::vector<uint32_t>{0, 1, 3}));
+  index.candidates("ong", found);
+  EXPECT_EQ(found, (std::vector<uint32_t>{0, 1, 2}));
+  index.candidates("song o", found);
+  EXPECT_EQ(found, (std::vector<uint32_t>{1}));
+}
+
+TEST_F(TrigramIndexTest, Candidates_MissingTrigramOrShortQuery_Empty) {
+  index.insert(0, "love song");
+
+  index.candidates("lovx", found);
+  EXPECT_TRUE(found.empty());
+  index.candidates("lo", found); // below MIN_QUERY: no trigram to look up
+  EXPECT_TRUE(found.empty());
+  index.insert(1, "ab"); // too short to be indexed
+  EXPECT_EQ(index.getListCount(), 7);
+}
+
+// ========================
+// Test: insert / erase
+// ========================
+
+TEST_F(TrigramIndexTest, Insert_OutOfOrderAndAgain_ListsStaySortedUnique) {
+  index.insert(5, "abcd");
+  index.insert(2, "abcd");
+  index.insert(5, "abcd"); // same ID again, e.g. key changed back
+  index.insert(9, "abcabc");
+
+  index.candidates("abc", found);
+  EXPECT_EQ(found, (std::vector<uint32_t>{2, 5, 9}));
+  index.candidates("bcd", found);
+  EXPECT_EQ(found, (std::vector<uint32_t>{2, 5}));
+  EXPECT_EQ(index.getEntryCount(), 7); // abc x3, bcd x2, bca, cab
+}
+
+TEST_F(TrigramIndexTest, Erase_StaleUntilRebuild) {
+  for (uint32_t doc = 0; doc < 1000; doc++) {
+    index.insert(doc, "title " + std::to_string(doc));
+  }
+  EXPECT_FALSE(index.needsRebuild());
+
+  // Erased keys keep their postings: candidates are verified by callers
+  index.erase("title 7");
+  index.candidates("e 7", found);
+  EXPECT_EQ(found.front(), 7);
+  for (uint32_t doc = 0; doc < 900; doc++) {
+    index.erase("title " + std::to_string(doc));
+  }
+  EXPECT_TRUE(index.needsRebuild());
+
+  index.clear();
+  EXPECT_FALSE(index.needsRebuild());
+  EXPECT_EQ(index.getEntryCount(), 0);
+  index.candidates("title", found);
+  EXPECT_TRUE(found.empty());
+}